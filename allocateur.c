@@ -0,0 +1,278 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "allocateur.h"
+
+
+//Entête placé devant chaque bloc rendu à l'appelant (16 octets : l'alignement de malloc est gardé)
+typedef struct {
+    Allocateur *proprietaire;
+    size_t taille_phase;        //Taille du bloc entête compris << 4 | phase
+} EnteteBloc;
+
+#define TAILLE_ENTETE_BLOC sizeof(EnteteBloc)
+
+//Allocateur et phase courants de chaque thread
+static _Thread_local Allocateur *allocateur_actuel = NULL;
+static _Thread_local PhaseMemoire phase_actuelle = PHASE_AUTRE;
+
+
+// ----------------------
+/*
+Allocateur par défaut
+*/
+// ----------------------
+
+static void *allouer_defaut(Allocateur *a, size_t taille, PhaseMemoire phase) {
+    (void)a;
+    (void)phase;
+    return malloc(taille);
+}
+
+static void liberer_defaut(Allocateur *a, void *bloc, size_t taille, PhaseMemoire phase) {
+    (void)a;
+    (void)taille;
+    (void)phase;
+    free(bloc);
+}
+
+static Allocateur allocateur_defaut = {allouer_defaut, liberer_defaut};
+
+//Retourne l'allocateur par défaut (malloc, free)
+Allocateur *allocateur_par_defaut(void) {
+    return &allocateur_defaut;
+}
+
+
+// ----------------------
+/*
+Arène
+   Les allocations sont placées les unes après les autres dans le bloc courant ; un bloc plein est
+   remplacé par un nouveau, chainé au précédent. Libérer une allocation ne fait rien : la mémoire
+   est rendue à arene_vider (fin d'une requête) ou arene_liberer.
+*/
+// ----------------------
+
+struct BlocArene {
+    BlocArene *suivant;
+    size_t taille;              //Octets utilisables dans donnees
+    size_t utilises;
+    _Alignas(16) unsigned char donnees[];
+};
+
+static void *allouer_arene(Allocateur *base, size_t taille, PhaseMemoire phase) {
+    (void)phase;
+    AllocateurArene *a = (AllocateurArene *)base;
+    taille = (taille + 15) & ~(size_t)15;
+    BlocArene *bloc = a->blocs;
+    if (!bloc || bloc->taille - bloc->utilises < taille) {
+        size_t utilisable = taille > a->taille_bloc ? taille : a->taille_bloc;
+        bloc = malloc(sizeof(BlocArene) + utilisable);
+        if (!bloc) return NULL;
+        bloc->taille = utilisable;
+        bloc->utilises = 0;
+        bloc->suivant = a->blocs;
+        a->blocs = bloc;
+        a->reserves += sizeof(BlocArene) + utilisable;
+    }
+    void *p = bloc->donnees + bloc->utilises;
+    bloc->utilises += taille;
+    return p;
+}
+
+static void liberer_arene(Allocateur *a, void *bloc, size_t taille, PhaseMemoire phase) {
+    (void)a;
+    (void)bloc;
+    (void)taille;
+    (void)phase;
+}
+
+//Fonction d'initialisation d'une arène
+//Parametre a : AllocateurArene
+//Parametre taille_bloc : taille minimale des blocs demandés à malloc
+void arene_initialiser(AllocateurArene *a, size_t taille_bloc) {
+    a->base = (Allocateur){allouer_arene, liberer_arene};
+    a->blocs = NULL;
+    a->taille_bloc = taille_bloc ? taille_bloc : 64 * 1024;
+    a->reserves = 0;
+}
+
+//Fonction rendant toutes les allocations d'une arène (le plus ancien bloc est gardé pour la suite)
+void arene_vider(AllocateurArene *a) {
+    BlocArene *bloc = a->blocs;
+    while (bloc && bloc->suivant) {
+        BlocArene *suivant = bloc->suivant;
+        a->reserves -= sizeof(BlocArene) + bloc->taille;
+        free(bloc);
+        bloc = suivant;
+    }
+    if (bloc) bloc->utilises = 0;
+    a->blocs = bloc;
+}
+
+//Fonction de libération d'une arène
+void arene_liberer(AllocateurArene *a) {
+    arene_vider(a);
+    free(a->blocs);
+    a->blocs = NULL;
+    a->reserves = 0;
+}
+
+
+// ----------------------
+/*
+Suivi
+*/
+// ----------------------
+
+static void compter_allocation(StatistiquesMemoire *s, size_t taille) {
+    s->vivants += taille;
+    s->allocations++;
+    if (s->vivants > s->pic) s->pic = s->vivants;
+}
+
+static void *allouer_suivi(Allocateur *base, size_t taille, PhaseMemoire phase) {
+    AllocateurSuivi *s = (AllocateurSuivi *)base;
+    void *bloc = NULL;
+    if (!s->budget || s->total.vivants + taille <= s->budget) {
+        bloc = s->parent->allouer(s->parent, taille, phase);
+    }
+    if (!bloc) {
+        s->total.refus++;
+        s->phases[phase].refus++;
+        return NULL;
+    }
+    compter_allocation(&s->total, taille);
+    compter_allocation(&s->phases[phase], taille);
+    return bloc;
+}
+
+static void liberer_suivi(Allocateur *base, void *bloc, size_t taille, PhaseMemoire phase) {
+    AllocateurSuivi *s = (AllocateurSuivi *)base;
+    s->parent->liberer(s->parent, bloc, taille, phase);
+    s->total.vivants -= taille;
+    s->total.liberations++;
+    s->phases[phase].vivants -= taille;
+    s->phases[phase].liberations++;
+}
+
+//Fonction d'initialisation d'un suivi
+//Parametre s : AllocateurSuivi
+//Parametre parent : allocateur qui fait les allocations (allocateur par défaut si NULL)
+//Parametre budget : nombre maximal d'octets vivants, 0 pour aucune limite
+void suivi_initialiser(AllocateurSuivi *s, Allocateur *parent, size_t budget) {
+    memset(s, 0, sizeof(*s));
+    s->base = (Allocateur){allouer_suivi, liberer_suivi};
+    s->parent = parent ? parent : &allocateur_defaut;
+    s->budget = budget;
+}
+
+//Nom d'une phase
+const char *nom_phase_memoire(PhaseMemoire phase) {
+    static const char *noms[NB_PHASES_MEMOIRE] = {
+        [PHASE_AUTRE] = "autre", [PHASE_LEXICALE] = "lexicale", [PHASE_SYNTAXIQUE] = "syntaxique",
+        [PHASE_SEMANTIQUE] = "sémantique", [PHASE_COMPILATION] = "compilation", [PHASE_EXECUTION] = "exécution"
+    };
+    return (phase >= 0 && phase < NB_PHASES_MEMOIRE) ? noms[phase] : "?";
+}
+
+//Fonction d'affichage des statistiques d'un suivi (phases sans allocation omises)
+void afficher_suivi(const AllocateurSuivi *s, FILE *sortie) {
+    fprintf(sortie, "  %-12s %10s %10s %12s %12s %6s\n", "phase", "vivants", "pic", "allocations", "libérations",
+            "refus");
+    for (int p = 0; p <= NB_PHASES_MEMOIRE; p++) {
+        const StatistiquesMemoire *st = p < NB_PHASES_MEMOIRE ? &s->phases[p] : &s->total;
+        if (p < NB_PHASES_MEMOIRE && st->allocations == 0 && st->refus == 0) continue;
+        fprintf(sortie, "  %-12s %10zu %10zu %12ld %12ld %6ld\n",
+                p < NB_PHASES_MEMOIRE ? nom_phase_memoire((PhaseMemoire)p) : "total", st->vivants, st->pic,
+                st->allocations, st->liberations, st->refus);
+    }
+}
+
+
+// ----------------------
+/*
+Allocateur courant et allocations des modules
+*/
+// ----------------------
+
+//Fonction choisissant l'allocateur courant du thread
+//Parametre a : Allocateur, NULL pour l'allocateur par défaut
+//Retourne l'allocateur précédent
+Allocateur *utiliser_allocateur(Allocateur *a) {
+    Allocateur *precedent = allocateur_courant();
+    allocateur_actuel = a;
+    return precedent;
+}
+
+//Retourne l'allocateur courant du thread
+Allocateur *allocateur_courant(void) {
+    return allocateur_actuel ? allocateur_actuel : &allocateur_defaut;
+}
+
+//Fonction choisissant la phase à laquelle les allocations du thread sont attribuées
+//Retourne la phase précédente
+PhaseMemoire definir_phase_memoire(PhaseMemoire phase) {
+    PhaseMemoire precedente = phase_actuelle;
+    phase_actuelle = phase;
+    return precedente;
+}
+
+//Fonction d'allocation par un allocateur donné
+//Retourne le bloc, ou NULL en cas d'échec
+void *allouer_avec(Allocateur *a, size_t taille) {
+    if (taille > (SIZE_MAX >> 4) - TAILLE_ENTETE_BLOC) return NULL;
+    size_t total = TAILLE_ENTETE_BLOC + taille;
+    EnteteBloc *entete = a->allouer(a, total, phase_actuelle);
+    if (!entete) return NULL;
+    entete->proprietaire = a;
+    entete->taille_phase = total << 4 | (size_t)phase_actuelle;
+    return entete + 1;
+}
+
+//Fonction de duplication d'une chaine par un allocateur donné
+char *dupliquer_avec(Allocateur *a, const char *chaine) {
+    size_t n = strlen(chaine) + 1;
+    char *copie = allouer_avec(a, n);
+    if (copie) memcpy(copie, chaine, n);
+    return copie;
+}
+
+void *mem_allouer(size_t taille) {
+    return allouer_avec(allocateur_courant(), taille);
+}
+
+void *mem_callouer(size_t nombre, size_t taille) {
+    if (taille && nombre > SIZE_MAX / taille) return NULL;
+    void *p = mem_allouer(nombre * taille);
+    if (p) memset(p, 0, nombre * taille);
+    return p;
+}
+
+char *mem_dupliquer(const char *chaine) {
+    return dupliquer_avec(allocateur_courant(), chaine);
+}
+
+//Fonction de libération d'un bloc (rendu à l'allocateur qui l'a fourni)
+//Parametre p : bloc obtenu par la couche d'allocation (peut être NULL)
+void mem_liberer(void *p) {
+    if (!p) return;
+    EnteteBloc *entete = (EnteteBloc *)p - 1;
+    entete->proprietaire->liberer(entete->proprietaire, entete, entete->taille_phase >> 4,
+                                  (PhaseMemoire)(entete->taille_phase & 0xF));
+}
+
+//Fonction de réallocation : le nouveau bloc vient du même allocateur que l'ancien
+//Retourne le nouveau bloc, ou NULL en cas d'échec (l'ancien bloc est alors intact)
+void *mem_reallouer(void *p, size_t taille) {
+    if (!p) return mem_allouer(taille);
+    EnteteBloc *entete = (EnteteBloc *)p - 1;
+    size_t ancienne = (entete->taille_phase >> 4) - TAILLE_ENTETE_BLOC;
+    void *nouveau = allouer_avec(entete->proprietaire, taille);
+    if (!nouveau) return NULL;
+    memcpy(nouveau, p, ancienne < taille ? ancienne : taille);
+    mem_liberer(p);
+    return nouveau;
+}
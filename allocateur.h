@@ -0,0 +1,92 @@
+#ifndef ALLOCATEUR_H
+#define ALLOCATEUR_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+//Couche d'allocation : les modules allouent par mem_allouer, mem_dupliquer... qui passent par
+//l'allocateur courant du thread (allocateur par défaut si aucun n'est choisi). Un appelant
+//choisit l'allocateur d'une requête avec utiliser_allocateur, sans changer les signatures des
+//fonctions appelées :
+//  - allocateur par défaut : malloc et free ;
+//  - arène : allocations contiguës dans de grands blocs, libérées toutes ensemble ;
+//  - suivi : compte les octets vivants, le pic et les allocations par phase (lexicale,
+//    syntaxique...), et refuse toute allocation au-delà d'un budget (NULL, donc ERR_MEMOIRE pour
+//    l'appelant, au lieu d'un arrêt du programme).
+//Chaque bloc retient son allocateur : mem_liberer rend le bloc à l'allocateur qui l'a fourni,
+//même si l'allocateur courant a changé entre temps.
+//Un allocateur d'arène ou de suivi ne doit servir qu'à un thread à la fois.
+
+//Phases auxquelles les allocations sont attribuées
+typedef enum {
+    PHASE_AUTRE,
+    PHASE_LEXICALE,
+    PHASE_SYNTAXIQUE,
+    PHASE_SEMANTIQUE,
+    PHASE_COMPILATION,
+    PHASE_EXECUTION,
+    NB_PHASES_MEMOIRE
+} PhaseMemoire;
+
+//Interface d'un allocateur : taille comprend l'entête du bloc
+typedef struct Allocateur {
+    void* (*allouer)(struct Allocateur* a, size_t taille, PhaseMemoire phase);
+    void (*liberer)(struct Allocateur* a, void* bloc, size_t taille, PhaseMemoire phase);
+} Allocateur;
+
+typedef struct {
+    size_t vivants;             //Octets alloués et pas encore libérés
+    size_t pic;                 //Maximum de vivants
+    long allocations;
+    long liberations;
+    long refus;                 //Allocations refusées (budget dépassé ou mémoire épuisée)
+} StatistiquesMemoire;
+
+//Arène : les blocs ne sont rendus qu'à arene_vider ou arene_liberer
+typedef struct BlocArene BlocArene;
+typedef struct {
+    Allocateur base;
+    BlocArene* blocs;
+    size_t taille_bloc;
+    size_t reserves;            //Octets obtenus de malloc
+} AllocateurArene;
+
+//Suivi : chaque allocation est faite par parent
+typedef struct {
+    Allocateur base;
+    Allocateur* parent;
+    size_t budget;              //0 : pas de limite
+    StatistiquesMemoire total;
+    StatistiquesMemoire phases[NB_PHASES_MEMOIRE];
+} AllocateurSuivi;
+
+//Allocateur par défaut (malloc, free)
+Allocateur* allocateur_par_defaut(void);
+
+//Arène de blocs d'au moins taille_bloc octets
+void arene_initialiser(AllocateurArene* a, size_t taille_bloc);
+void arene_vider(AllocateurArene* a);           //Toutes les allocations sont libérées, le premier bloc est gardé
+void arene_liberer(AllocateurArene* a);
+
+//Suivi des allocations faites par parent (allocateur par défaut si NULL), budget en octets (0 : aucun)
+void suivi_initialiser(AllocateurSuivi* s, Allocateur* parent, size_t budget);
+void afficher_suivi(const AllocateurSuivi* s, FILE* sortie);
+const char* nom_phase_memoire(PhaseMemoire phase);
+
+//Allocateur et phase courants du thread. Retournent la valeur précédente, à rétablir après usage
+Allocateur* utiliser_allocateur(Allocateur* a);  //NULL : allocateur par défaut
+Allocateur* allocateur_courant(void);
+PhaseMemoire definir_phase_memoire(PhaseMemoire phase);
+
+//Allocations par l'allocateur courant (NULL en cas d'échec ou de budget dépassé)
+void* mem_allouer(size_t taille);
+void* mem_callouer(size_t nombre, size_t taille);
+void* mem_reallouer(void* p, size_t taille);
+char* mem_dupliquer(const char* chaine);
+void mem_liberer(void* p);
+
+//Allocations par un allocateur donné (les blocs sont aussi libérés par mem_liberer)
+void* allouer_avec(Allocateur* a, size_t taille);
+char* dupliquer_avec(Allocateur* a, const char* chaine);
+
+#endif
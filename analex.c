@@ -1,139 +1,259 @@
 #include <stdio.h>
 #include <stdlib.h>
 //Fonctions pour l'allocation et la libération de mémoire dynamique
-//(malloc, free), ainsi que d'autres fonctionnalités générales telles que
-//exit pour terminer le programme.
+//(malloc, free), ainsi que d'autres fonctionnalités générales.
 
 #include <string.h>
 //Offre des fonctions pour manipuler les chaînes de caractères, comme
 //strlen pour obtenir la longueur d'une chaîne, strncmp pour comparer les chaînes
 //strdup pour dupliquer une chaîne.
 
-#include <ctype.h>
-//Cette librairie contient des fonctions pour vérifier le type de 
-//caractère, comme islower pour déterminer si un caractère est une lettre
-//minuscule et isdigit pour vérifier si un caractère est un chiffre.
-
 #include "analex.h"
-//Pour déclarer CreationListeLexeme
+//Pour déclarer CreationListeLexeme et les fonctions de balayage
+
+#include "operateurs.h"
+//Pour reconnaître les symboles des opérateurs logiques
+
+#include "allocateur.h"
+//Pour allouer les lexèmes par l'allocateur courant (mem_allouer, mem_liberer)
 
 
 //taille fini pour le nombre de lexemes
 #define MAX_LEXEMES 100
 
-//sequences UTF-8 pour les opérateurs logiques
-#define ET_LOGIQUE "\xE2\x88\xA7"           //(U+2227)
-#define OU_LOGIQUE "\xE2\x88\xA8"           //(U+2228)
-#define NON_LOGIQUE "\xC2\xAC"              //(U+00AC)
-#define PRODUIT "\xE2\x86\x92"              //(U+2192)
-#define IMPLICATION_DOUBLE "\xE2\x87\x92"   //(U+21D2)
+//Les séquences UTF-8 des opérateurs logiques sont dans la table de operateurs.h
+
 
-//Fonction pour comparer une sous chaine avec une sequence UTF-8
-//Parametre chaine : chaine de caracteres
-//Parametre pos : entier
-//Parametre seq : chaine de caracteres
-//La fonction retourne 1 si la sous-chaîne de chaine à partir de la position pos correspond à la séquence seq.
-//retourne 0 si la sous-chaîne ne correspond pas à la séquence seq
-int match_sequence(const char* chaine, int pos, const char* seq) {
-    return strncmp(&chaine[pos], seq, strlen(seq)) == 0;
+// ----------------------
+/*
+Balayage vectorisé :
+   Les fonctions suivantes classent 16 octets (SSE2) ou 32 octets (AVX2) à la fois pour sauter
+   les suites d'espaces et trouver la fin des identifiants [a-z][a-z0-9]*.
+   Les classes de caractères sont celles de isspace/islower/isdigit pour les octets ASCII ;
+   les octets >= 0x80 n'appartiennent à aucune classe, comme avec glibc en locale UTF-8.
+   Les versions scalaires servent pour la fin de chaine et sur les machines sans SIMD.
+*/
+// ----------------------
+
+//Retourne 1 si c est un espace ASCII (' ', '\t', '\n', '\v', '\f', '\r')
+static int est_espace(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
 }
 
-//Fonction creant la liste des lexèmes
-//Parametre chaine: une chaine de caracteres
-//retourne une liste de chaines de caracteres
-char** CreationListeLexeme(const char* chaine) {
-    //allouer dynamiquement la liste des lexemes
-    char** ListeLexeme = malloc(MAX_LEXEMES * sizeof(char*));
-    if (!ListeLexeme) {
-        perror("echec de l'allocation memoire");
-        exit(EXIT_FAILURE);
+//Retourne 1 si c peut faire partie d'un identifiant de proposition (lettre minuscule ou chiffre)
+static int est_identifiant(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+}
+
+//Version scalaire : retourne le premier indice >= i qui n'est pas un espace (au plus n)
+int avancer_espaces_scalaire(const char* chaine, int i, int n) {
+    while (i < n && est_espace((unsigned char)chaine[i])) {
+        i++;
+    }
+    return i;
+}
+
+//Version scalaire : retourne le premier indice >= i qui n'est pas un caractère d'identifiant (au plus n)
+int avancer_identifiant_scalaire(const char* chaine, int i, int n) {
+    while (i < n && est_identifiant((unsigned char)chaine[i])) {
+        i++;
+    }
+    return i;
+}
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+//Masque des octets de v compris entre lo et hi (comparaison non signée ramenée à une comparaison signée)
+static __m128i octets_entre_16(__m128i v, char lo, char hi) {
+    __m128i decale = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - (unsigned char)lo)));
+    return _mm_cmplt_epi8(decale, _mm_set1_epi8((char)(0x80 + (unsigned char)(hi - lo) + 1)));
+}
+
+static __m128i classe_espaces_16(__m128i v) {
+    return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), octets_entre_16(v, '\t', '\r'));
+}
+
+static __m128i classe_identifiant_16(__m128i v) {
+    return _mm_or_si128(octets_entre_16(v, 'a', 'z'), octets_entre_16(v, '0', '9'));
+}
+
+#define AVANCER_SSE2(nom, classe)                                               \
+static int nom(const char* chaine, int i, int n) {                              \
+    while (i + 16 <= n) {                                                       \
+        __m128i v = _mm_loadu_si128((const __m128i*)&chaine[i]);                \
+        unsigned masque = ~(unsigned)_mm_movemask_epi8(classe(v)) & 0xFFFFu;    \
+        if (masque) return i + __builtin_ctz(masque);                           \
+        i += 16;                                                                \
+    }                                                                           \
+    return i;                                                                   \
+}
+
+AVANCER_SSE2(avancer_espaces_sse2, classe_espaces_16)
+AVANCER_SSE2(avancer_identifiant_sse2, classe_identifiant_16)
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define AVEC_AVX2 1
+
+//Les fonctions AVX2 sont compilées pour la cible avx2 uniquement, et choisies à l'exécution
+//si le processeur le permet : il n'est donc pas nécessaire de compiler avec -mavx2.
+__attribute__((target("avx2")))
+static __m256i octets_entre_32(__m256i v, char lo, char hi) {
+    __m256i decale = _mm256_add_epi8(v, _mm256_set1_epi8((char)(0x80 - (unsigned char)lo)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(0x80 + (unsigned char)(hi - lo) + 1)), decale);
+}
+
+__attribute__((target("avx2")))
+static __m256i classe_espaces_32(__m256i v) {
+    return _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), octets_entre_32(v, '\t', '\r'));
+}
+
+__attribute__((target("avx2")))
+static __m256i classe_identifiant_32(__m256i v) {
+    return _mm256_or_si256(octets_entre_32(v, 'a', 'z'), octets_entre_32(v, '0', '9'));
+}
+
+#define AVANCER_AVX2(nom, classe, suite)                                        \
+__attribute__((target("avx2")))                                                 \
+static int nom(const char* chaine, int i, int n) {                              \
+    while (i + 32 <= n) {                                                       \
+        __m256i v = _mm256_loadu_si256((const __m256i*)&chaine[i]);             \
+        unsigned masque = ~(unsigned)_mm256_movemask_epi8(classe(v));           \
+        if (masque) return i + __builtin_ctz(masque);                           \
+        i += 32;                                                                \
+    }                                                                           \
+    return suite(chaine, i, n);                                                 \
+}
+
+AVANCER_AVX2(avancer_espaces_avx2, classe_espaces_32, avancer_espaces_sse2)
+AVANCER_AVX2(avancer_identifiant_avx2, classe_identifiant_32, avancer_identifiant_sse2)
+#endif
+
+//Retourne 1 si le processeur supporte AVX2
+//(pas de cache statique : la lecture est peu coûteuse et reste sûre entre threads)
+static int utiliser_avx2(void) {
+#ifdef AVEC_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+#endif
+
+//Retourne le premier indice >= i qui n'est pas un espace (au plus n)
+int avancer_espaces(const char* chaine, int i, int n) {
+#if defined(__SSE2__)
+#ifdef AVEC_AVX2
+    if (utiliser_avx2()) {
+        i = avancer_espaces_avx2(chaine, i, n);
+    } else
+#endif
+    i = avancer_espaces_sse2(chaine, i, n);
+#endif
+    return avancer_espaces_scalaire(chaine, i, n);
+}
+
+//Retourne le premier indice >= i qui n'est pas un caractère d'identifiant (au plus n)
+int avancer_identifiant(const char* chaine, int i, int n) {
+#if defined(__SSE2__)
+#ifdef AVEC_AVX2
+    if (utiliser_avx2()) {
+        i = avancer_identifiant_avx2(chaine, i, n);
+    } else
+#endif
+    i = avancer_identifiant_sse2(chaine, i, n);
+#endif
+    return avancer_identifiant_scalaire(chaine, i, n);
+}
+
+//Fonction pour libérer une liste de lexèmes (terminée par NULL)
+//Parametre ListeLexeme : liste de chaines de caracteres (peut être NULL)
+void liberer_lexemes(char** ListeLexeme) {
+    if (!ListeLexeme) return;
+    for (int j = 0; ListeLexeme[j] != NULL; j++) {
+        mem_liberer(ListeLexeme[j]);
     }
+    mem_liberer(ListeLexeme);
+}
+
+//Corps de CreationListeLexeme
+static char** creer_liste_lexemes(const char* chaine, Statut* statut) {
+    statut_ok(statut);
 
     int n = strlen(chaine);
     int i = 0;
     int lex_idx = 0;
 
     if (n == 0) {
-        perror("Chaine vide");
-        exit(EXIT_FAILURE);
+        statut_definir(statut, ERR_CHAINE_VIDE, 0, "Chaine vide");
+        return NULL;
+    }
+
+    //allouer dynamiquement la liste des lexemes (calloc : la liste reste terminée par NULL à tout moment)
+    char** ListeLexeme = mem_callouer(MAX_LEXEMES, sizeof(char*));
+    if (!ListeLexeme) {
+        statut_definir(statut, ERR_MEMOIRE, 0, "Echec de l'allocation memoire");
+        return NULL;
     }
 
     while (i < n) {
-        //on verifie en premier les sequences UTF-8
-        if (match_sequence(chaine, i, ET_LOGIQUE)) {
-            ListeLexeme[lex_idx++] = strdup("Op(ET)");
-            i += strlen(ET_LOGIQUE);
+        unsigned char c = (unsigned char)chaine[i];
+        const Operateur* op;
+        int debut = i;
+        char* lexeme = NULL;
+
+        //on verifie si la liste des lexemes a atteint sa capacité maximale
+        if (lex_idx >= MAX_LEXEMES - 1 && !est_espace(c)) {
+            statut_definir(statut, ERR_TROP_DE_LEXEMES, i, "Nombre maximal de lexemes atteint");
+            liberer_lexemes(ListeLexeme);
+            return NULL;
+        }
+
+        //on verifie en premier les sequences UTF-8 des opérateurs, reconnues par leur octet de tête
+        if (c >= 0x80 && (op = operateur_symbole(chaine, i, n)) != NULL) {
+            lexeme = mem_dupliquer(op->lexeme);
+            i += op->longueur;
         }
-        else if (match_sequence(chaine, i, OU_LOGIQUE)) {
-            ListeLexeme[lex_idx++] = strdup("Op(OU)");
-            i += strlen(OU_LOGIQUE);
+        else if (c == '(') { //Parenthèse ouvrante
+            lexeme = mem_dupliquer("PO");
+            i++;
         }
-        else if (match_sequence(chaine, i, NON_LOGIQUE)) {
-            ListeLexeme[lex_idx++] = strdup("Op(NON)");
-            i += strlen(NON_LOGIQUE);
+        else if (c == ')') { //Parenthèse fermante
+            lexeme = mem_dupliquer("PF");
+            i++;
         }
-        else if (match_sequence(chaine, i, IMPLICATION_DOUBLE)) {
-            ListeLexeme[lex_idx++] = strdup("Op(IMPLIQUE)");
-            i += strlen(IMPLICATION_DOUBLE);
+        else if (c >= 'a' && c <= 'z') { //Pour une lettre minuscule
+            //On avance l'index pour capturer la proposition complete (lettre + chiffres eventuels)
+            i = avancer_identifiant(chaine, i, n);
+            int len = i - debut;
+            //On alloue suffisamment de memoire pour "Prop(" + identifiant + ")" + '\0'
+            lexeme = mem_allouer(6 + len + 1);
+            if (lexeme) {
+                memcpy(lexeme, "Prop(", 5);
+                memcpy(lexeme + 5, &chaine[debut], len);
+                lexeme[5 + len] = ')';
+                lexeme[6 + len] = '\0';
+            }
         }
-        else if (match_sequence(chaine, i, PRODUIT)) {
-            ListeLexeme[lex_idx++] = strdup("Op(PRODUIT)");
-            i += strlen(PRODUIT);
+        else if (est_espace(c)) {
+            //Ignorer les espaces (toute la suite d'un coup)
+            i = avancer_espaces(chaine, i, n);
+            continue;
         }
         else {
-            switch (chaine[i]) {
-                case '(': //Parenthèse ouvrante
-                    ListeLexeme[lex_idx++] = strdup("PO");
-                    i++;
-                    break;
-                case ')': //Parenthèse fermante
-                    ListeLexeme[lex_idx++] = strdup("PF");
-                    i++;
-                    break;
-                default:
-                    if (islower((unsigned char)chaine[i])) { //Pour une lettre minuscule
-                        int start = i;
-                        //On avance l'index pour capturer la proposition complete (lettre + chiffres eventuels)
-                        while (i < n && (islower((unsigned char)chaine[i]) || isdigit((unsigned char)chaine[i]))) {
-                            i++;
-                        }
-                        int len = i - start;
-                        //On alloue suffisamment de memoire pour "Prop(" + identifiant + ")" + '\0'
-                        char* res = malloc(6 + len + 1); // "Prop(" + identifiant + ")" + '\0'
-                        if (!res) {
-                            perror("Échec de l'allocation mémoire");
-                            //On libere la mémoire allouee avant de quitter
-                            for (int j = 0; j < lex_idx; j++) {
-                                free(ListeLexeme[j]);
-                            }
-                            free(ListeLexeme);
-                            exit(EXIT_FAILURE);
-                        }
-                        snprintf(res, 6 + len + 1, "Prop(%.*s)", len, &chaine[start]);
-                        ListeLexeme[lex_idx++] = res;
-                    }
-                    else if (isspace((unsigned char)chaine[i])) {
-                        //Ignorer les espaces
-                        i++;
-                    }
-                    else {
-                        fprintf(stderr, "Lexeme invalide dans la chaine: '%c'\n", chaine[i]);
-                        //Liberer la memoire allouee avant de quitter
-                        for (int j = 0; j < lex_idx; j++) {
-                            free(ListeLexeme[j]);
-                        }
-                        free(ListeLexeme);
-                        exit(EXIT_FAILURE);
-                    }
-                    break;
-            }
+            //Liberer la memoire allouee avant de signaler l'erreur
+            statut_definir(statut, ERR_LEXEME_INVALIDE, i, "Lexeme invalide dans la chaine");
+            liberer_lexemes(ListeLexeme);
+            return NULL;
         }
 
-        //on verifie si la liste des lexemes a atteint sa capacité maximale
-        if (lex_idx >= MAX_LEXEMES - 1) {
-            fprintf(stderr, "Nombre maximal de lexemes atteint\n");
-            break;
+        if (!lexeme) {
+            statut_definir(statut, ERR_MEMOIRE, debut, "Echec de l'allocation memoire");
+            liberer_lexemes(ListeLexeme);
+            return NULL;
         }
+        ListeLexeme[lex_idx++] = lexeme;
     }
 
     ListeLexeme[lex_idx] = NULL; //terminer la liste des lexemes avec NULL
@@ -141,4 +261,14 @@ char** CreationListeLexeme(const char* chaine) {
     return ListeLexeme;
 }
 
-
+//Fonction creant la liste des lexèmes
+//Parametre chaine: une chaine de caracteres
+//Parametre statut: Statut, rempli en cas d'erreur avec la position (octet) du problème (peut être NULL)
+//retourne une liste de chaines de caracteres, ou NULL en cas d'erreur (la mémoire déjà allouée est libérée)
+//Les allocations sont attribuées à la phase lexicale
+char** CreationListeLexeme(const char* chaine, Statut* statut) {
+    PhaseMemoire phase = definir_phase_memoire(PHASE_LEXICALE);
+    char** lexemes = creer_liste_lexemes(chaine, statut);
+    definir_phase_memoire(phase);
+    return lexemes;
+}
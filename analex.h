@@ -1,8 +1,18 @@
 #ifndef ANALEX_H
 #define ANALEX_H
 
-//Fonction générant la liste de lexemes
-char** CreationListeLexeme(const char* input);
+#include "erreurs.h"
+
+//Fonction générant la liste de lexemes (NULL en cas d'erreur, détaillée dans statut)
+char** CreationListeLexeme(const char* input, Statut* statut);
+
+//Fonction libérant une liste de lexemes
+void liberer_lexemes(char** lexemes);
+
+//Fonctions de balayage (vectorisées si possible) : retournent le premier indice >= i,
+//au plus n, qui n'est pas un espace / pas un caractère d'identifiant [a-z0-9]
+int avancer_espaces(const char* chaine, int i, int n);
+int avancer_identifiant(const char* chaine, int i, int n);
 
 #endif
 
@@ -2,7 +2,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//Pour projeter l'image du vocabulaire en mémoire (mmap)
+
 #include "anasem.h"
+#include "vocabulaire.h" //Pour le format de l'image et la fonction de hachage
+#include "operateurs.h"  //Pour l'arité des opérateurs
+#include "allocateur.h"  //Pour libérer les noeuds et les noms des propositions
 
 
 //On initialise une liste des propositions valides avec une taille maximale
@@ -10,30 +19,165 @@
 char* valid_props[MAX_PROPS];
 int prop_count = 0;
 
+//Vocabulaire chargé depuis une image (nb_mots = 0 si aucun) : ses noms ont les indices [0, nb_mots),
+//ceux de la liste ci-dessus viennent ensuite
+typedef struct {
+    const void *image;
+    size_t taille;
+    const EnteteVocabulaire *entete;
+    const uint32_t *deplacements;
+    const uint32_t *debut_noms;
+    const char *noms;
+    uint32_t nb_mots;
+} Vocabulaire;
+Vocabulaire vocabulaire = {NULL, 0, NULL, NULL, NULL, NULL, 0};
+
 //Fonction permettant d'ajouter une proposition valide à liste des propositions valides
 //Parametre prop : chaine de caracteres
 //Ajoute une proposition valide dans la liste de propositions valides s'il y a assez de place
-void add_valid_prop(const char *prop) {
+//Retourne ERR_AUCUNE, ERR_TABLE_PLEINE si le nombre max de propositions est atteint, ERR_MEMOIRE sinon
+int add_valid_prop(const char *prop) {
     //Verifier si le nombre max de propositions est atteint
     if (prop_count >= MAX_PROPS) {
-        fprintf(stderr, "Erreur: Trop de propositions valides.\n");
-        exit(EXIT_FAILURE);
+        return ERR_TABLE_PLEINE;
+    }
+    //La table est commune à tout le processus : elle ne dépend pas de l'allocateur d'une requête
+    char *copie = dupliquer_avec(allocateur_par_defaut(), prop);
+    if (!copie) {
+        return ERR_MEMOIRE;
     }
-    valid_props[prop_count++] = strdup(prop);
+    valid_props[prop_count++] = copie;
+    return ERR_AUCUNE;
 }
 
 //Fonction pour vérifier si une proposition est valide
 //Parametre prop : une chaine de caracteres 
 //Retourne 1 si la proposition est valide et 0 sinon
 int is_valid_prop(const char *prop) {
+    return indice_prop(prop) >= 0;
+}
+
+//Fonction pour retrouver l'indice d'une proposition valide
+//Parametre prop : une chaine de caracteres
+//Retourne l'indice de la proposition dans la liste des propositions valides, -1 si elle n'y est pas
+//C'est cet indice qui sert d'opérande à l'instruction VM_LOAD de la machine virtuelle
+int indice_prop(const char *prop) {
+    return indice_prop_longueur(prop, strlen(prop));
+}
+
+//Fonction pour retrouver l'indice d'une proposition donnée par ses n premiers caractères
+//(pour chercher un nom directement dans la chaine analysée, sans le copier)
+//Parametre prop : une chaine de caracteres
+//Parametre n : longueur du nom
+//Retourne l'indice de la proposition, -1 si elle n'est pas valide
+int indice_prop_longueur(const char *prop, size_t n) {
+    if (vocabulaire.nb_mots > 0) {
+        //Une seule comparaison : le hachage parfait ne laisse qu'un emplacement possible
+        uint64_t h = hacher_vocabulaire(prop, n, vocabulaire.entete->graine);
+        const uint32_t *d = &vocabulaire.deplacements[2 * seau_vocabulaire(h, vocabulaire.entete->nb_seaux)];
+        uint32_t e = emplacement_vocabulaire(h, d[0], d[1], vocabulaire.nb_mots);
+        uint32_t debut = vocabulaire.debut_noms[e], fin = vocabulaire.debut_noms[e + 1];
+        //Les bornes sont vérifiées ici plutôt qu'au chargement, pour que celui-ci ne lise pas toute la table
+        if (debut < fin && fin <= vocabulaire.entete->taille_noms && fin - debut == n + 1 &&
+            memcmp(vocabulaire.noms + debut, prop, n) == 0) {
+            return (int)e;
+        }
+    }
     for (int i = 0; i < prop_count; i++) {
-        if (strcmp(valid_props[i], prop) == 0) {
-            return 1;
+        if (strncmp(valid_props[i], prop, n) == 0 && valid_props[i][n] == '\0') {
+            return (int)vocabulaire.nb_mots + i;
         }
     }
+    return -1;
+}
+
+//Fonction pour retrouver le nom d'une proposition valide
+//Parametre indice : entier
+//Retourne le nom de la proposition, NULL si l'indice ne correspond à aucune proposition valide
+const char* nom_prop(int indice) {
+    if (indice >= 0 && (uint32_t)indice < vocabulaire.nb_mots) {
+        uint32_t debut = vocabulaire.debut_noms[indice];
+        return debut < vocabulaire.entete->taille_noms ? vocabulaire.noms + debut : NULL;
+    }
+    indice -= (int)vocabulaire.nb_mots;
+    if (indice < 0 || indice >= prop_count) {
+        return NULL;
+    }
+    return valid_props[indice];
+}
+
+//Fonction chargeant un vocabulaire de propositions depuis une image construite par construire_vocabulaire
+//L'image est projetée en mémoire telle quelle : le chargement ne lit que l'entête, quel que soit
+//le nombre de noms, et les pages sont partagées entre les processus qui chargent la même image
+//Parametre chemin : fichier de l'image
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 si l'image est illisible ou incohérente (le vocabulaire précédent est alors conservé)
+int charger_vocabulaire(const char *chemin, Statut *statut) {
+    statut_ok(statut);
+    int fd = open(chemin, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) close(fd);
+        statut_definir(statut, ERR_FICHIER, -1, "Image du vocabulaire illisible");
+        return -1;
+    }
+    size_t taille = (size_t)st.st_size;
+    if (taille < sizeof(EnteteVocabulaire)) {
+        close(fd);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Image du vocabulaire tronquée");
+        return -1;
+    }
+    const void *image = mmap(NULL, taille, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Projection de l'image du vocabulaire impossible");
+        return -1;
+    }
+
+    //Vérification de la cohérence des tailles : les recherches ne vérifient plus rien ensuite
+    const EnteteVocabulaire *entete = image;
+    uint64_t taille_tables = 2 * (uint64_t)entete->nb_seaux * sizeof(uint32_t) +
+                             ((uint64_t)entete->nb_mots + 1) * sizeof(uint32_t);
+    const uint32_t *deplacements = (const uint32_t *)(entete + 1);
+    const uint32_t *debut_noms = deplacements + 2 * (size_t)entete->nb_seaux;
+    //Chaque taille est bornée avant la somme, qui ne peut donc pas reboucler
+    int valide = memcmp(entete->magie, MAGIE_VOCABULAIRE, 8) == 0 &&
+                 entete->nb_seaux > 0 && entete->nb_mots <= INT32_MAX &&
+                 entete->taille_totale == taille &&
+                 entete->taille_noms <= taille && taille_tables <= taille - sizeof(EnteteVocabulaire) &&
+                 sizeof(EnteteVocabulaire) + taille_tables + entete->taille_noms == taille &&
+                 debut_noms[0] == 0 && debut_noms[entete->nb_mots] == entete->taille_noms &&
+                 (entete->taille_noms == 0 || ((const char *)image)[taille - 1] == '\0');
+    if (!valide) {
+        munmap((void *)image, taille);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Image du vocabulaire invalide");
+        return -1;
+    }
+
+    fermer_vocabulaire();
+    vocabulaire.image = image;
+    vocabulaire.taille = taille;
+    vocabulaire.entete = entete;
+    vocabulaire.deplacements = deplacements;
+    vocabulaire.debut_noms = debut_noms;
+    vocabulaire.noms = (const char *)(debut_noms + entete->nb_mots + 1);
+    vocabulaire.nb_mots = entete->nb_mots;
     return 0;
 }
 
+//Fonction fermant le vocabulaire chargé (les noms de la liste retrouvent les indices [0, prop_count))
+void fermer_vocabulaire(void) {
+    if (vocabulaire.image) {
+        munmap((void *)vocabulaire.image, vocabulaire.taille);
+    }
+    memset(&vocabulaire, 0, sizeof(vocabulaire));
+}
+
+//Fonction donnant le nombre de propositions valides (vocabulaire et liste)
+int nombre_props(void) {
+    return (int)vocabulaire.nb_mots + prop_count;
+}
+
 //Fonction pour initialiser les propositions valides
 //Ajoute à la liste des propositions valides les propositions considérées comme valides
 void initialize_valid_props() {
@@ -46,55 +190,59 @@ void initialize_valid_props() {
 //Libère la mémoire de chaque proposition
 void free_valid_props_memory() {
     for (int i = 0; i < prop_count; i++) {
-        free(valid_props[i]);
+        mem_liberer(valid_props[i]);
     }
     prop_count = 0;
 }
 
+//Message d'une proposition invalide, avec son nom (un message par thread, valable jusqu'à l'erreur suivante)
+static _Thread_local char message_prop_invalide[128];
+
 //Fonction globale permettant de réaliser l'analyse sémantique
 //Parametre node : ASTNode (arbre syntaxique)
-void analyseur_semantique(ASTNode *node) {
+//Parametre statut : Statut, rempli avec la première erreur rencontrée et l'indice du lexème du noeud
+//fautif (position du noeud, -1 s'il n'a pas été créé par l'analyse syntaxique) (peut être NULL)
+//Retourne 0 si l'arbre est correct, -1 sinon
+int analyseur_semantique(ASTNode *node, Statut *statut) {
     //Si le noeud est vide
-    if (node == NULL) return;
+    if (node == NULL) return 0;
 
     //On effetue l'analyse sémantique sur les enfants avant de traiter le noeud courant
-    analyseur_semantique(node->left);
-    analyseur_semantique(node->right);
+    if (analyseur_semantique(node->left, statut) < 0) return -1;
+    if (analyseur_semantique(node->right, statut) < 0) return -1;
 
-    //Selon le type de noeud 
-    //Seuls Prop(""),Op("ET"),Op("OU"),Op("IMPLIQUE") et Op("PRODUIT") sont des noeuds
-    switch (node->type) {
-        case NODE_PROP:
+    //Selon le type de noeud (table des opérateurs de operateurs.h)
+    //Seuls Prop("") et les opérateurs de la table sont des noeuds
+    const Operateur *op = operateur_noeud(node->type);
+    if (!op) {
+        statut_definir(statut, ERR_NOEUD_INCONNU, node->position, "Type de noeud inconnu");
+        return -1;
+    }
+    switch (op->arite) {
+        case 0:
             //On vérifie si la proposition est valide
             if (!is_valid_prop(node->value)) {
-                fprintf(stderr, "Erreur sémantique: Proposition invalide '%s'.\n", node->value);
-                exit(EXIT_FAILURE);
-            }
-            break;
-        case NODE_AND:
-        case NODE_OR:
-        case NODE_IMP:
-        case NODE_PROD:
-            //On vérifie que les opérateurs ont des opérandes non vides
-            if (node->left == NULL || node->right == NULL) {
-                fprintf(stderr, "Erreur sémantique: L'opérateur '%s' doit avoir deux opérandes.\n",
-                        (node->type == NODE_AND) ? "AND" :
-                        (node->type == NODE_OR) ? "OR" :
-                        (node->type == NODE_IMP) ? "IMPLIQUE" : "PRODUIT");
-                exit(EXIT_FAILURE);
+                snprintf(message_prop_invalide, sizeof(message_prop_invalide), "Proposition invalide '%s'",
+                         node->value ? node->value : "");
+                statut_definir(statut, ERR_PROP_INVALIDE, node->position, message_prop_invalide);
+                return -1;
             }
             break;
-        case NODE_NOT:
+        case 1:
             //On vérifie que l'opérateur NOT a un opérande non vide
             if (node->right == NULL) {
-                fprintf(stderr, "Erreur sémantique: L'opérateur 'NOT' doit avoir un opérande.\n");
-                exit(EXIT_FAILURE);
+                statut_definir(statut, ERR_ARITE, node->position, "L'opérateur NOT doit avoir un opérande");
+                return -1;
             }
             break;
         default:
-            fprintf(stderr, "Erreur sémantique: Type de noeud inconnu.\n");
-            exit(EXIT_FAILURE);
+            //On vérifie que les opérateurs ont des opérandes non vides
+            if (node->left == NULL || node->right == NULL) {
+                statut_definir(statut, ERR_ARITE, node->position, "Un opérateur binaire doit avoir deux opérandes");
+                return -1;
+            }
     }
+    return 0;
 }
 
 //Fonction pour libérer la mémoire allouée à l'arbre syntaxique
@@ -103,6 +251,6 @@ void free_ast(ASTNode *node) {
     if (node == NULL) return;
     free_ast(node->left);
     free_ast(node->right);
-    if (node->value) free(node->value);
-    free(node);
+    if (node->value) mem_liberer(node->value);
+    mem_liberer(node);
 }
@@ -1,13 +1,27 @@
 #ifndef ANASEM_H
 #define ANASEM_H
 
+#include <stddef.h>
 #include "anasynt.h"
 
-//Analyse semantique
-void analyseur_semantique(ASTNode* ast);
+//Analyse semantique (0 si l'arbre est correct, -1 sinon avec l'erreur dans statut)
+int analyseur_semantique(ASTNode* ast, Statut* statut);
 
 //Initialisation des propositions considérées comme valides
 void initialize_valid_props(void);
+//Ajout d'une proposition valide (ERR_AUCUNE ou code d'erreur)
+int add_valid_prop(const char *prop);
+//Indice d'une proposition dans la liste des propositions valides (-1 si invalide)
+int indice_prop(const char *prop);
+int indice_prop_longueur(const char *prop, size_t n);
+//Nom de la proposition valide d'indice donné (NULL si l'indice est invalide)
+const char* nom_prop(int indice);
+//Nombre de propositions valides (indices [0, nombre_props()))
+int nombre_props(void);
+//Chargement d'un vocabulaire construit par construire_vocabulaire (voir vocabulaire.h) : ses noms
+//prennent les indices [0, nb_mots) et ceux de la liste sont décalés d'autant. Retourne 0 ou -1
+int charger_vocabulaire(const char *chemin, Statut *statut);
+void fermer_vocabulaire(void);
 //Libérer la memoire allouée par les propositions valides
 void free_valid_props_memory(void);
 
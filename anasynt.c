@@ -4,6 +4,8 @@
 #include <ctype.h>
 #include <locale.h>
 #include "anasynt.h"
+#include "operateurs.h" //pour la précédence et l'associativité des opérateurs
+#include "allocateur.h" //pour allouer les noeuds par l'allocateur courant
 
 
 //Structure utilisée pour encapsuler l'état du parseur lors de l'analyse syntaxique
@@ -11,29 +13,39 @@
 typedef struct {
     char **lexemes;         //lexèmes générés par l'analyse lexicale
     int current;            //indice du lexème en cours
+    Statut statut;          //première erreur rencontrée
 } ParserState;
 
-//Fonction pour afficher les erreurs de syntaxes
+//Fonction pour signaler les erreurs de syntaxes
+//Parametre state : ParserState
+//Parametre code : CodeErreur
 //Parametre msg : une chaine de caracteres
-//Parametre pos : un entier
-//On affiche un message d'erreur de syntaxe et la position de l'erreur et on quitte le programme
-void error(const char *msg, int pos) {
-    fprintf(stderr, "Erreur de syntaxe à la position %d: %s\n", pos, msg);
-    exit(EXIT_FAILURE);
+//On enregistre le message d'erreur et la position de l'erreur (la première erreur est conservée)
+//Retourne NULL, pour que les fonctions de parsing puissent écrire return error(...)
+ASTNode* error(ParserState *state, CodeErreur code, const char *msg) {
+    if (state->statut.code == ERR_AUCUNE) {
+        statut_definir(&state->statut, code, state->current, msg);
+    }
+    return NULL;
 }
 
 
 //Fonction de creation d'un noeud proposition
 //Parametre prop : chaine de caracteres
+//Retourne NULL si l'allocation échoue
 ASTNode* createPropNode(const char *prop) {
-    ASTNode *node = malloc(sizeof(ASTNode));
+    ASTNode *node = mem_allouer(sizeof(ASTNode));
     if (!node) {
-        perror("Erreur d'allocation mémoire");
-        exit(EXIT_FAILURE);
+        return NULL;
     }
     node->type = NODE_PROP;
-    node->value = strdup(prop); // On copie la valeur de la proposition
+    node->value = mem_dupliquer(prop); // On copie la valeur de la proposition
+    if (!node->value) {
+        mem_liberer(node);
+        return NULL;
+    }
     node->left = node->right = NULL; // Cela veut dire que qu'il n'y a pas d'enfants pour une proposition
+    node->position = -1;
     return node;
 }
 
@@ -41,16 +53,40 @@ ASTNode* createPropNode(const char *prop) {
 //Parametre type : NodeType
 //Parametre left : ASTNode (enfant gauche)
 //Parametre right: ASTNode (enfant droit)
+//Retourne NULL si l'allocation échoue (les enfants restent alors à la charge de l'appelant)
 ASTNode* createOpNode(NodeType type, ASTNode *left, ASTNode *right) {
-    ASTNode *node = malloc(sizeof(ASTNode));
+    ASTNode *node = mem_allouer(sizeof(ASTNode));
     if (!node) {
-        perror("Erreur d'allocation mémoire");
-        exit(EXIT_FAILURE);
+        return NULL;
     }
     node->type = type;
     node->value = NULL;
     node->left = left;  
     node->right = right; 
+    node->position = -1;
+    return node;
+}
+
+//Fonction créant un noeud opérateur pendant le parsing
+//Si un opérande manque (erreur déjà signalée) ou si l'allocation échoue, les opérandes sont libérés
+//Parametre state : ParserState
+//Parametre type : NodeType
+//Parametre left : ASTNode (NULL pour la négation)
+//Parametre right : ASTNode
+//Parametre position : entier, indice du lexème de l'opérateur
+//Retourne le noeud créé, ou NULL en cas d'erreur
+ASTNode* combiner(ParserState *state, NodeType type, ASTNode *left, ASTNode *right, int position) {
+    if (!right) {
+        freeAST(left);
+        return NULL;
+    }
+    ASTNode *node = createOpNode(type, left, right);
+    if (!node) {
+        freeAST(left);
+        freeAST(right);
+        return error(state, ERR_MEMOIRE, "Erreur d'allocation mémoire");
+    }
+    node->position = position;
     return node;
 }
 
@@ -72,77 +108,39 @@ Fonctions de Parsing :
 
 //on commence par référencer les fonctions de parsing :
 ASTNode* parse_expr(ParserState *state);
-ASTNode* parse_implication(ParserState *state);
-ASTNode* parse_or_expr(ParserState *state);
-ASTNode* parse_and_expr(ParserState *state);
+ASTNode* parse_binaire(ParserState *state, int precedence_min);
 ASTNode* parse_not_expr(ParserState *state);
 ASTNode* parse_primary(ParserState *state);
 
-//La règle de grammaire BNF : expr ::= implication
+//La règle de grammaire BNF : expr ::= binaire(1)
 //Parametre state : ParserState
 ASTNode* parse_expr(ParserState *state) {
-    return parse_implication(state);
+    return parse_binaire(state, 1);
 }
 
 /*
- Fonction : parse_implication
- Ici, on veut gérer l'associativité à droite des opérateurs d'implication
- On parse donc les opérateurs IMPLIQUE (⇒) et PRODUIT (→).
- La règle de grammaire correspondante est : implication ::= or_expr ( "Op(IMPLIQUE)" implication | "Op(PRODUIT)" implication )?
+ Fonction : parse_binaire
+ Ici, on parse les opérateurs binaires par précédence (table de operateurs.h), du moins prioritaire
+ au plus prioritaire : ⇔, puis ⇒ et → (associatifs à droite), puis ∨ ⊕ ↓, puis ∧ ↑.
+ La règle de grammaire correspondante est : binaire(p) ::= not_expr ( op binaire(p') )*
+ pour chaque opérateur op de précédence >= p, avec p' = précédence de op si op est associatif
+ à droite, précédence de op + 1 sinon (associatif à gauche)
 */
 //Parametre state : ParserState
-ASTNode* parse_implication(ParserState *state) {
-    ASTNode *left = parse_or_expr(state);
-    
-    //Gestion des implications consécutives :
-    while (state->lexemes[state->current] &&
-           (strcmp(state->lexemes[state->current], "Op(IMPLIQUE)") == 0 ||
-            strcmp(state->lexemes[state->current], "Op(PRODUIT)") == 0)) {
-        if (strcmp(state->lexemes[state->current], "Op(IMPLIQUE)") == 0) {
-            advance_lexeme(state);
-            ASTNode *right = parse_implication(state); //L'implication est associative à droite
-            left = createOpNode(NODE_IMP, left, right);
-        } else if (strcmp(state->lexemes[state->current], "Op(PRODUIT)") == 0) {
-            advance_lexeme(state);
-            ASTNode *right = parse_implication(state); //De meme pour le Produit
-            left = createOpNode(NODE_PROD, left, right);
-        }
-    }
-
-    return left;
-}
-
-/*
- Fonction : parse_or_exp
- Ici, on veut gérer l'associativité à gauche pour l'opérateur OR
- La règle de grammaire correspondante est : or_expr ::= and_expr ( "Op(OU)" and_expr )
-*/
-//Parametre state : ParserState
-ASTNode* parse_or_expr(ParserState *state) {
-    ASTNode *left = parse_and_expr(state);
-
-    while (state->lexemes[state->current] && strcmp(state->lexemes[state->current], "Op(OU)") == 0) {
-        advance_lexeme(state);
-        ASTNode *right = parse_and_expr(state);
-        left = createOpNode(NODE_OR, left, right);
-    }
-
-    return left;
-}
-
-/*
- Fonction : parse_and_exp
- Ici, on veut gérer l'associativité à gauche pour l'opérateur AND
- La règle de grammaire correspondante est : and_expr ::= not_expr ( "Op(ET)" not_expr )
- */
-//Parametre state : ParserState
-ASTNode* parse_and_expr(ParserState *state) {
+//Parametre precedence_min : entier, précédence minimale des opérateurs acceptés
+ASTNode* parse_binaire(ParserState *state, int precedence_min) {
     ASTNode *left = parse_not_expr(state);
+    if (!left) return NULL;
 
-    while (state->lexemes[state->current] && strcmp(state->lexemes[state->current], "Op(ET)") == 0) {
+    const Operateur *op;
+    while ((op = operateur_lexeme(state->lexemes[state->current])) != NULL &&
+           op->arite == 2 && op->precedence >= precedence_min) {
+        int position = state->current;
         advance_lexeme(state);
-        ASTNode *right = parse_not_expr(state);
-        left = createOpNode(NODE_AND, left, right);
+        int suivante = op->associativite == ASSOC_DROITE ? op->precedence : op->precedence + 1;
+        ASTNode *right = parse_binaire(state, suivante);
+        left = combiner(state, (NodeType)(op - operateurs), left, right, position);
+        if (!left) return NULL;
     }
 
     return left;
@@ -155,10 +153,11 @@ ASTNode* parse_and_expr(ParserState *state) {
  */
 //Parametre state : ParserState
 ASTNode* parse_not_expr(ParserState *state) {
-    if (state->lexemes[state->current] && strcmp(state->lexemes[state->current], "Op(NON)") == 0) {
+    if (state->lexemes[state->current] && strcmp(state->lexemes[state->current], operateurs[NODE_NOT].lexeme) == 0) {
+        int position = state->current;
         advance_lexeme(state);
         ASTNode *operand = parse_not_expr(state);
-        return createOpNode(NODE_NOT, NULL, operand);
+        return combiner(state, NODE_NOT, NULL, operand, position);
     } else {
         return parse_primary(state);
     }
@@ -172,24 +171,27 @@ ASTNode* parse_not_expr(ParserState *state) {
 //Parametre state : ParserState
 ASTNode* parse_primary(ParserState *state) {
     if (!state->lexemes[state->current]) {
-        error("Expression inattendue à la fin de l'entrée", state->current);
+        return error(state, ERR_SYNTAXE, "Expression inattendue à la fin de l'entrée");
     }
     //On vérifie si le lexème actuel est une proposition
     if (strncmp(state->lexemes[state->current], "Prop(", 5) == 0) {
         //On extrait le nom de la proposition (par exemple, "p1" de "Prop(p1)")
-        char *prop = strdup(&state->lexemes[state->current][5]); // "Prop(p1)" -> "p1)"
+        char *prop = mem_dupliquer(&state->lexemes[state->current][5]); // "Prop(p1)" -> "p1)"
         if (!prop) {
-            perror("Erreur d'allocation mémoire pour prop");
-            exit(EXIT_FAILURE);
+            return error(state, ERR_MEMOIRE, "Erreur d'allocation mémoire pour prop");
         }
         size_t len = strlen(prop);
         if (len < 1 || prop[len - 1] != ')') {
-            free(prop);
-            error("Format de proposition invalide", state->current);
+            mem_liberer(prop);
+            return error(state, ERR_SYNTAXE, "Format de proposition invalide");
         }
         prop[len - 1] = '\0'; //on retire la parenthèse fermante
         ASTNode *node = createPropNode(prop);
-        free(prop);
+        mem_liberer(prop);
+        if (!node) {
+            return error(state, ERR_MEMOIRE, "Erreur d'allocation mémoire");
+        }
+        node->position = state->current;
         advance_lexeme(state); //après avoir traité la proposition on passe au lexème suivant
         return node;
 
@@ -197,15 +199,16 @@ ASTNode* parse_primary(ParserState *state) {
     } else if (strcmp(state->lexemes[state->current], "PO") == 0) {
         advance_lexeme(state);
         ASTNode *node = parse_expr(state); // on parse l'expression entre parenthèses
+        if (!node) return NULL;
         //On vérifie si on a atteint la parenthèse fermante
         if (!state->lexemes[state->current] || strcmp(state->lexemes[state->current], "PF") != 0) {
-            error("Parenthèse fermante manquante", state->current);
+            freeAST(node);
+            return error(state, ERR_SYNTAXE, "Parenthèse fermante manquante");
         }
         advance_lexeme(state); //Après la parenthèse fermante, on passe au lexème suivant
         return node;
     } else {
-        error("Proposition ou parenthèse ouvrante attendue", state->current);
-        return NULL; //Pour éviter les warnings de compilateur.
+        return error(state, ERR_SYNTAXE, "Proposition ou parenthèse ouvrante attendue");
     }
 }
 
@@ -219,27 +222,13 @@ void printAST(ASTNode *node, int depth) {
         printf("  ");
     }
 
-    switch (node->type) {
-        case NODE_PROP:
-            printf("Prop(%s)\n", node->value);
-            break;
-        case NODE_AND:
-            printf("AND\n");
-            break;
-        case NODE_OR:
-            printf("OR\n");
-            break;
-        case NODE_NOT:
-            printf("NOT\n");
-            break;
-        case NODE_IMP:
-            printf("IMPLIQUE\n");
-            break;
-        case NODE_PROD:
-            printf("PRODUIT\n");
-            break;
-        default:
-            printf("UNKNOWN NODE\n");
+    const Operateur *op = operateur_noeud(node->type);
+    if (node->type == NODE_PROP) {
+        printf("Prop(%s)\n", node->value);
+    } else if (op) {
+        printf("%s\n", op->affichage);
+    } else {
+        printf("UNKNOWN NODE\n");
     }
 
     //On affiche récursivement les enfants gauche et droit
@@ -253,24 +242,29 @@ void freeAST(ASTNode *node) {
     if (node == NULL) return;
     freeAST(node->left);
     freeAST(node->right);
-    if (node->value) free(node->value);
-    free(node);
+    if (node->value) mem_liberer(node->value);
+    mem_liberer(node);
 }
 
 //Fonction globale pour tester l'analyse syntaxique
 //Parametre lexemes : liste de chaines de caracteres
-//Retourne un arbre syntaxique si l'analyse réussit, sinon une erreur
-ASTNode* analyseur_syntaxique(char** lexemes) {
+//Parametre statut : Statut, rempli en cas d'erreur avec l'indice du lexème fautif (peut être NULL)
+//Retourne un arbre syntaxique si l'analyse réussit, sinon NULL (les noeuds déjà créés sont libérés)
+ASTNode* analyseur_syntaxique(char** lexemes, Statut *statut) {
+    PhaseMemoire phase = definir_phase_memoire(PHASE_SYNTAXIQUE);
     ParserState state;
     state.lexemes = lexemes;
     state.current = 0;
+    statut_ok(&state.statut);
 
     ASTNode *ast = parse_expr(&state);
 
-    if (state.lexemes[state.current] != NULL) {
-        error("Lexème inattendu après la fin de l'expression", state.current);
+    if (ast && state.lexemes[state.current] != NULL) {
+        freeAST(ast);
+        ast = error(&state, ERR_SYNTAXE, "Lexème inattendu après la fin de l'expression");
     }
 
+    if (statut) *statut = state.statut;
+    definir_phase_memoire(phase);
     return ast;
 }
-
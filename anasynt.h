@@ -1,26 +1,38 @@
 #ifndef ANASYNT_H
 #define ANASYNT_H
 
+#include "erreurs.h"
+
 //Strucuture des noeuds d'un arbre syntaxique
+//(symboles, précédences et opcodes des opérateurs : voir la table de operateurs.h)
 typedef enum {
     NODE_PROP,
     NODE_AND,
     NODE_OR,
     NODE_NOT,
     NODE_IMP,
-    NODE_PROD
+    NODE_PROD,
+    NODE_EQUIV,     //Equivalence (⇔)
+    NODE_XOR,       //Ou exclusif (⊕)
+    NODE_NAND,      //Non et (↑)
+    NODE_NOR        //Non ou (↓)
 } NodeType;
 
 //Structure de l'arbre syntaxique
 typedef struct ASTNode {
     NodeType type;
     char *value;
+    int position;               //Indice du lexème du noeud (-1 si le noeud n'a pas été créé par l'analyse)
     struct ASTNode *left;
     struct ASTNode *right;
 } ASTNode;
 
-//Analyse syntaxique
-ASTNode* analyseur_syntaxique(char** lexemes);
+//Création des noeuds (NULL si l'allocation échoue)
+ASTNode* createPropNode(const char *prop);
+ASTNode* createOpNode(NodeType type, ASTNode *left, ASTNode *right);
+
+//Analyse syntaxique (NULL en cas d'erreur, détaillée dans statut)
+ASTNode* analyseur_syntaxique(char** lexemes, Statut* statut);
 
 //Fonction d'affichage des arbres syntaxiques
 void printAST(ASTNode* node, int depth);
@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arbreplat.h"
+#include "anasem.h" //pour indice_prop et nom_prop
+#include "operateurs.h" //pour l'arité et l'opcode de chaque type de noeud
+#include "allocateur.h" //pour allouer les tableaux par l'allocateur courant
+
+
+//Capacité initiale des tableaux d'un arbre plat
+#define CAPACITE_INITIALE 64
+
+//Fonction d'initialisation d'un arbre plat vide
+//Parametre arbre : ArbrePlat
+void arbre_plat_initialiser(ArbrePlat *arbre) {
+    memset(arbre, 0, sizeof(*arbre));
+}
+
+//Fonction de libération de la mémoire d'un arbre plat
+//Parametre arbre : ArbrePlat
+void liberer_arbre_plat(ArbrePlat *arbre) {
+    mem_liberer(arbre->types);
+    mem_liberer(arbre->args);
+    memset(arbre, 0, sizeof(*arbre));
+}
+
+//Fonction garantissant la place de nb noeuds après les noeuds de l'arbre (la capacité au moins double)
+//Parametre arbre : ArbrePlat
+//Parametre nb : nombre de noeuds
+//Retourne 0, ou -1 si la mémoire manque
+int arbre_plat_reserver(ArbrePlat *arbre, uint32_t nb) {
+    if (arbre->capacite - arbre->nb_noeuds >= nb) return 0;
+    if (nb > UINT32_MAX / 2 - arbre->nb_noeuds || arbre->capacite >= UINT32_MAX / 2) return -1;
+    uint32_t capacite = arbre->capacite ? 2 * arbre->capacite : CAPACITE_INITIALE;
+    if (capacite < arbre->nb_noeuds + nb) capacite = arbre->nb_noeuds + nb;
+    uint8_t *types = mem_reallouer(arbre->types, capacite * sizeof(uint8_t));
+    if (!types) return -1;
+    arbre->types = types;
+    uint32_t *args = mem_reallouer(arbre->args, capacite * sizeof(uint32_t));
+    if (!args) return -1;
+    arbre->args = args;
+    arbre->capacite = capacite;
+    return 0;
+}
+
+//Fonction ajoutant un noeud à la fin de l'arbre (les tableaux doublent quand ils sont pleins)
+//Parametre arbre : ArbrePlat
+//Parametre type : NodeType
+//Parametre arg : indice de proposition ou de l'opérande gauche
+//Retourne l'indice du noeud, ou -1 si la mémoire manque
+long arbre_plat_ajouter(ArbrePlat *arbre, NodeType type, uint32_t arg) {
+    if (arbre->nb_noeuds == arbre->capacite && arbre_plat_reserver(arbre, 1) < 0) return -1;
+    arbre->types[arbre->nb_noeuds] = (uint8_t)type;
+    arbre->args[arbre->nb_noeuds] = arg;
+    return arbre->nb_noeuds++;
+}
+
+//Fonction de conversion d'un arbre syntaxique en arbre plat
+//Le parcours postfixe utilise une pile explicite : la profondeur de l'arbre n'est pas limitée par la pile d'appels
+//Parametre ast : ASTNode
+//Parametre arbre : ArbrePlat, vidé puis rempli
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int arbre_plat_depuis_ast(ASTNode *ast, ArbrePlat *arbre, Statut *statut) {
+    arbre->nb_noeuds = 0;
+    if (!ast) {
+        statut_definir(statut, ERR_ARITE, -1, "Arbre vide");
+        return -1;
+    }
+
+    //pile : noeuds en cours de parcours, etapes : nombre d'enfants déjà parcourus
+    //racines : indices des sous-arbres terminés dont le parent n'est pas encore ajouté
+    size_t capacite = 64, sommet = 0, nb_racines = 0;
+    ASTNode **pile = mem_allouer(capacite * sizeof(ASTNode *));
+    uint8_t *etapes = mem_allouer(capacite * sizeof(uint8_t));
+    uint32_t *racines = mem_allouer(capacite * sizeof(uint32_t));
+    int resultat = -1;
+    if (!pile || !etapes || !racines) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        goto fin;
+    }
+    pile[sommet] = ast;
+    etapes[sommet++] = 0;
+
+    while (sommet > 0) {
+        ASTNode *n = pile[sommet - 1];
+        if (etapes[sommet - 1] < 2) {
+            ASTNode *enfant = etapes[sommet - 1] == 0 ? n->left : n->right;
+            etapes[sommet - 1]++;
+            if (!enfant) continue;
+            if (sommet == capacite) {
+                capacite *= 2;
+                ASTNode **p = mem_reallouer(pile, capacite * sizeof(ASTNode *));
+                if (p) pile = p;
+                uint8_t *e = mem_reallouer(etapes, capacite * sizeof(uint8_t));
+                if (e) etapes = e;
+                uint32_t *r = mem_reallouer(racines, capacite * sizeof(uint32_t));
+                if (r) racines = r;
+                if (!p || !e || !r) {
+                    statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+                    goto fin;
+                }
+            }
+            pile[sommet] = enfant;
+            etapes[sommet++] = 0;
+            continue;
+        }
+
+        //Les enfants sont ajoutés : on ajoute le noeud
+        sommet--;
+        long indice;
+        const Operateur *op = operateur_noeud(n->type);
+        switch (op ? op->arite : -1) {
+            case 0: {
+                int prop = indice_prop(n->value);
+                if (prop < 0) {
+                    statut_definir(statut, ERR_PROP_INVALIDE, arbre->nb_noeuds, "Proposition invalide");
+                    goto fin;
+                }
+                indice = arbre_plat_ajouter(arbre, NODE_PROP, (uint32_t)prop);
+                break;
+            }
+            case 1:
+                if (n->left || !n->right) {
+                    statut_definir(statut, ERR_ARITE, arbre->nb_noeuds, "L'opérateur NOT doit avoir un opérande");
+                    goto fin;
+                }
+                nb_racines--;
+                indice = arbre_plat_ajouter(arbre, n->type, 0);
+                break;
+            case 2:
+                if (!n->left || !n->right) {
+                    statut_definir(statut, ERR_ARITE, arbre->nb_noeuds, "Un opérateur binaire doit avoir deux opérandes");
+                    goto fin;
+                }
+                nb_racines -= 2;
+                indice = arbre_plat_ajouter(arbre, n->type, racines[nb_racines]);
+                break;
+            default:
+                statut_definir(statut, ERR_NOEUD_INCONNU, arbre->nb_noeuds, "Type de noeud inconnu");
+                goto fin;
+        }
+        if (indice < 0) {
+            statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+            goto fin;
+        }
+        racines[nb_racines++] = (uint32_t)indice;
+    }
+    resultat = 0;
+
+fin:
+    mem_liberer(pile);
+    mem_liberer(etapes);
+    mem_liberer(racines);
+    if (resultat < 0) arbre->nb_noeuds = 0;
+    return resultat;
+}
+
+//Fonction de conversion d'un arbre plat en arbre syntaxique
+//Les sous-arbres terminés sont empilés : en ordre postfixe, un opérateur trouve ses opérandes au sommet
+//Parametre arbre : ArbrePlat (vérifié par analyse_semantique_plate)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne l'arbre syntaxique, ou NULL en cas d'erreur
+ASTNode *arbre_plat_vers_ast(const ArbrePlat *arbre, Statut *statut) {
+    if (analyse_semantique_plate(arbre, statut) < 0) return NULL;
+
+    ASTNode **pile = mem_allouer(arbre->nb_noeuds * sizeof(ASTNode *));
+    if (!pile) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return NULL;
+    }
+    uint32_t sommet = 0;
+    for (uint32_t i = 0; i < arbre->nb_noeuds; i++) {
+        ASTNode *n;
+        NodeType type = (NodeType)arbre->types[i];
+        if (type == NODE_PROP) {
+            n = createPropNode(nom_prop(arbre->args[i]));
+        } else if (type == NODE_NOT) {
+            n = createOpNode(NODE_NOT, NULL, pile[sommet - 1]);
+            if (n) sommet--;
+        } else {
+            n = createOpNode(type, pile[sommet - 2], pile[sommet - 1]);
+            if (n) sommet -= 2;
+        }
+        if (!n) {
+            while (sommet > 0) freeAST(pile[--sommet]);
+            mem_liberer(pile);
+            statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+            return NULL;
+        }
+        pile[sommet++] = n;
+    }
+    ASTNode *racine = pile[0];
+    mem_liberer(pile);
+    return racine;
+}
+
+//Fonction d'analyse sémantique d'un arbre plat, en un seul parcours des tableaux
+//On suit le nombre de sous-arbres terminés : l'opérande gauche d'un opérateur binaire doit être
+//la racine du sous-arbre précédant son opérande droit, ce qu'on vérifie avec la taille des sous-arbres
+//Parametre arbre : ArbrePlat
+//Parametre statut : Statut, rempli avec l'indice du noeud fautif (peut être NULL)
+//Retourne 0 si l'arbre est correct, -1 sinon
+int analyse_semantique_plate(const ArbrePlat *arbre, Statut *statut) {
+    if (arbre->nb_noeuds == 0) {
+        statut_definir(statut, ERR_ARITE, -1, "Arbre vide");
+        return -1;
+    }
+    //debut[i] : indice du premier noeud du sous-arbre de racine i (le sous-arbre est debut[i] .. i)
+    uint32_t *debut = mem_allouer(arbre->nb_noeuds * sizeof(uint32_t));
+    if (!debut) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    int resultat = 0;
+    uint32_t i;
+    for (i = 0; i < arbre->nb_noeuds && resultat == 0; i++) {
+        uint32_t a = arbre->args[i];
+        const Operateur *op = operateur_noeud(arbre->types[i]);
+        switch (op ? op->arite : -1) {
+            case 0:
+                if (!nom_prop(a)) {
+                    statut_definir(statut, ERR_PROP_INVALIDE, i, "Proposition invalide");
+                    resultat = -1;
+                }
+                debut[i] = i;
+                break;
+            case 1:
+                if (i < 1) {
+                    statut_definir(statut, ERR_ARITE, i, "L'opérateur NOT doit avoir un opérande");
+                    resultat = -1;
+                    break;
+                }
+                debut[i] = debut[i - 1];
+                break;
+            case 2:
+                //L'opérande gauche se termine juste avant le début de l'opérande droit
+                if (i < 2 || debut[i - 1] == 0 || a != debut[i - 1] - 1) {
+                    statut_definir(statut, ERR_ARITE, i, "Un opérateur binaire doit avoir deux opérandes");
+                    resultat = -1;
+                    break;
+                }
+                debut[i] = debut[a];
+                break;
+            default:
+                statut_definir(statut, ERR_NOEUD_INCONNU, i, "Type de noeud inconnu");
+                resultat = -1;
+        }
+    }
+    //La racine doit couvrir tout l'arbre
+    if (resultat == 0 && debut[arbre->nb_noeuds - 1] != 0) {
+        statut_definir(statut, ERR_SYNTAXE, arbre->nb_noeuds - 1, "Plusieurs racines");
+        resultat = -1;
+    }
+    mem_liberer(debut);
+    return resultat;
+}
+
+//Fonction de compilation d'un arbre plat : l'ordre postfixe est déjà celui du programme
+//Parametre arbre : ArbrePlat (vérifié)
+//Parametre prog : tableau d'instructions
+//Parametre capacite : entier, taille du tableau
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_arbre_plat(const ArbrePlat *arbre, VMInstruction *prog, int capacite, Statut *statut) {
+    if (arbre->nb_noeuds > (uint32_t)capacite) {
+        statut_definir(statut, ERR_PROGRAMME_PLEIN, capacite, "Programme trop long");
+        return -1;
+    }
+    for (uint32_t i = 0; i < arbre->nb_noeuds; i++) {
+        const Operateur *op = operateur_noeud(arbre->types[i]);
+        if (!op) {
+            statut_definir(statut, ERR_NOEUD_INCONNU, i, "Type de noeud inconnu");
+            return -1;
+        }
+        prog[i] = (VMInstruction){op->opcode, op->arite == 0 ? (int)arbre->args[i] : 0};
+    }
+    return (int)arbre->nb_noeuds;
+}
+
+//Fonction d'évaluation bit-parallèle d'un arbre plat vérifié
+//Parametre arbre : ArbrePlat
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Parametre valeurs : tableau de travail (nb_noeuds mots), valeurs[i] reçoit le mot du noeud i
+//Retourne le mot des résultats de la racine
+uint64_t evaluer_arbre_plat_64(const ArbrePlat *arbre, const uint64_t *colonnes, uint64_t *valeurs) {
+    const uint8_t *types = arbre->types;
+    const uint32_t *args = arbre->args;
+    for (uint32_t i = 0; i < arbre->nb_noeuds; i++) {
+        switch ((NodeType)types[i]) {
+            case NODE_PROP:
+                valeurs[i] = colonnes[args[i]];
+                break;
+            case NODE_AND:
+                valeurs[i] = valeurs[args[i]] & valeurs[i - 1];
+                break;
+            case NODE_OR:
+                valeurs[i] = valeurs[args[i]] | valeurs[i - 1];
+                break;
+            case NODE_NOT:
+                valeurs[i] = ~valeurs[i - 1];
+                break;
+            case NODE_IMP:
+            case NODE_PROD:
+                valeurs[i] = ~valeurs[args[i]] | valeurs[i - 1];
+                break;
+            case NODE_EQUIV:
+                valeurs[i] = ~(valeurs[args[i]] ^ valeurs[i - 1]);
+                break;
+            case NODE_XOR:
+                valeurs[i] = valeurs[args[i]] ^ valeurs[i - 1];
+                break;
+            case NODE_NAND:
+                valeurs[i] = ~(valeurs[args[i]] & valeurs[i - 1]);
+                break;
+            case NODE_NOR:
+                valeurs[i] = ~(valeurs[args[i]] | valeurs[i - 1]);
+                break;
+        }
+    }
+    return valeurs[arbre->nb_noeuds - 1];
+}
@@ -0,0 +1,50 @@
+#ifndef ARBREPLAT_H
+#define ARBREPLAT_H
+
+#include <stdint.h>
+#include "anasynt.h" //pour les arbres syntaxiques (conversion)
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Arbre syntaxique compact : les noeuds sont rangés dans l'ordre postfixe, dans deux tableaux.
+//Le noeud i a le type types[i] (NodeType) ; pour une proposition, args[i] est son indice dans
+//les propositions valides ; pour un opérateur, l'opérande droit (ou l'unique opérande de NOT)
+//est le noeud i - 1 et args[i] est l'indice de l'opérande gauche (0 pour NOT).
+//La racine est le dernier noeud. Un noeud occupe 5 octets.
+typedef struct {
+    uint8_t* types;
+    uint32_t* args;
+    uint32_t nb_noeuds;
+    uint32_t capacite;
+} ArbrePlat;
+
+//Initialisation (arbre vide) et libération
+void arbre_plat_initialiser(ArbrePlat* arbre);
+void liberer_arbre_plat(ArbrePlat* arbre);
+
+//Ajout d'un noeud à la fin de l'arbre (ordre postfixe). Retourne l'indice du noeud, ou -1 si la
+//mémoire manque
+long arbre_plat_ajouter(ArbrePlat* arbre, NodeType type, uint32_t arg);
+
+//Place pour nb noeuds de plus (remplis ensuite directement dans types et args). Retourne 0 ou -1
+int arbre_plat_reserver(ArbrePlat* arbre, uint32_t nb);
+
+//Conversion depuis un arbre syntaxique : les propositions doivent être valides.
+//Retourne 0, ou -1 (ERR_PROP_INVALIDE, ERR_ARITE, ERR_NOEUD_INCONNU, ERR_MEMOIRE)
+int arbre_plat_depuis_ast(ASTNode* ast, ArbrePlat* arbre, Statut* statut);
+
+//Conversion vers un arbre syntaxique (NULL en cas d'erreur)
+ASTNode* arbre_plat_vers_ast(const ArbrePlat* arbre, Statut* statut);
+
+//Analyse sémantique en un parcours : types connus, opérandes placés avant leur opérateur,
+//propositions valides, une seule racine. Retourne 0, ou -1 avec la position du noeud fautif
+int analyse_semantique_plate(const ArbrePlat* arbre, Statut* statut);
+
+//Compilation : un noeud donne une instruction, dans l'ordre des noeuds
+//Retourne le nombre d'instructions, ou -1 si le tableau est trop petit
+int compiler_arbre_plat(const ArbrePlat* arbre, VMInstruction* prog, int capacite, Statut* statut);
+
+//Evaluation bit-parallèle (64 valuations, colonnes[i] : proposition i) d'un arbre vérifié.
+//valeurs est un tableau de travail d'au moins nb_noeuds mots. Retourne le mot des résultats
+uint64_t evaluer_arbre_plat_64(const ArbrePlat* arbre, const uint64_t* colonnes, uint64_t* valeurs);
+
+#endif
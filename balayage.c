@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "balayage.h"
+#include "allocateur.h"
+
+
+//Nombre de paquets de 64 valuations réservés à la fois par un thread
+#define BLOC_PAQUETS 256
+
+//Nombre maximal de threads de balayage
+#define MAX_THREADS_BALAYAGE 64
+
+//Intervalle entre deux appels du rappel de progression (en millisecondes)
+#define INTERVALLE_PROGRESSION 50
+
+//Les paquets de 64 valuations sont les mots de enumerer_valuations (runtime.h) : la valuation du
+//bit j du paquet p est (p << 6) | j.
+
+//Etat partagé d'un balayage
+typedef struct {
+    const VMInstruction *prog_a;
+    int taille_a;
+    const VMInstruction *prog_b;        //NULL pour une vérification de tautologie
+    int taille_b;
+    int nb_props;
+    uint64_t nb_paquets;                //Nombre de paquets de 64 valuations à évaluer
+
+    atomic_uint_fast64_t prochain;      //Prochain paquet à réserver
+    atomic_uint_fast64_t faits;         //Nombre de paquets évalués
+    atomic_int arret;                   //Mis à 1 dès qu'un contre-exemple est trouvé
+    atomic_int actifs;                  //Nombre de threads encore en cours
+
+    pthread_mutex_t verrou;             //Protège trouve et temoin
+    int trouve;
+    uint64_t temoin;
+} Balayage;
+
+
+//Fonction renumérotant les propositions d'un programme de 0 à nb_props - 1
+//Parametre prog : tableau d'instructions
+//Parametre taille : entier
+//Parametre res : ResultatBalayage, où sont ajoutées les nouvelles propositions
+//Parametre statut : Statut (ERR_MEMOIRE, ou ERR_TABLE_PLEINE au-delà de MAX_PROPS_BALAYAGE propositions)
+//Retourne une copie du programme renumérotée, ou NULL en cas d'erreur
+VMInstruction *renumeroter_propositions(const VMInstruction *prog, int taille, ResultatBalayage *res,
+                                        Statut *statut) {
+    VMInstruction *copie = mem_allouer((taille > 0 ? taille : 1) * sizeof(VMInstruction));
+    if (!copie) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return NULL;
+    }
+    for (int i = 0; i < taille; i++) {
+        copie[i] = prog[i];
+        if (prog[i].opcode != VM_LOAD) continue;
+
+        int k = 0;
+        while (k < res->nb_props && res->props[k] != prog[i].operand) {
+            k++;
+        }
+        if (k == res->nb_props) {
+            if (res->nb_props >= MAX_PROPS_BALAYAGE) {
+                statut_definir(statut, ERR_TABLE_PLEINE, i, "Trop de propositions pour un balayage exhaustif");
+                mem_liberer(copie);
+                return NULL;
+            }
+            res->props[res->nb_props++] = prog[i].operand;
+        }
+        copie[i].operand = k;
+    }
+    return copie;
+}
+
+//Evaluation d'un paquet : retourne 1 et garde le témoin si un contre-exemple est trouvé
+static int verifier_paquet_balayage(uint64_t p, const uint64_t *colonnes, void *donnees) {
+    Balayage *b = donnees;
+    //Un bit à 1 dans mauvais correspond à un contre-exemple
+    uint64_t r = executer_programme_64(b->prog_a, b->taille_a, colonnes);
+    uint64_t mauvais = b->prog_b ? r ^ executer_programme_64(b->prog_b, b->taille_b, colonnes) : ~r;
+    if (!mauvais) return 0;
+
+    uint64_t valuation = (p << 6) | (uint64_t)__builtin_ctzll(mauvais);
+    if (b->nb_props < 6) {
+        valuation &= ((uint64_t)1 << b->nb_props) - 1;
+    }
+    pthread_mutex_lock(&b->verrou);
+    if (!b->trouve) {
+        b->trouve = 1;
+        b->temoin = valuation;
+    }
+    pthread_mutex_unlock(&b->verrou);
+    return 1;
+}
+
+//Fonction exécutée par chaque thread de balayage
+//Parametre arg : Balayage
+void *travailleur_balayage(void *arg) {
+    Balayage *b = arg;
+    uint64_t colonnes[MAX_PROPS_BALAYAGE];
+
+    while (!atomic_load_explicit(&b->arret, memory_order_relaxed)) {
+        uint64_t debut = atomic_fetch_add(&b->prochain, BLOC_PAQUETS);
+        if (debut >= b->nb_paquets) break;
+        uint64_t fin = debut + BLOC_PAQUETS < b->nb_paquets ? debut + BLOC_PAQUETS : b->nb_paquets;
+
+        uint64_t arret = enumerer_valuations(b->nb_props, NULL, colonnes, debut, fin, verifier_paquet_balayage, b);
+        if (arret < fin) {
+            atomic_store(&b->arret, 1);
+            atomic_fetch_add(&b->faits, arret - debut + 1);
+            atomic_fetch_sub(&b->actifs, 1);
+            return NULL;
+        }
+        atomic_fetch_add(&b->faits, fin - debut);
+    }
+
+    atomic_fetch_sub(&b->actifs, 1);
+    return NULL;
+}
+
+//Nombre de valuations correspondant à un nombre de paquets évalués (au plus 2^nb_props)
+static uint64_t valuations_evaluees(const Balayage *b, uint64_t paquets) {
+    uint64_t total = (uint64_t)1 << b->nb_props;
+    uint64_t n = paquets << 6;
+    return n < total ? n : total;
+}
+
+//Fonction commune aux balayages de tautologie et d'équivalence
+//Parametre prog_b : NULL pour une tautologie
+//Retourne 1 si aucun contre-exemple, 0 si un contre-exemple est trouvé, -1 en cas d'erreur
+//(programme refusé par verifier_programme, trop de propositions ou mémoire insuffisante)
+int balayer(const VMInstruction *prog_a, int taille_a, const VMInstruction *prog_b, int taille_b,
+            int nb_threads, RappelProgression rappel, void *donnees, ResultatBalayage *res, Statut *statut) {
+    memset(res, 0, sizeof(*res));
+    statut_ok(statut);
+
+    //Les programmes sont vérifiés une fois ici : l'exécution bit-parallèle ne vérifie plus rien
+    if (verifier_programme(prog_a, taille_a, statut) < 0) return -1;
+    if (prog_b && verifier_programme(prog_b, taille_b, statut) < 0) return -1;
+
+    Balayage b;
+    memset(&b, 0, sizeof(b));
+    VMInstruction *copie_a = renumeroter_propositions(prog_a, taille_a, res, statut);
+    VMInstruction *copie_b = NULL;
+    if (!copie_a) return -1;
+    if (prog_b && !(copie_b = renumeroter_propositions(prog_b, taille_b, res, statut))) {
+        mem_liberer(copie_a);
+        return -1;
+    }
+
+    b.prog_a = copie_a;
+    b.taille_a = taille_a;
+    b.prog_b = copie_b;
+    b.taille_b = taille_b;
+    b.nb_props = res->nb_props;
+    b.nb_paquets = mots_valuations(b.nb_props);
+    atomic_init(&b.prochain, 0);
+    atomic_init(&b.faits, 0);
+    atomic_init(&b.arret, 0);
+    pthread_mutex_init(&b.verrou, NULL);
+
+    if (nb_threads <= 0) {
+        nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (nb_threads < 1) nb_threads = 1;
+    if (nb_threads > MAX_THREADS_BALAYAGE) nb_threads = MAX_THREADS_BALAYAGE;
+    atomic_init(&b.actifs, nb_threads);
+
+    //Un thread qui n'a pas pu être créé n'est pas attendu : les paquets sont réservés à la demande, les
+    //threads lancés font aussi sa part (le thread appelant balaye seul si aucun n'a pu être créé)
+    pthread_t threads[MAX_THREADS_BALAYAGE];
+    int lance[MAX_THREADS_BALAYAGE];
+    int nb_lances = 0;
+    for (int t = 0; t < nb_threads; t++) {
+        lance[t] = pthread_create(&threads[t], NULL, travailleur_balayage, &b) == 0;
+        if (lance[t]) nb_lances++;
+        else atomic_fetch_sub(&b.actifs, 1);
+    }
+    if (nb_lances == 0) {
+        atomic_store(&b.actifs, 1);
+        travailleur_balayage(&b);
+    }
+
+    //Le thread appelant rapporte la progression pendant que les threads évaluent
+    uint64_t total = (uint64_t)1 << b.nb_props;
+    struct timespec pause = {0, INTERVALLE_PROGRESSION * 1000000L};
+    while (rappel && atomic_load(&b.actifs) > 0) {
+        rappel(valuations_evaluees(&b, atomic_load(&b.faits)), total, donnees);
+        nanosleep(&pause, NULL);
+    }
+    for (int t = 0; t < nb_threads; t++) {
+        if (lance[t]) pthread_join(threads[t], NULL);
+    }
+
+    res->valuations_testees = valuations_evaluees(&b, atomic_load(&b.faits));
+    res->trouve = b.trouve;
+    res->temoin = b.temoin;
+    if (rappel) {
+        rappel(res->valuations_testees, total, donnees);
+    }
+
+    pthread_mutex_destroy(&b.verrou);
+    mem_liberer(copie_a);
+    mem_liberer(copie_b);
+    return res->trouve ? 0 : 1;
+}
+
+//Vérification de tautologie par balayage parallèle de la table de vérité
+//Parametre prog : tableau d'instructions (résultat au sommet de la pile)
+//Parametre taille : entier
+//Parametre nb_threads : entier (<= 0 pour utiliser tous les processeurs)
+//Parametre rappel : RappelProgression (peut être NULL)
+//Parametre donnees : pointeur transmis au rappel
+//Parametre res : ResultatBalayage
+//Parametre statut : Statut
+int balayer_tautologie(const VMInstruction *prog, int taille, int nb_threads,
+                       RappelProgression rappel, void *donnees, ResultatBalayage *res, Statut *statut) {
+    return balayer(prog, taille, NULL, 0, nb_threads, rappel, donnees, res, statut);
+}
+
+//Vérification d'équivalence de deux programmes par balayage parallèle de la table de vérité
+//Les propositions des deux programmes sont réunies : le témoin porte sur toutes
+int balayer_equivalence(const VMInstruction *prog_a, int taille_a,
+                        const VMInstruction *prog_b, int taille_b, int nb_threads,
+                        RappelProgression rappel, void *donnees, ResultatBalayage *res, Statut *statut) {
+    return balayer(prog_a, taille_a, prog_b, taille_b, nb_threads, rappel, donnees, res, statut);
+}
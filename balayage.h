@@ -0,0 +1,34 @@
+#ifndef BALAYAGE_H
+#define BALAYAGE_H
+
+#include <stdint.h>
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Nombre maximal de propositions distinctes pour un balayage exhaustif
+#define MAX_PROPS_BALAYAGE 62
+
+//Résultat d'un balayage de la table de vérité
+typedef struct {
+    int nb_props;                       //Nombre de propositions distinctes des programmes
+    int props[MAX_PROPS_BALAYAGE];      //Indices des propositions (opérandes de VM_LOAD), dans l'ordre des bits du témoin
+    int trouve;                         //1 si un contre-exemple a été trouvé
+    uint64_t temoin;                    //Contre-exemple : le bit k donne la valeur de la proposition props[k]
+    uint64_t valuations_testees;        //Nombre de valuations évaluées avant l'arrêt
+} ResultatBalayage;
+
+//Fonction appelée régulièrement pendant le balayage avec le nombre de valuations déjà évaluées
+typedef void (*RappelProgression)(uint64_t faites, uint64_t total, void* donnees);
+
+//Vérifie qu'un programme est une tautologie en évaluant toutes les valuations sur nb_threads threads
+//Retourne 1 si c'est une tautologie, 0 si un contre-exemple est trouvé (res->temoin), -1 en cas d'erreur
+//(statut : programme invalide, ERR_TABLE_PLEINE au-delà de MAX_PROPS_BALAYAGE propositions, ERR_MEMOIRE)
+int balayer_tautologie(const VMInstruction* prog, int taille, int nb_threads,
+                       RappelProgression rappel, void* donnees, ResultatBalayage* res, Statut* statut);
+
+//Vérifie que deux programmes sont équivalents (même résultat pour toutes les valuations)
+//Retourne 1 s'ils sont équivalents, 0 si une valuation les distingue (res->temoin), -1 en cas d'erreur
+int balayer_equivalence(const VMInstruction* prog_a, int taille_a,
+                        const VMInstruction* prog_b, int taille_b, int nb_threads,
+                        RappelProgression rappel, void* donnees, ResultatBalayage* res, Statut* statut);
+
+#endif
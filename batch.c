@@ -0,0 +1,387 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+//Pour les threads de traitement et leur synchronisation (verrous, conditions)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//Pour ouvrir le fichier d'entrée et le projeter en mémoire (mmap)
+
+#include "batch.h"
+#include "allocateur.h"
+#include "analex.h"      //Pour CreationListeLexeme et avancer_espaces
+#include "anasem.h"      //Pour analyseur_semantique
+#include "compilateur.h" //Pour compiler_programme
+
+
+//Le fichier est découpé en morceaux d'environ TAILLE_MORCEAU octets, recalés sur les fins de ligne.
+//Un morceau est l'unité de travail donnée aux threads.
+#define TAILLE_MORCEAU (64 * 1024)
+
+//Nombre de morceaux terminés pouvant attendre leur écriture (tampon de réordonnancement)
+#define FENETRE 256
+
+//Nombre maximal de threads de traitement
+#define MAX_THREADS 64
+
+//Tampon de texte extensible, utilisé pour le résultat d'un morceau et pour la ligne courante
+typedef struct {
+    char *texte;
+    size_t taille;
+    size_t capacite;
+    int echec;                      //1 si un ajout a été refusé faute de mémoire (texte incomplet)
+} Tampon;
+
+//File de morceaux propre à un thread.
+//Le thread w possède les morceaux w, w + P, w + 2P, ... (P threads), représentés par les indices
+//locaux [prochain, fin). Un thread inactif vole le morceau le plus ancien d'une autre file.
+typedef struct {
+    pthread_mutex_t verrou;
+    long prochain;
+    long fin;
+} FileMorceaux;
+
+//Etat partagé du traitement par lot
+typedef struct {
+    const char *donnees;            //Fichier projeté en mémoire
+    size_t taille;                  //Taille du fichier
+    long nb_morceaux;
+    int nb_threads;
+    FileMorceaux files[MAX_THREADS];
+
+    //Tampon de réordonnancement : le résultat du morceau c est rangé dans la place c % FENETRE
+    pthread_mutex_t verrou;
+    pthread_cond_t condition;
+    Tampon resultats[FENETRE];
+    int prets[FENETRE];
+    long ecrits;                    //Nombre de morceaux déjà écrits sur la sortie (ou écartés après un
+                                    //manque de mémoire)
+} Lot;
+
+//Paramètres d'un thread de traitement
+typedef struct {
+    Lot *lot;
+    int id;
+    long nb_formules;               //Nombre de formules traitées par ce thread
+} Travailleur;
+
+//Mnémoniques des instructions, dans l'ordre de VMOpcode
+static const char *mnemoniques[] = {"NOP", "PUSH", "POP", "AND", "OR", "NOT", "IMP", "PRINT", "LOAD", "EQV", "XOR", "NAND", "NOR"};
+
+
+//Fonction pour ajouter des octets à la fin d'un tampon (agrandi si besoin)
+//Si la mémoire manque, rien n'est ajouté et t->echec passe à 1
+//Parametre t : Tampon
+//Parametre texte : octets à ajouter
+//Parametre n : nombre d'octets
+void tampon_ajouter(Tampon *t, const char *texte, size_t n) {
+    if (t->taille + n + 1 > t->capacite) {
+        size_t capacite = t->capacite ? t->capacite : 256;
+        while (t->taille + n + 1 > capacite) {
+            capacite *= 2;
+        }
+        char *nouveau = mem_reallouer(t->texte, capacite);
+        if (!nouveau) {
+            t->echec = 1;
+            return;
+        }
+        t->texte = nouveau;
+        t->capacite = capacite;
+    }
+    memcpy(t->texte + t->taille, texte, n);
+    t->taille += n;
+    t->texte[t->taille] = '\0';
+}
+
+//Fonction écrivant un programme sous forme de texte ("LOAD 0 LOAD 1 AND") suivi d'une fin de ligne
+//Parametre t : Tampon
+//Parametre prog : tableau d'instructions
+//Parametre n : nombre d'instructions
+void ecrire_programme(Tampon *t, const VMInstruction *prog, int n) {
+    char texte[32];
+    for (int i = 0; i < n; i++) {
+        int len;
+        if (prog[i].opcode == VM_LOAD || prog[i].opcode == VM_PUSH) {
+            len = snprintf(texte, sizeof(texte), "%s%s %d", i ? " " : "", mnemoniques[prog[i].opcode], prog[i].operand);
+        } else {
+            len = snprintf(texte, sizeof(texte), "%s%s", i ? " " : "", mnemoniques[prog[i].opcode]);
+        }
+        tampon_ajouter(t, texte, len);
+    }
+    tampon_ajouter(t, "\n", 1);
+}
+
+//Fonction retournant la position du début du morceau c : le premier début de ligne à partir de c * TAILLE_MORCEAU
+//Parametre lot : Lot
+//Parametre c : numéro du morceau
+long debut_morceau(const Lot *lot, long c) {
+    if (c <= 0) return 0;
+    size_t pos = (size_t)c * TAILLE_MORCEAU;
+    if (pos >= lot->taille) return lot->taille;
+    const char *fin_ligne = memchr(lot->donnees + pos - 1, '\n', lot->taille - pos + 1);
+    return fin_ligne ? (fin_ligne - lot->donnees) + 1 : (long)lot->taille;
+}
+
+//Fonction donnant le prochain morceau à traiter par le thread w
+//On sert d'abord la file du thread, sinon on vole le morceau le plus ancien parmi les autres files
+//(le plus ancien est aussi celui que le tampon de réordonnancement attend en premier)
+//Retourne le numéro du morceau, ou -1 s'il n'y a plus de travail
+long prendre_morceau(Lot *lot, int w) {
+    int p = lot->nb_threads;
+    for (;;) {
+        int victime = -1;
+        long meilleur = -1;
+        for (int k = 0; k < p; k++) {
+            int v = (w + k) % p;
+            FileMorceaux *f = &lot->files[v];
+            pthread_mutex_lock(&f->verrou);
+            if (f->prochain < f->fin) {
+                long c = f->prochain * p + v;
+                if (v == w) {
+                    f->prochain++;
+                    pthread_mutex_unlock(&f->verrou);
+                    return c;
+                }
+                if (meilleur < 0 || c < meilleur) {
+                    meilleur = c;
+                    victime = v;
+                }
+            }
+            pthread_mutex_unlock(&f->verrou);
+        }
+        if (victime < 0) return -1;
+
+        //On revérifie sous verrou : le morceau a pu être pris entre temps
+        FileMorceaux *f = &lot->files[victime];
+        pthread_mutex_lock(&f->verrou);
+        if (f->prochain < f->fin && f->prochain * p + victime == meilleur) {
+            f->prochain++;
+            pthread_mutex_unlock(&f->verrou);
+            return meilleur;
+        }
+        pthread_mutex_unlock(&f->verrou);
+    }
+}
+
+//Fonction écrivant une ligne d'erreur : ERREUR <code> <position> <message>
+//Parametre res : Tampon
+//Parametre statut : Statut
+void ecrire_erreur(Tampon *res, const Statut *statut) {
+    char texte[160];
+    int n = snprintf(texte, sizeof(texte), "ERREUR %d %d %s\n", (int)statut->code, statut->position,
+                     statut->message ? statut->message : "");
+    if (n >= (int)sizeof(texte)) n = sizeof(texte) - 1;
+    tampon_ajouter(res, texte, n);
+}
+
+//Fonction traitant une formule : analyses lexicale, syntaxique, sémantique puis compilation
+//Parametre ligne : chaine de caracteres (non vide)
+//Parametre prog : tableau d'instructions de taille PROGRAM_SIZE, propre au thread
+//Parametre res : Tampon où est écrit le résultat, ou une ligne d'erreur si la formule est refusée
+void traiter_formule(const char *ligne, VMInstruction *prog, Tampon *res) {
+    Statut statut;
+    statut_ok(&statut);
+    int n = -1;
+
+    char **lexemes = CreationListeLexeme(ligne, &statut);
+    if (lexemes) {
+        ASTNode *ast = analyseur_syntaxique(lexemes, &statut);
+        liberer_lexemes(lexemes);
+        if (ast && analyseur_semantique(ast, &statut) == 0) {
+            n = compiler_programme(ast, prog, PROGRAM_SIZE, &statut);
+        }
+        freeAST(ast);
+    }
+
+    if (n < 0) {
+        ecrire_erreur(res, &statut);
+    } else {
+        ecrire_programme(res, prog, n);
+    }
+}
+
+//Fonction traitant les formules du morceau c et rangeant le résultat dans le tampon de réordonnancement
+//Parametre tr : Travailleur
+//Parametre c : numéro du morceau (sa place dans le tampon de réordonnancement doit être libre)
+//Parametre ligne : Tampon de la ligne courante, réutilisé d'un morceau à l'autre
+//Parametre prog : tableau d'instructions de taille PROGRAM_SIZE
+void traiter_morceau(Travailleur *tr, long c, Tampon *ligne, VMInstruction *prog) {
+    Lot *lot = tr->lot;
+
+    //Si la mémoire manque, le morceau est abandonné (res.echec vaut 1)
+    Tampon res = {NULL, 0, 0, 0};
+    long pos = debut_morceau(lot, c);
+    long fin = debut_morceau(lot, c + 1);
+    while (pos < fin && !res.echec) {
+        const char *debut = lot->donnees + pos;
+        const char *fin_ligne = memchr(debut, '\n', fin - pos);
+        long len = fin_ligne ? fin_ligne - debut : fin - pos;
+        pos += len + 1;
+        if (len > 0 && debut[len - 1] == '\r') len--;
+
+        ligne->taille = 0;
+        tampon_ajouter(ligne, debut, len);
+        if (ligne->echec) {
+            res.echec = 1;
+            ligne->echec = 0;
+            break;
+        }
+        //Une ligne vide (ou d'espaces) donne une ligne vide en sortie
+        if (avancer_espaces(ligne->texte, 0, (int)len) == len) {
+            tampon_ajouter(&res, "\n", 1);
+            continue;
+        }
+        traiter_formule(ligne->texte, prog, &res);
+        tr->nb_formules++;
+    }
+
+    //Le résultat du morceau est rangé dans le tampon de réordonnancement
+    pthread_mutex_lock(&lot->verrou);
+    lot->resultats[c % FENETRE] = res;
+    lot->prets[c % FENETRE] = 1;
+    pthread_cond_broadcast(&lot->condition);
+    pthread_mutex_unlock(&lot->verrou);
+}
+
+//Fonction exécutée par chaque thread de traitement
+//Parametre arg : Travailleur
+void *travailleur_lot(void *arg) {
+    Travailleur *tr = arg;
+    Lot *lot = tr->lot;
+    Tampon ligne = {NULL, 0, 0, 0};         //Ligne courante, réutilisée d'une ligne à l'autre
+    VMInstruction prog[PROGRAM_SIZE];       //Programme compilé, réutilisé d'une ligne à l'autre
+    long c;
+
+    while ((c = prendre_morceau(lot, tr->id)) >= 0) {
+        //On attend qu'il y ait de la place dans le tampon de réordonnancement
+        pthread_mutex_lock(&lot->verrou);
+        while (c >= lot->ecrits + FENETRE) {
+            pthread_cond_wait(&lot->condition, &lot->verrou);
+        }
+        pthread_mutex_unlock(&lot->verrou);
+        traiter_morceau(tr, c, &ligne, prog);
+    }
+
+    mem_liberer(ligne.texte);
+    return NULL;
+}
+
+//Fonction globale de traitement par lot
+//Parametre chemin_entree : chemin du fichier de formules (une par ligne)
+//Parametre sortie : FILE où sont écrits les programmes, dans l'ordre des lignes
+//Parametre nb_threads : entier (<= 0 pour utiliser tous les processeurs)
+//Parametre statut : Statut (ERR_FICHIER ou ERR_MEMOIRE)
+//Retourne le nombre de formules traitées, -1 si le fichier ne peut pas être lu ou si la mémoire manque
+//(la sortie s'arrête alors au dernier morceau complet)
+long traiter_lot(const char *chemin_entree, FILE *sortie, int nb_threads, Statut *statut) {
+    statut_ok(statut);
+    int fd = open(chemin_entree, O_RDONLY);
+    if (fd < 0) {
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de formules impossible à ouvrir");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de formules illisible");
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    char *donnees = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (donnees == MAP_FAILED) {
+        statut_definir(statut, ERR_FICHIER, -1, "Projection du fichier de formules impossible");
+        return -1;
+    }
+    madvise(donnees, st.st_size, MADV_SEQUENTIAL);
+
+    if (nb_threads <= 0) {
+        nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (nb_threads < 1) nb_threads = 1;
+    if (nb_threads > MAX_THREADS) nb_threads = MAX_THREADS;
+
+    Lot *lot = mem_callouer(1, sizeof(Lot));
+    if (!lot) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        munmap(donnees, st.st_size);
+        return -1;
+    }
+    lot->donnees = donnees;
+    lot->taille = st.st_size;
+    lot->nb_morceaux = (long)((lot->taille + TAILLE_MORCEAU - 1) / TAILLE_MORCEAU);
+    lot->nb_threads = nb_threads;
+    pthread_mutex_init(&lot->verrou, NULL);
+    pthread_cond_init(&lot->condition, NULL);
+    for (int w = 0; w < nb_threads; w++) {
+        pthread_mutex_init(&lot->files[w].verrou, NULL);
+        lot->files[w].prochain = 0;
+        lot->files[w].fin = (lot->nb_morceaux - w + nb_threads - 1) / nb_threads;
+    }
+
+    //Les morceaux d'un thread qui n'a pas pu être créé sont volés par les autres ; si aucun n'a pu être
+    //créé, le thread principal traite chaque morceau juste avant de l'écrire
+    pthread_t threads[MAX_THREADS];
+    int lance[MAX_THREADS];
+    int nb_lances = 0;
+    Travailleur travailleurs[MAX_THREADS];
+    for (int w = 0; w < nb_threads; w++) {
+        travailleurs[w] = (Travailleur){lot, w, 0};
+        lance[w] = pthread_create(&threads[w], NULL, travailleur_lot, &travailleurs[w]) == 0;
+        nb_lances += lance[w];
+    }
+    Tampon ligne = {NULL, 0, 0, 0};
+    VMInstruction prog[PROGRAM_SIZE];
+
+    //Le thread principal écrit les résultats dans l'ordre des morceaux ; après un morceau abandonné
+    //faute de mémoire, les suivants sont encore attendus (pour libérer les threads) mais pas écrits
+    int memoire_manquante = 0;
+    for (long c = 0; c < lot->nb_morceaux; c++) {
+        int place = c % FENETRE;
+        if (nb_lances == 0) traiter_morceau(&travailleurs[0], c, &ligne, prog);
+        pthread_mutex_lock(&lot->verrou);
+        while (!lot->prets[place]) {
+            pthread_cond_wait(&lot->condition, &lot->verrou);
+        }
+        Tampon res = lot->resultats[place];
+        lot->prets[place] = 0;
+        pthread_mutex_unlock(&lot->verrou);
+
+        if (res.echec) memoire_manquante = 1;
+        if (res.taille > 0 && !memoire_manquante) {
+            fwrite(res.texte, 1, res.taille, sortie);
+        }
+        mem_liberer(res.texte);
+
+        pthread_mutex_lock(&lot->verrou);
+        lot->ecrits++;
+        pthread_cond_broadcast(&lot->condition);
+        pthread_mutex_unlock(&lot->verrou);
+    }
+
+    long nb_formules = 0;
+    for (int w = 0; w < nb_threads; w++) {
+        if (lance[w]) pthread_join(threads[w], NULL);
+        nb_formules += travailleurs[w].nb_formules;
+    }
+    mem_liberer(ligne.texte);
+    for (int w = 0; w < nb_threads; w++) {
+        pthread_mutex_destroy(&lot->files[w].verrou);
+    }
+
+    pthread_mutex_destroy(&lot->verrou);
+    pthread_cond_destroy(&lot->condition);
+    mem_liberer(lot);
+    munmap(donnees, st.st_size);
+    if (memoire_manquante) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    return nb_formules;
+}
@@ -0,0 +1,15 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+#include "erreurs.h"
+
+//Traitement par lot d'un fichier de formules (une formule par ligne) :
+//chaque ligne est analysée (lexicale, syntaxique, sémantique) puis compilée,
+//et le programme obtenu est écrit sur sortie, une ligne par formule, dans l'ordre du fichier.
+//Une formule refusée donne la ligne "ERREUR <code> <position> <message>" (codes de erreurs.h)
+//Retourne le nombre de formules traitées, ou -1 si le fichier ne peut pas être lu (statut ERR_FICHIER)
+//ou si la mémoire manque (ERR_MEMOIRE)
+long traiter_lot(const char* chemin_entree, FILE* sortie, int nb_threads, Statut* statut);
+
+#endif
@@ -0,0 +1,570 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cnf.h"
+#include "allocateur.h"
+#include "operateurs.h" //pour la table de vérité des opérateurs
+
+
+//Taille initiale de la table de hachage des propositions (puissance de 2)
+#define TAILLE_TABLE_INITIALE 64
+
+//Fonction de hachage d'une chaine (FNV-1a)
+static unsigned hacher_nom(const char *nom) {
+    unsigned h = 2166136261u;
+    for (; *nom; nom++) {
+        h = (h ^ (unsigned char)*nom) * 16777619u;
+    }
+    return h;
+}
+
+//Fonction d'initialisation de l'encodeur
+//La table de hachage est allouée à la première proposition : l'initialisation ne peut pas échouer
+//Parametre enc : EncodeurCNF
+//Parametre emettre : fonction recevant les clauses
+//Parametre donnees : pointeur transmis à emettre
+void encodeur_initialiser(EncodeurCNF *enc, EmettreClause emettre, void *donnees) {
+    memset(enc, 0, sizeof(*enc));
+    enc->emettre = emettre;
+    enc->donnees = donnees;
+}
+
+//Fonction de libération de la mémoire de l'encodeur
+void encodeur_liberer(EncodeurCNF *enc) {
+    for (int i = 0; i < enc->nb_props; i++) {
+        mem_liberer(enc->noms[i]);
+    }
+    mem_liberer(enc->noms);
+    mem_liberer(enc->variables);
+    mem_liberer(enc->table);
+    memset(enc, 0, sizeof(*enc));
+}
+
+//Case de la table où se trouve une proposition, ou case vide où la ranger
+static unsigned case_prop(const EncodeurCNF *enc, const char *nom) {
+    unsigned h = hacher_nom(nom) & (enc->taille_table - 1);
+    while (enc->table[h] && strcmp(enc->noms[enc->table[h] - 1], nom) != 0) {
+        h = (h + 1) & (enc->taille_table - 1);
+    }
+    return h;
+}
+
+//Fonction doublant la table de hachage (créée à TAILLE_TABLE_INITIALE cases)
+//Retourne 0, ou -1 si la mémoire manque (la table est alors inchangée)
+static int agrandir_table(EncodeurCNF *enc) {
+    int taille = enc->taille_table ? enc->taille_table * 2 : TAILLE_TABLE_INITIALE;
+    int *table = mem_callouer(taille, sizeof(int));
+    if (!table) return -1;
+    for (int i = 0; i < enc->nb_props; i++) {
+        unsigned h = hacher_nom(enc->noms[i]) & (taille - 1);
+        while (table[h]) {
+            h = (h + 1) & (taille - 1);
+        }
+        table[h] = i + 1;
+    }
+    mem_liberer(enc->table);
+    enc->table = table;
+    enc->taille_table = taille;
+    return 0;
+}
+
+//Fonction notant un manque de mémoire de l'encodeur
+//Retourne 0
+static int memoire_manquante_encodeur(EncodeurCNF *enc) {
+    enc->memoire_manquante = 1;
+    return 0;
+}
+
+//Fonction donnant la variable d'une proposition
+//Parametre enc : EncodeurCNF
+//Parametre nom : chaine de caracteres
+//Retourne la variable de la proposition, créée si la proposition n'a jamais été rencontrée,
+//ou 0 si la mémoire manque (l'encodeur est alors inchangé)
+int encodeur_variable_prop(EncodeurCNF *enc, const char *nom) {
+    if (enc->table) {
+        unsigned h = case_prop(enc, nom);
+        if (enc->table[h]) return enc->variables[enc->table[h] - 1];
+    }
+
+    //La table reste au plus à moitié pleine
+    if (2 * (enc->nb_props + 1) > enc->taille_table && agrandir_table(enc) < 0) {
+        return memoire_manquante_encodeur(enc);
+    }
+    if (enc->nb_props >= enc->capacite_props) {
+        int capacite = enc->capacite_props ? enc->capacite_props * 2 : 16;
+        char **noms = mem_reallouer(enc->noms, capacite * sizeof(char *));
+        if (noms) enc->noms = noms;
+        int *variables = noms ? mem_reallouer(enc->variables, capacite * sizeof(int)) : NULL;
+        if (variables) enc->variables = variables;
+        if (!noms || !variables) return memoire_manquante_encodeur(enc);
+        enc->capacite_props = capacite;
+    }
+    char *copie = mem_dupliquer(nom);
+    if (!copie) return memoire_manquante_encodeur(enc);
+    unsigned h = case_prop(enc, nom);
+    enc->noms[enc->nb_props] = copie;
+    enc->variables[enc->nb_props] = ++enc->nb_variables;
+    enc->table[h] = ++enc->nb_props;
+    return enc->nb_variables;
+}
+
+//Fonction émettant une clause
+void encodeur_clause(EncodeurCNF *enc, const int *litteraux, int n) {
+    enc->nb_clauses++;
+    if (enc->emettre) {
+        enc->emettre(litteraux, n, enc->donnees);
+    }
+}
+
+//Fonction émettant une clause de 2 ou 3 littéraux (c = 0 pour une clause de 2 littéraux)
+static void clause3(EncodeurCNF *enc, int a, int b, int c) {
+    int litteraux[3] = {a, b, c};
+    encodeur_clause(enc, litteraux, c ? 3 : 2);
+}
+
+//Fonction définissant la variable auxiliaire x d'un opérateur binaire d'opérandes a et b
+//Les clauses de x ⇒ (a op b) sont utiles quand le noeud est en polarité positive,
+//celles de (a op b) ⇒ x en polarité négative ; l'encodage complet émet les deux
+//Parametre polarite : 1 (positive), -1 (négative) ou 0 (les deux, sous un ⇔ ou un ⊕)
+static void definir_operateur(EncodeurCNF *enc, NodeType type, int x, int a, int b, int polarite) {
+    int positif = !enc->selon_polarite || polarite >= 0;
+    int negatif = !enc->selon_polarite || polarite <= 0;
+    switch (type) {
+        case NODE_AND: //x ⇔ (a ∧ b)
+            if (positif) {
+                clause3(enc, -x, a, 0);
+                clause3(enc, -x, b, 0);
+            }
+            if (negatif) clause3(enc, x, -a, -b);
+            break;
+        case NODE_OR: //x ⇔ (a ∨ b)
+            if (positif) clause3(enc, -x, a, b);
+            if (negatif) {
+                clause3(enc, x, -a, 0);
+                clause3(enc, x, -b, 0);
+            }
+            break;
+        case NODE_IMP:
+        case NODE_PROD: //x ⇔ (¬a ∨ b)
+            if (positif) clause3(enc, -x, -a, b);
+            if (negatif) {
+                clause3(enc, x, a, 0);
+                clause3(enc, x, -b, 0);
+            }
+            break;
+        default: {
+            //Autres opérateurs : une clause par ligne de la table de vérité,
+            //(a = va ∧ b = vb) ⇒ (x = a op b)
+            const Operateur *op = operateur_noeud(type);
+            if (!op || op->arite != 2) break;
+            for (int va = 0; va <= 1; va++) {
+                for (int vb = 0; vb <= 1; vb++) {
+                    int r = valeur_table(op->table, va, vb);
+                    if (r ? negatif : positif) clause3(enc, r ? x : -x, va ? -a : a, vb ? -b : b);
+                }
+            }
+            break;
+        }
+    }
+}
+
+//Polarité d'un opérande, d'après la table de vérité de l'opérateur
+//Parametre cote : 0 (opérande gauche) ou 1 (opérande droit, seul opérande de la négation)
+//Retourne 1 si l'opérateur est croissant en cet opérande, -1 s'il est décroissant, 0 sinon (⇔, ⊕)
+static int polarite_operande(NodeType type, int cote) {
+    const Operateur *op = operateur_noeud(type);
+    if (!op || op->arite == 0) return 1;
+    int croissant = 1, decroissant = 1;
+    for (int v = 0; v <= 1; v++) {
+        int f0 = cote ? valeur_table(op->table, v, 0) : valeur_table(op->table, 0, v);
+        int f1 = cote ? valeur_table(op->table, v, 1) : valeur_table(op->table, 1, v);
+        if (f0 > f1) croissant = 0;
+        if (f0 < f1) decroissant = 0;
+    }
+    return croissant ? 1 : (decroissant ? -1 : 0);
+}
+
+//Elément de la pile de parcours : un noeud, sa polarité et l'étape de son traitement
+//(0 : enfant gauche à visiter, 1 : enfant droit à visiter, 2 : noeud à encoder)
+typedef struct {
+    ASTNode *noeud;
+    int polarite;
+    int etape;
+} EtapeParcours;
+
+//Fonction d'encodage d'une formule
+//Le parcours postfixe est fait avec une pile explicite : la profondeur de l'arbre n'est pas limitée
+//par la pile d'appels, et le temps comme la mémoire restent linéaires en la taille de l'arbre
+//Parametre enc : EncodeurCNF
+//Parametre ast : ASTNode
+//Retourne le littéral représentant la formule, 0 si l'arbre est invalide ou si la mémoire manque
+//(enc->memoire_manquante vaut alors 1)
+int encoder_formule(EncodeurCNF *enc, ASTNode *ast) {
+    enc->memoire_manquante = 0;
+    if (ast == NULL) return 0;
+
+    int capacite = 64;
+    EtapeParcours *pile = mem_allouer(capacite * sizeof(EtapeParcours));
+    int *valeurs = mem_allouer(capacite * sizeof(int));
+    int sommet = 0, nb_valeurs = 0;
+    if (!pile || !valeurs) {
+        mem_liberer(pile);
+        mem_liberer(valeurs);
+        return memoire_manquante_encodeur(enc);
+    }
+    pile[sommet++] = (EtapeParcours){ast, 1, 0};
+
+    while (sommet > 0) {
+        EtapeParcours *e = &pile[sommet - 1];
+        if (e->etape < 2) {
+            ASTNode *enfant = (e->etape == 0) ? e->noeud->left : e->noeud->right;
+            //La négation et la partie gauche d'une implication inversent la polarité,
+            //les opérandes de ⇔ et ⊕ ont les deux polarités
+            int polarite = polarite_operande(e->noeud->type, e->etape) * e->polarite;
+            e->etape++;
+            if (enfant) {
+                if (sommet >= capacite) {
+                    EtapeParcours *p = mem_reallouer(pile, 2 * capacite * sizeof(EtapeParcours));
+                    if (p) pile = p;
+                    int *v = p ? mem_reallouer(valeurs, 2 * capacite * sizeof(int)) : NULL;
+                    if (v) valeurs = v;
+                    if (!p || !v) {
+                        memoire_manquante_encodeur(enc);
+                        break;
+                    }
+                    capacite *= 2;
+                }
+                pile[sommet++] = (EtapeParcours){enfant, polarite, 0};
+            }
+            continue;
+        }
+
+        //Les deux enfants sont encodés : leurs littéraux sont au sommet de la pile des valeurs
+        ASTNode *n = e->noeud;
+        int polarite = e->polarite;
+        sommet--;
+        int litteral;
+        if (n->type == NODE_PROP) {
+            litteral = encodeur_variable_prop(enc, n->value);
+            if (litteral == 0) break;
+        } else if (n->type == NODE_NOT) {
+            if (nb_valeurs < 1) break;
+            litteral = -valeurs[--nb_valeurs]; //La négation ne demande pas de variable auxiliaire
+        } else {
+            if (nb_valeurs < 2) break;
+            int b = valeurs[--nb_valeurs];
+            int a = valeurs[--nb_valeurs];
+            litteral = ++enc->nb_variables;
+            definir_operateur(enc, n->type, litteral, a, b, polarite);
+        }
+        valeurs[nb_valeurs++] = litteral;
+    }
+
+    int resultat = (sommet == 0 && nb_valeurs == 1) ? valeurs[0] : 0;
+    mem_liberer(pile);
+    mem_liberer(valeurs);
+    return resultat;
+}
+
+
+// ----------------------
+/*
+Export DIMACS :
+   Les clauses sont écrites au fil de l'encodage dans un tampon de sortie.
+   L'en-tête "p cnf V C" doit précéder les clauses : un premier encodage sans sortie compte V et C,
+   ce qui permet d'écrire aussi dans un tube (pas de retour en arrière dans le fichier).
+*/
+// ----------------------
+
+#define TAILLE_TAMPON_DIMACS (1 << 16)
+
+//Tampon d'écriture des clauses
+typedef struct {
+    FILE *sortie;
+    char tampon[TAILLE_TAMPON_DIMACS];
+    int pos;
+} EcrivainDimacs;
+
+//Fonction recevant une clause de l'encodeur et l'écrivant au format DIMACS ("1 -2 3 0")
+static void ecrire_clause_dimacs(const int *litteraux, int n, void *donnees) {
+    EcrivainDimacs *e = donnees;
+    //Au plus 12 caractères par littéral, plus le 0 final et la fin de ligne
+    if (e->pos + 12 * (n + 1) > TAILLE_TAMPON_DIMACS) {
+        fwrite(e->tampon, 1, e->pos, e->sortie);
+        e->pos = 0;
+    }
+    for (int i = 0; i <= n; i++) {
+        int l = (i < n) ? litteraux[i] : 0;
+        if (l < 0) {
+            e->tampon[e->pos++] = '-';
+            l = -l;
+        }
+        char chiffres[12];
+        int k = 0;
+        do {
+            chiffres[k++] = '0' + l % 10;
+            l /= 10;
+        } while (l > 0);
+        while (k > 0) {
+            e->tampon[e->pos++] = chiffres[--k];
+        }
+        e->tampon[e->pos++] = (i < n) ? ' ' : '\n';
+    }
+}
+
+//Fonction d'export d'une formule au format DIMACS
+//Parametre ast : ASTNode
+//Parametre sortie : FILE
+//Parametre selon_polarite : 1 pour l'encodage selon la polarité (moins de clauses), 0 pour l'encodage complet
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre de clauses écrites, -1 si l'arbre est invalide ou si la mémoire manque
+//Les lignes de commentaire "c <variable> <proposition>" donnent la variable de chaque proposition
+long exporter_dimacs(ASTNode *ast, FILE *sortie, int selon_polarite, Statut *statut) {
+    statut_ok(statut);
+    //Premier parcours : comptage des variables et des clauses
+    EncodeurCNF enc;
+    encodeur_initialiser(&enc, NULL, NULL);
+    enc.selon_polarite = selon_polarite;
+    if (encoder_formule(&enc, ast) == 0) {
+        if (enc.memoire_manquante) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        else statut_definir(statut, ERR_ARITE, -1, "Arbre invalide");
+        encodeur_liberer(&enc);
+        return -1;
+    }
+    int nb_variables = enc.nb_variables;
+    long nb_clauses = enc.nb_clauses + 1; //Plus la clause unitaire qui affirme la formule
+    for (int i = 0; i < enc.nb_props; i++) {
+        fprintf(sortie, "c %d %s\n", enc.variables[i], enc.noms[i]);
+    }
+    fprintf(sortie, "p cnf %d %ld\n", nb_variables, nb_clauses);
+    encodeur_liberer(&enc);
+
+    //Second parcours : les variables sont numérotées dans le même ordre, les clauses sont écrites
+    //(si la mémoire manque, la sortie s'arrête avant la clause qui affirme la formule)
+    EcrivainDimacs *e = mem_allouer(sizeof(EcrivainDimacs));
+    if (!e) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    e->sortie = sortie;
+    e->pos = 0;
+    encodeur_initialiser(&enc, ecrire_clause_dimacs, e);
+    enc.selon_polarite = selon_polarite;
+    int racine = encoder_formule(&enc, ast);
+    if (racine != 0) encodeur_clause(&enc, &racine, 1);
+    fwrite(e->tampon, 1, e->pos, sortie);
+
+    long ecrites = racine != 0 ? enc.nb_clauses : -1;
+    if (racine == 0) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    encodeur_liberer(&enc);
+    mem_liberer(e);
+    return ecrites;
+}
+
+
+// ----------------------
+/*
+Forme normale disjonctive :
+   Développement direct, les négations étant poussées vers les propositions au fil du parcours
+   (polarité). Le nombre de termes pouvant croître exponentiellement, on s'arrête dès qu'une
+   étape dépasse max_termes : cette expansion est réservée aux petites formules.
+*/
+// ----------------------
+
+//Fonction notant un manque de mémoire pendant le développement
+//Retourne -1
+static int memoire_manquante_fnd(Statut *statut) {
+    statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    return -1;
+}
+
+//Ajoute un terme (littéraux triés, sans doublon) à une FND
+//Retourne 0, ou -1 si la mémoire manque (la FND est alors inchangée)
+static int fnd_ajouter_terme(FormeDisjonctive *f, const int *litteraux, int n, int *capacite, Statut *statut) {
+    int total = f->debut[f->nb_termes];
+    if (total + n > *capacite) {
+        int *nouveaux = mem_reallouer(f->litteraux, 2 * (*capacite + n) * sizeof(int));
+        if (!nouveaux) return memoire_manquante_fnd(statut);
+        f->litteraux = nouveaux;
+        *capacite = 2 * (*capacite + n);
+    }
+    memcpy(&f->litteraux[total], litteraux, n * sizeof(int));
+    f->nb_termes++;
+    f->debut[f->nb_termes] = total + n;
+    return 0;
+}
+
+//FND vide pouvant contenir max_termes termes
+//Retourne 0, ou -1 si la mémoire manque (la FND peut tout de même être libérée)
+static int fnd_creer(FormeDisjonctive *f, int max_termes, Statut *statut) {
+    f->nb_termes = 0;
+    f->debut = mem_allouer((max_termes + 1) * sizeof(int));
+    f->litteraux = NULL;
+    if (!f->debut) return memoire_manquante_fnd(statut);
+    f->debut[0] = 0;
+    return 0;
+}
+
+//Comparaison de littéraux par variable (pour trier les termes)
+static int comparer_litteraux(const void *a, const void *b) {
+    int x = abs(*(const int *)a), y = abs(*(const int *)b);
+    return (x > y) - (x < y);
+}
+
+//Ajoute à res les termes de a puis ceux de b
+//Retourne 0, ou -1 si res dépasse max_termes termes ou si la mémoire manque
+static int fnd_union(const FormeDisjonctive *a, const FormeDisjonctive *b, int max_termes,
+                     FormeDisjonctive *res, int *capacite, Statut *statut) {
+    if (res->nb_termes + a->nb_termes + b->nb_termes > max_termes) return -1;
+    for (int i = 0; i < a->nb_termes; i++) {
+        if (fnd_ajouter_terme(res, &a->litteraux[a->debut[i]], a->debut[i + 1] - a->debut[i], capacite,
+                              statut) < 0) return -1;
+    }
+    for (int i = 0; i < b->nb_termes; i++) {
+        if (fnd_ajouter_terme(res, &b->litteraux[b->debut[i]], b->debut[i + 1] - b->debut[i], capacite,
+                              statut) < 0) return -1;
+    }
+    return 0;
+}
+
+//Ajoute à res le produit de a et b : chaque terme de a est combiné avec chaque terme de b,
+//les termes contradictoires (x ∧ ¬x) disparaissent
+//Retourne 0, ou -1 si res dépasse max_termes termes ou si la mémoire manque
+static int fnd_produit(const FormeDisjonctive *a, const FormeDisjonctive *b, int max_termes,
+                       FormeDisjonctive *res, int *capacite, Statut *statut) {
+    int erreur = 0;
+    int *terme = mem_allouer((a->debut[a->nb_termes] + b->debut[b->nb_termes] + 1) * sizeof(int));
+    if (!terme) return memoire_manquante_fnd(statut);
+    for (int i = 0; i < a->nb_termes && !erreur; i++) {
+        for (int j = 0; j < b->nb_termes && !erreur; j++) {
+            int k = 0, contradiction = 0;
+            for (int x = a->debut[i]; x < a->debut[i + 1]; x++) terme[k++] = a->litteraux[x];
+            for (int x = b->debut[j]; x < b->debut[j + 1]; x++) terme[k++] = b->litteraux[x];
+            qsort(terme, k, sizeof(int), comparer_litteraux);
+            int m = 0;
+            for (int x = 0; x < k; x++) {
+                if (m > 0 && terme[m - 1] == terme[x]) continue;
+                if (m > 0 && terme[m - 1] == -terme[x]) contradiction = 1;
+                terme[m++] = terme[x];
+            }
+            if (contradiction) continue;
+            if (res->nb_termes >= max_termes) erreur = -1;
+            else erreur = fnd_ajouter_terme(res, terme, m, capacite, statut);
+        }
+    }
+    mem_liberer(terme);
+    return erreur;
+}
+
+//Fonction récursive de développement
+//Parametre positif : 1 si le noeud est sous un nombre pair de négations
+//Retourne 0, ou -1 si la limite de termes est dépassée ou si la mémoire manque
+static int developper(EncodeurCNF *enc, ASTNode *n, int positif, int max_termes, FormeDisjonctive *res,
+                      Statut *statut) {
+    if (fnd_creer(res, max_termes, statut) < 0 || n == NULL) return -1;
+
+    int capacite = 0;
+    if (n->type == NODE_PROP) {
+        int v = encodeur_variable_prop(enc, n->value);
+        if (v == 0) return memoire_manquante_fnd(statut);
+        int l = positif ? v : -v;
+        return fnd_ajouter_terme(res, &l, 1, &capacite, statut);
+    }
+    if (n->type == NODE_NOT) {
+        liberer_fnd(res);
+        return developper(enc, n->right, !positif, max_termes, res, statut);
+    }
+
+    //Lignes de la table de vérité où le noeud vaut positif : une seule ligne donne un produit
+    //(a ∧ b, ¬(a ∨ b), ¬(a ⇒ b) = a ∧ ¬b), trois lignes une union (a ∨ b, a ⇒ b = ¬a ∨ b, ¬(a ∧ b)),
+    //deux lignes (⇔, ⊕) l'union de deux produits
+    const Operateur *op = operateur_noeud(n->type);
+    if (!op || op->arite != 2) return -1;
+    int lignes[4], nb_lignes = 0, autre = 0;
+    for (int l = 0; l < 4; l++) {
+        if (valeur_table(op->table, l >> 1, l & 1) == positif) lignes[nb_lignes++] = l;
+        else autre = l;
+    }
+
+    //a[v], b[v] : développement de l'opérande quand il vaut v (calculé au plus une fois)
+    FormeDisjonctive a[2], b[2];
+    int a_pret[2] = {0, 0}, b_pret[2] = {0, 0};
+    int erreur = 0;
+    if (nb_lignes == 3) {
+        int va = !(autre >> 1), vb = !(autre & 1);
+        a_pret[va] = 1;
+        erreur = developper(enc, n->left, va, max_termes, &a[va], statut);
+        if (!erreur) {
+            b_pret[vb] = 1;
+            erreur = developper(enc, n->right, vb, max_termes, &b[vb], statut);
+        }
+        if (!erreur) erreur = fnd_union(&a[va], &b[vb], max_termes, res, &capacite, statut);
+    } else {
+        for (int k = 0; k < nb_lignes && !erreur; k++) {
+            int va = lignes[k] >> 1, vb = lignes[k] & 1;
+            if (!a_pret[va]) {
+                a_pret[va] = 1;
+                erreur = developper(enc, n->left, va, max_termes, &a[va], statut);
+            }
+            if (!erreur && !b_pret[vb]) {
+                b_pret[vb] = 1;
+                erreur = developper(enc, n->right, vb, max_termes, &b[vb], statut);
+            }
+            if (!erreur) erreur = fnd_produit(&a[va], &b[vb], max_termes, res, &capacite, statut);
+        }
+    }
+
+    for (int v = 0; v <= 1; v++) {
+        if (a_pret[v]) liberer_fnd(&a[v]);
+        if (b_pret[v]) liberer_fnd(&b[v]);
+    }
+    return erreur;
+}
+
+//Fonction de développement en forme normale disjonctive
+//Parametre enc : EncodeurCNF, donne la variable de chaque proposition
+//Parametre ast : ASTNode
+//Parametre max_termes : entier, nombre maximal de termes
+//Parametre fnd : FormeDisjonctive (à libérer avec liberer_fnd, même en cas d'échec)
+//Parametre statut : Statut, rempli si la mémoire manque (peut être NULL)
+//Retourne le nombre de termes, -1 si la limite est dépassée, si l'arbre est invalide ou si la mémoire manque
+int expansion_fnd(EncodeurCNF *enc, ASTNode *ast, int max_termes, FormeDisjonctive *fnd, Statut *statut) {
+    statut_ok(statut);
+    if (developper(enc, ast, 1, max_termes, fnd, statut) < 0) {
+        return -1;
+    }
+    return fnd->nb_termes;
+}
+
+//Fonction d'écriture d'une FND
+void ecrire_fnd(const EncodeurCNF *enc, const FormeDisjonctive *fnd, FILE *sortie) {
+    if (fnd->nb_termes == 0) {
+        fprintf(sortie, "FAUX\n");
+        return;
+    }
+    for (int i = 0; i < fnd->nb_termes; i++) {
+        int n = fnd->debut[i + 1] - fnd->debut[i];
+        fprintf(sortie, "%s%s", i ? "∨" : "", n > 1 ? "(" : "");
+        for (int x = fnd->debut[i]; x < fnd->debut[i + 1]; x++) {
+            int l = fnd->litteraux[x];
+            const char *nom = "?";
+            for (int k = 0; k < enc->nb_props; k++) {
+                if (enc->variables[k] == abs(l)) nom = enc->noms[k];
+            }
+            fprintf(sortie, "%s%s%s", x > fnd->debut[i] ? "∧" : "", l < 0 ? "¬" : "", nom);
+        }
+        if (n == 0) fprintf(sortie, "VRAI");
+        fprintf(sortie, "%s", n > 1 ? ")" : "");
+    }
+    fprintf(sortie, "\n");
+}
+
+//Fonction de libération d'une FND
+void liberer_fnd(FormeDisjonctive *fnd) {
+    mem_liberer(fnd->debut);
+    mem_liberer(fnd->litteraux);
+    fnd->debut = NULL;
+    fnd->litteraux = NULL;
+    fnd->nb_termes = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef CNF_H
+#define CNF_H
+
+#include <stdio.h>
+#include "anasynt.h" //pour les arbres syntaxiques
+#include "erreurs.h"
+
+//Fonction recevant chaque clause produite par l'encodeur (littéraux au format DIMACS : v ou -v)
+typedef void (*EmettreClause)(const int* litteraux, int n, void* donnees);
+
+//Encodeur de Tseitin : chaque opérateur reçoit une variable auxiliaire définie par quelques clauses,
+//les propositions gardent la même variable d'une formule à l'autre
+typedef struct {
+    char** noms;            //Noms des propositions rencontrées
+    int* variables;         //Variable de chaque proposition
+    int nb_props;
+    int capacite_props;
+    int* table;             //Table de hachage : indice dans noms + 1, 0 si la case est vide (allouée à la
+    int taille_table;       //première proposition)
+
+    int selon_polarite;     //1 : seules les clauses utiles à la polarité de chaque noeud sont émises
+                            //(Plaisted-Greenbaum, équisatisfiable), 0 : encodage complet (équivalence)
+    int nb_variables;       //Dernière variable utilisée (propositions et auxiliaires)
+    long nb_clauses;        //Nombre de clauses émises
+    EmettreClause emettre;
+    void* donnees;          //Pointeur transmis à emettre
+    int memoire_manquante;  //1 si le dernier encodage a échoué faute de mémoire
+} EncodeurCNF;
+
+//Initialisation et libération d'un encodeur
+void encodeur_initialiser(EncodeurCNF* enc, EmettreClause emettre, void* donnees);
+void encodeur_liberer(EncodeurCNF* enc);
+
+//Variable d'une proposition (créée à la première rencontre), 0 si la mémoire manque
+int encodeur_variable_prop(EncodeurCNF* enc, const char* nom);
+
+//Encode une formule et retourne le littéral qui la représente (la formule n'est pas affirmée),
+//0 si l'arbre est invalide ou si la mémoire manque (memoire_manquante vaut alors 1)
+int encoder_formule(EncodeurCNF* enc, ASTNode* ast);
+
+//Emet une clause (appelle la fonction emettre de l'encodeur)
+void encodeur_clause(EncodeurCNF* enc, const int* litteraux, int n);
+
+//Ecrit la FNC de la formule au format DIMACS, clause par clause, sans garder les clauses en mémoire
+//(deux parcours de l'arbre : le premier compte les variables et les clauses de l'en-tête)
+//Retourne le nombre de clauses écrites, -1 si l'arbre est invalide ou si la mémoire manque (statut
+//est alors rempli, peut être NULL)
+long exporter_dimacs(ASTNode* ast, FILE* sortie, int selon_polarite, Statut* statut);
+
+//Forme normale disjonctive : le terme i est la conjonction des littéraux
+//litteraux[debut[i] .. debut[i + 1] - 1] (variables des propositions de l'encodeur)
+typedef struct {
+    int nb_termes;
+    int* debut;
+    int* litteraux;
+} FormeDisjonctive;
+
+//Développe la formule en FND si elle a au plus max_termes termes à chaque étape
+//Retourne le nombre de termes, -1 si la limite est dépassée, l'arbre invalide ou la mémoire manquante
+//(statut est rempli dans ce dernier cas, peut être NULL)
+int expansion_fnd(EncodeurCNF* enc, ASTNode* ast, int max_termes, FormeDisjonctive* fnd, Statut* statut);
+
+//Ecrit une FND avec les opérateurs de la grammaire, par exemple (p1∧¬p2)∨p3
+void ecrire_fnd(const EncodeurCNF* enc, const FormeDisjonctive* fnd, FILE* sortie);
+
+//Libère la mémoire d'une FND
+void liberer_fnd(FormeDisjonctive* fnd);
+
+#endif
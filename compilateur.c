@@ -2,6 +2,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include "compilateur.h"
+#include "anasem.h" //pour indice_prop
+#include "operateurs.h" //pour la table des opérateurs
 
 //Structure d'une entrée dans la table des symboles
 typedef struct {
@@ -47,16 +49,36 @@ void Implique(ASTNode *left, ASTNode *right) {
     printf("Effectuer IMPLIQUE entre '%s' et '%s'\n", left->value, right->value);
 }
 
+//Opérateur EQUIVALENT
+void Equivalent(ASTNode *left, ASTNode *right) {
+    printf("Effectuer EQUIVALENT entre '%s' et '%s'\n", left->value, right->value);
+}
+
+//Opérateur OU exclusif
+void OuExclusif(ASTNode *left, ASTNode *right) {
+    printf("Effectuer OU_EXCLUSIF entre '%s' et '%s'\n", left->value, right->value);
+}
+
+//Opérateur NON ET
+void NonEt(ASTNode *left, ASTNode *right) {
+    printf("Effectuer NON_ET entre '%s' et '%s'\n", left->value, right->value);
+}
+
+//Opérateur NON OU
+void NonOu(ASTNode *left, ASTNode *right) {
+    printf("Effectuer NON_OU entre '%s' et '%s'\n", left->value, right->value);
+}
+
 //Fonction pour ajouter une entrée à la table des symboles
 //Parametre name : chaine de caracteres
 //Parametre num_params : entier
 //Parametre func : fonction void
-void add_symbol(const char *name, int num_params, void (*func)(ASTNode *, ASTNode *)) {
+//Retourne ERR_AUCUNE, ou ERR_TABLE_PLEINE si la table des symboles est pleine
+int add_symbol(const char *name, int num_params, void (*func)(ASTNode *, ASTNode *)) {
 
     //Vérification de la capacité de la table des symboles
     if (symbol_table_count >= SYMBOL_TABLE_SIZE) {
-        fprintf(stderr, "Erreur: La table des symboles est pleine.\n");
-        exit(EXIT_FAILURE);
+        return ERR_TABLE_PLEINE;
     }
 
     //Copie du nom du symbole
@@ -80,14 +102,21 @@ void add_symbol(const char *name, int num_params, void (*func)(ASTNode *, ASTNod
 
     //Compteur
     symbol_table_count++;
+    return ERR_AUCUNE;
 }
 
 // Fonction pour initialiser la table des symboles avec les opérateurs logiques
+//Les noms et les arités viennent de la table des opérateurs (le produit → s'exécute comme IMPLIQUE)
 void initialize_symbol_table() {
-    add_symbol("ET", 2, Et);
-    add_symbol("NON", 1, Non);
-    add_symbol("OU", 2, Ou);
-    add_symbol("IMPLIQUE", 2, Implique);
+    static void (*const fonctions[NB_TYPES_NOEUDS])(ASTNode *, ASTNode *) = {
+        [NODE_AND] = Et, [NODE_NOT] = Non, [NODE_OR] = Ou, [NODE_IMP] = Implique, [NODE_PROD] = Implique,
+        [NODE_EQUIV] = Equivalent, [NODE_XOR] = OuExclusif, [NODE_NAND] = NonEt, [NODE_NOR] = NonOu
+    };
+    for (int t = 0; t < NB_TYPES_NOEUDS; t++) {
+        if (operateurs[t].arite > 0) {
+            add_symbol(operateurs[t].nom, operateurs[t].arite, fonctions[t]);
+        }
+    }
 }
 
 //Fonction pour initialiser la machine virtuelle
@@ -115,3 +144,73 @@ int find_symbol(const char *name) {
     }
     return -1; //Symbole non trouvé
 }
+
+
+//Fonction récursive de génération du code : parcours postfixe de l'arbre
+//(les opérandes sont empilés avant l'opérateur)
+//Parametre node : ASTNode
+//Parametre prog : tableau d'instructions
+//Parametre capacite : entier
+//Parametre n : nombre d'instructions déjà générées
+//Parametre statut : Statut (peut être NULL)
+//Retourne le nouveau nombre d'instructions, ou -1 en cas d'erreur
+static int generer_code(ASTNode* node, VMInstruction* prog, int capacite, int n, Statut* statut) {
+    if (node == NULL || n < 0) return n;
+
+    n = generer_code(node->left, prog, capacite, n, statut);
+    n = generer_code(node->right, prog, capacite, n, statut);
+    if (n < 0) return -1;
+    if (n >= capacite) {
+        statut_definir(statut, ERR_PROGRAMME_PLEIN, n, "Programme trop long");
+        return -1;
+    }
+
+    const Operateur *op = operateur_noeud(node->type);
+    if (!op) {
+        statut_definir(statut, ERR_NOEUD_INCONNU, n, "Type de noeud inconnu");
+        return -1;
+    }
+    if (node->type == NODE_PROP) {
+        int indice = indice_prop(node->value);
+        if (indice < 0) {
+            statut_definir(statut, ERR_PROP_INVALIDE, n, "Proposition invalide");
+            return -1;
+        }
+        prog[n] = (VMInstruction){VM_LOAD, indice};
+    } else {
+        //Une instruction par opérateur (le produit → s'évalue comme une implication)
+        prog[n] = (VMInstruction){op->opcode, 0};
+    }
+    return n + 1;
+}
+
+//Fonction de compilation d'un arbre syntaxique (déjà vérifié par l'analyse sémantique)
+//Parametre ast : ASTNode
+//Parametre prog : tableau d'instructions
+//Parametre capacite : entier, taille du tableau
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre d'instructions générées, ou -1 en cas d'erreur
+//Cette fonction n'utilise pas de variable globale : elle peut être appelée depuis plusieurs threads
+int compiler_programme(ASTNode* ast, VMInstruction* prog, int capacite, Statut* statut) {
+    return generer_code(ast, prog, capacite, 0, statut);
+}
+
+//Fonction de compilation vers le programme de la machine virtuelle
+//Parametre ast : ASTNode
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Ajoute les instructions au programme de runtime.c, le résultat reste au sommet de la pile
+//Retourne 0, ou -1 en cas d'erreur
+int compiler_proposition(ASTNode* ast, Statut* statut) {
+    VMInstruction prog[PROGRAM_SIZE];
+    int n = compiler_programme(ast, prog, PROGRAM_SIZE, statut);
+    if (n < 0) {
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        if (add_instruction(prog[i].opcode, prog[i].operand) != ERR_AUCUNE) {
+            statut_definir(statut, ERR_PROGRAMME_PLEIN, i, "Programme trop long");
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -2,8 +2,19 @@
 #define COMPILATEUR_H
 
 #include "anasynt.h" //pour les fonctions liées aux arbres syntaxiques uniquement
+#include "runtime.h" //pour les instructions de la machine virtuelle
 
-void compiler_proposition(ASTNode* ast);
+//Initialisation de la table des symboles et de la machine virtuelle (une seule fois par processus)
+void initialize_symbol_table(void);
+void initialize_virtual_machine(void);
+
+//Compile un arbre syntaxique dans un tableau d'instructions fourni par l'appelant
+//Retourne le nombre d'instructions, ou -1 si le tableau est trop petit ou une proposition invalide
+int compiler_programme(ASTNode* ast, VMInstruction* prog, int capacite, Statut* statut);
+
+//Compile un arbre syntaxique dans le programme de la machine virtuelle (runtime.c)
+//Retourne 0, ou -1 en cas d'erreur
+int compiler_proposition(ASTNode* ast, Statut* statut);
 
 #endif
 
@@ -0,0 +1,496 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "decoupage.h"
+#include "frontal.h"    //Pour analyser_segment_profondeur et analyser_formule
+#include "analex.h"     //Pour avancer_espaces
+#include "operateurs.h" //Pour les symboles, précédences et associativités des opérateurs
+#include "allocateur.h" //Pour les arènes des threads
+
+
+//Taille minimale d'un morceau parcouru par un thread (octets)
+#define TAILLE_MORCEAU_MIN (64 * 1024)
+
+//Découpages imbriqués au-delà desquels un opérande est analysé d'un seul tenant
+#define NIVEAUX_DECOUPAGE_MAX 64
+
+//Etat d'une analyse parallèle
+typedef struct {
+    const char *chaine;
+    ArbrePlat *arbre;                   //Arbre final
+    int nb_threads;
+    int taille_segment;                 //Opérandes analysés d'un seul tenant (au moins une part de la formule par thread)
+    RapportDecoupage rapport;
+} Decoupage;
+
+//Opérateurs de coupure d'un segment : l'opérande i va de la fin de l'opérateur i - 1 au début de l'opérateur i
+typedef struct {
+    int debut;
+    int fin;
+    int profondeur;                     //Imbrication autour du segment
+    long nb;                            //Nombre d'opérateurs (nb + 1 opérandes)
+    int *positions;
+    uint8_t *types;                     //NodeType de chaque opérateur
+    Associativite associativite;
+} Coupures;
+
+//Parcours d'un morceau du segment par un thread
+typedef struct {
+    const char *chaine;
+    int debut;
+    int fin;
+    int fin_segment;
+    int profondeur;                     //Variation dans le morceau, puis profondeur au début du morceau
+    int minimum;                        //Plus faible profondeur atteinte, relative au début du morceau
+    int precedence;                     //Plus faible précédence des opérateurs hors parenthèses (INT_MAX : aucun)
+    int *positions;                     //Opérateurs de cette précédence
+    uint8_t *types;
+    long nb;
+    long capacite;
+    int erreur;
+    AllocateurArene *arene;
+} MorceauDecoupage;
+
+//Analyse d'opérandes consécutifs par un thread
+typedef struct {
+    const Decoupage *d;
+    const Coupures *c;
+    int niveau;
+    long premier;                       //Opérandes [premier, dernier)
+    long dernier;
+    uint32_t *fins;                     //Fin des noeuds de chaque opérande dans arbre
+    ArbrePlat arbre;
+    long segments;
+    int erreur;
+    AllocateurArene *arene;
+} AnalyseOperandes;
+
+
+// ----------------------
+/*
+Threads
+*/
+// ----------------------
+
+//Fonction exécutant fonction sur nb travaux de taille octets : le premier dans le thread appelant,
+//les autres dans de nouveaux threads (un thread qui n'a pas pu être créé laisse son travail à l'appelant)
+static void lancer_threads_decoupage(int nb, void *(*fonction)(void *), void *travaux, size_t taille) {
+    pthread_t threads[MAX_THREADS_DECOUPAGE];
+    int lance[MAX_THREADS_DECOUPAGE];
+    char *t = travaux;
+    for (int k = 1; k < nb; k++) {
+        lance[k] = pthread_create(&threads[k], NULL, fonction, t + k * taille) == 0;
+    }
+    fonction(t);
+    for (int k = 1; k < nb; k++) {
+        if (lance[k]) pthread_join(threads[k], NULL);
+        else fonction(t + k * taille);
+    }
+}
+
+
+// ----------------------
+/*
+Relevé des opérateurs de coupure
+   Passage 1 : variation de la profondeur des parenthèses de chaque morceau (en parallèle).
+   Somme préfixe : profondeur au début de chaque morceau (une valeur par morceau).
+   Passage 2 : opérateurs binaires à la profondeur 0, de la plus faible précédence (en parallèle).
+   Les morceaux ne commencent jamais au milieu d'un symbole UTF-8 ; les parenthèses sont des octets
+   ASCII qui n'apparaissent dans aucun autre lexème.
+*/
+// ----------------------
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+//Profondeurs relatives après chacun des 16 octets de v (somme préfixe en 4 décalages)
+static __m128i prefixe_parentheses_16(__m128i v) {
+    __m128i p = _mm_sub_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(')')), _mm_cmpeq_epi8(v, _mm_set1_epi8('(')));
+    p = _mm_add_epi8(p, _mm_slli_si128(p, 1));
+    p = _mm_add_epi8(p, _mm_slli_si128(p, 2));
+    p = _mm_add_epi8(p, _mm_slli_si128(p, 4));
+    return _mm_add_epi8(p, _mm_slli_si128(p, 8));
+}
+
+//Dernière profondeur d'un préfixe (variation sur les 16 octets)
+static int variation_16(__m128i p) {
+    return (signed char)(_mm_extract_epi16(p, 7) >> 8);
+}
+
+//Plus faible profondeur d'un préfixe (ordre signé ramené à l'ordre non signé)
+static int minimum_16(__m128i p) {
+    __m128i m = _mm_xor_si128(p, _mm_set1_epi8((char)0x80));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 8));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 4));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 2));
+    m = _mm_min_epu8(m, _mm_srli_si128(m, 1));
+    return (signed char)((_mm_cvtsi128_si32(m) & 0xFF) ^ 0x80);
+}
+#endif
+
+static void *variation_morceau(void *arg) {
+    MorceauDecoupage *m = arg;
+    const char *c = m->chaine;
+    int profondeur = 0, minimum = 0;
+    int i = m->debut;
+#if defined(__SSE2__)
+    for (; i + 16 <= m->fin; i += 16) {
+        __m128i p = prefixe_parentheses_16(_mm_loadu_si128((const __m128i *)(c + i)));
+        int bas = profondeur + minimum_16(p);
+        minimum = bas < minimum ? bas : minimum;
+        profondeur += variation_16(p);
+    }
+#endif
+    //Sans branchement : les parenthèses arrivent au hasard, un test par octet serait souvent mal prédit
+    for (; i < m->fin; i++) {
+        profondeur += (c[i] == '(') - (c[i] == ')');
+        minimum = profondeur < minimum ? profondeur : minimum;
+    }
+    m->profondeur = profondeur;
+    m->minimum = minimum;
+    return NULL;
+}
+
+//Fonction notant un opérateur hors parenthèses s'il a la plus faible précédence vue dans le morceau
+//Retourne 0, ou -1 si la mémoire manque
+static int noter_coupure(MorceauDecoupage *m, int i) {
+    //Un octet qui ne commence aucun symbole sera refusé par l'analyse de son opérande
+    const Operateur *op = operateur_symbole(m->chaine, i, m->fin_segment);
+    if (!op || op->arite != 2 || op->precedence > m->precedence) return 0;
+    if (op->precedence < m->precedence) {
+        m->precedence = op->precedence;
+        m->nb = 0;
+    }
+    if (m->nb == m->capacite) {
+        long capacite = m->capacite ? 2 * m->capacite : 256;
+        int *positions = mem_reallouer(m->positions, capacite * sizeof(int));
+        if (!positions) return -1;
+        m->positions = positions;
+        uint8_t *types = mem_reallouer(m->types, capacite * sizeof(uint8_t));
+        if (!types) return -1;
+        m->types = types;
+        m->capacite = capacite;
+    }
+    m->positions[m->nb] = i;
+    m->types[m->nb++] = (uint8_t)(op - operateurs);
+    return 0;
+}
+
+static void *coupures_morceau(void *arg) {
+    MorceauDecoupage *m = arg;
+    Allocateur *precedent = utiliser_allocateur(&m->arene->base);
+    const unsigned char *c = (const unsigned char *)m->chaine;
+    int profondeur = m->profondeur;
+    m->precedence = INT_MAX;
+    int i = m->debut;
+#if defined(__SSE2__)
+    //Les octets de début ou de suite d'un symbole (>= 0x80) à la profondeur 0 sont les seuls candidats
+    for (; !m->erreur && i + 16 <= m->fin; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(c + i));
+        __m128i p = prefixe_parentheses_16(v);
+        if (profondeur <= 16 && profondeur >= -16) {
+            __m128i nulle = _mm_cmpeq_epi8(p, _mm_set1_epi8((char)-profondeur));
+            unsigned candidats = (unsigned)_mm_movemask_epi8(_mm_and_si128(nulle, v));
+            while (candidats && !m->erreur) {
+                if (noter_coupure(m, i + __builtin_ctz(candidats)) < 0) m->erreur = 1;
+                candidats &= candidats - 1;
+            }
+        }
+        profondeur += variation_16(p);
+    }
+#endif
+    for (; !m->erreur && i < m->fin; i++) {
+        profondeur += (c[i] == '(') - (c[i] == ')');
+        if (profondeur == 0 && c[i] >= 0x80 && noter_coupure(m, i) < 0) m->erreur = 1;
+    }
+    utiliser_allocateur(precedent);
+    return NULL;
+}
+
+//Fonction relevant les opérateurs de coupure d'un segment
+//Parametre c : Coupures (debut, fin et profondeur donnés), positions et types alloués ici
+//Parametre arenes : une arène par morceau
+//Parametre nb : nombre de morceaux (et de threads)
+//Retourne 0, ou -1 si les parenthèses ne sont pas équilibrées ou si la mémoire manque
+static int relever_coupures(const Decoupage *d, Coupures *c, AllocateurArene *arenes, int nb) {
+    MorceauDecoupage morceaux[MAX_THREADS_DECOUPAGE] = {{0}};
+    long longueur = c->fin - c->debut;
+    int limite = c->debut;
+    for (int k = 0; k < nb; k++) {
+        int fin = k + 1 == nb ? c->fin : c->debut + (int)(longueur * (k + 1) / nb);
+        while (fin < c->fin && ((unsigned char)d->chaine[fin] & 0xC0) == 0x80) fin++;
+        if (fin < limite) fin = limite;
+        morceaux[k].chaine = d->chaine;
+        morceaux[k].debut = limite;
+        morceaux[k].fin = fin;
+        morceaux[k].fin_segment = c->fin;
+        morceaux[k].arene = &arenes[k];
+        limite = fin;
+    }
+
+    lancer_threads_decoupage(nb, variation_morceau, morceaux, sizeof(MorceauDecoupage));
+    int profondeur = 0;
+    for (int k = 0; k < nb; k++) {
+        if (profondeur + morceaux[k].minimum < 0) return -1;
+        int variation = morceaux[k].profondeur;
+        morceaux[k].profondeur = profondeur;
+        profondeur += variation;
+    }
+    if (profondeur != 0) return -1;
+    lancer_threads_decoupage(nb, coupures_morceau, morceaux, sizeof(MorceauDecoupage));
+
+    //Réunion des opérateurs des morceaux qui ont la plus faible précédence
+    int precedence = INT_MAX;
+    for (int k = 0; k < nb; k++) {
+        if (morceaux[k].erreur) return -1;
+        if (morceaux[k].precedence < precedence) precedence = morceaux[k].precedence;
+    }
+    c->nb = 0;
+    for (int k = 0; k < nb; k++) {
+        if (morceaux[k].precedence == precedence) c->nb += morceaux[k].nb;
+    }
+    if (c->nb == 0) return 0;
+    c->positions = mem_allouer(c->nb * sizeof(int));
+    c->types = mem_allouer(c->nb * sizeof(uint8_t));
+    if (!c->positions || !c->types) return -1;
+    long n = 0;
+    for (int k = 0; k < nb; k++) {
+        if (morceaux[k].precedence != precedence) continue;
+        memcpy(c->positions + n, morceaux[k].positions, morceaux[k].nb * sizeof(int));
+        memcpy(c->types + n, morceaux[k].types, morceaux[k].nb * sizeof(uint8_t));
+        n += morceaux[k].nb;
+    }
+    c->associativite = operateurs[c->types[0]].associativite;
+    for (long i = 1; i < c->nb; i++) {
+        if (operateurs[c->types[i]].associativite != c->associativite) return -1;
+    }
+    return 0;
+}
+
+
+// ----------------------
+/*
+Opérandes
+   L'opérande 0 est analysé comme le segment entier ; les suivants sont l'opérande droit d'un
+   appel analyser_binaire de plus : un niveau de plus pour un opérateur associatif à gauche, i
+   niveaux de plus pour le i-ème opérateur associatif à droite (les implications s'emboitent).
+*/
+// ----------------------
+
+static int debut_operande(const Coupures *c, long i) {
+    return i == 0 ? c->debut : c->positions[i - 1] + operateurs[c->types[i - 1]].longueur;
+}
+
+static int fin_operande(const Coupures *c, long i) {
+    return i == c->nb ? c->fin : c->positions[i];
+}
+
+static int profondeur_operande(const Coupures *c, long i) {
+    long profondeur = c->profondeur + (i == 0 ? 0 : c->associativite == ASSOC_DROITE ? i : 1);
+    return profondeur > INT_MAX / 2 ? INT_MAX / 2 : (int)profondeur;
+}
+
+//Retourne 1 si l'opérande est analysé d'un seul tenant, 0 s'il est découpé à son tour
+static int operande_feuille(const Decoupage *d, const Coupures *c, long i, int niveau) {
+    return fin_operande(c, i) - debut_operande(c, i) <= d->taille_segment || niveau + 1 >= NIVEAUX_DECOUPAGE_MAX;
+}
+
+static void *analyser_operandes(void *arg) {
+    AnalyseOperandes *t = arg;
+    Allocateur *precedent = utiliser_allocateur(&t->arene->base);
+    arbre_plat_initialiser(&t->arbre);
+    for (long i = t->premier; i < t->dernier && !t->erreur; i++) {
+        if (!operande_feuille(t->d, t->c, i, t->niveau)) continue;
+        t->segments++;
+        if (analyser_segment_profondeur(t->d->chaine, debut_operande(t->c, i), fin_operande(t->c, i),
+                                        profondeur_operande(t->c, i), &t->arbre, NULL) < 0) {
+            t->erreur = 1;
+        } else {
+            t->fins[i] = t->arbre.nb_noeuds;
+        }
+    }
+    utiliser_allocateur(precedent);
+    return NULL;
+}
+
+//Fonction recopiant les noeuds [a, b) d'un arbre à la fin d'un autre (indices des opérandes gauches décalés)
+//Retourne l'indice de la racine recopiée, ou -1 si la mémoire manque
+static long recopier_operande(ArbrePlat *destination, const ArbrePlat *source, uint32_t a, uint32_t b) {
+    uint32_t n = b - a;
+    if (n == 0 || arbre_plat_reserver(destination, n) < 0) return -1;
+    uint32_t base = destination->nb_noeuds;
+    memcpy(destination->types + base, source->types + a, n);
+    for (uint32_t k = 0; k < n; k++) {
+        uint32_t arg = source->args[a + k];
+        if (operateurs[source->types[a + k]].arite == 2) arg = arg - a + base;
+        destination->args[base + k] = arg;
+    }
+    destination->nb_noeuds += n;
+    return destination->nb_noeuds - 1;
+}
+
+static long decouper_segment(Decoupage *d, int debut, int fin, int profondeur, int niveau);
+
+//Fonction analysant les opérandes en parallèle puis les reliant dans l'arbre final
+//Retourne la racine du segment, ou -1 en cas d'erreur
+static long relier_operandes(Decoupage *d, const Coupures *c, AllocateurArene *arenes, int niveau) {
+    if (niveau + 1 > d->rapport.niveaux) d->rapport.niveaux = niveau + 1;
+    long nb_operandes = c->nb + 1;
+    int droite = c->associativite == ASSOC_DROITE;
+    uint32_t *fins = mem_allouer(nb_operandes * sizeof(uint32_t));
+    uint32_t *racines = droite ? mem_allouer(nb_operandes * sizeof(uint32_t)) : NULL;
+    if (!fins || (droite && !racines)) {
+        mem_liberer(fins);
+        mem_liberer(racines);
+        return -1;
+    }
+
+    //Opérandes consécutifs, répartis selon leur position dans la chaine
+    int nb = nb_operandes < d->nb_threads ? (int)nb_operandes : d->nb_threads;
+    AnalyseOperandes travaux[MAX_THREADS_DECOUPAGE];
+    long longueur = c->fin - c->debut;
+    long i = 0;
+    for (int t = 0; t < nb; t++) {
+        long limite = c->debut + longueur * (t + 1) / nb;
+        travaux[t] = (AnalyseOperandes){d, c, niveau, i, i, fins, {0}, 0, 0, &arenes[t]};
+        while (i < nb_operandes && (t + 1 == nb || debut_operande(c, i) < limite)) i++;
+        travaux[t].dernier = i;
+    }
+    lancer_threads_decoupage(nb, analyser_operandes, travaux, sizeof(AnalyseOperandes));
+    int erreur = 0;
+    for (int t = 0; t < nb; t++) {
+        erreur |= travaux[t].erreur;
+        d->rapport.segments += travaux[t].segments;
+    }
+
+    //Recopie dans l'ordre de la chaine, les opérateurs de coupure sont ajoutés entre les opérandes
+    long racine = -1;
+    int t = 0;
+    uint32_t curseur = 0;
+    for (i = 0; !erreur && i < nb_operandes; i++) {
+        while (i >= travaux[t].dernier) {
+            t++;
+            curseur = 0;
+        }
+        long r;
+        if (operande_feuille(d, c, i, niveau)) {
+            r = recopier_operande(d->arbre, &travaux[t].arbre, curseur, fins[i]);
+            curseur = fins[i];
+        } else {
+            r = decouper_segment(d, debut_operande(c, i), fin_operande(c, i), profondeur_operande(c, i), niveau + 1);
+        }
+        if (r >= 0 && droite) {
+            racines[i] = (uint32_t)r;
+        } else if (r >= 0 && i > 0) {
+            r = arbre_plat_ajouter(d->arbre, (NodeType)c->types[i - 1], (uint32_t)racine);
+        }
+        erreur = r < 0;
+        racine = r;
+    }
+    for (i = c->nb; !erreur && droite && i >= 1; i--) {
+        racine = arbre_plat_ajouter(d->arbre, (NodeType)c->types[i - 1], racines[i - 1]);
+        erreur = racine < 0;
+    }
+    mem_liberer(fins);
+    mem_liberer(racines);
+    return erreur ? -1 : racine;
+}
+
+//Fonction découpant un segment sans opérateur binaire hors parenthèses : ¬...¬( segment )
+//Retourne la racine du segment, ou -1 en cas d'erreur
+static long decouper_operande_seul(Decoupage *d, int debut, int fin, int profondeur, int niveau) {
+    int i = avancer_espaces(d->chaine, debut, fin);
+    int nb_negations = 0;
+    const Operateur *op;
+    while (i < fin && (op = operateur_symbole(d->chaine, i, fin)) != NULL && op->arite == 1) {
+        nb_negations++;
+        i = avancer_espaces(d->chaine, i + op->longueur, fin);
+    }
+    int j = fin;
+    while (j > i && avancer_espaces(d->chaine, j - 1, j) == j) j--;
+    if (i >= j - 1 || d->chaine[i] != '(' || d->chaine[j - 1] != ')') {
+        d->rapport.segments++;
+        return analyser_segment_profondeur(d->chaine, debut, fin, profondeur, d->arbre, NULL);
+    }
+
+    //Une négation est un appel analyser_non de plus, la parenthèse un appel analyser_binaire de plus
+    long racine = decouper_segment(d, i + 1, j - 1, profondeur + 1 + nb_negations, niveau + 1);
+    for (int k = 0; racine >= 0 && k < nb_negations; k++) {
+        racine = arbre_plat_ajouter(d->arbre, NODE_NOT, 0);
+    }
+    return racine;
+}
+
+//Fonction analysant un segment [debut, fin) à la fin de l'arbre final
+//Retourne la racine du segment, ou -1 en cas d'erreur
+static long decouper_segment(Decoupage *d, int debut, int fin, int profondeur, int niveau) {
+    if (fin - debut <= d->taille_segment || niveau >= NIVEAUX_DECOUPAGE_MAX) {
+        d->rapport.segments++;
+        return analyser_segment_profondeur(d->chaine, debut, fin, profondeur, d->arbre, NULL);
+    }
+    int taille_morceau = d->taille_segment < TAILLE_MORCEAU_MIN ? d->taille_segment : TAILLE_MORCEAU_MIN;
+    int nb = (fin - debut) / taille_morceau;
+    if (nb < 1) nb = 1;
+    if (nb > d->nb_threads) nb = d->nb_threads;
+
+    AllocateurArene arenes[MAX_THREADS_DECOUPAGE];
+    for (int k = 0; k < d->nb_threads; k++) arene_initialiser(&arenes[k], 0);
+    Coupures c = {debut, fin, profondeur, 0, NULL, NULL, ASSOC_GAUCHE};
+    long racine = -1;
+    if (relever_coupures(d, &c, arenes, nb) == 0) {
+        racine = c.nb == 0 ? decouper_operande_seul(d, debut, fin, profondeur, niveau)
+                           : relier_operandes(d, &c, arenes, niveau);
+    }
+    mem_liberer(c.positions);
+    mem_liberer(c.types);
+    for (int k = 0; k < d->nb_threads; k++) arene_liberer(&arenes[k]);
+    return racine;
+}
+
+
+//Fonction d'analyse parallèle d'une formule vers un arbre plat
+//Parametre chaine : chaine de caracteres
+//Parametre arbre : ArbrePlat, vidé puis rempli
+//Parametre nb_threads : entier, <= 0 pour utiliser tous les processeurs
+//Parametre taille_segment : taille (octets) au-dessous de laquelle un opérande n'est plus découpé, <= 0 pour la valeur par défaut
+//Parametre rapport : RapportDecoupage (peut être NULL)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int analyser_formule_parallele(const char *chaine, ArbrePlat *arbre, int nb_threads, int taille_segment,
+                               RapportDecoupage *rapport, Statut *statut) {
+    statut_ok(statut);
+    Decoupage d = {chaine, arbre, nb_threads, taille_segment > 0 ? taille_segment : TAILLE_SEGMENT_PARALLELE, {0, 0, 0}};
+    if (d.nb_threads <= 0) {
+        d.nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (d.nb_threads < 1) d.nb_threads = 1;
+    if (d.nb_threads > MAX_THREADS_DECOUPAGE) d.nb_threads = MAX_THREADS_DECOUPAGE;
+
+    size_t longueur = strlen(chaine);
+    int r = -1;
+    arbre->nb_noeuds = 0;
+    if (longueur > INT_MAX) {
+        statut_definir(statut, ERR_TROP_DE_LEXEMES, -1, "Formule trop longue");
+    } else if (longueur <= (size_t)d.taille_segment || d.nb_threads == 1) {
+        d.rapport.segments = 1;
+        r = analyser_formule(chaine, arbre, statut);
+    } else {
+        //Quelques opérandes par thread suffisent : découper plus finement ne ferait que multiplier les parcours
+        if (longueur / (4 * d.nb_threads) > (size_t)d.taille_segment) d.taille_segment = (int)(longueur / (4 * d.nb_threads));
+        PhaseMemoire phase = definir_phase_memoire(PHASE_SYNTAXIQUE);
+        long racine = decouper_segment(&d, 0, (int)longueur, 0, 0);
+        definir_phase_memoire(phase);
+        r = racine >= 0 && racine + 1 == arbre->nb_noeuds ? 0 : -1;
+        if (r < 0) {
+            //L'analyse séquentielle donne l'erreur, à la même position
+            d.rapport.repli = 1;
+            r = analyser_formule(chaine, arbre, statut);
+        }
+    }
+    if (rapport) *rapport = d.rapport;
+    return r;
+}
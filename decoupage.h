@@ -0,0 +1,35 @@
+#ifndef DECOUPAGE_H
+#define DECOUPAGE_H
+
+#include "erreurs.h"
+#include "arbreplat.h" //pour l'arbre plat produit
+
+//Analyse parallèle d'une très grande formule. La chaine est découpée en morceaux parcourus par
+//plusieurs threads : un premier parcours donne la variation de la profondeur des parenthèses de
+//chaque morceau, une somme préfixe donne la profondeur au début de chaque morceau, puis un second
+//parcours relève les opérateurs binaires hors parenthèses de la plus faible précédence. La formule
+//est coupée à ces opérateurs ; les opérandes sont analysés en même temps (analyser_segment, un
+//arbre et une arène par thread) puis recopiés dans l'arbre final, reliés par les opérateurs de
+//coupure : de gauche à droite pour ⇔ ∨ ⊕ ↓ ∧ ↑, de droite à gauche pour ⇒ →. Un opérande encore
+//trop grand est découpé de la même façon (après ses négations et ses parenthèses extérieures).
+//L'arbre obtenu est identique, noeud pour noeud, à celui de analyser_formule. En cas d'erreur, la
+//formule est analysée à nouveau par analyser_formule, qui donne l'erreur et sa position.
+
+//Taille par défaut des opérandes analysés d'un seul tenant (octets)
+#define TAILLE_SEGMENT_PARALLELE (1 << 20)
+
+#define MAX_THREADS_DECOUPAGE 64
+
+typedef struct {
+    long segments;              //Opérandes analysés par analyser_segment
+    int niveaux;                //Découpages imbriqués (0 : formule analysée d'un seul tenant)
+    int repli;                  //1 si la formule a été analysée à nouveau par analyser_formule
+} RapportDecoupage;
+
+//Analyse d'une formule vers un arbre plat (vidé puis rempli).
+//nb_threads <= 0 : tous les processeurs. taille_segment <= 0 : TAILLE_SEGMENT_PARALLELE
+//Retourne 0, ou -1 en cas d'erreur (la même que analyser_formule)
+int analyser_formule_parallele(const char* chaine, ArbrePlat* arbre, int nb_threads, int taille_segment,
+                               RapportDecoupage* rapport, Statut* statut);
+
+#endif
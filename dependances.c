@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dependances.h"
+#include "allocateur.h"
+
+
+// ----------------------
+/*
+Supports des règles
+*/
+// ----------------------
+
+//Fonction calculant le support d'un programme
+//Parametre prog : tableau d'instructions, taille : entier
+//Parametre support : SupportRegle rempli (à libérer avec liberer_support)
+//Parametre statut : Statut (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int calculer_support(const VMInstruction *prog, int taille, SupportRegle *support, Statut *statut) {
+    memset(support, 0, sizeof(*support));
+    statut_ok(statut);
+    if (verifier_programme(prog, taille, statut) < 0) return -1;
+    int max_prop = -1;
+    for (int i = 0; i < taille; i++) {
+        if (prog[i].opcode != VM_LOAD) continue;
+        if (prog[i].operand < 0 || prog[i].operand >= MAX_PROPS_REGLES) {
+            statut_definir(statut, ERR_PROP_INVALIDE, i, "Proposition invalide");
+            return -1;
+        }
+        if (prog[i].operand > max_prop) max_prop = prog[i].operand;
+    }
+    if (max_prop < 0) return 0;
+
+    //Bitmap complet, puis seulement ses mots non nuls
+    int nb_rangs = max_prop / 64 + 1;
+    uint64_t *bitmap = mem_callouer(nb_rangs, sizeof(uint64_t));
+    if (!bitmap) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    for (int i = 0; i < taille; i++) {
+        if (prog[i].opcode == VM_LOAD) bitmap[prog[i].operand / 64] |= 1ULL << (prog[i].operand % 64);
+    }
+    int nb_mots = 0;
+    for (int r = 0; r < nb_rangs; r++) nb_mots += bitmap[r] != 0;
+    support->rangs = mem_allouer(nb_mots * sizeof(uint32_t));
+    support->mots = mem_allouer(nb_mots * sizeof(uint64_t));
+    if (!support->rangs || !support->mots) {
+        mem_liberer(bitmap);
+        liberer_support(support);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    for (int r = 0; r < nb_rangs; r++) {
+        if (bitmap[r] == 0) continue;
+        support->rangs[support->nb_mots] = r;
+        support->mots[support->nb_mots++] = bitmap[r];
+    }
+    mem_liberer(bitmap);
+    return 0;
+}
+
+//Fonction testant si une proposition est dans un support (recherche dichotomique du rang)
+int support_contient(const SupportRegle *support, int prop) {
+    if (prop < 0) return 0;
+    uint32_t rang = prop / 64;
+    int bas = 0, haut = support->nb_mots;
+    while (bas < haut) {
+        int milieu = (bas + haut) / 2;
+        if (support->rangs[milieu] < rang) bas = milieu + 1;
+        else haut = milieu;
+    }
+    return bas < support->nb_mots && support->rangs[bas] == rang && (support->mots[bas] >> (prop % 64) & 1);
+}
+
+//Fonction donnant le nombre de propositions d'un support
+int taille_support(const SupportRegle *support) {
+    int n = 0;
+    for (int k = 0; k < support->nb_mots; k++) n += __builtin_popcountll(support->mots[k]);
+    return n;
+}
+
+//Fonction de libération d'un support
+void liberer_support(SupportRegle *support) {
+    mem_liberer(support->rangs);
+    mem_liberer(support->mots);
+    memset(support, 0, sizeof(*support));
+}
+
+
+// ----------------------
+/*
+Ensemble de règles
+*/
+// ----------------------
+
+//Fonction d'initialisation d'un ensemble vide
+void ensemble_regles_initialiser(EnsembleRegles *e) {
+    memset(e, 0, sizeof(*e));
+}
+
+//Agrandissement des tableaux d'un ensemble (une case par règle)
+//Retourne 0, ou -1 si la mémoire manque (la capacité est alors inchangée)
+static int agrandir_ensemble_regles(EnsembleRegles *e) {
+    int capacite = e->capacite ? 2 * e->capacite : 64;
+    void *p;
+    if (!(p = mem_reallouer(e->progs, capacite * sizeof(VMInstruction *)))) return -1;
+    e->progs = p;
+    if (!(p = mem_reallouer(e->tailles, capacite * sizeof(int)))) return -1;
+    e->tailles = p;
+    if (!(p = mem_reallouer(e->supports, capacite * sizeof(SupportRegle)))) return -1;
+    e->supports = p;
+    if (!(p = mem_reallouer(e->resultats, capacite * sizeof(uint64_t)))) return -1;
+    e->resultats = p;
+    if (!(p = mem_reallouer(e->atteintes, capacite * sizeof(int)))) return -1;
+    e->atteintes = p;
+    if (!(p = mem_reallouer(e->marques, capacite * sizeof(uint32_t)))) return -1;
+    e->marques = p;
+    memset(e->marques + e->capacite, 0, (capacite - e->capacite) * sizeof(uint32_t));
+    e->capacite = capacite;
+    return 0;
+}
+
+//Agrandissement des colonnes jusqu'à nb_props propositions (nouvelles colonnes à 0)
+//Retourne 0, ou -1 si la mémoire manque (les colonnes sont alors inchangées)
+static int agrandir_colonnes(EnsembleRegles *e, int nb_props) {
+    if (nb_props <= e->nb_props) return 0;
+    uint64_t *colonnes = mem_reallouer(e->colonnes, nb_props * sizeof(uint64_t));
+    if (!colonnes) return -1;
+    memset(colonnes + e->nb_props, 0, (nb_props - e->nb_props) * sizeof(uint64_t));
+    e->colonnes = colonnes;
+    e->nb_props = nb_props;
+    return 0;
+}
+
+//Fonction ajoutant une règle à un ensemble
+//Parametre e : EnsembleRegles
+//Parametre prog : tableau d'instructions (recopié), taille : entier
+//Parametre statut : Statut (peut être NULL)
+//Retourne le numéro de la règle, ou -1 en cas d'erreur
+int ajouter_regle(EnsembleRegles *e, const VMInstruction *prog, int taille, Statut *statut) {
+    SupportRegle support;
+    if (calculer_support(prog, taille, &support, statut) < 0) return -1;
+    int nb_props = support.nb_mots ? 64 * (int)support.rangs[support.nb_mots - 1] + 64 -
+                                         __builtin_clzll(support.mots[support.nb_mots - 1])
+                                   : 0;
+    VMInstruction *copie = mem_allouer(taille * sizeof(VMInstruction));
+    if (!copie || (e->nb_regles == e->capacite && agrandir_ensemble_regles(e) < 0) ||
+        agrandir_colonnes(e, nb_props) < 0) {
+        mem_liberer(copie);
+        liberer_support(&support);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    memcpy(copie, prog, taille * sizeof(VMInstruction));
+    int r = e->nb_regles++;
+    e->progs[r] = copie;
+    e->tailles[r] = taille;
+    e->supports[r] = support;
+    e->resultats[r] = executer_programme_64(copie, taille, e->colonnes);
+    e->index_a_jour = 0;
+    return r;
+}
+
+//Fonction construisant l'index inversé des propositions vers les règles
+//Retourne 0, ou -1 si la mémoire manque
+int construire_index(EnsembleRegles *e, Statut *statut) {
+    statut_ok(statut);
+    int *debut = mem_callouer(e->nb_props + 1, sizeof(int));
+    if (!debut) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    //Nombre de règles par proposition, puis début de chaque proposition
+    for (int r = 0; r < e->nb_regles; r++) {
+        const SupportRegle *s = &e->supports[r];
+        for (int k = 0; k < s->nb_mots; k++) {
+            for (uint64_t m = s->mots[k]; m; m &= m - 1) debut[64 * s->rangs[k] + __builtin_ctzll(m) + 1]++;
+        }
+    }
+    for (int p = 0; p < e->nb_props; p++) debut[p + 1] += debut[p];
+    int *index = mem_allouer((debut[e->nb_props] ? debut[e->nb_props] : 1) * sizeof(int));
+    int *curseur = mem_allouer((e->nb_props ? e->nb_props : 1) * sizeof(int));
+    if (!index || !curseur) {
+        mem_liberer(debut);
+        mem_liberer(index);
+        mem_liberer(curseur);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    memcpy(curseur, debut, e->nb_props * sizeof(int));
+    for (int r = 0; r < e->nb_regles; r++) {
+        const SupportRegle *s = &e->supports[r];
+        for (int k = 0; k < s->nb_mots; k++) {
+            for (uint64_t m = s->mots[k]; m; m &= m - 1) index[curseur[64 * s->rangs[k] + __builtin_ctzll(m)]++] = r;
+        }
+    }
+    mem_liberer(curseur);
+    mem_liberer(e->debut_index);
+    mem_liberer(e->index);
+    e->debut_index = debut;
+    e->index = index;
+    e->nb_props_index = e->nb_props;
+    e->index_a_jour = 1;
+    return 0;
+}
+
+//Fonction donnant le résultat courant d'une règle
+uint64_t valeur_regle(const EnsembleRegles *e, int regle) {
+    return e->resultats[regle];
+}
+
+//Fonction de réévaluation des règles atteintes par un événement
+//Parametre e : EnsembleRegles
+//Parametre props : tableau de nb indices de propositions, valeurs : leurs nouvelles valeurs
+//Parametre basculees : tableau d'au moins nb_regles entiers, rempli avec les règles basculées
+//Parametre statut : Statut (peut être NULL)
+//Retourne le nombre de règles basculées, ou -1 en cas d'erreur
+int reevaluer_changements(EnsembleRegles *e, const int *props, const uint64_t *valeurs, int nb, int *basculees,
+                          Statut *statut) {
+    statut_ok(statut);
+    int max_prop = -1;
+    for (int k = 0; k < nb; k++) {
+        if (props[k] < 0 || props[k] >= MAX_PROPS_REGLES) {
+            statut_definir(statut, ERR_PROP_INVALIDE, k, "Proposition invalide");
+            return -1;
+        }
+        if (props[k] > max_prop) max_prop = props[k];
+    }
+    if (!e->index_a_jour && construire_index(e, statut) < 0) return -1;
+    //Les valeurs des propositions lues par aucune règle sont gardées pour les règles ajoutées ensuite
+    if (agrandir_colonnes(e, max_prop + 1) < 0) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    e->evenements++;
+
+    //Une marque par événement : les marques ne sont remises à 0 que lorsque l'époque reboucle
+    if (++e->epoque == 0) {
+        memset(e->marques, 0, e->capacite * sizeof(uint32_t));
+        e->epoque = 1;
+    }
+    int nb_atteintes = 0;
+    for (int k = 0; k < nb; k++) {
+        int p = props[k];
+        if (e->colonnes[p] == valeurs[k]) continue;
+        e->colonnes[p] = valeurs[k];
+        if (p >= e->nb_props_index) continue;
+        for (int i = e->debut_index[p]; i < e->debut_index[p + 1]; i++) {
+            int r = e->index[i];
+            if (e->marques[r] == e->epoque) continue;
+            e->marques[r] = e->epoque;
+            e->atteintes[nb_atteintes++] = r;
+        }
+    }
+
+    int nb_basculees = 0;
+    for (int i = 0; i < nb_atteintes; i++) {
+        int r = e->atteintes[i];
+        uint64_t resultat = executer_programme_64(e->progs[r], e->tailles[r], e->colonnes);
+        if (resultat != e->resultats[r]) {
+            e->resultats[r] = resultat;
+            basculees[nb_basculees++] = r;
+        }
+    }
+    e->reevaluations += nb_atteintes;
+    return nb_basculees;
+}
+
+//Fonction de libération d'un ensemble de règles
+void liberer_ensemble_regles(EnsembleRegles *e) {
+    for (int r = 0; r < e->nb_regles; r++) {
+        mem_liberer(e->progs[r]);
+        liberer_support(&e->supports[r]);
+    }
+    mem_liberer(e->progs);
+    mem_liberer(e->tailles);
+    mem_liberer(e->supports);
+    mem_liberer(e->resultats);
+    mem_liberer(e->atteintes);
+    mem_liberer(e->marques);
+    mem_liberer(e->colonnes);
+    mem_liberer(e->debut_index);
+    mem_liberer(e->index);
+    memset(e, 0, sizeof(*e));
+}
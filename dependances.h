@@ -0,0 +1,93 @@
+#ifndef DEPENDANCES_H
+#define DEPENDANCES_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Réévaluation dirigée par les changements : quand un événement ne modifie que quelques
+//propositions, seules les règles qui lisent l'une d'elles sont exécutées à nouveau.
+//  - le support d'une règle (propositions lues par ses VM_LOAD) est gardé en bitmap compressé :
+//    seuls les mots de 64 bits non nuls sont stockés, avec leur rang ;
+//  - un index inversé donne, pour chaque proposition, les règles qui la lisent (une table de
+//    débuts et une table de règles, par ordre croissant des règles) ;
+//  - reevaluer_changements marque les règles atteintes par les propositions modifiées (chaque
+//    règle une seule fois), les exécute et donne celles dont le résultat a changé.
+//Le coût d'un événement dépend du nombre de règles atteintes, et non plus du nombre total de règles.
+//Chaque proposition est une colonne de 64 valuations (comme executer_programme_64) : le résultat
+//d'une règle change si l'un de ses 64 bits change.
+
+//Indices de propositions acceptés : 0 .. MAX_PROPS_REGLES - 1 (les colonnes et l'index inversé sont des
+//tableaux indicés par proposition, jusqu'à la plus grande proposition lue ou modifiée)
+#define MAX_PROPS_REGLES (1 << 24)
+
+//Bitmap compressé des propositions lues par une règle
+typedef struct {
+    int nb_mots;
+    uint32_t* rangs;            //Rang des mots non nuls (proposition 64 * rang + bit), croissants
+    uint64_t* mots;
+} SupportRegle;
+
+//Support d'un programme (vérifié ici). Retourne 0, ou -1 en cas d'erreur (ERR_PROP_INVALIDE pour une
+//proposition hors de 0 .. MAX_PROPS_REGLES - 1)
+int calculer_support(const VMInstruction* prog, int taille, SupportRegle* support, Statut* statut);
+
+//1 si la règle lit la proposition, 0 sinon
+int support_contient(const SupportRegle* support, int prop);
+
+//Nombre de propositions du support
+int taille_support(const SupportRegle* support);
+
+void liberer_support(SupportRegle* support);
+
+typedef struct {
+    int nb_regles;
+    int capacite;
+    VMInstruction** progs;      //Copies des programmes des règles
+    int* tailles;
+    SupportRegle* supports;
+    uint64_t* resultats;        //Résultat courant de chaque règle
+
+    int nb_props;               //Propositions lues par une règle ou modifiées : 0 .. nb_props - 1
+    uint64_t* colonnes;         //Valeurs courantes (0 au départ)
+
+    int index_a_jour;           //0 après l'ajout d'une règle : l'index est reconstruit au besoin
+    int nb_props_index;         //Propositions couvertes par l'index (les suivantes ne sont pas lues)
+    int* debut_index;           //Règles de la proposition p : index[debut_index[p] .. debut_index[p + 1] - 1]
+    int* index;
+
+    uint32_t* marques;          //Marque de la dernière réévaluation qui a atteint chaque règle
+    uint32_t epoque;
+    int* atteintes;             //Règles atteintes par la réévaluation en cours
+
+    long evenements;            //Appels de reevaluer_changements
+    long reevaluations;         //Règles exécutées par reevaluer_changements
+} EnsembleRegles;
+
+//Ensemble vide
+void ensemble_regles_initialiser(EnsembleRegles* e);
+
+//Ajout d'une règle (programme recopié, évalué avec les valeurs courantes)
+//Retourne le numéro de la règle (0, 1, ... dans l'ordre des ajouts), ou -1 en cas d'erreur
+int ajouter_regle(EnsembleRegles* e, const VMInstruction* prog, int taille, Statut* statut);
+
+//Construction de l'index inversé (faite par reevaluer_changements si des règles ont été ajoutées)
+//Retourne 0, ou -1 si la mémoire manque
+int construire_index(EnsembleRegles* e, Statut* statut);
+
+//Résultat courant d'une règle
+uint64_t valeur_regle(const EnsembleRegles* e, int regle);
+
+//Evénement : les propositions props[0 .. nb - 1] prennent les valeurs valeurs[0 .. nb - 1]
+//(une proposition lue par aucune règle garde sa valeur pour les règles ajoutées ensuite).
+//Les règles qui lisent une proposition dont la valeur a changé sont réévaluées ; celles dont le
+//résultat a changé sont écrites dans basculees (au plus nb_regles cases), dans l'ordre où elles
+//sont atteintes.
+//Retourne le nombre de règles basculées, ou -1 en cas d'erreur (valeurs inchangées ; ERR_PROP_INVALIDE
+//pour une proposition hors de 0 .. MAX_PROPS_REGLES - 1)
+int reevaluer_changements(EnsembleRegles* e, const int* props, const uint64_t* valeurs, int nb, int* basculees,
+                          Statut* statut);
+
+void liberer_ensemble_regles(EnsembleRegles* e);
+
+#endif
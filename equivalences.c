@@ -0,0 +1,376 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "equivalences.h"
+#include "allocateur.h"
+#include "solveur.h"     //Pour la vérification exacte des formules à beaucoup de propositions
+#include "operateurs.h"  //Pour les tables de vérité des opcodes
+
+
+//Temps écoulé en secondes depuis debut
+static double secondes_equivalences(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Générateur pseudo-aléatoire des valuations (xorshift64*)
+static uint64_t aleatoire_equivalences(uint64_t *etat) {
+    *etat ^= *etat >> 12;
+    *etat ^= *etat << 25;
+    *etat ^= *etat >> 27;
+    return *etat * 0x2545F4914F6CDD1DULL;
+}
+
+
+// ----------------------
+/*
+Vérification exacte
+   Le solveur est partagé par toutes les vérifications d'un classement : chaque programme n'est
+   encodé qu'une fois (une variable par proposition, une variable par opérateur binaire définie
+   par les 4 lignes de sa table de vérité), et chaque paire est vérifiée par deux questions sous
+   hypothèses : a ∧ ¬b puis ¬a ∧ b, toutes deux insatisfiables si a ⇔ b.
+*/
+// ----------------------
+
+typedef struct {
+    const VMInstruction *const *progs;
+    const int *tailles;
+    int nb_props;
+    uint64_t *colonnes;         //Colonnes du balayage (nb_props)
+    Solveur solveur;
+    int solveur_pret;
+    int *litteral;              //Littéral de chaque formule dans le solveur, 0 si pas encore encodée
+    int *variable_prop;         //Variable de chaque proposition dans le solveur, 0 si pas encore créée
+    int *pile;
+    int capacite_pile;
+    long verifications_sat;
+} Verificateur;
+
+static int verificateur_initialiser(Verificateur *v, const VMInstruction *const *progs, const int *tailles,
+                                    int nb_formules, int nb_props) {
+    memset(v, 0, sizeof(*v));
+    v->progs = progs;
+    v->tailles = tailles;
+    v->nb_props = nb_props;
+    v->colonnes = mem_callouer(nb_props > 0 ? nb_props : 1, sizeof(uint64_t));
+    v->litteral = mem_callouer(nb_formules > 0 ? nb_formules : 1, sizeof(int));
+    v->variable_prop = mem_callouer(nb_props > 0 ? nb_props : 1, sizeof(int));
+    return v->colonnes && v->litteral && v->variable_prop ? 0 : -1;
+}
+
+static void verificateur_liberer(Verificateur *v) {
+    if (v->solveur_pret) solveur_liberer(&v->solveur);
+    mem_liberer(v->colonnes);
+    mem_liberer(v->litteral);
+    mem_liberer(v->variable_prop);
+    mem_liberer(v->pile);
+    memset(v, 0, sizeof(*v));
+}
+
+//Fonction recensant les propositions de deux programmes
+//Retourne leur nombre, ou MAX_PROPS_BALAYAGE_EXACT + 1 s'il y en a plus
+static int recenser_props_paire(const VMInstruction *a, int taille_a, const VMInstruction *b, int taille_b, int *props) {
+    int n = 0;
+    for (int i = 0; i < taille_a + taille_b; i++) {
+        VMInstruction instr = i < taille_a ? a[i] : b[i - taille_a];
+        if (instr.opcode != VM_LOAD) continue;
+        int k = 0;
+        while (k < n && props[k] != instr.operand) k++;
+        if (k < n) continue;
+        if (n == MAX_PROPS_BALAYAGE_EXACT) return MAX_PROPS_BALAYAGE_EXACT + 1;
+        props[n++] = instr.operand;
+    }
+    return n;
+}
+
+//Paire comparée par balayer_paire
+typedef struct {
+    const VMInstruction *a;
+    int taille_a;
+    const VMInstruction *b;
+    int taille_b;
+    uint64_t masque;
+} PaireBalayee;
+
+static int comparer_mot_paire(uint64_t mot, const uint64_t *colonnes, void *donnees) {
+    (void)mot;
+    const PaireBalayee *paire = donnees;
+    uint64_t ra = executer_programme_64(paire->a, paire->taille_a, colonnes);
+    uint64_t rb = executer_programme_64(paire->b, paire->taille_b, colonnes);
+    return ((ra ^ rb) & paire->masque) != 0;
+}
+
+//Fonction comparant deux programmes sur toutes les valuations de leurs n propositions
+static int balayer_paire(Verificateur *v, const VMInstruction *a, int taille_a, const VMInstruction *b, int taille_b,
+                         const int *props, int n) {
+    PaireBalayee paire = {a, taille_a, b, taille_b, masque_valuations(n)};
+    uint64_t nb_mots = mots_valuations(n);
+    return enumerer_valuations(n, props, v->colonnes, 0, nb_mots, comparer_mot_paire, &paire) == nb_mots;
+}
+
+//Fonction encodant un programme vérifié dans le solveur
+//Retourne le littéral représentant son résultat, ou 0 si la mémoire manque (le programme sera encodé
+//à nouveau s'il est encore demandé, ses premières clauses ne contraignent que des variables nouvelles)
+static int encoder_programme(Verificateur *v, int f) {
+    if (v->litteral[f]) return v->litteral[f];
+    Solveur *s = &v->solveur;
+    const VMInstruction *prog = v->progs[f];
+    int taille = v->tailles[f];
+    if (taille > v->capacite_pile) {
+        int *pile = mem_reallouer(v->pile, taille * sizeof(int));
+        if (!pile) return 0;
+        v->pile = pile;
+        v->capacite_pile = taille;
+    }
+    int sommet = -1;
+    for (int i = 0; i < taille; i++) {
+        VMInstruction instr = prog[i];
+        switch (instr.opcode) {
+            case VM_LOAD: {
+                int *x = &v->variable_prop[instr.operand];
+                if (!*x && !(*x = solveur_nouvelle_variable(s))) return 0;
+                v->pile[++sommet] = *x;
+                break;
+            }
+            case VM_PUSH: {
+                int x = solveur_nouvelle_variable(s);
+                int unite = instr.operand ? x : -x;
+                if (!x || solveur_ajouter_clause(s, &unite, 1, NULL) < 0) return 0;
+                v->pile[++sommet] = x;
+                break;
+            }
+            case VM_POP:
+            case VM_PRINT:
+                sommet--;
+                break;
+            case VM_NOT:
+                v->pile[sommet] = -v->pile[sommet];
+                break;
+            case VM_NOP:
+                break;
+            default: {
+                //Opérateur binaire : x ⇔ (a op b), une clause par ligne de la table de vérité
+                uint8_t table = operateur_opcode(instr.opcode)->table;
+                int b = v->pile[sommet--];
+                int a = v->pile[sommet];
+                int x = solveur_nouvelle_variable(s);
+                if (!x) return 0;
+                for (int ligne = 0; ligne < 4; ligne++) {
+                    int va = ligne >> 1, vb = ligne & 1;
+                    int clause[3] = {va ? -a : a, vb ? -b : b, valeur_table(table, va, vb) ? x : -x};
+                    if (solveur_ajouter_clause(s, clause, 3, NULL) < 0) return 0;
+                }
+                v->pile[sommet] = x;
+                break;
+            }
+        }
+    }
+    v->litteral[f] = v->pile[sommet];
+    return v->litteral[f];
+}
+
+//Fonction de vérification exacte de l'équivalence des formules fa et fb
+//Retourne 1 si elles sont équivalentes, 0 sinon, -1 si la mémoire manque
+static int verifier_paire(Verificateur *v, int fa, int fb) {
+    const VMInstruction *a = v->progs[fa], *b = v->progs[fb];
+    int taille_a = v->tailles[fa], taille_b = v->tailles[fb];
+    int props[MAX_PROPS_BALAYAGE_EXACT];
+    int n = recenser_props_paire(a, taille_a, b, taille_b, props);
+    if (n <= MAX_PROPS_BALAYAGE_EXACT) {
+        return balayer_paire(v, a, taille_a, b, taille_b, props, n);
+    }
+
+    if (!v->solveur_pret) {
+        solveur_initialiser(&v->solveur);
+        v->solveur_pret = 1;
+    }
+    v->verifications_sat++;
+    int la = encoder_programme(v, fa);
+    int lb = la ? encoder_programme(v, fb) : 0;
+    if (!lb) return -1;
+    int difference_1[2] = {la, -lb};
+    int difference_2[2] = {-la, lb};
+    int r = resoudre(&v->solveur, difference_1, 2, NULL);
+    if (r == 0) r = resoudre(&v->solveur, difference_2, 2, NULL);
+    return r < 0 ? -1 : !r;
+}
+
+//Fonction de vérification exacte de l'équivalence de deux programmes
+//Parametre prog_a, prog_b : programmes acceptés par verifier_programme
+//Parametre nb_props : nombre de propositions (opérandes de VM_LOAD dans [0, nb_props))
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 1 s'ils sont équivalents, 0 sinon, -1 si la mémoire manque
+int programmes_equivalents(const VMInstruction *prog_a, int taille_a, const VMInstruction *prog_b, int taille_b,
+                           int nb_props, Statut *statut) {
+    statut_ok(statut);
+    const VMInstruction *progs[2] = {prog_a, prog_b};
+    int tailles[2] = {taille_a, taille_b};
+    Verificateur v;
+    int r = verificateur_initialiser(&v, progs, tailles, 2, nb_props) < 0 ? -1 : verifier_paire(&v, 0, 1);
+    verificateur_liberer(&v);
+    if (r < 0) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    return r;
+}
+
+
+// ----------------------
+/*
+Classement
+*/
+// ----------------------
+
+//Formule repérée par l'empreinte de sa signature (les seaux sont les suites d'empreintes égales)
+typedef struct {
+    uint64_t empreinte;
+    int formule;
+} EmpreinteFormule;
+
+static int comparer_empreintes(const void *a, const void *b) {
+    const EmpreinteFormule *x = a, *y = b;
+    if (x->empreinte != y->empreinte) return x->empreinte < y->empreinte ? -1 : 1;
+    return (x->formule > y->formule) - (x->formule < y->formule);
+}
+
+//Fonction de classement des formules par équivalence
+//Parametre progs, tailles : programmes des formules
+//Parametre nb_formules : entier
+//Parametre nb_props : nombre de propositions (opérandes de VM_LOAD dans [0, nb_props))
+//Parametre nb_mots : mots de 64 valuations par signature (MOTS_SIGNATURE si <= 0)
+//Parametre graine : graine des valuations aléatoires
+//Parametre res : ClassesEquivalence, à libérer avec liberer_classes_equivalence
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre de classes, ou -1 en cas d'erreur
+int classer_equivalences(const VMInstruction *const *progs, const int *tailles, int nb_formules, int nb_props,
+                         int nb_mots, uint64_t graine, ClassesEquivalence *res, Statut *statut) {
+    memset(res, 0, sizeof(*res));
+    statut_ok(statut);
+    if (nb_mots <= 0) nb_mots = MOTS_SIGNATURE;
+
+    //Les programmes sont vérifiés une fois ici : l'exécution bit-parallèle ne vérifie plus rien
+    for (int f = 0; f < nb_formules; f++) {
+        if (verifier_programme(progs[f], tailles[f], statut) < 0) return -1;
+        for (int i = 0; i < tailles[f]; i++) {
+            if (progs[f][i].opcode == VM_LOAD && (progs[f][i].operand < 0 || progs[f][i].operand >= nb_props)) {
+                statut_definir(statut, ERR_PROP_INVALIDE, i, "Proposition hors de [0, nb_props)");
+                return -1;
+            }
+        }
+    }
+
+    uint64_t *signatures = mem_allouer((size_t)nb_formules * nb_mots * sizeof(uint64_t) + 1);
+    uint64_t *colonnes = mem_allouer((nb_props > 0 ? nb_props : 1) * sizeof(uint64_t));
+    EmpreinteFormule *ordre = mem_allouer((nb_formules > 0 ? nb_formules : 1) * sizeof(EmpreinteFormule));
+    res->classe = mem_allouer((nb_formules > 0 ? nb_formules : 1) * sizeof(int));
+    res->representant = mem_allouer((nb_formules > 0 ? nb_formules : 1) * sizeof(int));
+    Verificateur v;
+    int pret = verificateur_initialiser(&v, progs, tailles, nb_formules, nb_props) == 0;
+    if (!signatures || !colonnes || !ordre || !res->classe || !res->representant || !pret) {
+        mem_liberer(signatures);
+        mem_liberer(colonnes);
+        mem_liberer(ordre);
+        verificateur_liberer(&v);
+        liberer_classes_equivalence(res);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+
+    //1. Signatures : les mêmes colonnes aléatoires servent à toutes les formules, mot par mot
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    uint64_t etat = graine ? graine : 0x9E3779B97F4A7C15ULL;
+    for (int w = 0; w < nb_mots; w++) {
+        for (int p = 0; p < nb_props; p++) colonnes[p] = aleatoire_equivalences(&etat);
+        for (int f = 0; f < nb_formules; f++) {
+            signatures[(size_t)f * nb_mots + w] = executer_programme_64(progs[f], tailles[f], colonnes);
+        }
+    }
+    res->temps_signatures = secondes_equivalences(debut);
+
+    //2. Seaux : tri par empreinte de la signature (FNV-1a des mots)
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int f = 0; f < nb_formules; f++) {
+        uint64_t h = 14695981039346656037ULL;
+        const uint64_t *sig = &signatures[(size_t)f * nb_mots];
+        for (int w = 0; w < nb_mots; w++) h = (h ^ sig[w]) * 1099511628211ULL;
+        ordre[f].empreinte = h ^ (h >> 29);
+        ordre[f].formule = f;
+    }
+    qsort(ordre, nb_formules, sizeof(EmpreinteFormule), comparer_empreintes);
+    res->temps_seaux = secondes_equivalences(debut);
+
+    //3. Vérification exacte dans chaque seau : chaque formule est comparée aux représentants des
+    //classes déjà trouvées dans le seau qui ont exactement la même signature
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int nb_classes = 0, erreur = 0;
+    for (int i = 0; i < nb_formules && !erreur;) {
+        int fin = i;
+        while (fin < nb_formules && ordre[fin].empreinte == ordre[i].empreinte) fin++;
+        int premiere_classe = nb_classes;
+        for (int k = i; k < fin && !erreur; k++) {
+            int f = ordre[k].formule;
+            const uint64_t *sig = &signatures[(size_t)f * nb_mots];
+            int classe = -1, meme_signature = 0;
+            for (int c = premiere_classe; c < nb_classes && classe < 0 && !erreur; c++) {
+                int r = res->representant[c];
+                if (memcmp(sig, &signatures[(size_t)r * nb_mots], nb_mots * sizeof(uint64_t)) != 0) continue;
+                meme_signature = 1;
+                res->verifications++;
+                int equivalentes = verifier_paire(&v, r, f);
+                if (equivalentes < 0) erreur = 1;
+                else if (equivalentes) classe = c;
+                else res->faux_candidats++;
+            }
+            if (classe < 0) {
+                classe = nb_classes++;
+                res->representant[classe] = f;
+                if (!meme_signature) res->nb_seaux++;
+            }
+            res->classe[f] = classe;
+        }
+        i = fin;
+    }
+    res->verifications_sat = v.verifications_sat;
+    res->temps_verifications = secondes_equivalences(debut);
+    if (erreur) {
+        mem_liberer(signatures);
+        mem_liberer(colonnes);
+        mem_liberer(ordre);
+        verificateur_liberer(&v);
+        liberer_classes_equivalence(res);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+
+    //Numérotation des classes dans l'ordre de leur plus petit membre
+    int *numero = (int *)ordre; //ordre ne sert plus
+    for (int c = 0; c < nb_classes; c++) numero[c] = -1;
+    int suivant = 0;
+    for (int f = 0; f < nb_formules; f++) {
+        int c = res->classe[f];
+        if (numero[c] < 0) {
+            numero[c] = suivant;
+            res->representant[suivant] = f;
+            suivant++;
+        }
+        res->classe[f] = numero[c];
+    }
+    res->nb_formules = nb_formules;
+    res->nb_classes = nb_classes;
+
+    mem_liberer(signatures);
+    mem_liberer(colonnes);
+    mem_liberer(ordre);
+    verificateur_liberer(&v);
+    return nb_classes;
+}
+
+//Fonction de libération d'un résultat
+void liberer_classes_equivalence(ClassesEquivalence *res) {
+    mem_liberer(res->classe);
+    mem_liberer(res->representant);
+    res->classe = NULL;
+    res->representant = NULL;
+}
@@ -0,0 +1,53 @@
+#ifndef EQUIVALENCES_H
+#define EQUIVALENCES_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Classes d'équivalence d'un grand nombre de formules compilées, sans comparer toutes les paires :
+//  1. signature : chaque programme est évalué sur les mêmes nb_mots * 64 valuations aléatoires
+//     (executer_programme_64, un mot de 64 valuations à la fois) ;
+//  2. seaux : les formules sont triées par signature, seules celles de même signature peuvent
+//     être équivalentes ;
+//  3. vérification exacte à l'intérieur de chaque seau seulement : balayage de toutes les
+//     valuations si les deux formules ont au plus MAX_PROPS_BALAYAGE_EXACT propositions,
+//     solveur SAT incrémental (solveur.h) sinon.
+
+//Nombre de mots de 64 valuations d'une signature par défaut (4096 valuations)
+#define MOTS_SIGNATURE 64
+
+//Au-delà de ce nombre de propositions, la vérification exacte passe par le solveur SAT
+#define MAX_PROPS_BALAYAGE_EXACT 16
+
+typedef struct {
+    int nb_formules;
+    int nb_classes;
+    int* classe;                    //Classe de chaque formule, numérotées dans l'ordre des représentants
+    int* representant;              //Plus petit indice de formule de chaque classe
+
+    int nb_seaux;                   //Nombre de signatures distinctes
+    long verifications;             //Vérifications exactes faites
+    long verifications_sat;         //Dont par le solveur SAT
+    long faux_candidats;            //Formules de même signature qui ne sont pas équivalentes
+    double temps_signatures;        //Secondes de chaque étape
+    double temps_seaux;
+    double temps_verifications;
+} ClassesEquivalence;
+
+//Calcule les classes d'équivalence des programmes progs[i] (tailles[i] instructions, opérandes de
+//VM_LOAD dans [0, nb_props)). nb_mots : taille des signatures (MOTS_SIGNATURE si <= 0), graine :
+//graine des valuations aléatoires. Retourne le nombre de classes, ou -1 si un programme est refusé ou
+//si la mémoire manque (statut)
+int classer_equivalences(const VMInstruction* const* progs, const int* tailles, int nb_formules, int nb_props,
+                         int nb_mots, uint64_t graine, ClassesEquivalence* res, Statut* statut);
+
+//Vérification exacte de l'équivalence de deux programmes (mêmes conventions). Retourne 1 ou 0, -1 si
+//la mémoire manque
+int programmes_equivalents(const VMInstruction* prog_a, int taille_a, const VMInstruction* prog_b, int taille_b,
+                           int nb_props, Statut* statut);
+
+//Libération des tableaux d'un résultat
+void liberer_classes_equivalence(ClassesEquivalence* res);
+
+#endif
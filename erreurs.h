@@ -0,0 +1,54 @@
+#ifndef ERREURS_H
+#define ERREURS_H
+
+#include <stddef.h>
+
+//Codes d'erreur communs à toutes les étapes (analyses, compilation, machine virtuelle)
+typedef enum {
+    ERR_AUCUNE = 0,         //Pas d'erreur
+    ERR_MEMOIRE,            //Allocation mémoire impossible
+    ERR_CHAINE_VIDE,        //Analyse lexicale d'une chaine vide
+    ERR_LEXEME_INVALIDE,    //Caractère qui ne commence aucun lexème
+    ERR_TROP_DE_LEXEMES,    //Nombre maximal de lexèmes atteint
+    ERR_SYNTAXE,            //Suite de lexèmes qui ne respecte pas la grammaire
+    ERR_PROP_INVALIDE,      //Proposition absente des propositions valides
+    ERR_ARITE,              //Opérateur sans le bon nombre d'opérandes
+    ERR_NOEUD_INCONNU,      //Type de noeud inconnu dans l'arbre
+    ERR_TABLE_PLEINE,       //Table (symboles, propositions) pleine
+    ERR_PROGRAMME_PLEIN,    //Programme de la machine virtuelle trop long
+    ERR_PILE_PLEINE,        //Débordement de la pile de la machine virtuelle
+    ERR_PILE_VIDE,          //Dépilement d'une pile vide
+    ERR_OPCODE_INCONNU,     //Instruction inconnue
+    ERR_VALEURS_ABSENTES,   //VM_LOAD sans valeurs de propositions
+    ERR_HANDLE_INVALIDE,    //Programme compilé inconnu ou déjà libéré (serveur)
+    ERR_REQUETE_INVALIDE,   //Trame mal formée ou type de requête inconnu (serveur)
+    ERR_FICHIER,            //Fichier impossible à ouvrir, à créer ou à écrire
+    ERR_IMAGE_INVALIDE,     //Fichier binaire (image, table) tronqué, mal formé ou d'un autre programme
+    ERR_ARGUMENT            //Arguments incompatibles entre eux (tailles, fichiers d'entrée et de sortie)
+} CodeErreur;
+
+//Statut retourné par chaque étape : code, position de l'erreur et message
+//La position est l'octet dans la chaine (analyse lexicale), l'indice du lexème (analyse syntaxique,
+//et analyse sémantique : lexème du noeud fautif), l'indice de l'instruction (machine virtuelle),
+//ou -1 quand elle n'a pas de sens
+typedef struct {
+    CodeErreur code;
+    int position;
+    const char *message;
+} Statut;
+
+//Remplit un statut (qui peut être NULL si l'appelant ne s'intéresse pas au détail de l'erreur)
+static inline void statut_definir(Statut *statut, CodeErreur code, int position, const char *message) {
+    if (statut) {
+        statut->code = code;
+        statut->position = position;
+        statut->message = message;
+    }
+}
+
+//Statut sans erreur
+static inline void statut_ok(Statut *statut) {
+    statut_definir(statut, ERR_AUCUNE, -1, NULL);
+}
+
+#endif
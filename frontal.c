@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "frontal.h"
+#include "analex.h"  //Pour avancer_espaces et avancer_identifiant
+#include "anasem.h"  //Pour indice_prop_longueur
+#include "operateurs.h" //Pour les symboles, précédences et opcodes des opérateurs
+#include "allocateur.h" //Pour la phase des allocations de l'arbre plat
+
+
+//Profondeur maximale d'imbrication (parenthèses, négations, implications enchainées) :
+//au-delà, la formule est refusée plutôt que de risquer un débordement de la pile d'appels
+#define PROFONDEUR_MAX 10000
+
+//Types des lexèmes lus à la demande
+typedef enum {
+    LEX_FIN,
+    LEX_PROP,
+    LEX_OPERATEUR,      //Opérateur de la table (dans le champ op)
+    LEX_PO,
+    LEX_PF,
+    LEX_INVALIDE
+} TypeLexeme;
+
+//Etat de l'analyse fusionnée
+typedef struct {
+    const char *chaine;
+    int pos;                    //Position de lecture (après le lexème courant)
+    int fin;
+    TypeLexeme type;            //Lexème courant
+    int debut;                  //Octet où commence le lexème courant
+    int longueur;
+    const Operateur *op;        //Opérateur du lexème courant (LEX_OPERATEUR)
+
+    ArbrePlat *arbre;           //Destination des noeuds (ou NULL)
+    VMInstruction *prog;        //Destination des instructions (ou NULL)
+    int capacite;
+    long nb_noeuds;             //Indice du prochain noeud (les noeuds déjà présents dans l'arbre comptent)
+
+    int profondeur;
+    Statut *statut;
+} AnalyseurFusionne;
+
+
+// ----------------------
+/*
+Lecture des lexèmes à la demande
+*/
+// ----------------------
+
+//Fonction lisant le lexème suivant de la chaine
+//Parametre a : AnalyseurFusionne
+void lexeme_suivant(AnalyseurFusionne *a) {
+    const unsigned char *c = (const unsigned char *)a->chaine;
+    int i = avancer_espaces(a->chaine, a->pos, a->fin);
+    a->debut = i;
+    a->longueur = 1;
+    if (i >= a->fin) {
+        a->type = LEX_FIN;
+        a->longueur = 0;
+    } else if (c[i] >= 'a' && c[i] <= 'z') {
+        a->type = LEX_PROP;
+        a->longueur = avancer_identifiant(a->chaine, i, a->fin) - i;
+    } else if (c[i] == '(') {
+        a->type = LEX_PO;
+    } else if (c[i] == ')') {
+        a->type = LEX_PF;
+    } else if (c[i] >= 0x80 && (a->op = operateur_symbole(a->chaine, i, a->fin)) != NULL) {
+        a->type = LEX_OPERATEUR;
+        a->longueur = a->op->longueur;
+    } else {
+        a->type = LEX_INVALIDE;
+    }
+    a->pos = i + a->longueur;
+}
+
+//Fonction signalant une erreur sur le lexème courant (un lexème invalide l'emporte sur l'erreur de syntaxe)
+//Retourne -1, pour que les fonctions d'analyse puissent écrire return erreur_fusionnee(...)
+long erreur_fusionnee(AnalyseurFusionne *a, CodeErreur code, const char *message) {
+    if (a->type == LEX_INVALIDE) {
+        statut_definir(a->statut, ERR_LEXEME_INVALIDE, a->debut, "Lexeme invalide dans la chaine");
+    } else {
+        statut_definir(a->statut, code, a->debut, message);
+    }
+    return -1;
+}
+
+//Fonction produisant un noeud (dans l'arbre plat et/ou dans le programme)
+//Parametre a : AnalyseurFusionne
+//Parametre type : NodeType
+//Parametre arg : indice de proposition ou de l'opérande gauche
+//Retourne l'indice du noeud, ou -1 en cas d'erreur
+long emettre_noeud(AnalyseurFusionne *a, NodeType type, uint32_t arg) {
+    if (a->prog) {
+        if (a->nb_noeuds >= a->capacite) {
+            statut_definir(a->statut, ERR_PROGRAMME_PLEIN, a->debut, "Programme trop long");
+            return -1;
+        }
+        a->prog[a->nb_noeuds] = (VMInstruction){operateurs[type].opcode, type == NODE_PROP ? (int)arg : 0};
+    }
+    if (a->arbre && arbre_plat_ajouter(a->arbre, type, arg) < 0) {
+        statut_definir(a->statut, ERR_MEMOIRE, a->debut, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    return a->nb_noeuds++;
+}
+
+
+// ----------------------
+/*
+Analyse syntaxique et sémantique :
+   Même grammaire que anasynt.c (précédences de la table des opérateurs). Chaque fonction retourne
+   l'indice de la racine du sous-arbre produit (ou -1) ; les opérandes sont produits avant leur
+   opérateur, et l'opérande droit se termine juste avant l'opérateur, comme l'attend l'arbre plat.
+*/
+// ----------------------
+
+long analyser_binaire(AnalyseurFusionne *a, int precedence_min);
+
+//primaire ::= proposition | "(" binaire(1) ")"
+long analyser_primaire(AnalyseurFusionne *a) {
+    if (a->type == LEX_PROP) {
+        int prop = indice_prop_longueur(a->chaine + a->debut, a->longueur);
+        if (prop < 0) {
+            return erreur_fusionnee(a, ERR_PROP_INVALIDE, "Proposition invalide");
+        }
+        long noeud = emettre_noeud(a, NODE_PROP, (uint32_t)prop);
+        lexeme_suivant(a);
+        return noeud;
+    }
+    if (a->type == LEX_PO) {
+        lexeme_suivant(a);
+        long noeud = analyser_binaire(a, 1);
+        if (noeud < 0) return -1;
+        if (a->type != LEX_PF) {
+            return erreur_fusionnee(a, ERR_SYNTAXE, "Parenthèse fermante manquante");
+        }
+        lexeme_suivant(a);
+        return noeud;
+    }
+    if (a->type == LEX_FIN) {
+        return erreur_fusionnee(a, ERR_SYNTAXE, "Expression inattendue à la fin de l'entrée");
+    }
+    return erreur_fusionnee(a, ERR_SYNTAXE, "Proposition ou parenthèse ouvrante attendue");
+}
+
+//non ::= "¬" non | primaire
+long analyser_non(AnalyseurFusionne *a) {
+    if (a->type != LEX_OPERATEUR || a->op->arite != 1) {
+        return analyser_primaire(a);
+    }
+    NodeType type = (NodeType)(a->op - operateurs);
+    if (++a->profondeur > PROFONDEUR_MAX) {
+        return erreur_fusionnee(a, ERR_SYNTAXE, "Formule trop imbriquée");
+    }
+    lexeme_suivant(a);
+    long operande = analyser_non(a);
+    a->profondeur--;
+    if (operande < 0) return -1;
+    return emettre_noeud(a, type, 0);
+}
+
+//binaire(p) ::= non ( op binaire(p') )*   pour les opérateurs op de précédence >= p
+//(p' = précédence de op pour un opérateur associatif à droite, précédence de op + 1 sinon)
+long analyser_binaire(AnalyseurFusionne *a, int precedence_min) {
+    if (++a->profondeur > PROFONDEUR_MAX) {
+        return erreur_fusionnee(a, ERR_SYNTAXE, "Formule trop imbriquée");
+    }
+    long gauche = analyser_non(a);
+    while (gauche >= 0 && a->type == LEX_OPERATEUR && a->op->arite == 2 && a->op->precedence >= precedence_min) {
+        const Operateur *op = a->op;
+        lexeme_suivant(a);
+        int suivante = op->associativite == ASSOC_DROITE ? op->precedence : op->precedence + 1;
+        if (analyser_binaire(a, suivante) < 0) return -1;
+        gauche = emettre_noeud(a, (NodeType)(op - operateurs), (uint32_t)gauche);
+    }
+    a->profondeur--;
+    return gauche;
+}
+
+//Fonction commune : analyse des octets [debut, fin) de la chaine
+//Parametre profondeur : imbrication déjà atteinte autour du segment (0 pour une formule entière)
+//Retourne l'indice de la racine, ou -1 en cas d'erreur
+long analyser_fusionne(AnalyseurFusionne *a, const char *chaine, int debut, int fin, int profondeur,
+                       Statut *statut) {
+    statut_ok(statut);
+    a->chaine = chaine;
+    a->pos = debut;
+    a->fin = fin;
+    a->profondeur = profondeur;
+    a->statut = statut;
+    if (debut >= fin) {
+        statut_definir(statut, ERR_CHAINE_VIDE, debut, "Chaine vide");
+        return -1;
+    }
+
+    lexeme_suivant(a);
+    long racine = analyser_binaire(a, 1);
+    if (racine >= 0 && a->type != LEX_FIN) {
+        return erreur_fusionnee(a, ERR_SYNTAXE, "Lexème inattendu après la fin de l'expression");
+    }
+    return racine;
+}
+
+//Fonction d'analyse d'un segment de chaine vers un arbre plat
+//Parametre chaine : chaine de caracteres
+//Parametre debut, fin : octets analysés [debut, fin)
+//Parametre arbre : ArbrePlat, les noeuds sont ajoutés après ceux déjà présents (qui ne sont pas modifiés)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne l'indice de la racine du segment, ou -1 en cas d'erreur (l'arbre retrouve alors sa taille initiale)
+long analyser_segment(const char *chaine, int debut, int fin, ArbrePlat *arbre, Statut *statut) {
+    return analyser_segment_profondeur(chaine, debut, fin, 0, arbre, statut);
+}
+
+//Fonction d'analyse d'un segment situé à l'intérieur d'une formule
+//Parametre profondeur : imbrication (parenthèses, négations, implications) autour du segment dans la
+//formule : la limite PROFONDEUR_MAX est atteinte au même endroit qu'en analysant la formule entière
+//Autres parametres et retour : voir analyser_segment
+long analyser_segment_profondeur(const char *chaine, int debut, int fin, int profondeur, ArbrePlat *arbre,
+                                 Statut *statut) {
+    AnalyseurFusionne a;
+    memset(&a, 0, sizeof(a));
+    a.arbre = arbre;
+    a.nb_noeuds = arbre->nb_noeuds;
+    uint32_t taille = arbre->nb_noeuds;
+    //Les trois analyses sont fusionnées : les noeuds ajoutés sont attribués à la phase syntaxique
+    PhaseMemoire phase = definir_phase_memoire(PHASE_SYNTAXIQUE);
+    long racine = analyser_fusionne(&a, chaine, debut, fin, profondeur, statut);
+    definir_phase_memoire(phase);
+    if (racine < 0) arbre->nb_noeuds = taille;
+    return racine;
+}
+
+//Fonction d'analyse d'une formule vers un arbre plat
+//Parametre chaine : chaine de caracteres
+//Parametre arbre : ArbrePlat, vidé puis rempli
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int analyser_formule(const char *chaine, ArbrePlat *arbre, Statut *statut) {
+    arbre->nb_noeuds = 0;
+    return analyser_segment(chaine, 0, strlen(chaine), arbre, statut) < 0 ? -1 : 0;
+}
+
+//Fonction d'analyse d'une formule avec production directe du programme (sans arbre)
+//Parametre chaine : chaine de caracteres
+//Parametre prog : tableau d'instructions
+//Parametre capacite : entier, taille du tableau
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_formule(const char *chaine, VMInstruction *prog, int capacite, Statut *statut) {
+    AnalyseurFusionne a;
+    memset(&a, 0, sizeof(a));
+    a.prog = prog;
+    a.capacite = capacite;
+    if (analyser_fusionne(&a, chaine, 0, strlen(chaine), 0, statut) < 0) return -1;
+    return (int)a.nb_noeuds;
+}
@@ -0,0 +1,29 @@
+#ifndef FRONTAL_H
+#define FRONTAL_H
+
+#include "erreurs.h"
+#include "arbreplat.h" //pour l'arbre plat produit et les instructions
+
+//Analyse d'une formule en un seul passage : les lexèmes sont lus à la demande dans la chaine
+//(pas de liste de lexèmes), chaque proposition est cherchée dans les propositions valides dès
+//qu'elle est lue, et les noeuds sont produits directement dans l'ordre postfixe.
+//Les erreurs sont celles des trois analyses séparées ; la position est toujours l'octet fautif
+//dans la chaine (la première erreur rencontrée en lisant la chaine de gauche à droite).
+
+//Analyse d'une formule vers un arbre plat (vidé puis rempli, sa mémoire est réutilisée)
+//Retourne 0, ou -1 en cas d'erreur
+int analyser_formule(const char* chaine, ArbrePlat* arbre, Statut* statut);
+
+//Analyse des octets [debut, fin) d'une chaine : les noeuds sont ajoutés à la suite de ceux de l'arbre
+//Retourne l'indice de la racine du segment, ou -1 en cas d'erreur
+long analyser_segment(const char* chaine, int debut, int fin, ArbrePlat* arbre, Statut* statut);
+
+//Analyse d'un segment entouré de profondeur niveaux d'imbrication dans la formule dont il fait partie
+long analyser_segment_profondeur(const char* chaine, int debut, int fin, int profondeur, ArbrePlat* arbre,
+                                 Statut* statut);
+
+//Analyse d'une formule et production directe du programme de la machine virtuelle
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_formule(const char* chaine, VMInstruction* prog, int capacite, Statut* statut);
+
+#endif
@@ -0,0 +1,690 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modeles.h"
+#include "allocateur.h"
+#include "cnf.h" //pour l'encodage de Tseitin de la formule
+
+
+//Nombre maximal de composantes gardées dans le cache
+#define MAX_ENTREES_CACHE (1 << 20)
+
+
+// ----------------------
+/*
+Grands entiers :
+   Le nombre de modèles peut dépasser 2^64 dès 65 propositions,
+   on utilise donc des entiers de précision arbitraire (addition, produit, décalage).
+   Si la mémoire manque, une opération donne un entier inconnu (taille -1), qui rend inconnus
+   les résultats des opérations suivantes.
+*/
+// ----------------------
+
+//Grand entier inconnu
+static GrandEntier ge_inconnu(void) {
+    return (GrandEntier){NULL, -1};
+}
+
+//Grand entier valant v
+static GrandEntier ge_petit(uint32_t v) {
+    GrandEntier n = {NULL, 0};
+    if (v) {
+        n.mots = mem_allouer(sizeof(uint32_t));
+        if (!n.mots) return ge_inconnu();
+        n.mots[0] = v;
+        n.taille = 1;
+    }
+    return n;
+}
+
+//Copie d'un grand entier
+static GrandEntier ge_copie(const GrandEntier *a) {
+    GrandEntier n = {NULL, a->taille};
+    if (a->taille > 0) {
+        n.mots = mem_allouer(a->taille * sizeof(uint32_t));
+        if (!n.mots) return ge_inconnu();
+        memcpy(n.mots, a->mots, a->taille * sizeof(uint32_t));
+    }
+    return n;
+}
+
+//On retire les mots de poids fort nuls
+static void ge_normaliser(GrandEntier *a) {
+    while (a->taille > 0 && a->mots[a->taille - 1] == 0) {
+        a->taille--;
+    }
+}
+
+//Addition : a += b
+static void ge_ajouter(GrandEntier *a, const GrandEntier *b) {
+    if (b->taille == 0 || a->taille < 0) return;
+    int taille = (a->taille > b->taille ? a->taille : b->taille) + 1;
+    uint32_t *mots = b->taille > 0 ? mem_reallouer(a->mots, taille * sizeof(uint32_t)) : NULL;
+    if (!mots) {
+        liberer_grand_entier(a);
+        *a = ge_inconnu();
+        return;
+    }
+    for (int i = a->taille; i < taille; i++) {
+        mots[i] = 0;
+    }
+    uint64_t retenue = 0;
+    for (int i = 0; i < taille; i++) {
+        uint64_t s = (uint64_t)mots[i] + (i < b->taille ? b->mots[i] : 0) + retenue;
+        mots[i] = (uint32_t)s;
+        retenue = s >> 32;
+    }
+    a->mots = mots;
+    a->taille = taille;
+    ge_normaliser(a);
+}
+
+//Produit : retourne a * b
+static GrandEntier ge_produit(const GrandEntier *a, const GrandEntier *b) {
+    GrandEntier r = {NULL, 0};
+    if (a->taille < 0 || b->taille < 0) return ge_inconnu();
+    if (a->taille == 0 || b->taille == 0) return r;
+    r.taille = a->taille + b->taille;
+    r.mots = mem_callouer(r.taille, sizeof(uint32_t));
+    if (!r.mots) return ge_inconnu();
+    for (int i = 0; i < a->taille; i++) {
+        uint64_t retenue = 0;
+        for (int j = 0; j < b->taille; j++) {
+            uint64_t p = (uint64_t)a->mots[i] * b->mots[j] + r.mots[i + j] + retenue;
+            r.mots[i + j] = (uint32_t)p;
+            retenue = p >> 32;
+        }
+        r.mots[i + b->taille] = (uint32_t)retenue;
+    }
+    ge_normaliser(&r);
+    return r;
+}
+
+//Décalage : a *= 2^k
+static void ge_decaler(GrandEntier *a, int k) {
+    if (a->taille <= 0 || k == 0) return;
+    int decalage_mots = k / 32, decalage_bits = k % 32;
+    int taille = a->taille + decalage_mots + 1;
+    uint32_t *mots = mem_callouer(taille, sizeof(uint32_t));
+    if (!mots) {
+        liberer_grand_entier(a);
+        *a = ge_inconnu();
+        return;
+    }
+    for (int i = 0; i < a->taille; i++) {
+        uint64_t v = (uint64_t)a->mots[i] << decalage_bits;
+        mots[i + decalage_mots] |= (uint32_t)v;
+        mots[i + decalage_mots + 1] |= (uint32_t)(v >> 32);
+    }
+    mem_liberer(a->mots);
+    a->mots = mots;
+    a->taille = taille;
+    ge_normaliser(a);
+}
+
+//Fonction de libération d'un grand entier
+void liberer_grand_entier(GrandEntier *n) {
+    mem_liberer(n->mots);
+    n->mots = NULL;
+    n->taille = 0;
+}
+
+//Fonction d'écriture décimale d'un grand entier
+//On divise successivement par 10^9 : chaque reste donne 9 chiffres décimaux
+//Retourne une chaine allouée (à libérer avec mem_liberer), ou NULL si la mémoire manque
+char *grand_entier_texte(const GrandEntier *n) {
+    if (n->taille < 0) return mem_dupliquer("?");
+    GrandEntier q = ge_copie(n);
+    int capacite = 10 * (n->taille + 1) + 1;
+    char *texte = q.taille >= 0 ? mem_allouer(capacite) : NULL;
+    if (!texte) {
+        liberer_grand_entier(&q);
+        return NULL;
+    }
+    int len = 0;
+
+    do {
+        uint64_t reste = 0;
+        for (int i = q.taille - 1; i >= 0; i--) {
+            uint64_t v = (reste << 32) | q.mots[i];
+            q.mots[i] = (uint32_t)(v / 1000000000u);
+            reste = v % 1000000000u;
+        }
+        ge_normaliser(&q);
+        //Les chiffres sont écrits à l'envers, on retournera la chaine à la fin
+        for (int k = 0; k < 9 && (q.taille > 0 || reste > 0 || k == 0); k++) {
+            texte[len++] = '0' + (char)(reste % 10);
+            reste /= 10;
+        }
+    } while (q.taille > 0);
+
+    for (int i = 0; i < len / 2; i++) {
+        char c = texte[i];
+        texte[i] = texte[len - 1 - i];
+        texte[len - 1 - i] = c;
+    }
+    texte[len] = '\0';
+    liberer_grand_entier(&q);
+    return texte;
+}
+
+
+// ----------------------
+/*
+Compteur de modèles :
+   La formule est encodée en clauses par Tseitin (chaque variable auxiliaire est déterminée par ses
+   opérandes, le nombre de modèles des clauses est donc celui de la formule).
+   On compte ensuite avec un DPLL : après chaque choix et propagation unitaire, les clauses restantes
+   sont découpées en composantes connexes (sans variable commune) dont les nombres de modèles se
+   multiplient. Chaque composante est gardée en cache, identifiée par ses variables libres et ses clauses.
+*/
+// ----------------------
+
+//Entrée du cache : clé [nb_vars, vars..., nb_clauses, clauses...] et nombre de modèles
+typedef struct {
+    int *cle;
+    int taille_cle;
+    unsigned hache;
+    GrandEntier valeur;
+} EntreeCache;
+
+//Etat du compteur
+typedef struct {
+    int nb_variables;
+
+    //Clauses stockées à la suite : clause c = litteraux[debut[c] .. debut[c] + longueur[c] - 1]
+    int nb_clauses, capacite_clauses;
+    int *debut, *longueur;
+    int *litteraux;
+    int nb_litteraux, capacite_litteraux;
+
+    //Clauses contenant chaque variable : occurrences[occ_debut[v] .. occ_debut[v + 1] - 1]
+    int *occ_debut, *occurrences;
+
+    signed char *valeur;        //-1 libre, 0 faux, 1 vrai
+    char *est_prop;             //1 si la variable est une proposition (et non une auxiliaire)
+    int *trail;                 //Variables affectées, dans l'ordre
+    int taille_trail;
+
+    int *marque, tampon;        //Clauses de la composante en cours : marque[c] == tampon
+    int *parent, *groupe, *score; //Tableaux de travail indicés par variable
+
+    EntreeCache *cache;
+    int taille_cache, nb_cache;
+
+    int memoire_manquante;      //1 si une clause de l'encodeur n'a pas pu être rangée
+} Compteur;
+
+static GrandEntier compter_composante(Compteur *c, const int *vars, int nv, const int *clauses, int nc);
+
+//Fonction recevant les clauses de l'encodeur : les littéraux répétés sont retirés
+//et les clauses toujours vraies (x ∨ ¬x) ignorées
+static void collecter_clause(const int *litteraux, int n, void *donnees) {
+    Compteur *c = donnees;
+    if (c->nb_clauses >= c->capacite_clauses) {
+        int capacite = c->capacite_clauses ? 2 * c->capacite_clauses : 256;
+        int *debut = mem_reallouer(c->debut, capacite * sizeof(int));
+        if (debut) c->debut = debut;
+        int *longueur = debut ? mem_reallouer(c->longueur, capacite * sizeof(int)) : NULL;
+        if (longueur) c->longueur = longueur;
+        if (!longueur) {
+            c->memoire_manquante = 1;
+            return;
+        }
+        c->capacite_clauses = capacite;
+    }
+    if (c->nb_litteraux + n > c->capacite_litteraux) {
+        int *nouveaux = mem_reallouer(c->litteraux, 2 * (c->capacite_litteraux + n) * sizeof(int));
+        if (!nouveaux) {
+            c->memoire_manquante = 1;
+            return;
+        }
+        c->litteraux = nouveaux;
+        c->capacite_litteraux = 2 * (c->capacite_litteraux + n);
+    }
+
+    int *clause = &c->litteraux[c->nb_litteraux];
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        int present = 0;
+        for (int j = 0; j < k; j++) {
+            if (clause[j] == -litteraux[i]) return; //Clause toujours vraie
+            if (clause[j] == litteraux[i]) present = 1;
+        }
+        if (!present) clause[k++] = litteraux[i];
+    }
+    c->debut[c->nb_clauses] = c->nb_litteraux;
+    c->longueur[c->nb_clauses] = k;
+    c->nb_clauses++;
+    c->nb_litteraux += k;
+}
+
+//Valeur d'un littéral : -1 si sa variable est libre, sinon 1 (vrai) ou 0 (faux)
+static int valeur_litteral(const Compteur *c, int l) {
+    int v = c->valeur[l > 0 ? l : -l];
+    if (v < 0) return -1;
+    return l > 0 ? v : !v;
+}
+
+//Retourne 1 si la clause est satisfaite par l'affectation courante
+static int clause_satisfaite(const Compteur *c, int clause) {
+    for (int i = 0; i < c->longueur[clause]; i++) {
+        if (valeur_litteral(c, c->litteraux[c->debut[clause] + i]) == 1) return 1;
+    }
+    return 0;
+}
+
+//Affecte le littéral l à vrai
+static void affecter(Compteur *c, int l) {
+    int v = l > 0 ? l : -l;
+    c->valeur[v] = l > 0;
+    c->trail[c->taille_trail++] = v;
+}
+
+//Annule les affectations faites après la position pos du trail
+static void annuler(Compteur *c, int pos) {
+    while (c->taille_trail > pos) {
+        c->valeur[c->trail[--c->taille_trail]] = -1;
+    }
+}
+
+//Propagation unitaire des affectations faites depuis la position pos du trail,
+//limitée aux clauses marquées (celles de la composante en cours)
+//Retourne 0 si une clause devient fausse (conflit), 1 sinon
+static int propager(Compteur *c, int pos) {
+    for (int t = pos; t < c->taille_trail; t++) {
+        int v = c->trail[t];
+        for (int k = c->occ_debut[v]; k < c->occ_debut[v + 1]; k++) {
+            int clause = c->occurrences[k];
+            if (c->marque[clause] != c->tampon) continue;
+
+            int libres = 0, dernier = 0, satisfaite = 0;
+            for (int i = 0; i < c->longueur[clause] && !satisfaite; i++) {
+                int l = c->litteraux[c->debut[clause] + i];
+                int val = valeur_litteral(c, l);
+                if (val == 1) satisfaite = 1;
+                else if (val < 0) { libres++; dernier = l; }
+            }
+            if (satisfaite) continue;
+            if (libres == 0) return 0;
+            if (libres == 1) affecter(c, dernier);
+        }
+    }
+    return 1;
+}
+
+//Marque les clauses de la composante en cours pour la propagation
+static void marquer_clauses(Compteur *c, const int *clauses, int nc) {
+    c->tampon++;
+    for (int i = 0; i < nc; i++) {
+        c->marque[clauses[i]] = c->tampon;
+    }
+}
+
+//Racine d'une variable dans l'union-find
+static int trouver(Compteur *c, int v) {
+    while (c->parent[v] != v) {
+        c->parent[v] = c->parent[c->parent[v]];
+        v = c->parent[v];
+    }
+    return v;
+}
+
+//Fonction comptant les modèles de l'affectation courante restreinte aux variables vars et clauses clauses :
+//les clauses non satisfaites sont découpées en composantes connexes comptées séparément,
+//chaque variable libre qui n'apparait plus dans aucune clause double le nombre de modèles
+//Retourne un entier inconnu si la mémoire manque
+static GrandEntier compter_residuel(Compteur *c, const int *vars, int nv, const int *clauses, int nc) {
+    int *restantes = mem_allouer((nc > 0 ? nc : 1) * sizeof(int));
+    if (!restantes) return ge_inconnu();
+    int nr = 0;
+    for (int i = 0; i < nc; i++) {
+        if (!clause_satisfaite(c, clauses[i])) restantes[nr++] = clauses[i];
+    }
+
+    //Union-find des variables libres reliées par une clause restante (score sert de drapeau "utilisée")
+    for (int i = 0; i < nv; i++) {
+        c->parent[vars[i]] = vars[i];
+        c->score[vars[i]] = 0;
+    }
+    for (int i = 0; i < nr; i++) {
+        int premiere = 0;
+        for (int j = 0; j < c->longueur[restantes[i]]; j++) {
+            int l = c->litteraux[c->debut[restantes[i]] + j];
+            int v = l > 0 ? l : -l;
+            if (c->valeur[v] >= 0) continue;
+            c->score[v] = 1;
+            if (!premiere) {
+                premiere = v;
+            } else {
+                int a = trouver(c, premiere), b = trouver(c, v);
+                if (a != b) c->parent[a] = b;
+            }
+        }
+    }
+
+    //Numérotation des composantes et variables isolées
+    int isolees = 0, nb_groupes = 0;
+    for (int i = 0; i < nv; i++) {
+        int v = vars[i];
+        if (c->valeur[v] >= 0) continue;
+        if (!c->score[v]) {
+            isolees++;
+            continue;
+        }
+        int r = trouver(c, v);
+        if (c->groupe[r] < 0) c->groupe[r] = nb_groupes++;
+    }
+
+    //Répartition des variables et des clauses par composante (listes triées comme vars et clauses)
+    int *nb_vars_g = mem_callouer(nb_groupes + 1, sizeof(int));
+    int *nb_clauses_g = mem_callouer(nb_groupes + 1, sizeof(int));
+    int *vars_g = mem_allouer((nv > 0 ? nv : 1) * sizeof(int));
+    int *clauses_g = mem_allouer((nr > 0 ? nr : 1) * sizeof(int));
+    int *groupe_clause = mem_allouer((nr > 0 ? nr : 1) * sizeof(int));
+    int *groupe_var = mem_allouer((nv > 0 ? nv : 1) * sizeof(int));
+    int *pos_v = mem_allouer((nb_groupes + 1) * sizeof(int));
+    int *pos_c = mem_allouer((nb_groupes + 1) * sizeof(int));
+    int memoire = nb_vars_g && nb_clauses_g && vars_g && clauses_g && groupe_clause && groupe_var && pos_v && pos_c;
+
+    if (memoire) {
+        for (int i = 0; i < nv; i++) {
+            int v = vars[i];
+            groupe_var[i] = (c->valeur[v] < 0 && c->score[v]) ? c->groupe[trouver(c, v)] : -1;
+            if (groupe_var[i] >= 0) nb_vars_g[groupe_var[i] + 1]++;
+        }
+        for (int i = 0; i < nr; i++) {
+            int v = 0;
+            for (int j = 0; j < c->longueur[restantes[i]] && !v; j++) {
+                int l = c->litteraux[c->debut[restantes[i]] + j];
+                if (c->valeur[l > 0 ? l : -l] < 0) v = l > 0 ? l : -l;
+            }
+            groupe_clause[i] = c->groupe[trouver(c, v)];
+            nb_clauses_g[groupe_clause[i] + 1]++;
+        }
+        for (int g = 0; g < nb_groupes; g++) {
+            nb_vars_g[g + 1] += nb_vars_g[g];
+            nb_clauses_g[g + 1] += nb_clauses_g[g];
+        }
+        memcpy(pos_v, nb_vars_g, (nb_groupes + 1) * sizeof(int));
+        memcpy(pos_c, nb_clauses_g, (nb_groupes + 1) * sizeof(int));
+        for (int i = 0; i < nv; i++) {
+            if (groupe_var[i] >= 0) vars_g[pos_v[groupe_var[i]]++] = vars[i];
+        }
+        for (int i = 0; i < nr; i++) {
+            clauses_g[pos_c[groupe_clause[i]]++] = restantes[i];
+        }
+    }
+
+    //Remise à zéro des tableaux de travail avant les appels récursifs
+    for (int i = 0; i < nv; i++) {
+        c->groupe[vars[i]] = -1;
+        c->score[vars[i]] = 0;
+    }
+
+    GrandEntier resultat = memoire ? ge_petit(1) : ge_inconnu();
+    ge_decaler(&resultat, isolees);
+    for (int g = 0; g < nb_groupes && resultat.taille > 0; g++) {
+        GrandEntier n = compter_composante(c, &vars_g[nb_vars_g[g]], nb_vars_g[g + 1] - nb_vars_g[g],
+                                           &clauses_g[nb_clauses_g[g]], nb_clauses_g[g + 1] - nb_clauses_g[g]);
+        GrandEntier p = ge_produit(&resultat, &n);
+        liberer_grand_entier(&resultat);
+        liberer_grand_entier(&n);
+        resultat = p;
+    }
+
+    mem_liberer(restantes);
+    mem_liberer(nb_vars_g);
+    mem_liberer(nb_clauses_g);
+    mem_liberer(vars_g);
+    mem_liberer(clauses_g);
+    mem_liberer(groupe_clause);
+    mem_liberer(groupe_var);
+    mem_liberer(pos_v);
+    mem_liberer(pos_c);
+    return resultat;
+}
+
+//Construction de la clé de cache d'une composante
+//Retourne la clé, ou NULL si la mémoire manque
+static int *cle_composante(const int *vars, int nv, const int *clauses, int nc, int *taille, unsigned *hache) {
+    *taille = nv + nc + 2;
+    int *cle = mem_allouer(*taille * sizeof(int));
+    if (!cle) return NULL;
+    cle[0] = nv;
+    memcpy(&cle[1], vars, nv * sizeof(int));
+    cle[nv + 1] = nc;
+    memcpy(&cle[nv + 2], clauses, nc * sizeof(int));
+
+    unsigned h = 2166136261u;
+    for (int i = 0; i < *taille; i++) {
+        h = (h ^ (unsigned)cle[i]) * 16777619u;
+    }
+    *hache = h;
+    return cle;
+}
+
+//Recherche d'une composante dans le cache
+//Retourne l'indice de l'entrée trouvée, ou de la case vide où l'insérer
+static int chercher_cache(const Compteur *c, const int *cle, int taille, unsigned hache) {
+    int i = hache & (c->taille_cache - 1);
+    while (c->cache[i].cle) {
+        if (c->cache[i].hache == hache && c->cache[i].taille_cle == taille &&
+            memcmp(c->cache[i].cle, cle, taille * sizeof(int)) == 0) {
+            return i;
+        }
+        i = (i + 1) & (c->taille_cache - 1);
+    }
+    return i;
+}
+
+//Agrandissement du cache quand il est à moitié plein
+//Retourne 0, ou -1 si la mémoire manque (le cache est alors inchangé)
+static int agrandir_cache(Compteur *c) {
+    EntreeCache *nouveau = mem_callouer(2 * c->taille_cache, sizeof(EntreeCache));
+    if (!nouveau) return -1;
+    EntreeCache *ancien = c->cache;
+    int ancienne_taille = c->taille_cache;
+    c->taille_cache *= 2;
+    c->cache = nouveau;
+    for (int i = 0; i < ancienne_taille; i++) {
+        if (ancien[i].cle) {
+            c->cache[chercher_cache(c, ancien[i].cle, ancien[i].taille_cle, ancien[i].hache)] = ancien[i];
+        }
+    }
+    mem_liberer(ancien);
+    return 0;
+}
+
+//Fonction comptant les modèles d'une composante connexe (variables libres vars, clauses non satisfaites)
+//Retourne un entier inconnu si la mémoire manque
+static GrandEntier compter_composante(Compteur *c, const int *vars, int nv, const int *clauses, int nc) {
+    int taille_cle;
+    unsigned hache;
+    int *cle = cle_composante(vars, nv, clauses, nc, &taille_cle, &hache);
+    if (!cle) return ge_inconnu();
+    int place = chercher_cache(c, cle, taille_cle, hache);
+    if (c->cache[place].cle) {
+        mem_liberer(cle);
+        return ge_copie(&c->cache[place].valeur);
+    }
+
+    //Choix de la variable de branchement : la plus fréquente, en préférant les propositions
+    //(une fois les propositions fixées, la propagation détermine les variables auxiliaires)
+    for (int i = 0; i < nc; i++) {
+        for (int j = 0; j < c->longueur[clauses[i]]; j++) {
+            int l = c->litteraux[c->debut[clauses[i]] + j];
+            c->score[l > 0 ? l : -l]++;
+        }
+    }
+    int choix = 0, meilleur = -1;
+    for (int i = 0; i < nv; i++) {
+        int v = vars[i];
+        int s = c->score[v] + (c->est_prop[v] ? c->nb_clauses : 0);
+        if (c->valeur[v] < 0 && s > meilleur) {
+            meilleur = s;
+            choix = v;
+        }
+    }
+    for (int i = 0; i < nc; i++) {
+        for (int j = 0; j < c->longueur[clauses[i]]; j++) {
+            int l = c->litteraux[c->debut[clauses[i]] + j];
+            c->score[l > 0 ? l : -l] = 0;
+        }
+    }
+
+    GrandEntier total = {NULL, 0};
+    for (int val = 1; val >= 0 && total.taille >= 0; val--) {
+        int pos = c->taille_trail;
+        affecter(c, val ? choix : -choix);
+        marquer_clauses(c, clauses, nc);
+        if (propager(c, pos)) {
+            GrandEntier n = compter_residuel(c, vars, nv, clauses, nc);
+            ge_ajouter(&total, &n);
+            liberer_grand_entier(&n);
+        }
+        annuler(c, pos);
+    }
+
+    //Mise en cache du résultat (la position a pu changer pendant les appels récursifs) ;
+    //si la mémoire manque, le résultat n'est simplement pas gardé
+    GrandEntier copie = {NULL, -1};
+    if (total.taille >= 0 && c->nb_cache < MAX_ENTREES_CACHE &&
+        (2 * (c->nb_cache + 1) <= c->taille_cache || agrandir_cache(c) == 0)) {
+        copie = ge_copie(&total);
+    }
+    if (copie.taille >= 0) {
+        place = chercher_cache(c, cle, taille_cle, hache);
+        c->cache[place] = (EntreeCache){cle, taille_cle, hache, copie};
+        c->nb_cache++;
+    } else {
+        mem_liberer(cle);
+    }
+    return total;
+}
+
+//Fonction globale de comptage des modèles
+//Parametre ast : ASTNode
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre de valuations des propositions de la formule qui la satisfont,
+//ou 0 si l'arbre est invalide ou si la mémoire manque
+GrandEntier count_models(ASTNode *ast, Statut *statut) {
+    GrandEntier resultat = {NULL, 0};
+    Compteur c;
+    memset(&c, 0, sizeof(c));
+    statut_ok(statut);
+
+    //Encodage de la formule, affirmée par une clause unitaire
+    EncodeurCNF enc;
+    encodeur_initialiser(&enc, collecter_clause, &c);
+    int racine = encoder_formule(&enc, ast);
+    if (racine != 0) encodeur_clause(&enc, &racine, 1);
+    c.nb_variables = enc.nb_variables;
+
+    int n = c.nb_variables + 1;
+    int memoire = racine != 0 && !c.memoire_manquante;
+    if (memoire) {
+        c.valeur = mem_allouer(n);
+        c.est_prop = mem_callouer(n, 1);
+        c.trail = mem_allouer(n * sizeof(int));
+        c.parent = mem_allouer(n * sizeof(int));
+        c.groupe = mem_allouer(n * sizeof(int));
+        c.score = mem_callouer(n, sizeof(int));
+        c.occ_debut = mem_callouer(n + 1, sizeof(int));
+        c.occurrences = mem_allouer((c.nb_litteraux > 0 ? c.nb_litteraux : 1) * sizeof(int));
+        c.marque = mem_callouer(c.nb_clauses > 0 ? c.nb_clauses : 1, sizeof(int));
+        c.taille_cache = 1024;
+        c.cache = mem_callouer(c.taille_cache, sizeof(EntreeCache));
+        memoire = c.valeur && c.est_prop && c.trail && c.parent && c.groupe && c.score &&
+                  c.occ_debut && c.occurrences && c.marque && c.cache;
+    }
+    if (memoire) {
+        memset(c.valeur, -1, n);
+        for (int v = 0; v < n; v++) {
+            c.groupe[v] = -1;
+        }
+        for (int i = 0; i < enc.nb_props; i++) {
+            c.est_prop[enc.variables[i]] = 1;
+        }
+    }
+    int arbre_invalide = racine == 0 && !enc.memoire_manquante;
+    encodeur_liberer(&enc);
+
+    //Listes d'occurrences (tri par comptage)
+    int *pos = memoire ? mem_allouer((n + 1) * sizeof(int)) : NULL;
+    if (pos) {
+        for (int i = 0; i < c.nb_litteraux; i++) {
+            int l = c.litteraux[i];
+            c.occ_debut[(l > 0 ? l : -l) + 1]++;
+        }
+        for (int v = 0; v < n; v++) {
+            c.occ_debut[v + 1] += c.occ_debut[v];
+        }
+        memcpy(pos, c.occ_debut, (n + 1) * sizeof(int));
+        for (int cl = 0; cl < c.nb_clauses; cl++) {
+            for (int i = 0; i < c.longueur[cl]; i++) {
+                int l = c.litteraux[c.debut[cl] + i];
+                c.occurrences[pos[l > 0 ? l : -l]++] = cl;
+            }
+        }
+        mem_liberer(pos);
+    }
+
+    //Toutes les variables et toutes les clauses forment la composante de départ
+    int *vars = pos ? mem_allouer(n * sizeof(int)) : NULL;
+    int *clauses = vars ? mem_allouer((c.nb_clauses > 0 ? c.nb_clauses : 1) * sizeof(int)) : NULL;
+    if (clauses) {
+        for (int v = 1; v < n; v++) {
+            vars[v - 1] = v;
+        }
+        for (int cl = 0; cl < c.nb_clauses; cl++) {
+            clauses[cl] = cl;
+        }
+        marquer_clauses(&c, clauses, c.nb_clauses);
+
+        //Propagation des clauses unitaires de départ
+        int conflit = 0;
+        for (int cl = 0; cl < c.nb_clauses && !conflit; cl++) {
+            if (c.longueur[cl] == 0) {
+                conflit = 1;
+            } else if (c.longueur[cl] == 1) {
+                int val = valeur_litteral(&c, c.litteraux[c.debut[cl]]);
+                if (val == 0) conflit = 1;
+                else if (val < 0) affecter(&c, c.litteraux[c.debut[cl]]);
+            }
+        }
+        if (!conflit && propager(&c, 0)) {
+            resultat = compter_residuel(&c, vars, c.nb_variables, clauses, c.nb_clauses);
+        }
+    }
+    if (arbre_invalide) {
+        statut_definir(statut, ERR_ARITE, -1, "Arbre invalide");
+    } else if (!clauses || resultat.taille < 0) {
+        liberer_grand_entier(&resultat);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    }
+
+    for (int i = 0; c.cache && i < c.taille_cache; i++) {
+        if (c.cache[i].cle) {
+            mem_liberer(c.cache[i].cle);
+            liberer_grand_entier(&c.cache[i].valeur);
+        }
+    }
+    mem_liberer(c.cache);
+    mem_liberer(vars);
+    mem_liberer(clauses);
+    mem_liberer(c.debut);
+    mem_liberer(c.longueur);
+    mem_liberer(c.litteraux);
+    mem_liberer(c.occ_debut);
+    mem_liberer(c.occurrences);
+    mem_liberer(c.valeur);
+    mem_liberer(c.est_prop);
+    mem_liberer(c.trail);
+    mem_liberer(c.parent);
+    mem_liberer(c.groupe);
+    mem_liberer(c.score);
+    mem_liberer(c.marque);
+    return resultat;
+}
@@ -0,0 +1,27 @@
+#ifndef MODELES_H
+#define MODELES_H
+
+#include <stdint.h>
+#include "anasynt.h" //pour les arbres syntaxiques
+#include "erreurs.h"
+
+//Entier naturel de précision arbitraire, en base 2^32 (mots de poids faible en premier)
+//taille = 0 représente zéro, taille = -1 un résultat inconnu (mémoire manquante pendant le calcul)
+typedef struct {
+    uint32_t* mots;
+    int taille;
+} GrandEntier;
+
+//Compte les valuations des propositions de la formule qui la rendent vraie (#SAT)
+//Les propositions comptées sont celles qui apparaissent dans la formule
+//Retourne 0 si l'arbre est invalide ou si la mémoire manque (statut est alors rempli, peut être NULL)
+GrandEntier count_models(ASTNode* ast, Statut* statut);
+
+//Ecriture décimale d'un grand entier ("?" s'il est inconnu)
+//Retourne une chaine allouée (à libérer avec mem_liberer), ou NULL si la mémoire manque
+char* grand_entier_texte(const GrandEntier* n);
+
+//Libération d'un grand entier
+void liberer_grand_entier(GrandEntier* n);
+
+#endif
@@ -0,0 +1,339 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+//Pour projeter les fichiers de colonnes en mémoire (mmap)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "notation.h"
+#include "registres.h"
+#include "allocateur.h"
+
+
+//Etat partagé d'une notation
+typedef struct {
+    const FichierColonnes *entree;
+    FichierColonnes *sortie;
+    const ProgrammeRegistres *formules;
+    int nb_formules;
+    const uint32_t *colonnes_lues;      //Colonne de l'entrée de chaque proposition utilisée
+    int nb_utilisees;
+    uint64_t mots_par_bloc;
+    uint64_t masque_dernier_mot;        //Bits des enregistrements présents dans le dernier mot
+} Notation;
+
+//Travail d'un thread : blocs [bloc_debut, bloc_fin)
+typedef struct {
+    const Notation *n;
+    uint64_t bloc_debut;
+    uint64_t bloc_fin;
+    uint64_t *valuations;               //mots_par_bloc lignes de nb_utilisees mots
+} TravailNotation;
+
+
+// ----------------------
+/*
+Fichiers de colonnes
+*/
+// ----------------------
+
+//Taille d'un fichier de colonnes, 0 si elle dépasse size_t
+static size_t taille_fichier_colonnes(uint64_t nb_colonnes, uint64_t mots_par_colonne) {
+    uint64_t max_mots = (SIZE_MAX - sizeof(EnteteColonnes)) / sizeof(uint64_t);
+    if (nb_colonnes && mots_par_colonne > max_mots / nb_colonnes) return 0;
+    return sizeof(EnteteColonnes) + (size_t)(nb_colonnes * mots_par_colonne) * sizeof(uint64_t);
+}
+
+//Fonction d'ouverture d'un fichier de colonnes en lecture seule
+//Parametre chemin : chaine de caractères
+//Parametre f : FichierColonnes rempli
+//Parametre statut : Statut (peut être NULL)
+//Retourne 0, ou -1 si le fichier est illisible ou invalide
+int ouvrir_colonnes(const char *chemin, FichierColonnes *f, Statut *statut) {
+    memset(f, 0, sizeof(*f));
+    statut_ok(statut);
+    int fd = open(chemin, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) close(fd);
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de colonnes illisible");
+        return -1;
+    }
+    size_t taille_image = (size_t)st.st_size;
+    if (taille_image < sizeof(EnteteColonnes)) {
+        close(fd);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Fichier de colonnes tronqué");
+        return -1;
+    }
+    void *image = mmap(NULL, taille_image, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Projection du fichier de colonnes impossible");
+        return -1;
+    }
+
+    const EnteteColonnes *entete = image;
+    int valide = memcmp(entete->magie, MAGIE_COLONNES, 8) == 0 &&
+                 entete->mots_par_colonne == entete->nb_enregistrements / 64 + (entete->nb_enregistrements % 64 != 0) &&
+                 taille_fichier_colonnes(entete->nb_colonnes, entete->mots_par_colonne) == taille_image;
+    if (!valide) {
+        munmap(image, taille_image);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Fichier de colonnes invalide");
+        return -1;
+    }
+    f->nb_colonnes = entete->nb_colonnes;
+    f->nb_enregistrements = entete->nb_enregistrements;
+    f->mots_par_colonne = entete->mots_par_colonne;
+    f->mots = (uint64_t *)((unsigned char *)image + sizeof(EnteteColonnes));
+    f->image = image;
+    f->taille_image = taille_image;
+    return 0;
+}
+
+//Fonction de création d'un fichier de colonnes (toutes les valeurs à 0), projeté en lecture et écriture
+//Parametre chemin : chaine de caractères (un fichier existant est remplacé)
+//Parametre nb_colonnes : entier
+//Parametre nb_enregistrements : entier
+//Parametre f : FichierColonnes rempli
+//Parametre statut : Statut (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int creer_colonnes(const char *chemin, uint32_t nb_colonnes, uint64_t nb_enregistrements, FichierColonnes *f,
+                   Statut *statut) {
+    memset(f, 0, sizeof(*f));
+    statut_ok(statut);
+    uint64_t mots_par_colonne = nb_enregistrements / 64 + (nb_enregistrements % 64 != 0);
+    size_t taille_image = taille_fichier_colonnes(nb_colonnes, mots_par_colonne);
+    if (!taille_image) {
+        statut_definir(statut, ERR_ARGUMENT, -1, "Fichier de colonnes trop grand");
+        return -1;
+    }
+    int fd = open(chemin, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, (off_t)taille_image) < 0) {
+        if (fd >= 0) close(fd);
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de colonnes impossible à créer");
+        return -1;
+    }
+    void *image = mmap(NULL, taille_image, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Projection du fichier de colonnes impossible");
+        return -1;
+    }
+
+    //Le fichier agrandi par ftruncate est déjà rempli de 0 : seul l'entête est écrit
+    EnteteColonnes *entete = image;
+    memcpy(entete->magie, MAGIE_COLONNES, 8);
+    entete->nb_colonnes = nb_colonnes;
+    entete->reserve = 0;
+    entete->nb_enregistrements = nb_enregistrements;
+    entete->mots_par_colonne = mots_par_colonne;
+    f->nb_colonnes = nb_colonnes;
+    f->nb_enregistrements = nb_enregistrements;
+    f->mots_par_colonne = mots_par_colonne;
+    f->mots = (uint64_t *)((unsigned char *)image + sizeof(EnteteColonnes));
+    f->image = image;
+    f->taille_image = taille_image;
+    return 0;
+}
+
+//Fonction de fermeture d'un fichier de colonnes
+void fermer_colonnes(FichierColonnes *f) {
+    if (f->image) {
+        munmap(f->image, f->taille_image);
+    }
+    memset(f, 0, sizeof(*f));
+}
+
+
+// ----------------------
+/*
+Notation par blocs
+   Les mots d'un bloc sont copiés de chaque colonne utilisée dans un tampon de lignes (la ligne w
+   contient le mot w de chaque proposition utilisée, comme les colonnes attendues par
+   executer_registres_64), puis chaque formule est exécutée sur les lignes du bloc. Le tampon tient
+   dans le cache de premier niveau et ne sert qu'au thread qui le possède.
+*/
+// ----------------------
+
+//Fonction de préchargement des mots d'un bloc dans le cache
+static void precharger_bloc_notation(const Notation *n, uint64_t debut, uint64_t nb_mots) {
+    for (int k = 0; k < n->nb_utilisees; k++) {
+        const uint64_t *colonne = colonne_fichier(n->entree, n->colonnes_lues[k]) + debut;
+        for (uint64_t w = 0; w < nb_mots; w += 8) {
+            __builtin_prefetch(colonne + w, 0, 0);
+        }
+    }
+}
+
+//Fonction d'un thread de notation
+static void *travailleur_notation(void *arg) {
+    TravailNotation *t = arg;
+    const Notation *n = t->n;
+    const uint64_t total = n->entree->mots_par_colonne;
+    const int nu = n->nb_utilisees;
+    uint64_t *lignes = t->valuations;
+    for (uint64_t bloc = t->bloc_debut; bloc < t->bloc_fin; bloc++) {
+        uint64_t debut = bloc * n->mots_par_bloc;
+        uint64_t nb_mots = total - debut < n->mots_par_bloc ? total - debut : n->mots_par_bloc;
+        if (bloc + 1 < t->bloc_fin) {
+            uint64_t suivant = debut + nb_mots;
+            precharger_bloc_notation(n, suivant, total - suivant < n->mots_par_bloc ? total - suivant : n->mots_par_bloc);
+        }
+
+        //Copie des colonnes utilisées en lignes
+        for (int k = 0; k < nu; k++) {
+            const uint64_t *colonne = colonne_fichier(n->entree, n->colonnes_lues[k]) + debut;
+            for (uint64_t w = 0; w < nb_mots; w++) lignes[w * nu + k] = colonne[w];
+        }
+
+        for (int f = 0; f < n->nb_formules; f++) {
+            const ProgrammeRegistres *p = &n->formules[f];
+            uint64_t *resultats = colonne_fichier(n->sortie, (uint32_t)f) + debut;
+            for (uint64_t w = 0; w < nb_mots; w++) {
+                resultats[w] = executer_registres_64(p, lignes + w * nu);
+            }
+            if (debut + nb_mots == total) resultats[nb_mots - 1] &= n->masque_dernier_mot;
+        }
+    }
+    return NULL;
+}
+
+//Fonction de notation des enregistrements d'un fichier de colonnes
+//Parametre entree : FichierColonnes des valuations (colonne i : proposition i)
+//Parametre sortie : FichierColonnes des résultats (nb_formules colonnes, mêmes enregistrements)
+//Parametre progs : programmes de la machine virtuelle
+//Parametre tailles : tailles des programmes
+//Parametre nb_formules : entier
+//Parametre nb_threads : entier, <= 0 pour utiliser tous les processeurs
+//Parametre rapport : RapportNotation (peut être NULL)
+//Parametre statut : Statut (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur (programme refusé, proposition sans colonne, fichiers incompatibles)
+int noter_colonnes(const FichierColonnes *entree, FichierColonnes *sortie, const VMInstruction *const *progs,
+                   const int *tailles, int nb_formules, int nb_threads, RapportNotation *rapport, Statut *statut) {
+    statut_ok(statut);
+    if (rapport) memset(rapport, 0, sizeof(*rapport));
+    if (nb_formules < 0 || sortie->nb_colonnes < (uint32_t)nb_formules ||
+        sortie->nb_enregistrements != entree->nb_enregistrements) {
+        statut_definir(statut, ERR_ARGUMENT, -1, "Fichier de résultats incompatible avec l'entrée");
+        return -1;
+    }
+
+    PhaseMemoire phase = definir_phase_memoire(PHASE_COMPILATION);
+    ProgrammeRegistres *formules = mem_callouer(nb_formules > 0 ? nb_formules : 1, sizeof(ProgrammeRegistres));
+    int *locale = mem_allouer((entree->nb_colonnes > 0 ? entree->nb_colonnes : 1) * sizeof(int));
+    uint32_t *colonnes_lues = mem_allouer((entree->nb_colonnes > 0 ? entree->nb_colonnes : 1) * sizeof(uint32_t));
+    int ok = formules && locale && colonnes_lues;
+    if (!ok) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    for (uint32_t c = 0; ok && c < entree->nb_colonnes; c++) locale[c] = -1;
+
+    //Compilation, puis renumérotation des propositions selon leur ordre d'apparition
+    int nb_utilisees = 0;
+    int compilees = 0;
+    for (int f = 0; ok && f < nb_formules; f++) {
+        ok = compiler_registres(progs[f], tailles[f], &formules[f], statut) == 0;
+        if (!ok) break;
+        compilees++;
+        for (int k = 0; ok && k < formules[f].taille; k++) {
+            InstructionRegistre *i = &formules[f].code[k];
+            if (i->code != REG_CHARGER << 4) continue;
+            if (i->a >= entree->nb_colonnes) {
+                statut_definir(statut, ERR_PROP_INVALIDE, -1, "Proposition sans colonne dans le fichier d'entrée");
+                ok = 0;
+                break;
+            }
+            if (locale[i->a] < 0) {
+                locale[i->a] = nb_utilisees;
+                colonnes_lues[nb_utilisees++] = i->a;
+            }
+            i->a = (uint32_t)locale[i->a];
+        }
+    }
+    definir_phase_memoire(phase);
+
+    Notation n = {entree, sortie, formules, nb_formules, colonnes_lues, nb_utilisees, 0, ~0ULL};
+    n.mots_par_bloc = TAILLE_BLOC_NOTATION / (sizeof(uint64_t) * (nb_utilisees > 0 ? nb_utilisees : 1));
+    if (n.mots_par_bloc == 0) n.mots_par_bloc = 1;
+    if (entree->nb_enregistrements % 64) n.masque_dernier_mot = (1ULL << (entree->nb_enregistrements % 64)) - 1;
+    uint64_t nb_blocs = (entree->mots_par_colonne + n.mots_par_bloc - 1) / n.mots_par_bloc;
+
+    if (nb_threads <= 0) {
+        nb_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (nb_threads < 1) nb_threads = 1;
+    if (nb_threads > MAX_THREADS_NOTATION) nb_threads = MAX_THREADS_NOTATION;
+    if ((uint64_t)nb_threads > nb_blocs) nb_threads = nb_blocs > 0 ? (int)nb_blocs : 1;
+
+    //Un tampon de lignes par thread, alloué avant le départ des threads
+    TravailNotation travaux[MAX_THREADS_NOTATION];
+    int nb_tampons = 0;
+    for (int t = 0; ok && t < nb_threads; t++) {
+        travaux[t] = (TravailNotation){&n, nb_blocs * t / nb_threads, nb_blocs * (t + 1) / nb_threads, NULL};
+        travaux[t].valuations = mem_allouer(n.mots_par_bloc * (nb_utilisees > 0 ? nb_utilisees : 1) * sizeof(uint64_t));
+        if (!travaux[t].valuations) {
+            statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+            ok = 0;
+        } else {
+            nb_tampons++;
+        }
+    }
+
+    struct timespec debut, fin;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    if (ok && nb_formules > 0) {
+        pthread_t threads[MAX_THREADS_NOTATION];
+        int lance[MAX_THREADS_NOTATION];
+        for (int t = 1; t < nb_threads; t++) {
+            lance[t] = pthread_create(&threads[t], NULL, travailleur_notation, &travaux[t]) == 0;
+        }
+        travailleur_notation(&travaux[0]);
+        for (int t = 1; t < nb_threads; t++) {
+            //Un thread qui n'a pas pu être créé laisse sa part au thread appelant
+            if (lance[t]) pthread_join(threads[t], NULL);
+            else travailleur_notation(&travaux[t]);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+
+    if (ok && rapport) {
+        rapport->nb_enregistrements = entree->nb_enregistrements;
+        rapport->nb_formules = nb_formules;
+        rapport->nb_props_utilisees = nb_utilisees;
+        rapport->nb_threads = nb_threads;
+        rapport->mots_par_bloc = n.mots_par_bloc;
+        rapport->secondes = (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+        rapport->enregistrements_par_seconde =
+            rapport->secondes > 0 ? entree->nb_enregistrements / rapport->secondes : 0;
+    }
+
+    for (int t = 0; t < nb_tampons; t++) mem_liberer(travaux[t].valuations);
+    for (int f = 0; f < compilees; f++) liberer_programme_registres(&formules[f]);
+    mem_liberer(formules);
+    mem_liberer(locale);
+    mem_liberer(colonnes_lues);
+    return ok ? 0 : -1;
+}
+
+//Fonction de notation d'un fichier de colonnes vers un nouveau fichier de résultats
+//Parametre chemin_entree, chemin_sortie : chaines de caractères (le fichier de résultats est supprimé en cas d'erreur)
+//Autres parametres : voir noter_colonnes
+//Retourne 0, ou -1 en cas d'erreur
+int noter_fichier(const char *chemin_entree, const char *chemin_sortie, const VMInstruction *const *progs,
+                  const int *tailles, int nb_formules, int nb_threads, RapportNotation *rapport, Statut *statut) {
+    FichierColonnes entree, sortie;
+    if (ouvrir_colonnes(chemin_entree, &entree, statut) < 0) return -1;
+    if (creer_colonnes(chemin_sortie, nb_formules > 0 ? (uint32_t)nb_formules : 0, entree.nb_enregistrements, &sortie,
+                       statut) < 0) {
+        fermer_colonnes(&entree);
+        return -1;
+    }
+    int r = noter_colonnes(&entree, &sortie, progs, tailles, nb_formules, nb_threads, rapport, statut);
+    fermer_colonnes(&sortie);
+    fermer_colonnes(&entree);
+    if (r < 0) unlink(chemin_sortie);
+    return r;
+}
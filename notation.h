@@ -0,0 +1,82 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "erreurs.h"
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Notation d'enregistrements en colonnes : chaque enregistrement est une valuation des propositions.
+//Les valuations sont lues dans un fichier en colonnes de bits projeté en mémoire (une colonne
+//par proposition) et les résultats sont écrits dans un fichier de même format (une colonne par
+//formule), sans allocation ni analyse par enregistrement. Disposition d'un fichier :
+//  EnteteColonnes
+//  uint64_t colonnes[nb_colonnes][mots_par_colonne]   le bit j du mot i d'une colonne est la valeur
+//                                                     de l'enregistrement 64 * i + j
+//Les bits au-delà de nb_enregistrements dans le dernier mot valent 0.
+//
+//Les enregistrements sont traités par blocs qui tiennent dans le cache : les mots du bloc des
+//propositions utilisées sont copiés ligne par ligne (un mot de chaque proposition à la suite),
+//puis chaque formule, compilée en code à registres (registres.h), est exécutée sur tout le bloc.
+//Chaque thread traite une suite contiguë de blocs et précharge le bloc suivant.
+
+#define MAGIE_COLONNES "PROPCOL1"
+
+//Taille visée des valuations d'un bloc copiées (octets)
+#define TAILLE_BLOC_NOTATION (32 * 1024)
+
+#define MAX_THREADS_NOTATION 64
+
+typedef struct {
+    char magie[8];
+    uint32_t nb_colonnes;
+    uint32_t reserve;
+    uint64_t nb_enregistrements;
+    uint64_t mots_par_colonne;
+} EnteteColonnes;
+
+typedef struct {
+    uint32_t nb_colonnes;
+    uint64_t nb_enregistrements;
+    uint64_t mots_par_colonne;
+    uint64_t* mots;             //Colonne c : mots + c * mots_par_colonne (lecture seule pour un fichier ouvert)
+    void* image;
+    size_t taille_image;
+} FichierColonnes;
+
+typedef struct {
+    uint64_t nb_enregistrements;
+    int nb_formules;
+    int nb_props_utilisees;     //Colonnes lues
+    int nb_threads;
+    uint64_t mots_par_bloc;
+    double secondes;
+    double enregistrements_par_seconde;
+} RapportNotation;
+
+//Colonne c d'un fichier
+static inline uint64_t* colonne_fichier(const FichierColonnes* f, uint32_t c) {
+    return f->mots + (size_t)c * f->mots_par_colonne;
+}
+
+//Ouverture en lecture seule (entête et taille vérifiés). Retourne 0 ou -1
+int ouvrir_colonnes(const char* chemin, FichierColonnes* f, Statut* statut);
+
+//Création d'un fichier de colonnes à 0, projeté en lecture et écriture. Retourne 0 ou -1
+int creer_colonnes(const char* chemin, uint32_t nb_colonnes, uint64_t nb_enregistrements, FichierColonnes* f,
+                   Statut* statut);
+
+//Fin de la projection (les écritures sont dans le fichier)
+void fermer_colonnes(FichierColonnes* f);
+
+//Notation : la colonne f de sortie reçoit les résultats du programme progs[f] (opérandes de VM_LOAD :
+//colonnes de l'entrée). sortie doit avoir nb_formules colonnes et autant d'enregistrements que
+//l'entrée. nb_threads <= 0 : tous les processeurs. Retourne 0, ou -1 en cas d'erreur
+int noter_colonnes(const FichierColonnes* entree, FichierColonnes* sortie, const VMInstruction* const* progs,
+                   const int* tailles, int nb_formules, int nb_threads, RapportNotation* rapport, Statut* statut);
+
+//Notation d'un fichier vers un nouveau fichier de résultats. Retourne 0, ou -1 en cas d'erreur
+int noter_fichier(const char* chemin_entree, const char* chemin_sortie, const VMInstruction* const* progs,
+                  const int* tailles, int nb_formules, int nb_threads, RapportNotation* rapport, Statut* statut);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef OPERATEURS_H
+#define OPERATEURS_H
+
+#include <stdint.h>
+#include <string.h>
+#include "anasynt.h" //pour NodeType
+#include "runtime.h" //pour VMOpcode
+
+//Table des opérateurs logiques : c'est la seule description des opérateurs, utilisée par
+//l'analyse lexicale (symbole UTF-8 -> lexème), l'analyse syntaxique (précédence, associativité),
+//l'analyse sémantique (arité), la compilation (opcode) et la machine virtuelle (table de vérité).
+//Pour ajouter un opérateur : un type de noeud, un opcode, une ligne dans la table, et le cas de
+//l'opcode dans executer_programme_64 et evaluer_arbre_plat_64 (les boucles d'évaluation rapides).
+
+//Associativité des opérateurs binaires
+typedef enum {
+    ASSOC_GAUCHE,
+    ASSOC_DROITE
+} Associativite;
+
+typedef struct {
+    const char *symbole;            //Séquence UTF-8 (NULL pour une proposition)
+    int longueur;                   //Nombre d'octets du symbole
+    const char *lexeme;             //Lexème produit par l'analyse lexicale
+    const char *nom;                //Nom dans la table des symboles du compilateur
+    const char *affichage;          //Nom affiché par printAST
+    int arite;                      //0 (proposition), 1 (négation) ou 2
+    int precedence;                 //Opérateurs binaires : 1 (le moins prioritaire) à 4
+    Associativite associativite;
+    VMOpcode opcode;
+    uint8_t table;                  //Table de vérité : le bit (2 * a + b) vaut a op b (op b pour la négation)
+} Operateur;
+
+//Nombre de types de noeuds
+#define NB_TYPES_NOEUDS (NODE_NOR + 1)
+
+//Précédences : ⇔ < ⇒ → (associatifs à droite) < ∨ ⊕ ↓ < ∧ ↑ < ¬
+static const Operateur operateurs[NB_TYPES_NOEUDS] = {
+    [NODE_PROP]  = {NULL,           0, "Prop",            "PROP",        "PROP",     0, 0, ASSOC_GAUCHE, VM_LOAD, 0x0},
+    [NODE_AND]   = {"\xE2\x88\xA7", 3, "Op(ET)",          "ET",          "AND",      2, 4, ASSOC_GAUCHE, VM_AND,  0x8}, //∧ (U+2227)
+    [NODE_OR]    = {"\xE2\x88\xA8", 3, "Op(OU)",          "OU",          "OR",       2, 3, ASSOC_GAUCHE, VM_OR,   0xE}, //∨ (U+2228)
+    [NODE_NOT]   = {"\xC2\xAC",     2, "Op(NON)",         "NON",         "NOT",      1, 0, ASSOC_DROITE, VM_NOT,  0x5}, //¬ (U+00AC)
+    [NODE_IMP]   = {"\xE2\x87\x92", 3, "Op(IMPLIQUE)",    "IMPLIQUE",    "IMPLIQUE", 2, 2, ASSOC_DROITE, VM_IMP,  0xB}, //⇒ (U+21D2)
+    [NODE_PROD]  = {"\xE2\x86\x92", 3, "Op(PRODUIT)",     "PRODUIT",     "PRODUIT",  2, 2, ASSOC_DROITE, VM_IMP,  0xB}, //→ (U+2192)
+    [NODE_EQUIV] = {"\xE2\x87\x94", 3, "Op(EQUIVALENT)",  "EQUIVALENT",  "EQUIV",    2, 1, ASSOC_GAUCHE, VM_EQV,  0x9}, //⇔ (U+21D4)
+    [NODE_XOR]   = {"\xE2\x8A\x95", 3, "Op(OU_EXCLUSIF)", "OU_EXCLUSIF", "XOR",      2, 3, ASSOC_GAUCHE, VM_XOR,  0x6}, //⊕ (U+2295)
+    [NODE_NAND]  = {"\xE2\x86\x91", 3, "Op(NON_ET)",      "NON_ET",      "NAND",     2, 4, ASSOC_GAUCHE, VM_NAND, 0x7}, //↑ (U+2191)
+    [NODE_NOR]   = {"\xE2\x86\x93", 3, "Op(NON_OU)",      "NON_OU",      "NOR",      2, 3, ASSOC_GAUCHE, VM_NOR,  0x1}, //↓ (U+2193)
+};
+
+//Opérateur d'un type de noeud (NULL si le type est inconnu)
+static inline const Operateur *operateur_noeud(int type) {
+    return (type >= 0 && type < NB_TYPES_NOEUDS) ? &operateurs[type] : NULL;
+}
+
+//Opérateur dont le symbole UTF-8 commence à la position pos de la chaine de n octets (NULL sinon)
+static inline const Operateur *operateur_symbole(const char *chaine, int pos, int n) {
+    for (int t = 0; t < NB_TYPES_NOEUDS; t++) {
+        const Operateur *op = &operateurs[t];
+        if (op->symbole && pos + op->longueur <= n && chaine[pos] == op->symbole[0] &&
+            memcmp(&chaine[pos], op->symbole, op->longueur) == 0) {
+            return op;
+        }
+    }
+    return NULL;
+}
+
+//Opérateur correspondant à un lexème produit par l'analyse lexicale (NULL sinon)
+static inline const Operateur *operateur_lexeme(const char *lexeme) {
+    if (!lexeme || strncmp(lexeme, "Op(", 3) != 0) return NULL;
+    for (int t = 0; t < NB_TYPES_NOEUDS; t++) {
+        if (operateurs[t].arite > 0 && strcmp(operateurs[t].lexeme, lexeme) == 0) {
+            return &operateurs[t];
+        }
+    }
+    return NULL;
+}
+
+//Opérateur logique exécuté par un opcode (NULL pour les autres instructions)
+static inline const Operateur *operateur_opcode(VMOpcode opcode) {
+    for (int t = 0; t < NB_TYPES_NOEUDS; t++) {
+        if (operateurs[t].arite > 0 && operateurs[t].opcode == opcode) {
+            return &operateurs[t];
+        }
+    }
+    return NULL;
+}
+
+//Application bit à bit d'une table de vérité : chaque bit des mots est une valuation
+//(avec -1 pour vrai et 0 pour faux, la même fonction sert pour une seule valuation)
+static inline uint64_t appliquer_table_64(uint8_t table, uint64_t a, uint64_t b) {
+    uint64_t r = 0;
+    if (table & 0x1) r |= ~a & ~b;
+    if (table & 0x2) r |= ~a & b;
+    if (table & 0x4) r |= a & ~b;
+    if (table & 0x8) r |= a & b;
+    return r;
+}
+
+//Valeur de a op b (a et b valent 0 ou 1)
+static inline int valeur_table(uint8_t table, int a, int b) {
+    return (table >> (2 * a + b)) & 1;
+}
+
+//Transformations des tables de vérité : a op b devient ¬a op b, a op ¬b, ou b op a
+static inline uint8_t table_nier_gauche(uint8_t t) {
+    return ((t & 0x3) << 2) | ((t >> 2) & 0x3);
+}
+
+static inline uint8_t table_nier_droite(uint8_t t) {
+    return ((t & 0x5) << 1) | ((t >> 1) & 0x5);
+}
+
+static inline uint8_t table_transposer(uint8_t t) {
+    return (t & 0x9) | ((t & 0x2) << 1) | ((t & 0x4) >> 1);
+}
+
+#endif
@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "paliers.h"
+#include "analex.h"      //Pour CreationListeLexeme
+#include "anasem.h"      //Pour analyseur_semantique et indice_prop
+#include "compilateur.h" //Pour compiler_programme
+#include "operateurs.h"  //Pour les tables de vérité des opérateurs
+#include "allocateur.h"  //Pour allouer le code compilé par l'allocateur courant
+
+
+//Hauteur maximale de la pile des superinstructions
+#define PILE_SUPERINSTRUCTIONS 256
+
+//Fonction d'initialisation d'une formule au palier de l'arbre
+//Parametre f : FormulePaliers
+//Parametre ast : ASTNode vérifié, la formule en devient propriétaire
+void formule_paliers_initialiser(FormulePaliers *f, ASTNode *ast) {
+    memset(f, 0, sizeof(*f));
+    f->ast = ast;
+    f->palier = PALIER_ARBRE;
+    f->seuil_bytecode = SEUIL_BYTECODE;
+    f->seuil_superinstructions = SEUIL_SUPERINSTRUCTIONS;
+}
+
+//Fonction d'initialisation d'une formule à partir d'une chaine
+//Parametre f : FormulePaliers
+//Parametre chaine : chaine de caracteres
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur (la formule est alors vide, sans mémoire à libérer)
+int formule_paliers_depuis_chaine(FormulePaliers *f, const char *chaine, Statut *statut) {
+    char **lexemes = CreationListeLexeme(chaine, statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, statut) : NULL;
+    liberer_lexemes(lexemes);
+    if (ast && analyseur_semantique(ast, statut) < 0) {
+        freeAST(ast);
+        ast = NULL;
+    }
+    formule_paliers_initialiser(f, ast);
+    return ast ? 0 : -1;
+}
+
+//Fonction de libération d'une formule
+void liberer_formule_paliers(FormulePaliers *f) {
+    freeAST(f->ast);
+    mem_liberer(f->prog);
+    mem_liberer(f->sup);
+    memset(f, 0, sizeof(*f));
+}
+
+
+// ----------------------
+/*
+Palier 0 : parcours direct de l'arbre syntaxique
+   Rien n'est préparé : chaque proposition est cherchée par son nom à chaque évaluation.
+   C'est le palier le moins coûteux pour une formule évaluée une ou deux fois.
+*/
+// ----------------------
+
+//Fonction d'évaluation bit-parallèle d'un arbre syntaxique vérifié
+//Parametre n : ASTNode
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Retourne le mot des résultats
+uint64_t evaluer_ast_64(const ASTNode *n, const uint64_t *colonnes) {
+    switch (n->type) {
+        case NODE_PROP:
+            return colonnes[indice_prop(n->value)];
+        case NODE_NOT:
+            return ~evaluer_ast_64(n->right, colonnes);
+        default: {
+            uint64_t gauche = evaluer_ast_64(n->left, colonnes);
+            uint64_t droite = evaluer_ast_64(n->right, colonnes);
+            return appliquer_table_64(operateurs[n->type].table, gauche, droite);
+        }
+    }
+}
+
+
+// ----------------------
+/*
+Palier 1 : programme de la machine virtuelle (compilateur.c et runtime.c)
+*/
+// ----------------------
+
+//Nombre de noeuds d'un arbre syntaxique
+static int compter_noeuds(const ASTNode *n) {
+    return n ? 1 + compter_noeuds(n->left) + compter_noeuds(n->right) : 0;
+}
+
+//Fonction de promotion au palier du bytecode
+//Parametre f : FormulePaliers
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 si la formule ne peut pas être compilée (elle reste alors à son palier)
+int promouvoir_bytecode(FormulePaliers *f, Statut *statut) {
+    int capacite = compter_noeuds(f->ast);
+    PhaseMemoire phase = definir_phase_memoire(PHASE_COMPILATION);
+    VMInstruction *prog = mem_allouer(capacite * sizeof(VMInstruction));
+    definir_phase_memoire(phase);
+    if (!prog) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    int n = compiler_programme(f->ast, prog, capacite, statut);
+    if (n < 0 || verifier_programme(prog, n, statut) < 0) {
+        mem_liberer(prog);
+        return -1;
+    }
+    f->prog = prog;
+    f->taille_prog = n;
+    f->palier = PALIER_BYTECODE;
+    return 0;
+}
+
+
+// ----------------------
+/*
+Palier 2 : superinstructions
+   Une superinstruction applique une table de vérité (4 bits, operateurs.h) à ses opérandes.
+   Les transformations suivantes de la table ne coûtent rien à l'exécution :
+     - une proposition opérande (éventuellement niée) est lue directement dans les colonnes
+       au lieu d'être empilée (SUP_COLONNE, SUP_DEUX_COLONNES) ;
+     - la négation d'un opérande échange des lignes de la table ;
+     - la négation du résultat complète la table : ¬ n'est jamais une instruction ;
+     - si seul l'opérande gauche est une proposition, l'opérande droit est évalué d'abord
+       et la table est transposée.
+   Ainsi (p1∧¬p2)∨¬p3 s'exécute en 2 superinstructions au lieu de 7 instructions.
+*/
+// ----------------------
+
+//Tables unaires de SUP_CHARGER (appliquées à (0, colonne))
+#define TABLE_IDENTITE 0xA
+#define TABLE_NEGATION 0x5
+
+//Etat de la génération des superinstructions
+typedef struct {
+    Superinstruction *code;
+    int taille;
+    int capacite;
+    int hauteur;                //Hauteur de la pile à l'exécution après le code déjà généré
+    Statut *statut;
+} GenerateurSup;
+
+//Fonction reconnaissant un opérande qui se lit directement dans les colonnes
+//(une proposition sous un nombre quelconque de négations)
+//Parametre colonne, negation : indice de la proposition et parité des négations (sorties)
+//Retourne 1 si n est un tel opérande, 0 sinon
+static int operande_colonne(const ASTNode *n, uint32_t *colonne, int *negation) {
+    int neg = 0;
+    while (n->type == NODE_NOT) {
+        neg ^= 1;
+        n = n->right;
+    }
+    if (n->type != NODE_PROP) return 0;
+    *colonne = (uint32_t)indice_prop(n->value);
+    *negation = neg;
+    return 1;
+}
+
+//Fonction ajoutant une superinstruction
+//Parametre effet : variation de la hauteur de la pile
+//Retourne 0, ou -1 en cas d'erreur
+static int emettre_sup(GenerateurSup *g, GenreSuperinstruction genre, uint8_t table, uint32_t a, uint32_t b, int effet) {
+    if (g->taille == g->capacite) {
+        int capacite = g->capacite ? 2 * g->capacite : 16;
+        Superinstruction *code = mem_reallouer(g->code, capacite * sizeof(Superinstruction));
+        if (!code) {
+            statut_definir(g->statut, ERR_MEMOIRE, g->taille, "Erreur d'allocation mémoire");
+            return -1;
+        }
+        g->code = code;
+        g->capacite = capacite;
+    }
+    g->hauteur += effet;
+    if (g->hauteur > PILE_SUPERINSTRUCTIONS) {
+        statut_definir(g->statut, ERR_PILE_PLEINE, g->taille, "Pile débordée");
+        return -1;
+    }
+    g->code[g->taille++] = (Superinstruction){(uint8_t)(genre << 4 | (table & 0xF)), a, b};
+    return 0;
+}
+
+//Fonction récursive de génération : le code laisse la valeur du noeud au sommet de la pile
+//Retourne 0, ou -1 en cas d'erreur
+static int generer_sup(GenerateurSup *g, const ASTNode *n) {
+    uint32_t ca = 0, cb = 0;
+    int na = 0, nb = 0;
+    if (operande_colonne(n, &cb, &nb)) {
+        return emettre_sup(g, SUP_CHARGER, nb ? TABLE_NEGATION : TABLE_IDENTITE, 0, cb, 1);
+    }
+    if (n->type == NODE_NOT) {
+        //La dernière superinstruction produit la valeur de l'opérande : on complète sa table
+        if (generer_sup(g, n->right) < 0) return -1;
+        g->code[g->taille - 1].code ^= 0xF;
+        return 0;
+    }
+
+    uint8_t t = operateurs[n->type].table;
+    int gauche = operande_colonne(n->left, &ca, &na);
+    int droite = operande_colonne(n->right, &cb, &nb);
+    if (gauche && na) t = table_nier_gauche(t);
+    if (droite && nb) t = table_nier_droite(t);
+    if (gauche && droite) {
+        return emettre_sup(g, SUP_DEUX_COLONNES, t, ca, cb, 1);
+    }
+    if (droite) {
+        if (generer_sup(g, n->left) < 0) return -1;
+        return emettre_sup(g, SUP_COLONNE, t, 0, cb, 0);
+    }
+    if (gauche) {
+        if (generer_sup(g, n->right) < 0) return -1;
+        return emettre_sup(g, SUP_COLONNE, table_transposer(t), 0, ca, 0);
+    }
+    if (generer_sup(g, n->left) < 0 || generer_sup(g, n->right) < 0) return -1;
+    return emettre_sup(g, SUP_PILE, t, 0, 0, -1);
+}
+
+//Fonction de promotion au palier des superinstructions
+//Parametre f : FormulePaliers
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 si la génération échoue (la formule reste alors à son palier)
+int promouvoir_superinstructions(FormulePaliers *f, Statut *statut) {
+    GenerateurSup g = {NULL, 0, 0, 0, statut};
+    PhaseMemoire phase = definir_phase_memoire(PHASE_COMPILATION);
+    int r = generer_sup(&g, f->ast);
+    definir_phase_memoire(phase);
+    if (r < 0) {
+        mem_liberer(g.code);
+        return -1;
+    }
+    f->sup = g.code;
+    f->taille_sup = g.taille;
+    f->palier = PALIER_SUPERINSTRUCTIONS;
+    //Le bytecode ne sert plus
+    mem_liberer(f->prog);
+    f->prog = NULL;
+    f->taille_prog = 0;
+    return 0;
+}
+
+//Cas du switch d'exécution : un cas par genre et par table de vérité, pour que chaque table
+//soit une constante et que appliquer_table_64 se réduise à quelques opérations
+#define CAS_TABLE(genre, t, CORPS) case ((genre) << 4 | (t)): CORPS(t); break;
+#define CAS_GENRE(genre, CORPS)                                                                   \
+    CAS_TABLE(genre, 0, CORPS) CAS_TABLE(genre, 1, CORPS) CAS_TABLE(genre, 2, CORPS)              \
+    CAS_TABLE(genre, 3, CORPS) CAS_TABLE(genre, 4, CORPS) CAS_TABLE(genre, 5, CORPS)              \
+    CAS_TABLE(genre, 6, CORPS) CAS_TABLE(genre, 7, CORPS) CAS_TABLE(genre, 8, CORPS)              \
+    CAS_TABLE(genre, 9, CORPS) CAS_TABLE(genre, 10, CORPS) CAS_TABLE(genre, 11, CORPS)            \
+    CAS_TABLE(genre, 12, CORPS) CAS_TABLE(genre, 13, CORPS) CAS_TABLE(genre, 14, CORPS)           \
+    CAS_TABLE(genre, 15, CORPS)
+
+#define SUP_CORPS_CHARGER(t) pile[++sommet] = appliquer_table_64(t, 0, colonnes[s.b])
+#define SUP_CORPS_PILE(t) sommet--; pile[sommet] = appliquer_table_64(t, pile[sommet], pile[sommet + 1])
+#define SUP_CORPS_COLONNE(t) pile[sommet] = appliquer_table_64(t, pile[sommet], colonnes[s.b])
+#define SUP_CORPS_DEUX(t) pile[++sommet] = appliquer_table_64(t, colonnes[s.a], colonnes[s.b])
+
+//Fonction d'exécution bit-parallèle des superinstructions (code produit par promouvoir_superinstructions)
+//Parametre code : tableau de superinstructions
+//Parametre taille : nombre de superinstructions
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Retourne le mot des résultats
+uint64_t executer_superinstructions_64(const Superinstruction *code, int taille, const uint64_t *colonnes) {
+    uint64_t pile[PILE_SUPERINSTRUCTIONS];
+    int sommet = -1;
+    for (int i = 0; i < taille; i++) {
+        Superinstruction s = code[i];
+        switch (s.code) {
+            CAS_GENRE(SUP_CHARGER, SUP_CORPS_CHARGER)
+            CAS_GENRE(SUP_PILE, SUP_CORPS_PILE)
+            CAS_GENRE(SUP_COLONNE, SUP_CORPS_COLONNE)
+            CAS_GENRE(SUP_DEUX_COLONNES, SUP_CORPS_DEUX)
+            default:
+                break;
+        }
+    }
+    return pile[sommet];
+}
+
+
+// ----------------------
+/*
+Evaluation avec promotion
+*/
+// ----------------------
+
+//Fonction d'évaluation d'une formule au palier courant, après promotion éventuelle
+//Parametre f : FormulePaliers
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Retourne le mot des résultats
+uint64_t evaluer_paliers_64(FormulePaliers *f, const uint64_t *colonnes) {
+    f->nb_evaluations++;
+    if (f->palier == PALIER_ARBRE && f->nb_evaluations > f->seuil_bytecode && !f->echec_bytecode) {
+        f->echec_bytecode = promouvoir_bytecode(f, NULL) < 0;
+    }
+    //Une formule trop grande pour la machine virtuelle peut passer directement aux superinstructions
+    if (f->palier != PALIER_SUPERINSTRUCTIONS && f->nb_evaluations > f->seuil_superinstructions &&
+        !f->echec_superinstructions) {
+        f->echec_superinstructions = promouvoir_superinstructions(f, NULL) < 0;
+    }
+    switch (f->palier) {
+        case PALIER_SUPERINSTRUCTIONS:
+            return executer_superinstructions_64(f->sup, f->taille_sup, colonnes);
+        case PALIER_BYTECODE:
+            return executer_programme_64(f->prog, f->taille_prog, colonnes);
+        default:
+            return evaluer_ast_64(f->ast, colonnes);
+    }
+}
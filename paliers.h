@@ -0,0 +1,74 @@
+#ifndef PALIERS_H
+#define PALIERS_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "anasynt.h" //pour les arbres syntaxiques
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Exécution par paliers : une formule est d'abord évaluée en parcourant directement son arbre
+//syntaxique (rien à compiler), puis compilée pour la machine virtuelle de runtime.c après
+//seuil_bytecode évaluations, puis en superinstructions après seuil_superinstructions évaluations.
+//Le passage d'un palier à l'autre est fait par evaluer_paliers_64 et ne change pas le résultat.
+//Une formule ne doit pas être évaluée par plusieurs threads à la fois (compteur et promotion).
+
+//Seuils par défaut (nombre d'évaluations avant la promotion)
+#define SEUIL_BYTECODE 4
+#define SEUIL_SUPERINSTRUCTIONS 64
+
+typedef enum {
+    PALIER_ARBRE,               //Parcours de l'arbre syntaxique
+    PALIER_BYTECODE,            //Programme de la machine virtuelle (executer_programme_64)
+    PALIER_SUPERINSTRUCTIONS    //Superinstructions (executer_superinstructions_64)
+} Palier;
+
+//Genres de superinstructions. Chaque superinstruction remplace une ou plusieurs instructions :
+//le chargement des propositions, les négations et l'opérateur sont fusionnés en une seule table
+//de vérité appliquée en une seule fois.
+typedef enum {
+    SUP_CHARGER,                //Empile table(colonnes[b]) (proposition, éventuellement niée)
+    SUP_PILE,                   //Dépile y puis x, empile x table y
+    SUP_COLONNE,                //Remplace le sommet x par x table colonnes[b]
+    SUP_DEUX_COLONNES           //Empile colonnes[a] table colonnes[b]
+} GenreSuperinstruction;
+
+typedef struct {
+    uint8_t code;               //Genre << 4 | table de vérité (voir operateurs.h)
+    uint32_t a, b;              //Indices des propositions
+} Superinstruction;
+
+typedef struct {
+    ASTNode* ast;               //Arbre syntaxique vérifié (appartient à la formule)
+    Palier palier;
+    unsigned long nb_evaluations;
+    unsigned long seuil_bytecode;
+    unsigned long seuil_superinstructions;
+    int echec_bytecode;         //1 si une promotion a échoué (formule trop grande) : elle n'est pas retentée
+    int echec_superinstructions;
+
+    VMInstruction* prog;        //Palier PALIER_BYTECODE
+    int taille_prog;
+    Superinstruction* sup;      //Palier PALIER_SUPERINSTRUCTIONS
+    int taille_sup;
+} FormulePaliers;
+
+//Initialisation à partir d'un arbre déjà accepté par analyseur_semantique (la formule en devient
+//propriétaire), avec les seuils par défaut
+void formule_paliers_initialiser(FormulePaliers* f, ASTNode* ast);
+
+//Initialisation à partir d'une chaine (analyses lexicale, syntaxique et sémantique). Retourne 0 ou -1
+int formule_paliers_depuis_chaine(FormulePaliers* f, const char* chaine, Statut* statut);
+
+//Libération de l'arbre et du code compilé
+void liberer_formule_paliers(FormulePaliers* f);
+
+//Evaluation de 64 valuations (colonnes[i] : proposition i), avec promotion si un seuil est atteint
+uint64_t evaluer_paliers_64(FormulePaliers* f, const uint64_t* colonnes);
+
+//Chaque palier séparément (les promotions sont faites par evaluer_paliers_64)
+uint64_t evaluer_ast_64(const ASTNode* n, const uint64_t* colonnes);
+int promouvoir_bytecode(FormulePaliers* f, Statut* statut);
+int promouvoir_superinstructions(FormulePaliers* f, Statut* statut);
+uint64_t executer_superinstructions_64(const Superinstruction* code, int taille, const uint64_t* colonnes);
+
+#endif
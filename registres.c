@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "registres.h"
+#include "operateurs.h" //Pour les tables de vérité des opcodes
+#include "allocateur.h" //Pour allouer le code par l'allocateur courant
+
+
+// ----------------------
+/*
+Noeuds partagés
+   Le programme à pile est d'abord exécuté symboliquement : la pile contient des références
+   (2 * noeud + négation) et chaque opérateur devient un noeud (table, a, b) cherché dans une table
+   de hachage avant d'être créé. Les noeuds sont normalisés pour que deux écritures de la même
+   sous-formule donnent le même noeud :
+     - les négations des opérandes sont absorbées par la table ;
+     - les opérandes sont rangés (a < b), la table est transposée si besoin ;
+     - la table vaut 0 pour a = b = 0, sinon elle est complétée et la référence est niée ;
+     - les tables qui ne dépendent que d'un opérande, les opérandes égaux et les constantes
+       sont simplifiés.
+   Les noeuds sont créés dans l'ordre d'exécution : les opérandes d'un noeud le précèdent.
+*/
+// ----------------------
+
+typedef struct {
+    uint8_t code;               //Genre << 4 | table
+    uint32_t a, b;
+} NoeudRegistre;
+
+typedef struct {
+    NoeudRegistre *noeuds;
+    int nb_noeuds;
+    int *hachage;               //Indice du noeud + 1, 0 pour une case vide
+    int masque_hachage;
+    int faux;                   //Noeud de la constante faux, -1 s'il n'existe pas encore
+    int partages;
+} GenerateurRegistres;
+
+//Fonction cherchant un noeud, créé s'il n'existe pas encore
+//Retourne l'indice du noeud
+static int noeud_registre(GenerateurRegistres *g, uint8_t code, uint32_t a, uint32_t b) {
+    uint64_t h = ((uint64_t)code * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t)a * 0xC2B2AE3D27D4EB4FULL) ^
+                 ((uint64_t)b * 0x165667B19E3779F9ULL);
+    int i = (int)((h ^ (h >> 31)) & g->masque_hachage);
+    while (g->hachage[i]) {
+        NoeudRegistre *n = &g->noeuds[g->hachage[i] - 1];
+        if (n->code == code && n->a == a && n->b == b) {
+            g->partages++;
+            return g->hachage[i] - 1;
+        }
+        i = (i + 1) & g->masque_hachage;
+    }
+    g->noeuds[g->nb_noeuds] = (NoeudRegistre){code, a, b};
+    g->hachage[i] = ++g->nb_noeuds;
+    return g->nb_noeuds - 1;
+}
+
+//Référence de la constante faux (vrai est sa négation)
+static int reference_faux(GenerateurRegistres *g) {
+    if (g->faux < 0) g->faux = noeud_registre(g, REG_FAUX << 4, 0, 0);
+    return 2 * g->faux;
+}
+
+//Référence d'une fonction d'un seul opérande x : la valeur est valeur_0 si x est faux, valeur_1 sinon
+static int reference_unaire(GenerateurRegistres *g, int x, int valeur_0, int valeur_1) {
+    if (valeur_0 == valeur_1) return reference_faux(g) ^ valeur_0;
+    return x ^ valeur_0;
+}
+
+//Fonction combinant deux références par une table de vérité
+//Retourne la référence du résultat
+static int combiner_registres(GenerateurRegistres *g, uint8_t t, int x, int y) {
+    if (x & 1) t = table_nier_gauche(t);
+    if (y & 1) t = table_nier_droite(t);
+    int a = x >> 1, b = y >> 1;
+
+    //Opérandes égaux ou constants : il reste une fonction d'un seul opérande
+    if (a == b) return reference_unaire(g, 2 * a, valeur_table(t, 0, 0), valeur_table(t, 1, 1));
+    if (a == g->faux) return reference_unaire(g, 2 * b, valeur_table(t, 0, 0), valeur_table(t, 0, 1));
+    if (b == g->faux) return reference_unaire(g, 2 * a, valeur_table(t, 0, 0), valeur_table(t, 1, 0));
+
+    if (a > b) {
+        int c = a;
+        a = b;
+        b = c;
+        t = table_transposer(t);
+    }
+    int negation = t & 1;
+    if (negation) t ^= 0xF;
+    if (t == 0x0) return reference_faux(g) ^ negation;
+    if (t == 0xC) return 2 * a ^ negation;  //Table de a seul
+    if (t == 0xA) return 2 * b ^ negation;  //Table de b seul
+    return 2 * noeud_registre(g, (uint8_t)(REG_TABLE << 4 | t), (uint32_t)a, (uint32_t)b) ^ negation;
+}
+
+
+// ----------------------
+/*
+Allocation des registres
+   Balayage linéaire des noeuds utiles dans l'ordre d'exécution : les registres des opérandes
+   dont c'est le dernier usage sont libérés avant d'allouer celui du résultat (dst peut donc
+   être un des opérandes).
+*/
+// ----------------------
+
+//Fonction de génération du code à trois adresses
+//Parametre prog : programme de la machine à pile
+//Parametre taille : nombre d'instructions
+//Parametre res : ProgrammeRegistres, à libérer avec liberer_programme_registres
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int compiler_registres(const VMInstruction *prog, int taille, ProgrammeRegistres *res, Statut *statut) {
+    memset(res, 0, sizeof(*res));
+    if (verifier_programme(prog, taille, statut) < 0) return -1;
+    PhaseMemoire phase = definir_phase_memoire(PHASE_COMPILATION);
+
+    GenerateurRegistres g = {0};
+    g.faux = -1;
+    int capacite_hachage = 16;
+    while (capacite_hachage < 2 * (taille + 1)) capacite_hachage *= 2;
+    g.masque_hachage = capacite_hachage - 1;
+    g.noeuds = mem_allouer((taille + 1) * sizeof(NoeudRegistre));
+    g.hachage = mem_callouer(capacite_hachage, sizeof(int));
+    int *pile = mem_allouer(taille * sizeof(int));
+    int *dernier = mem_allouer((taille + 1) * sizeof(int));
+    int *registre = mem_allouer((taille + 1) * sizeof(int));
+    InstructionRegistre *code = mem_allouer((taille + 1) * sizeof(InstructionRegistre));
+    int ok = g.noeuds && g.hachage && pile && dernier && registre && code;
+    if (!ok) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+
+    //1. Noeuds partagés
+    int sommet = -1;
+    for (int pc = 0; ok && pc < taille; pc++) {
+        VMInstruction instr = prog[pc];
+        switch (instr.opcode) {
+            case VM_NOP:
+                break;
+            case VM_PUSH:
+                pile[++sommet] = reference_faux(&g) ^ (instr.operand != 0);
+                break;
+            case VM_LOAD:
+                pile[++sommet] = 2 * noeud_registre(&g, REG_CHARGER << 4, (uint32_t)instr.operand, 0);
+                break;
+            case VM_POP:
+            case VM_PRINT:
+                sommet--;
+                break;
+            case VM_NOT:
+                pile[sommet] ^= 1;
+                break;
+            default: {
+                int y = pile[sommet--];
+                pile[sommet] = combiner_registres(&g, operateur_opcode(instr.opcode)->table, pile[sommet], y);
+                break;
+            }
+        }
+    }
+
+    //verifier_programme garantit une valeur au sommet de la pile
+    int reference = ok && sommet >= 0 ? pile[sommet] : 0;
+
+    //2. Dernier usage de chaque noeud utile (-1 : noeud inutile), en remontant depuis le résultat
+    int racine = reference >> 1;
+    for (int i = 0; ok && i < g.nb_noeuds; i++) dernier[i] = -1;
+    if (ok) dernier[racine] = g.nb_noeuds;
+    for (int i = g.nb_noeuds - 1; ok && i >= 0; i--) {
+        NoeudRegistre *n = &g.noeuds[i];
+        if (dernier[i] < 0 || n->code >> 4 != REG_TABLE) continue;
+        if (dernier[n->a] < 0) dernier[n->a] = i;
+        if (dernier[n->b] < 0) dernier[n->b] = i;
+    }
+
+    //3. Balayage linéaire
+    uint8_t libres[MAX_REGISTRES];
+    int nb_libres = 0, nb_registres = 0, n = 0;
+    for (int i = 0; ok && i < g.nb_noeuds; i++) {
+        NoeudRegistre *noeud = &g.noeuds[i];
+        if (dernier[i] < 0) continue;
+        int table = noeud->code >> 4 == REG_TABLE;
+        if (table && dernier[noeud->a] == i) libres[nb_libres++] = (uint8_t)registre[noeud->a];
+        if (table && dernier[noeud->b] == i) libres[nb_libres++] = (uint8_t)registre[noeud->b];
+        if (nb_libres > 0) {
+            registre[i] = libres[--nb_libres];
+        } else if (nb_registres < MAX_REGISTRES) {
+            registre[i] = nb_registres++;
+        } else {
+            statut_definir(statut, ERR_PILE_PLEINE, i, "Trop de valeurs vivantes pour les registres");
+            ok = 0;
+            break;
+        }
+        code[n++] = (InstructionRegistre){noeud->code, (uint8_t)registre[i], table ? (uint8_t)registre[noeud->b] : 0,
+                                          table ? (uint32_t)registre[noeud->a] : noeud->a};
+    }
+
+    if (ok) {
+        res->code = code;
+        res->taille = n;
+        res->nb_registres = nb_registres;
+        res->resultat = (uint8_t)registre[racine];
+        res->masque = (reference & 1) ? ~(uint64_t)0 : 0;
+        res->partages = g.partages;
+    } else {
+        mem_liberer(code);
+    }
+    mem_liberer(g.noeuds);
+    mem_liberer(g.hachage);
+    mem_liberer(pile);
+    mem_liberer(dernier);
+    mem_liberer(registre);
+    definir_phase_memoire(phase);
+    return ok ? 0 : -1;
+}
+
+//Fonction de libération du code
+void liberer_programme_registres(ProgrammeRegistres *p) {
+    mem_liberer(p->code);
+    memset(p, 0, sizeof(*p));
+}
+
+
+// ----------------------
+/*
+Exécution
+   Comme pour les superinstructions (paliers.c), un cas par table pour que appliquer_table_64
+   se réduise à une ou deux opérations. Les opérandes sont lus dans le banc de registres et non au
+   sommet d'une pile : deux instructions qui ne dépendent pas l'une de l'autre peuvent s'exécuter
+   en parallèle dans le processeur.
+*/
+// ----------------------
+
+#define REG_CAS_TABLE(t) \
+    case (REG_TABLE << 4 | (t)): registres[i.dst] = appliquer_table_64(t, registres[i.a], registres[i.b]); break;
+
+//Fonction d'exécution bit-parallèle du code à trois adresses
+//Parametre p : ProgrammeRegistres produit par compiler_registres
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Retourne le mot des résultats
+uint64_t executer_registres_64(const ProgrammeRegistres *p, const uint64_t *colonnes) {
+    uint64_t registres[MAX_REGISTRES];
+    for (int k = 0; k < p->taille; k++) {
+        InstructionRegistre i = p->code[k];
+        switch (i.code) {
+            case REG_CHARGER << 4:
+                registres[i.dst] = colonnes[i.a];
+                break;
+            case REG_FAUX << 4:
+                registres[i.dst] = 0;
+                break;
+            //Tables normalisées : ¬a∧b, a∧¬b, ⊕, ∧, ∨
+            REG_CAS_TABLE(0x2)
+            REG_CAS_TABLE(0x4)
+            REG_CAS_TABLE(0x6)
+            REG_CAS_TABLE(0x8)
+            REG_CAS_TABLE(0xE)
+            default:
+                break;
+        }
+    }
+    return registres[p->resultat] ^ p->masque;
+}
@@ -0,0 +1,54 @@
+#ifndef REGISTRES_H
+#define REGISTRES_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "runtime.h" //pour les instructions de la machine virtuelle à pile
+
+//Machine virtuelle à registres : instructions à trois adresses (dst = a op b) sur un banc de
+//registres de 64 valuations. Le code est produit à partir d'un programme de la machine à pile :
+//  - chaque sous-formule n'est calculée qu'une fois (hachage des noeuds : une sous-formule qui
+//    apparait plusieurs fois, même écrite avec d'autres opérateurs ou négations, garde son
+//    registre tant qu'elle sert) ;
+//  - les négations sont absorbées par les tables de vérité : ¬ n'est jamais une instruction,
+//    il ne reste que cinq opérateurs (∧, ∨, ⊕, a∧¬b, ¬a∧b) et la négation éventuelle du résultat ;
+//  - les registres sont alloués par balayage linéaire (un registre est libéré après le dernier
+//    usage de sa valeur).
+
+//Taille du banc de registres
+#define MAX_REGISTRES 256
+
+//Genres d'instructions (code = genre << 4 | table de vérité, voir operateurs.h)
+typedef enum {
+    REG_CHARGER,                //dst = colonnes[a]
+    REG_FAUX,                   //dst = 0
+    REG_TABLE                   //dst = registre a table registre b
+} GenreRegistre;
+
+typedef struct {
+    uint8_t code;
+    uint8_t dst;
+    uint8_t b;
+    uint32_t a;                 //Registre, ou indice de la proposition pour REG_CHARGER
+} InstructionRegistre;
+
+typedef struct {
+    InstructionRegistre* code;
+    int taille;
+    int nb_registres;           //Registres utilisés (au plus MAX_REGISTRES)
+    uint8_t resultat;           //Registre du résultat
+    uint64_t masque;            //~0 si le résultat est nié, 0 sinon
+    int partages;               //Sous-formules retrouvées au lieu d'être recalculées
+} ProgrammeRegistres;
+
+//Génération du code à partir d'un programme de la machine à pile (vérifié ici).
+//Retourne 0, ou -1 (programme refusé, plus de MAX_REGISTRES valeurs vivantes, mémoire)
+int compiler_registres(const VMInstruction* prog, int taille, ProgrammeRegistres* res, Statut* statut);
+
+//Libération du code
+void liberer_programme_registres(ProgrammeRegistres* p);
+
+//Exécution bit-parallèle (colonnes[i] : proposition i). Retourne le mot des 64 résultats
+uint64_t executer_registres_64(const ProgrammeRegistres* p, const uint64_t* colonnes);
+
+#endif
@@ -2,25 +2,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "runtime.h"
+#include "operateurs.h" //Pour l'arité et la table de vérité des opérateurs
 
-//On commence par définir les différents codes d'opérations que la machine virtuelle peut exécuter.
-typedef enum {
-    VM_NOP,    //Pas d'opération
-    VM_PUSH,   //Empile une valeur sur la pile
-    VM_POP,    //Retire une valeur de la pile
-    VM_AND,    //Opération ET logique
-    VM_OR,     //Opération OU logique
-    VM_NOT,    //Opération NON logique
-    VM_IMP,    //Opération IMPLIQUE
-    VM_PRINT   //Affiche une valeur
-} VMOpcode;
-
-//L'instruction que la machine virtuelle doit exécuter.
-//Chaque instruction contient le type d'opération à effectuer ainsi que son opérande associé
-typedef struct {
-    VMOpcode opcode;   //Opération à effectuer
-    int operand;       //Opérande associé
-} VMInstruction;
 
 //Pour stocker les valeurs logiques pendant l'exécution des instructions, on utilisera une pile avec une taille maximale
 #define STACK_SIZE 256
@@ -28,10 +12,12 @@ int vm_stack[STACK_SIZE];
 int stack_top = -1;
 
 //La série d'instructions que la machine virtuelle va exécuter avec une taille maximale également :
-#define PROGRAM_SIZE 1024
 VMInstruction program[PROGRAM_SIZE];
 int program_counter = 0; //Compteur d'instructions indiquant à chaque fois l'instruction à exécuter.
 
+//Valeurs des propositions utilisées par l'instruction VM_LOAD
+const int* vm_valeurs = NULL;
+
 
 /*Ici, on ajoute une instruction au programme de la machine virtuelle.
      On vérifie que le programme n'excède pas la taille maximale.
@@ -39,12 +25,26 @@ int program_counter = 0; //Compteur d'instructions indiquant à chaque fois l'in
 */
 //Parametre opcode : VMOpcode
 //Parametre operand : entier
-void add_instruction(VMOpcode opcode, int operand) {
+//Retourne ERR_AUCUNE, ou ERR_PROGRAMME_PLEIN si le programme a atteint la taille maximale
+int add_instruction(VMOpcode opcode, int operand) {
     if (program_counter >= PROGRAM_SIZE) {
-        fprintf(stderr, "Erreur : Programme dépasse la taille maximale.\n");
-        exit(EXIT_FAILURE);
+        return ERR_PROGRAMME_PLEIN;
     }
     program[program_counter++] = (VMInstruction){opcode, operand};
+    return ERR_AUCUNE;
+}
+
+//On vide le programme et la pile de la machine virtuelle
+void reinitialiser_machine(void) {
+    program_counter = 0;
+    stack_top = -1;
+}
+
+
+//On définit les valeurs des propositions lues par VM_LOAD
+//Parametre valeurs : tableau d'entiers indicé par le numéro de proposition (0 faux, sinon vrai)
+void definir_valeurs_propositions(const int* valeurs) {
+    vm_valeurs = valeurs;
 }
 
 
@@ -54,69 +54,260 @@ void add_instruction(VMOpcode opcode, int operand) {
     - 0 représente FAUX
  */
 //Parametre value : entier
-void vm_push(int value) {
+//Retourne ERR_AUCUNE, ou ERR_PILE_PLEINE si la pile déborde
+int vm_push(int value) {
     if (stack_top >= STACK_SIZE - 1) {
-        fprintf(stderr, "Erreur : Pile débordée.\n");
-        exit(EXIT_FAILURE);
+        return ERR_PILE_PLEINE;
     }
     vm_stack[++stack_top] = (value != 0) ? -1 : 0; //Conversion en logique (-1 pour vrai, 0 pour faux)
+    return ERR_AUCUNE;
 }
 
 //On dépile une valeur de la pile de la machine virtuelle
-int vm_pop() {
+//Parametre valeur : pointeur vers l'entier qui reçoit la valeur dépilée (peut être NULL)
+//Retourne ERR_AUCUNE, ou ERR_PILE_VIDE si la pile est vide
+int vm_pop(int* valeur) {
     if (stack_top < 0) {
-        fprintf(stderr, "Erreur : Pile vide.\n");
-        exit(EXIT_FAILURE);
+        return ERR_PILE_VIDE;
     }
-    return vm_stack[stack_top--];
+    int v = vm_stack[stack_top--];
+    if (valeur) *valeur = v;
+    return ERR_AUCUNE;
+}
+
+//Nombre de valeurs dépilées et empilées par une instruction
+//Parametre opcode : VMOpcode
+//Parametre depile, empile : pointeurs vers des entiers
+//Retourne 0, ou -1 si l'opcode est inconnu
+static int effet_pile(VMOpcode opcode, int* depile, int* empile) {
+    switch (opcode) {
+        case VM_NOP:   *depile = 0; *empile = 0; return 0;
+        case VM_PUSH:
+        case VM_LOAD:  *depile = 0; *empile = 1; return 0;
+        case VM_POP:
+        case VM_PRINT: *depile = 1; *empile = 0; return 0;
+        default: {
+            //Opérateurs logiques : l'arité vient de la table des opérateurs
+            const Operateur *op = operateur_opcode(opcode);
+            if (!op) return -1;
+            *depile = op->arite;
+            *empile = 1;
+            return 0;
+        }
+    }
+}
+
+/*On vérifie un programme avant de l'exécuter : opcodes connus, pas de dépilement d'une pile vide,
+    pas de débordement de la pile, et une valeur au sommet de la pile à la fin.
+    La hauteur de la pile ne dépend pas des valeurs des propositions (pas de saut),
+    une seule vérification suffit donc pour toutes les valuations.
+ */
+//Parametre prog : tableau d'instructions
+//Parametre taille : nombre d'instructions
+//Parametre statut : Statut, rempli avec l'indice de l'instruction fautive (peut être NULL)
+//Retourne 0 si le programme est correct, -1 sinon
+int verifier_programme(const VMInstruction* prog, int taille, Statut* statut) {
+    int hauteur = 0;
+    for (int pc = 0; pc < taille; pc++) {
+        int depile, empile;
+        if (effet_pile(prog[pc].opcode, &depile, &empile) < 0) {
+            statut_definir(statut, ERR_OPCODE_INCONNU, pc, "Opcode inconnu");
+            return -1;
+        }
+        if (hauteur < depile) {
+            statut_definir(statut, ERR_PILE_VIDE, pc, "Pile vide");
+            return -1;
+        }
+        hauteur += empile - depile;
+        if (hauteur > STACK_SIZE) {
+            statut_definir(statut, ERR_PILE_PLEINE, pc, "Pile débordée");
+            return -1;
+        }
+    }
+    if (hauteur < 1) {
+        statut_definir(statut, ERR_PILE_VIDE, taille, "Aucun résultat sur la pile");
+        return -1;
+    }
+    return 0;
 }
 
 //On exécute le programme de la machine virtuelle :
-void execute_program() {
-    for (int pc = 0; pc < program_counter; pc++) {
+//Parametre statut : Statut, rempli avec l'indice de l'instruction fautive (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur (la pile est alors vidée pour pouvoir réutiliser la machine)
+int execute_program(Statut* statut) {
+    int code = ERR_AUCUNE;
+    int pc;
+    for (pc = 0; pc < program_counter && code == ERR_AUCUNE; pc++) {
         VMInstruction instr = program[pc];
+        int a = 0, b = 0;
         switch (instr.opcode) {
             case VM_NOP://Pas d'opération à effectuer
                 break; 
             case VM_PUSH://On empile l'opérande sur la pile
-                vm_push(instr.operand);
+                code = vm_push(instr.operand);
+                break;
+            case VM_LOAD://On empile la valeur de la proposition
+                if (!vm_valeurs) {
+                    code = ERR_VALEURS_ABSENTES;
+                    break;
+                }
+                code = vm_push(vm_valeurs[instr.operand]);
                 break;
             case VM_POP://On dépile une valeur de la pile
-                vm_pop();
-                break;
-            case VM_AND: { //On dépile 2 valeurs, on effectue un ET logique et on empile le résultat
-                int b = vm_pop();
-                int a = vm_pop();
-                vm_push((a != 0 && b != 0) ? -1 : 0); //a ET b
-                break;
-            }
-            case VM_OR: { //Pareil, on dépile 2 valeurs, on effectue un OU logique et on empile le résultat
-                int b = vm_pop();
-                int a = vm_pop();
-                vm_push((a != 0 || b != 0) ? -1 : 0); //a OU b
-                break;
-            }
-            case VM_NOT: {
-                int a = vm_pop();
-                vm_push((a == 0) ? -1 : 0); //NOT a
-                break;
-            }
-            case VM_IMP: {
-                int b = vm_pop();
-                int a = vm_pop();
-                vm_push((a == 0 || b != 0) ? -1 : 0); //a ⇒ b
-                break;
-            }
-            case VM_PRINT: {  //On dépile la valeur, et en fonction on va afficher VRAI ou FAUX
-                int value = vm_pop();
-                printf("Résultat : %s\n", (value == -1) ? "VRAI" : "FAUX");
-                break;
-            }
+                code = vm_pop(NULL);
+                break;
+            case VM_AND: //On dépile 2 valeurs, on effectue un ET logique et on empile le résultat
+                if ((code = vm_pop(&b)) == ERR_AUCUNE && (code = vm_pop(&a)) == ERR_AUCUNE) {
+                    code = vm_push((a != 0 && b != 0) ? -1 : 0); //a ET b
+                }
+                break;
+            case VM_OR: //Pareil, on dépile 2 valeurs, on effectue un OU logique et on empile le résultat
+                if ((code = vm_pop(&b)) == ERR_AUCUNE && (code = vm_pop(&a)) == ERR_AUCUNE) {
+                    code = vm_push((a != 0 || b != 0) ? -1 : 0); //a OU b
+                }
+                break;
+            case VM_NOT:
+                if ((code = vm_pop(&a)) == ERR_AUCUNE) {
+                    code = vm_push((a == 0) ? -1 : 0); //NOT a
+                }
+                break;
+            case VM_IMP:
+                if ((code = vm_pop(&b)) == ERR_AUCUNE && (code = vm_pop(&a)) == ERR_AUCUNE) {
+                    code = vm_push((a == 0 || b != 0) ? -1 : 0); //a ⇒ b
+                }
+                break;
+            case VM_EQV:
+            case VM_XOR:
+            case VM_NAND:
+            case VM_NOR: //Les autres opérateurs binaires s'appliquent par leur table de vérité
+                if ((code = vm_pop(&b)) == ERR_AUCUNE && (code = vm_pop(&a)) == ERR_AUCUNE) {
+                    uint8_t table = operateur_opcode(instr.opcode)->table;
+                    code = vm_push(valeur_table(table, a != 0, b != 0) ? -1 : 0);
+                }
+                break;
+            case VM_PRINT:  //On dépile la valeur, et en fonction on va afficher VRAI ou FAUX
+                if ((code = vm_pop(&a)) == ERR_AUCUNE) {
+                    printf("Résultat : %s\n", (a == -1) ? "VRAI" : "FAUX");
+                }
+                break;
             default:
-                fprintf(stderr, "Erreur : Opcode inconnu %d\n", instr.opcode);
-                exit(EXIT_FAILURE);
+                code = ERR_OPCODE_INCONNU;
         }
     }
+    if (code != ERR_AUCUNE) {
+        static const char *messages[] = {
+            [ERR_PILE_PLEINE] = "Pile débordée",
+            [ERR_PILE_VIDE] = "Pile vide",
+            [ERR_OPCODE_INCONNU] = "Opcode inconnu",
+            [ERR_VALEURS_ABSENTES] = "Valeurs des propositions non définies"
+        };
+        statut_definir(statut, (CodeErreur)code, pc - 1, messages[code]);
+        stack_top = -1;
+        return -1;
+    }
+    return 0;
 }
 
 
+/*Exécution bit-parallèle du programme : la pile contient des mots de 64 bits,
+    le bit k de chaque mot correspond à la k-ième valuation.
+    Les opérateurs logiques deviennent des opérations bit à bit, une instruction évalue donc 64 valuations.
+ */
+//Le programme doit avoir été accepté par verifier_programme : aucune vérification n'est faite ici
+//Parametre prog : tableau d'instructions
+//Parametre taille : nombre d'instructions
+//Parametre colonnes : valeurs des propositions (un mot de 64 valuations par proposition)
+//Retourne le mot des résultats
+uint64_t executer_programme_64(const VMInstruction* prog, int taille, const uint64_t* colonnes) {
+    uint64_t pile[STACK_SIZE];
+    int sommet = -1;
+
+    for (int pc = 0; pc < taille; pc++) {
+        VMInstruction instr = prog[pc];
+        switch (instr.opcode) {
+            case VM_NOP:
+                break;
+            case VM_PUSH:
+                pile[++sommet] = instr.operand ? ~(uint64_t)0 : 0;
+                break;
+            case VM_LOAD:
+                pile[++sommet] = colonnes[instr.operand];
+                break;
+            case VM_POP:
+            case VM_PRINT: //Pas d'affichage en mode bit-parallèle, la valeur est seulement dépilée
+                sommet--;
+                break;
+            case VM_AND:
+                sommet--;
+                pile[sommet] &= pile[sommet + 1];
+                break;
+            case VM_OR:
+                sommet--;
+                pile[sommet] |= pile[sommet + 1];
+                break;
+            case VM_NOT:
+                pile[sommet] = ~pile[sommet];
+                break;
+            case VM_IMP:
+                sommet--;
+                pile[sommet] = ~pile[sommet] | pile[sommet + 1];
+                break;
+            case VM_EQV:
+                sommet--;
+                pile[sommet] = ~(pile[sommet] ^ pile[sommet + 1]);
+                break;
+            case VM_XOR:
+                sommet--;
+                pile[sommet] ^= pile[sommet + 1];
+                break;
+            case VM_NAND:
+                sommet--;
+                pile[sommet] = ~(pile[sommet] & pile[sommet + 1]);
+                break;
+            case VM_NOR:
+                sommet--;
+                pile[sommet] = ~(pile[sommet] | pile[sommet + 1]);
+                break;
+            default:
+                break;
+        }
+    }
+    return pile[sommet];
+}
+
+
+// ----------------------
+/*
+Enumération des valuations par mots de 64
+*/
+// ----------------------
+
+const uint64_t motifs_valuations[6] = {
+    0xAAAAAAAAAAAAAAAAULL,
+    0xCCCCCCCCCCCCCCCCULL,
+    0xF0F0F0F0F0F0F0F0ULL,
+    0xFF00FF00FF00FF00ULL,
+    0xFFFF0000FFFF0000ULL,
+    0xFFFFFFFF00000000ULL
+};
+
+//Fonction énumérant des mots de valuations
+//Parametre n : nombre de propositions
+//Parametre props : colonne de chaque proposition (NULL : la proposition k est la colonne k)
+//Parametre colonnes : valeurs des propositions, remplies pour chaque mot
+//Parametre debut, fin : mots énumérés (au plus mots_valuations(n))
+//Parametre rappel : RappelValuations, donnees : pointeur transmis au rappel
+//Retourne le numéro du mot où le rappel a demandé l'arrêt, ou fin
+uint64_t enumerer_valuations(int n, const int* props, uint64_t* colonnes, uint64_t debut, uint64_t fin,
+                             RappelValuations rappel, void* donnees) {
+    for (int k = 0; k < n && k < 6; k++) {
+        colonnes[props ? props[k] : k] = motifs_valuations[k];
+    }
+    for (uint64_t p = debut; p < fin; p++) {
+        for (int k = 6; k < n; k++) {
+            colonnes[props ? props[k] : k] = ((p >> (k - 6)) & 1) ? ~(uint64_t)0 : 0;
+        }
+        if (rappel(p, colonnes, donnees)) return p;
+    }
+    return fin;
+}
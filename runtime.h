@@ -0,0 +1,82 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <stdint.h>
+#include "erreurs.h"
+
+//On commence par définir les différents codes d'opérations que la machine virtuelle peut exécuter.
+typedef enum {
+    VM_NOP,    //Pas d'opération
+    VM_PUSH,   //Empile une valeur sur la pile
+    VM_POP,    //Retire une valeur de la pile
+    VM_AND,    //Opération ET logique
+    VM_OR,     //Opération OU logique
+    VM_NOT,    //Opération NON logique
+    VM_IMP,    //Opération IMPLIQUE
+    VM_PRINT,  //Affiche une valeur
+    VM_LOAD,   //Empile la valeur de la proposition d'indice operand
+    VM_EQV,    //Opération EQUIVALENT
+    VM_XOR,    //Opération OU exclusif
+    VM_NAND,   //Opération NON ET
+    VM_NOR     //Opération NON OU
+} VMOpcode;
+
+//L'instruction que la machine virtuelle doit exécuter.
+//Chaque instruction contient le type d'opération à effectuer ainsi que son opérande associé
+typedef struct {
+    VMOpcode opcode;   //Opération à effectuer
+    int operand;       //Opérande associé
+} VMInstruction;
+
+//Taille maximale d'un programme de la machine virtuelle
+#define PROGRAM_SIZE 1024
+
+//Ajout d'une instruction au programme de la machine virtuelle (ERR_AUCUNE ou ERR_PROGRAMME_PLEIN)
+int add_instruction(VMOpcode opcode, int operand);
+
+//Vide le programme et la pile de la machine virtuelle
+void reinitialiser_machine(void);
+
+//Valeurs des propositions lues par VM_LOAD (indicées comme les propositions valides)
+void definir_valeurs_propositions(const int* valeurs);
+
+//Gestion de la pile et exécution du programme (codes d'erreur de erreurs.h)
+int vm_push(int value);
+int vm_pop(int* valeur);
+int execute_program(Statut* statut);
+
+//Vérification d'un programme (opcodes, hauteur de la pile) : 0 si correct, -1 sinon
+int verifier_programme(const VMInstruction* prog, int taille, Statut* statut);
+
+//Exécution bit-parallèle : chaque bit des mots correspond à une valuation différente (64 à la fois).
+//colonnes[i] contient la valeur de la proposition i pour chacune des 64 valuations.
+//Retourne le mot des 64 résultats. N'utilise pas de variable globale.
+//Le programme doit avoir été accepté par verifier_programme.
+uint64_t executer_programme_64(const VMInstruction* prog, int taille, const uint64_t* colonnes);
+
+//Enumération de toutes les valuations de n propositions par mots de 64 valuations : les 6 premières
+//propositions varient à l'intérieur d'un mot (bit j du mot : la proposition k vaut le bit k de j),
+//les suivantes sont constantes dans un mot et prennent les bits de son numéro (proposition k : bit
+//k - 6). La valuation du bit j du mot p est donc (p << 6) | j.
+extern const uint64_t motifs_valuations[6];
+
+//Nombre de mots des valuations de n propositions
+static inline uint64_t mots_valuations(int n) {
+    return n > 6 ? (uint64_t)1 << (n - 6) : 1;
+}
+
+//Bits du mot qui correspondent à une valuation (tous, sauf pour moins de 6 propositions)
+static inline uint64_t masque_valuations(int n) {
+    return n >= 6 ? ~(uint64_t)0 : ((uint64_t)1 << (1 << n)) - 1;
+}
+
+//Rappel de enumerer_valuations, pour chaque mot : retourne 0 pour continuer, autre chose pour s'arrêter
+typedef int (*RappelValuations)(uint64_t mot, const uint64_t* colonnes, void* donnees);
+
+//Enumération des mots debut .. fin - 1 : la proposition k est écrite dans colonnes[props[k]]
+//(colonnes[k] si props est NULL), puis le rappel est appelé.
+//Retourne le numéro du mot où le rappel a demandé l'arrêt, ou fin
+uint64_t enumerer_valuations(int n, const int* props, uint64_t* colonnes, uint64_t debut, uint64_t fin,
+                             RappelValuations rappel, void* donnees);
+
+#endif
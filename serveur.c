@@ -0,0 +1,662 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+//Pour la socket Unix, les entrées-sorties non bloquantes et la boucle poll
+
+#include "serveur.h"
+#include "allocateur.h"
+#include "analex.h"      //Pour CreationListeLexeme
+#include "anasem.h"      //Pour analyseur_semantique et initialize_valid_props
+#include "compilateur.h" //Pour compiler_programme et les tables
+
+
+//Nombre maximal de connexions simultanées en mode socket
+#define MAX_CONNEXIONS 64
+
+//Taille des lectures sur une connexion
+#define TAILLE_LECTURE (64 * 1024)
+
+//Nombre maximal de propositions d'un programme résident (une valuation tient dans un mot de 64 bits)
+#define MAX_PROPS_SERVEUR 64
+
+//Réponses non envoyées au-delà desquelles les requêtes d'une connexion ne sont plus lues ni traitées
+//(un client qui enchaine les requêtes sans lire les réponses ne fait pas grandir la sortie sans fin)
+#define MAX_SORTIE_EN_ATTENTE (4 * 1024 * 1024)
+
+//Délai accordé à l'arrêt pour envoyer les réponses en attente (un client qui ne lit plus ne bloque pas
+//l'arrêt du serveur)
+#define DELAI_ARRET_MS 1000
+
+//Tableau d'octets extensible (trames reçues en attente, réponses à envoyer)
+typedef struct {
+    char *octets;
+    size_t taille;
+    size_t capacite;
+    size_t debut;               //Octets déjà consommés (lus ou envoyés)
+} Octets;
+
+//Connexion d'un client
+typedef struct {
+    int fd_entree;
+    int fd_sortie;
+    int socket;                 //1 si fd_sortie est une socket : envoi par send, sans SIGPIPE si le client
+                                //est parti
+    Octets entree;
+    Octets sortie;
+} Connexion;
+
+
+// ----------------------
+/*
+Tableaux d'octets
+*/
+// ----------------------
+
+//Fonction réservant n octets à la fin d'un tableau (agrandi si besoin)
+//Parametre o : Octets
+//Parametre n : nombre d'octets
+//Retourne un pointeur vers les n octets réservés, ou NULL si la mémoire manque (tableau inchangé)
+char *octets_reserver(Octets *o, size_t n) {
+    if (o->taille + n > o->capacite) {
+        //On récupère d'abord la place des octets déjà consommés
+        if (o->debut > 0) {
+            memmove(o->octets, o->octets + o->debut, o->taille - o->debut);
+            o->taille -= o->debut;
+            o->debut = 0;
+        }
+        size_t capacite = o->capacite ? o->capacite : 4096;
+        while (o->taille + n > capacite) {
+            capacite *= 2;
+        }
+        if (capacite != o->capacite) {
+            char *nouveau = mem_reallouer(o->octets, capacite);
+            if (!nouveau) return NULL;
+            o->octets = nouveau;
+            o->capacite = capacite;
+        }
+    }
+    char *p = o->octets + o->taille;
+    o->taille += n;
+    return p;
+}
+
+//Fonction ajoutant une réponse (en-tête puis données) à la sortie d'une connexion
+//Parametre code : CodeErreur (type de la trame de réponse)
+//Retourne 0, ou -1 si la mémoire manque (rien n'est ajouté)
+int ajouter_reponse(Connexion *c, uint32_t code, uint32_t id, const void *donnees, uint32_t taille) {
+    EnteteTrame entete = {taille, code, id};
+    char *p = octets_reserver(&c->sortie, sizeof(entete) + taille);
+    if (!p) return -1;
+    memcpy(p, &entete, sizeof(entete));
+    if (taille > 0) memcpy(p + sizeof(entete), donnees, taille);
+    return 0;
+}
+
+//Fonction ajoutant une réponse d'erreur : position (u32) puis message
+//Retourne 0, ou -1 si la mémoire manque (rien n'est ajouté)
+int ajouter_erreur(Connexion *c, uint32_t id, const Statut *statut) {
+    const char *message = statut->message ? statut->message : "";
+    uint32_t taille = sizeof(uint32_t) + strlen(message);
+    EnteteTrame entete = {taille, statut->code, id};
+    uint32_t position = (uint32_t)statut->position;
+    char *p = octets_reserver(&c->sortie, sizeof(entete) + taille);
+    if (!p) return -1;
+    memcpy(p, &entete, sizeof(entete));
+    memcpy(p + sizeof(entete), &position, sizeof(position));
+    memcpy(p + sizeof(entete) + sizeof(position), message, strlen(message));
+    return 0;
+}
+
+//Fonction indiquant si les réponses en attente d'une connexion atteignent MAX_SORTIE_EN_ATTENTE
+int sortie_saturee(const Connexion *c) {
+    return c->sortie.taille - c->sortie.debut >= MAX_SORTIE_EN_ATTENTE;
+}
+
+
+// ----------------------
+/*
+Programmes résidents
+*/
+// ----------------------
+
+//Fonction pour initialiser le serveur : les tables ne sont construites qu'une fois pour toutes les requêtes
+//Parametre serveur : Serveur
+void serveur_initialiser(Serveur *serveur) {
+    memset(serveur, 0, sizeof(*serveur));
+    initialize_valid_props();
+    initialize_symbol_table();
+    initialize_virtual_machine();
+}
+
+//Fonction libérant les programmes résidents et les propositions valides
+//Parametre serveur : Serveur
+void serveur_liberer(Serveur *serveur) {
+    for (int i = 0; i < serveur->nb_programmes; i++) {
+        mem_liberer(serveur->programmes[i].prog);
+    }
+    mem_liberer(serveur->programmes);
+    mem_liberer(serveur->libres);
+    free_valid_props_memory();
+    memset(serveur, 0, sizeof(*serveur));
+}
+
+//Fonction retrouvant le programme d'un handle (indice dans les 16 bits faibles, génération au-dessus)
+//Parametre serveur : Serveur
+//Parametre handle : entier
+//Retourne le programme, ou NULL si le handle est inconnu ou périmé
+ProgrammeResident *trouver_programme(Serveur *serveur, uint32_t handle) {
+    uint32_t indice = handle & 0xFFFF;
+    if (indice >= (uint32_t)serveur->nb_programmes) return NULL;
+    ProgrammeResident *p = &serveur->programmes[indice];
+    if (!p->prog || (p->generation & 0xFFFF) != handle >> 16) return NULL;
+    return p;
+}
+
+//Fonction compilant une formule et la gardant en mémoire sous un nouveau handle
+//Parametre formule : chaine de caracteres
+//Parametre handle : pointeur vers l'entier qui reçoit le handle
+//Parametre statut : Statut, rempli en cas d'erreur
+//Retourne 0, ou -1 en cas d'erreur
+int compiler_resident(Serveur *serveur, const char *formule, uint32_t *handle, Statut *statut) {
+    VMInstruction prog[PROGRAM_SIZE];
+    int n = -1;
+
+    char **lexemes = CreationListeLexeme(formule, statut);
+    if (!lexemes) return -1;
+    ASTNode *ast = analyseur_syntaxique(lexemes, statut);
+    liberer_lexemes(lexemes);
+    if (ast && analyseur_semantique(ast, statut) == 0) {
+        n = compiler_programme(ast, prog, PROGRAM_SIZE, statut);
+    }
+    freeAST(ast);
+    if (n < 0 || verifier_programme(prog, n, statut) < 0) return -1;
+
+    //Les valuations des requêtes sont des mots de 64 bits
+    for (int i = 0; i < n; i++) {
+        if (prog[i].opcode == VM_LOAD && prog[i].operand >= MAX_PROPS_SERVEUR) {
+            statut_definir(statut, ERR_PROP_INVALIDE, i, "Proposition au-delà des 64 premières");
+            return -1;
+        }
+    }
+
+    int indice;
+    if (serveur->nb_libres > 0) {
+        indice = serveur->libres[--serveur->nb_libres];
+    } else {
+        if (serveur->nb_programmes > 0xFFFF) {
+            statut_definir(statut, ERR_TABLE_PLEINE, -1, "Trop de programmes résidents");
+            return -1;
+        }
+        if (serveur->nb_programmes == serveur->capacite) {
+            int capacite = serveur->capacite ? 2 * serveur->capacite : 64;
+            ProgrammeResident *programmes = mem_reallouer(serveur->programmes, capacite * sizeof(ProgrammeResident));
+            int *libres = programmes ? mem_reallouer(serveur->libres, capacite * sizeof(int)) : NULL;
+            if (programmes) serveur->programmes = programmes;
+            if (!libres) {
+                statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+                return -1;
+            }
+            serveur->libres = libres;
+            serveur->capacite = capacite;
+        }
+        indice = serveur->nb_programmes++;
+        serveur->programmes[indice].prog = NULL;
+        serveur->programmes[indice].generation = 0;
+    }
+
+    ProgrammeResident *p = &serveur->programmes[indice];
+    p->prog = mem_allouer((n > 0 ? n : 1) * sizeof(VMInstruction));
+    if (!p->prog) {
+        serveur->libres[serveur->nb_libres++] = indice;
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    memcpy(p->prog, prog, n * sizeof(VMInstruction));
+    p->taille = n;
+    *handle = ((p->generation & 0xFFFF) << 16) | (uint32_t)indice;
+    return 0;
+}
+
+//Fonction évaluant un programme sur au plus 64 valuations à la fois (une par bit des colonnes)
+//Parametre p : ProgrammeResident
+//Parametre valuations : tableau de n valuations (bit i : proposition valide d'indice i)
+//Parametre n : entier, au plus 64
+//Retourne le mot des résultats (bit k : résultat de la valuation k)
+uint64_t evaluer_paquet(const ProgrammeResident *p, const uint64_t *valuations, int n) {
+    uint64_t colonnes[MAX_PROPS_SERVEUR] = {0};
+    //Transposition : colonnes[i] regroupe la proposition i des n valuations
+    for (int k = 0; k < n; k++) {
+        uint64_t v = valuations[k];
+        while (v) {
+            int i = __builtin_ctzll(v);
+            colonnes[i] |= (uint64_t)1 << k;
+            v &= v - 1;
+        }
+    }
+    uint64_t r = executer_programme_64(p->prog, p->taille, colonnes);
+    return n == 64 ? r : r & (((uint64_t)1 << n) - 1);
+}
+
+
+// ----------------------
+/*
+Traitement des requêtes
+*/
+// ----------------------
+
+//Fonction traitant une requête complète et ajoutant sa réponse à la sortie de la connexion
+//Parametre serveur : Serveur
+//Parametre c : Connexion
+//Parametre entete : EnteteTrame de la requête
+//Parametre donnees : données de la requête
+//Retourne 0, ou -1 si la réponse ne peut pas être ajoutée faute de mémoire (la connexion est fermée)
+int traiter_requete(Serveur *serveur, Connexion *c, const EnteteTrame *entete, const char *donnees) {
+    Statut statut;
+    statut_ok(&statut);
+    uint32_t handle;
+    ProgrammeResident *p;
+
+    switch (entete->type) {
+        case REQ_COMPILER: {
+            char *formule = mem_allouer(entete->taille + 1);
+            if (!formule) {
+                statut_definir(&statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+                break;
+            }
+            memcpy(formule, donnees, entete->taille);
+            formule[entete->taille] = '\0';
+            int r = compiler_resident(serveur, formule, &handle, &statut);
+            mem_liberer(formule);
+            if (r == 0) return ajouter_reponse(c, ERR_AUCUNE, entete->id, &handle, sizeof(handle));
+            break;
+        }
+        case REQ_EVALUER: {
+            uint64_t valuation;
+            if (entete->taille != sizeof(uint32_t) + sizeof(uint64_t)) {
+                statut_definir(&statut, ERR_REQUETE_INVALIDE, -1, "Taille de requête invalide");
+                break;
+            }
+            memcpy(&handle, donnees, sizeof(handle));
+            memcpy(&valuation, donnees + sizeof(handle), sizeof(valuation));
+            if (!(p = trouver_programme(serveur, handle))) {
+                statut_definir(&statut, ERR_HANDLE_INVALIDE, -1, "Handle inconnu");
+                break;
+            }
+            uint32_t resultat = (uint32_t)(evaluer_paquet(p, &valuation, 1) & 1);
+            return ajouter_reponse(c, ERR_AUCUNE, entete->id, &resultat, sizeof(resultat));
+        }
+        case REQ_EVALUER_LOT: {
+            uint32_t n;
+            if (entete->taille < 2 * sizeof(uint32_t)) {
+                statut_definir(&statut, ERR_REQUETE_INVALIDE, -1, "Taille de requête invalide");
+                break;
+            }
+            memcpy(&handle, donnees, sizeof(handle));
+            memcpy(&n, donnees + sizeof(handle), sizeof(n));
+            if (entete->taille != 2 * sizeof(uint32_t) + (uint64_t)n * sizeof(uint64_t)) {
+                statut_definir(&statut, ERR_REQUETE_INVALIDE, -1, "Taille de requête invalide");
+                break;
+            }
+            if (!(p = trouver_programme(serveur, handle))) {
+                statut_definir(&statut, ERR_HANDLE_INVALIDE, -1, "Handle inconnu");
+                break;
+            }
+            //Les réponses sont écrites directement dans la sortie, sans copie intermédiaire
+            uint32_t nb_mots = (n + 63) / 64;
+            EnteteTrame reponse = {nb_mots * (uint32_t)sizeof(uint64_t), ERR_AUCUNE, entete->id};
+            char *sortie = octets_reserver(&c->sortie, sizeof(reponse) + reponse.taille);
+            if (!sortie) return -1;
+            memcpy(sortie, &reponse, sizeof(reponse));
+            const char *valuations = donnees + 2 * sizeof(uint32_t);
+            for (uint32_t m = 0; m < nb_mots; m++) {
+                uint64_t paquet[64];
+                int k = (n - 64 * m < 64) ? (int)(n - 64 * m) : 64;
+                memcpy(paquet, valuations + (size_t)m * 64 * sizeof(uint64_t), k * sizeof(uint64_t));
+                uint64_t r = evaluer_paquet(p, paquet, k);
+                memcpy(sortie + sizeof(reponse) + (size_t)m * sizeof(r), &r, sizeof(r));
+            }
+            return 0;
+        }
+        case REQ_LIBERER:
+            if (entete->taille != sizeof(uint32_t)) {
+                statut_definir(&statut, ERR_REQUETE_INVALIDE, -1, "Taille de requête invalide");
+                break;
+            }
+            memcpy(&handle, donnees, sizeof(handle));
+            if (!(p = trouver_programme(serveur, handle))) {
+                statut_definir(&statut, ERR_HANDLE_INVALIDE, -1, "Handle inconnu");
+                break;
+            }
+            mem_liberer(p->prog);
+            p->prog = NULL;
+            p->generation++;
+            serveur->libres[serveur->nb_libres++] = (int)(handle & 0xFFFF);
+            return ajouter_reponse(c, ERR_AUCUNE, entete->id, NULL, 0);
+        case REQ_ARRETER:
+            serveur->arret = 1;
+            return ajouter_reponse(c, ERR_AUCUNE, entete->id, NULL, 0);
+        default:
+            statut_definir(&statut, ERR_REQUETE_INVALIDE, -1, "Type de requête inconnu");
+            break;
+    }
+    return ajouter_erreur(c, entete->id, &statut);
+}
+
+//Fonction traitant toutes les requêtes complètes reçues sur une connexion
+//(plusieurs requêtes peuvent arriver dans une même lecture : leurs réponses sont regroupées)
+//Les requêtes suivantes attendent dans l'entrée quand la sortie est saturée
+//Parametre serveur : Serveur
+//Parametre c : Connexion
+//Retourne 0, 1 si des requêtes complètes attendent que la sortie se vide, ou -1 si une trame dépasse
+//la taille maximale ou si la mémoire manque
+int traiter_entree(Serveur *serveur, Connexion *c) {
+    int attente = 0;
+    while (!serveur->arret && c->entree.taille - c->entree.debut >= sizeof(EnteteTrame)) {
+        EnteteTrame entete;
+        memcpy(&entete, c->entree.octets + c->entree.debut, sizeof(entete));
+        if (entete.taille > TAILLE_MAX_TRAME) return -1;
+        if (c->entree.taille - c->entree.debut < sizeof(entete) + entete.taille) break;
+        if (sortie_saturee(c)) {
+            attente = 1;
+            break;
+        }
+        if (traiter_requete(serveur, c, &entete, c->entree.octets + c->entree.debut + sizeof(entete)) < 0) return -1;
+        c->entree.debut += sizeof(entete) + entete.taille;
+    }
+    if (c->entree.debut == c->entree.taille) {
+        c->entree.debut = c->entree.taille = 0;
+    }
+    return attente;
+}
+
+//Fonction lisant ce qui est disponible sur une connexion
+//Retourne le nombre d'octets lus, 0 à la fin du flux, -1 en cas d'erreur (EAGAIN compris, ENOMEM si
+//la mémoire manque)
+ssize_t lire_connexion(Connexion *c) {
+    char *p = octets_reserver(&c->entree, TAILLE_LECTURE);
+    if (!p) {
+        errno = ENOMEM;
+        return -1;
+    }
+    ssize_t lu;
+    do {
+        lu = read(c->fd_entree, p, TAILLE_LECTURE);
+    } while (lu < 0 && errno == EINTR);
+    c->entree.taille -= TAILLE_LECTURE - (lu > 0 ? lu : 0);
+    return lu;
+}
+
+//Fonction écrivant la sortie en attente d'une connexion
+//Parametre bloquant : 1 pour tout écrire, 0 pour s'arrêter quand le descripteur est plein
+//Retourne 0, ou -1 en cas d'erreur d'écriture (EPIPE si le client a fermé sa connexion)
+int ecrire_connexion(Connexion *c, int bloquant) {
+    while (c->sortie.debut < c->sortie.taille) {
+        const char *octets = c->sortie.octets + c->sortie.debut;
+        size_t n = c->sortie.taille - c->sortie.debut;
+        ssize_t ecrit = c->socket ? send(c->fd_sortie, octets, n, MSG_NOSIGNAL) : write(c->fd_sortie, octets, n);
+        if (ecrit < 0) {
+            if (errno == EINTR) continue;
+            if (!bloquant && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+            return -1;
+        }
+        c->sortie.debut += ecrit;
+    }
+    c->sortie.debut = c->sortie.taille = 0;
+    return 0;
+}
+
+//Fonction écrivant la sortie en attente d'une connexion non bloquante, jusqu'à l'instant
+//debut + DELAI_ARRET_MS au plus
+//Retourne 0 si tout est écrit, -1 en cas d'erreur ou si le délai est dépassé
+int vider_connexion(Connexion *c, struct timespec debut) {
+    while (c->sortie.debut < c->sortie.taille) {
+        if (ecrire_connexion(c, 0) < 0) return -1;
+        if (c->sortie.debut == c->sortie.taille) break;
+        struct timespec maintenant;
+        clock_gettime(CLOCK_MONOTONIC, &maintenant);
+        long restant = DELAI_ARRET_MS - (maintenant.tv_sec - debut.tv_sec) * 1000 -
+                       (maintenant.tv_nsec - debut.tv_nsec) / 1000000;
+        if (restant <= 0) return -1;
+        struct pollfd pfd = {c->fd_sortie, POLLOUT, 0};
+        if (poll(&pfd, 1, (int)restant) < 0 && errno != EINTR) return -1;
+    }
+    return 0;
+}
+
+//Fonction libérant les tableaux d'une connexion
+void liberer_connexion(Connexion *c) {
+    mem_liberer(c->entree.octets);
+    mem_liberer(c->sortie.octets);
+    memset(c, 0, sizeof(*c));
+}
+
+
+// ----------------------
+/*
+Boucles de service
+*/
+// ----------------------
+
+//Fonction servant un flux (entrée et sortie standard, tube, socket déjà connectée)
+//Parametre serveur : Serveur
+//Parametre fd_entree, fd_sortie : descripteurs de fichiers
+//Retourne 0, ou -1 en cas d'erreur
+int servir_flux(Serveur *serveur, int fd_entree, int fd_sortie) {
+    Connexion c;
+    memset(&c, 0, sizeof(c));
+    c.fd_entree = fd_entree;
+    c.fd_sortie = fd_sortie;
+    struct stat st;
+    c.socket = fstat(fd_sortie, &st) == 0 && S_ISSOCK(st.st_mode);
+
+    int resultat = 0;
+    while (!serveur->arret) {
+        ssize_t lu = lire_connexion(&c);
+        if (lu <= 0) {
+            resultat = lu < 0 ? -1 : 0;
+            break;
+        }
+        //Les réponses sont envoyées lorsque toutes les requêtes reçues ont été traitées, ou dès que la
+        //sortie est saturée
+        int attente;
+        do {
+            attente = traiter_entree(serveur, &c);
+            if (attente < 0 || ecrire_connexion(&c, 1) < 0) attente = -1;
+        } while (attente > 0);
+        if (attente < 0) {
+            resultat = -1;
+            break;
+        }
+    }
+    if (ecrire_connexion(&c, 1) < 0) resultat = -1;
+    liberer_connexion(&c);
+    return resultat;
+}
+
+//Fonction passant un descripteur en mode non bloquant (et fermé lors d'un exec)
+void rendre_non_bloquant(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+//Fonction servant les connexions d'une socket Unix
+//Parametre serveur : Serveur
+//Parametre chemin : chaine de caracteres, chemin de la socket (remplacée si elle existe)
+//Retourne 0, ou -1 si la socket ne peut pas être créée
+int servir_socket(Serveur *serveur, const char *chemin) {
+    struct sockaddr_un adresse;
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    if (strlen(chemin) >= sizeof(adresse.sun_path)) {
+        fprintf(stderr, "Erreur : Chemin de socket trop long.\n");
+        return -1;
+    }
+    strcpy(adresse.sun_path, chemin);
+
+    int ecoute = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ecoute < 0) {
+        perror("Erreur de création de la socket");
+        return -1;
+    }
+    rendre_non_bloquant(ecoute);
+    unlink(chemin);
+    if (bind(ecoute, (struct sockaddr *)&adresse, sizeof(adresse)) < 0 || listen(ecoute, 64) < 0) {
+        perror("Erreur d'écoute sur la socket");
+        close(ecoute);
+        return -1;
+    }
+
+    //L'indice 0 de fds est la socket d'écoute, l'indice i > 0 la connexion i - 1
+    struct pollfd fds[MAX_CONNEXIONS + 1];
+    Connexion connexions[MAX_CONNEXIONS];
+    int nb = 0;
+    fds[0].fd = ecoute;
+    fds[0].events = POLLIN;
+
+    while (!serveur->arret) {
+        //Une connexion dont la sortie est saturée n'est plus lue jusqu'à ce que le client lise ses réponses
+        for (int i = 0; i < nb; i++) {
+            fds[i + 1].fd = connexions[i].fd_entree;
+            fds[i + 1].events = (sortie_saturee(&connexions[i]) ? 0 : POLLIN) |
+                                (connexions[i].sortie.taille > connexions[i].sortie.debut ? POLLOUT : 0);
+            fds[i + 1].revents = 0;
+        }
+        fds[0].events = nb < MAX_CONNEXIONS ? POLLIN : 0;
+        if (poll(fds, nb + 1, -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("Erreur de poll");
+            break;
+        }
+
+        //Nouvelles connexions
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while (nb < MAX_CONNEXIONS && (fd = accept(ecoute, NULL, NULL)) >= 0) {
+                rendre_non_bloquant(fd);
+                memset(&connexions[nb], 0, sizeof(Connexion));
+                connexions[nb].fd_entree = connexions[nb].fd_sortie = fd;
+                connexions[nb].socket = 1;
+                fds[nb + 1].revents = 0;
+                nb++;
+            }
+        }
+
+        //Requêtes et réponses des connexions existantes
+        for (int i = 0; i < nb && !serveur->arret; i++) {
+            Connexion *c = &connexions[i];
+            int fermer = 0;
+            if (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR)) {
+                ssize_t lu = 1;
+                while (!sortie_saturee(c) && (lu = lire_connexion(c)) > 0) {
+                    if (traiter_entree(serveur, c) < 0) {
+                        fermer = 1;
+                        break;
+                    }
+                }
+                if (lu == 0 || (lu < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) fermer = 1;
+            }
+            if (!fermer && ecrire_connexion(c, 0) < 0) fermer = 1;
+            //Les requêtes gardées pendant la saturation sont traitées quand la sortie se vide
+            if (!fermer && !sortie_saturee(c) && traiter_entree(serveur, c) < 0) fermer = 1;
+            if (fermer) {
+                close(c->fd_entree);
+                liberer_connexion(c);
+                //La dernière connexion prend la place libérée
+                connexions[i] = connexions[nb - 1];
+                fds[i + 1].revents = fds[nb].revents;
+                nb--;
+                i--;
+            }
+        }
+    }
+
+    //Arrêt : les réponses en attente (dont celle de la requête d'arrêt) sont envoyées avant la fermeture,
+    //pendant au plus DELAI_ARRET_MS pour l'ensemble des connexions
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nb; i++) {
+        vider_connexion(&connexions[i], debut);
+        close(connexions[i].fd_entree);
+        liberer_connexion(&connexions[i]);
+    }
+    close(ecoute);
+    unlink(chemin);
+    return 0;
+}
+
+
+// ----------------------
+/*
+Fonctions pour les clients
+*/
+// ----------------------
+
+//Fonction écrivant exactement n octets
+//Retourne 0, ou -1 en cas d'erreur
+int ecrire_tout(int fd, const void *donnees, size_t n) {
+    const char *p = donnees;
+    while (n > 0) {
+        ssize_t ecrit = write(fd, p, n);
+        if (ecrit < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += ecrit;
+        n -= ecrit;
+    }
+    return 0;
+}
+
+//Fonction lisant exactement n octets
+//Retourne 0, ou -1 en cas d'erreur ou de fin du flux
+int lire_tout(int fd, void *donnees, size_t n) {
+    char *p = donnees;
+    while (n > 0) {
+        ssize_t lu = read(fd, p, n);
+        if (lu < 0 && errno == EINTR) continue;
+        if (lu <= 0) return -1;
+        p += lu;
+        n -= lu;
+    }
+    return 0;
+}
+
+//Fonction envoyant une trame (en-tête puis données)
+//Parametre fd : descripteur de fichier
+//Parametre type : TypeRequete
+//Parametre id : identifiant recopié dans la réponse
+//Parametre donnees, taille : données de la requête
+//Retourne 0, ou -1 en cas d'erreur
+int envoyer_trame(int fd, uint32_t type, uint32_t id, const void *donnees, uint32_t taille) {
+    EnteteTrame entete = {taille, type, id};
+    if (ecrire_tout(fd, &entete, sizeof(entete)) < 0) return -1;
+    return taille > 0 ? ecrire_tout(fd, donnees, taille) : 0;
+}
+
+//Fonction lisant une trame complète
+//Parametre fd : descripteur de fichier
+//Parametre entete : EnteteTrame lu
+//Parametre donnees : pointeur recevant les données allouées (NULL si la trame n'a pas de données)
+//Retourne 0, ou -1 en cas d'erreur ou de fin du flux
+int lire_trame(int fd, EnteteTrame *entete, void **donnees) {
+    *donnees = NULL;
+    if (lire_tout(fd, entete, sizeof(*entete)) < 0 || entete->taille > TAILLE_MAX_TRAME) return -1;
+    if (entete->taille == 0) return 0;
+    *donnees = malloc(entete->taille);
+    if (!*donnees) return -1;
+    if (lire_tout(fd, *donnees, entete->taille) < 0) {
+        free(*donnees);
+        *donnees = NULL;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef SERVEUR_H
+#define SERVEUR_H
+
+#include <stdint.h>
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Serveur d'évaluation local : les propositions valides et les tables sont initialisées une seule fois,
+//les programmes compilés restent en mémoire sous un handle entre les requêtes.
+//
+//Chaque trame commence par un en-tête de trois entiers 32 bits (ordre des octets de la machine,
+//le client est local) suivi de taille octets de données.
+//Requête : type = TypeRequete, id choisi par le client.
+//Réponse : type = code d'erreur (ERR_AUCUNE si succès), même id que la requête.
+//En cas d'erreur les données de la réponse sont la position (u32) suivie du message.
+//Les réponses sont envoyées dans l'ordre des requêtes : un client peut envoyer plusieurs requêtes
+//sans attendre les réponses.
+typedef struct {
+    uint32_t taille;
+    uint32_t type;
+    uint32_t id;
+} EnteteTrame;
+
+//Types de requêtes, avec leurs données et celles de la réponse
+typedef enum {
+    REQ_COMPILER = 1,       //Formule UTF-8 (sans zéro final) -> u32 handle
+    REQ_EVALUER = 2,        //u32 handle, u64 valuation -> u32 résultat (0 ou 1)
+                            //Le bit i de la valuation est la valeur de la proposition valide d'indice i
+    REQ_EVALUER_LOT = 3,    //u32 handle, u32 n, n valuations u64 -> (n + 63) / 64 mots u64,
+                            //le bit k du mot i est le résultat de la valuation 64 i + k
+    REQ_LIBERER = 4,        //u32 handle -> rien
+    REQ_ARRETER = 5         //Arrêt du serveur après la réponse -> rien
+} TypeRequete;
+
+//Taille maximale des données d'une trame (une trame plus grande ferme la connexion)
+#define TAILLE_MAX_TRAME (64u * 1024 * 1024)
+
+//Programme compilé conservé par le serveur
+typedef struct {
+    VMInstruction* prog;    //NULL si la place est libre
+    int taille;
+    uint32_t generation;    //Incrémentée à chaque libération, pour refuser les handles périmés
+} ProgrammeResident;
+
+//Etat du serveur, partagé par toutes les connexions
+typedef struct {
+    ProgrammeResident* programmes;
+    int nb_programmes;
+    int capacite;
+    int* libres;            //Places libres de programmes (pile)
+    int nb_libres;
+    int arret;              //Mis à 1 par REQ_ARRETER
+} Serveur;
+
+//Initialisation (propositions valides, table des symboles, machine virtuelle) et libération
+void serveur_initialiser(Serveur* serveur);
+void serveur_liberer(Serveur* serveur);
+
+//Sert une connexion déjà ouverte (par exemple l'entrée et la sortie standard) jusqu'à la fin du flux
+//ou une requête d'arrêt. Retourne 0, ou -1 en cas d'erreur de lecture, d'écriture ou de trame
+int servir_flux(Serveur* serveur, int fd_entree, int fd_sortie);
+
+//Ecoute sur une socket Unix et sert toutes les connexions (une seule boucle poll) jusqu'à une requête
+//d'arrêt. Un client qui ferme sa connexion sans lire ses réponses ne fait que fermer cette connexion
+//(pas de SIGPIPE) ; à l'arrêt, les réponses en attente sont envoyées pendant au plus DELAI_ARRET_MS.
+//Retourne 0, ou -1 si la socket ne peut pas être créée
+int servir_socket(Serveur* serveur, const char* chemin);
+
+//Fonctions pour les clients : envoi d'une trame et lecture d'une trame complète
+//lire_trame alloue les données (à libérer avec free). Retournent 0, ou -1 (erreur ou fin du flux)
+int envoyer_trame(int fd, uint32_t type, uint32_t id, const void* donnees, uint32_t taille);
+int lire_trame(int fd, EnteteTrame* entete, void** donnees);
+
+#endif
@@ -0,0 +1,780 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "solveur.h"
+#include "allocateur.h"
+
+
+//Entête d'une clause dans la mémoire : taille, apprise, lbd
+#define ENTETE_CLAUSE 3
+
+//Pas de clause (raison d'une décision)
+#define REF_AUCUNE -1
+
+//Propagation interrompue faute de mémoire
+#define REF_MEMOIRE -2
+
+//Conflits entre deux redémarrages : LUBY_UNITE * luby(i)
+#define LUBY_UNITE 100
+
+//Nombre initial de clauses apprises gardées, et augmentation à chaque réduction
+#define MAX_APPRISES_INITIAL 2000
+#define MAX_APPRISES_PAS 300
+
+//Décroissance de l'activité des variables (l'incrément est divisé à chaque conflit)
+#define DECROISSANCE_ACTIVITE 0.95
+
+
+//Codage interne des littéraux : 2 * v pour v, 2 * v + 1 pour ¬v
+static inline int code_litteral(int litteral) {
+    return litteral > 0 ? 2 * litteral : -2 * litteral + 1;
+}
+
+static inline int litteral_code(int code) {
+    return (code & 1) ? -(code >> 1) : (code >> 1);
+}
+
+static inline int niveau_courant(const Solveur *s) {
+    return s->debut_niveaux.nb;
+}
+
+//Fonction réservant la place de n entiers dans un vecteur
+//Retourne 0, ou -1 si la mémoire manque (le vecteur est alors inchangé)
+static int vecteur_reserver(VecteurEntiers *v, int n) {
+    if (n <= v->capacite) return 0;
+    int capacite = v->capacite ? 2 * v->capacite : 8;
+    if (capacite < n) capacite = n;
+    int *elements = mem_reallouer(v->elements, capacite * sizeof(int));
+    if (!elements) return -1;
+    v->elements = elements;
+    v->capacite = capacite;
+    return 0;
+}
+
+//Fonction ajoutant un entier à un vecteur
+//Retourne 0, ou -1 si la mémoire manque (jamais pour un vecteur dont la place est réservée)
+static int vecteur_ajouter(VecteurEntiers *v, int x) {
+    if (vecteur_reserver(v, v->nb + 1) < 0) return -1;
+    v->elements[v->nb++] = x;
+    return 0;
+}
+
+//Fonction agrandissant un tableau par variable ou par littéral (les nouvelles cases sont à zéro)
+//Retourne le tableau agrandi, ou NULL si la mémoire manque (l'ancien tableau reste alors valide)
+static void *agrandir_tableau(void *tableau, size_t ancien, size_t nouveau, size_t taille_element) {
+    char *t = mem_reallouer(tableau, nouveau * taille_element);
+    if (!t) return NULL;
+    memset(t + ancien * taille_element, 0, (nouveau - ancien) * taille_element);
+    return t;
+}
+
+//Fonction signalant un manque de mémoire
+//Retourne -1
+static int memoire_manquante_solveur(Statut *statut) {
+    statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+    return -1;
+}
+
+
+// ----------------------
+/*
+Tas des variables (VSIDS) : la prochaine décision porte sur la variable libre la plus active
+*/
+// ----------------------
+
+static void tas_monter(Solveur *s, int i) {
+    int v = s->tas[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (s->activite[s->tas[parent]] >= s->activite[v]) break;
+        s->tas[i] = s->tas[parent];
+        s->position_tas[s->tas[i]] = i;
+        i = parent;
+    }
+    s->tas[i] = v;
+    s->position_tas[v] = i;
+}
+
+static void tas_descendre(Solveur *s, int i) {
+    int v = s->tas[i];
+    for (;;) {
+        int fils = 2 * i + 1;
+        if (fils >= s->taille_tas) break;
+        if (fils + 1 < s->taille_tas && s->activite[s->tas[fils + 1]] > s->activite[s->tas[fils]]) fils++;
+        if (s->activite[s->tas[fils]] <= s->activite[v]) break;
+        s->tas[i] = s->tas[fils];
+        s->position_tas[s->tas[i]] = i;
+        i = fils;
+    }
+    s->tas[i] = v;
+    s->position_tas[v] = i;
+}
+
+static void tas_inserer(Solveur *s, int v) {
+    if (s->position_tas[v] >= 0) return;
+    s->tas[s->taille_tas] = v;
+    s->position_tas[v] = s->taille_tas++;
+    tas_monter(s, s->position_tas[v]);
+}
+
+static int tas_extraire(Solveur *s) {
+    int v = s->tas[0];
+    s->position_tas[v] = -1;
+    if (--s->taille_tas > 0) {
+        s->tas[0] = s->tas[s->taille_tas];
+        s->position_tas[s->tas[0]] = 0;
+        tas_descendre(s, 0);
+    }
+    return v;
+}
+
+static void augmenter_activite(Solveur *s, int v) {
+    if ((s->activite[v] += s->increment) > 1e100) {
+        for (int x = 1; x <= s->nb_variables; x++) s->activite[x] *= 1e-100;
+        s->increment *= 1e-100;
+    }
+    if (s->position_tas[v] >= 0) tas_monter(s, s->position_tas[v]);
+}
+
+
+// ----------------------
+/*
+Variables, affectations et clauses
+*/
+// ----------------------
+
+//Fonction déclarant les variables 1 .. nb_variables (les tableaux sont agrandis si besoin)
+//Chaque variable est affectée au plus une fois et ne paraît qu'une fois dans une clause : la trace,
+//la clause en cours et les marques de l'apprentissage sont réservées ici et ne grandissent plus
+//pendant la recherche
+//Retourne 0, ou -1 si la mémoire manque (les variables déclarées sont alors inchangées)
+static int reserver_variables(Solveur *s, int nb_variables) {
+    if (nb_variables <= s->nb_variables) return 0;
+    if (nb_variables >= s->capacite_variables) {
+        size_t ancien = s->capacite_variables;
+        size_t nouveau = 2 * ancien > (size_t)nb_variables + 1 ? 2 * ancien : (size_t)nb_variables + 1;
+        if (nouveau < 64) nouveau = 64;
+        void *p;
+        if (!(p = agrandir_tableau(s->surveillances, 2 * ancien, 2 * nouveau, sizeof(VecteurEntiers)))) return -1;
+        s->surveillances = p;
+        if (!(p = agrandir_tableau(s->valeurs, 2 * ancien, 2 * nouveau, sizeof(int8_t)))) return -1;
+        s->valeurs = p;
+        if (!(p = agrandir_tableau(s->niveau, ancien, nouveau, sizeof(int)))) return -1;
+        s->niveau = p;
+        if (!(p = agrandir_tableau(s->raison, ancien, nouveau, sizeof(int)))) return -1;
+        s->raison = p;
+        if (!(p = agrandir_tableau(s->phase, ancien, nouveau, sizeof(int8_t)))) return -1;
+        s->phase = p;
+        if (!(p = agrandir_tableau(s->vu, ancien, nouveau, sizeof(uint8_t)))) return -1;
+        s->vu = p;
+        if (!(p = agrandir_tableau(s->activite, ancien, nouveau, sizeof(double)))) return -1;
+        s->activite = p;
+        if (!(p = agrandir_tableau(s->tas, ancien, nouveau, sizeof(int)))) return -1;
+        s->tas = p;
+        if (!(p = agrandir_tableau(s->position_tas, ancien, nouveau, sizeof(int)))) return -1;
+        s->position_tas = p;
+        if (!(p = agrandir_tableau(s->modele, ancien, nouveau, sizeof(int8_t)))) return -1;
+        s->modele = p;
+        s->capacite_variables = (int)nouveau;
+    }
+    if (vecteur_reserver(&s->trace, nb_variables) < 0 || vecteur_reserver(&s->tampon, nb_variables + 1) < 0 ||
+        vecteur_reserver(&s->effaces, nb_variables) < 0) {
+        return -1;
+    }
+    for (int v = s->nb_variables + 1; v <= nb_variables; v++) {
+        s->raison[v] = REF_AUCUNE;
+        s->phase[v] = 1;
+        s->position_tas[v] = -1;
+        tas_inserer(s, v);
+    }
+    s->nb_variables = nb_variables;
+    return 0;
+}
+
+//Fonction affectant un littéral codé au niveau courant
+static void affecter(Solveur *s, int code, int raison) {
+    int v = code >> 1;
+    s->valeurs[code] = 1;
+    s->valeurs[code ^ 1] = -1;
+    s->niveau[v] = niveau_courant(s);
+    s->raison[v] = raison;
+    vecteur_ajouter(&s->trace, code);
+}
+
+//Fonction annulant les affectations des niveaux supérieurs à niveau
+static void annuler(Solveur *s, int niveau) {
+    if (niveau_courant(s) <= niveau) return;
+    int debut = s->debut_niveaux.elements[niveau];
+    for (int i = s->trace.nb - 1; i >= debut; i--) {
+        int code = s->trace.elements[i];
+        int v = code >> 1;
+        s->valeurs[code] = s->valeurs[code ^ 1] = 0;
+        s->raison[v] = REF_AUCUNE;
+        s->phase[v] = (int8_t)(code & 1);
+        tas_inserer(s, v);
+    }
+    s->trace.nb = debut;
+    s->propagees = debut;
+    s->debut_niveaux.nb = niveau;
+}
+
+//Fonction surveillant les deux premiers littéraux d'une clause
+//Chaque surveillance est une paire (référence, bloqueur) : si le bloqueur (un autre littéral de la
+//clause) est vrai, la clause est satisfaite sans lire la mémoire des clauses
+static void surveiller_clause(Solveur *s, int ref) {
+    const int *lits = &s->memoire.elements[ref + ENTETE_CLAUSE];
+    vecteur_ajouter(&s->surveillances[lits[0]], ref);
+    vecteur_ajouter(&s->surveillances[lits[0]], lits[1]);
+    vecteur_ajouter(&s->surveillances[lits[1]], ref);
+    vecteur_ajouter(&s->surveillances[lits[1]], lits[0]);
+}
+
+//Fonction rangeant une clause d'au moins 2 littéraux codés (qui ne sont pas dans memoire)
+//Toute la place est réservée avant le premier ajout : une clause est rangée entière ou pas du tout
+//Retourne la référence de la clause, ou REF_AUCUNE si la mémoire manque
+static int stocker_clause(Solveur *s, const int *codes, int n, int apprise, int lbd) {
+    VecteurEntiers *refs = apprise ? &s->apprises : &s->originales;
+    VecteurEntiers *w0 = &s->surveillances[codes[0]], *w1 = &s->surveillances[codes[1]];
+    if (vecteur_reserver(&s->memoire, s->memoire.nb + ENTETE_CLAUSE + n) < 0 ||
+        vecteur_reserver(refs, refs->nb + 1) < 0 || vecteur_reserver(w0, w0->nb + 2) < 0 ||
+        vecteur_reserver(w1, w1->nb + 2) < 0) {
+        return REF_AUCUNE;
+    }
+    int ref = s->memoire.nb;
+    vecteur_ajouter(&s->memoire, n);
+    vecteur_ajouter(&s->memoire, apprise);
+    vecteur_ajouter(&s->memoire, lbd);
+    for (int i = 0; i < n; i++) vecteur_ajouter(&s->memoire, codes[i]);
+    vecteur_ajouter(refs, ref);
+    surveiller_clause(s, ref);
+    return ref;
+}
+
+//Fonction de propagation des affectations de trace
+//Le littéral propagé par une clause est toujours à sa première place (analyser s'en sert)
+//Retourne la référence d'une clause en conflit, REF_AUCUNE, ou REF_MEMOIRE si une surveillance n'a
+//pas pu être déplacée (elle reste en place et le littéral sera propagé à nouveau)
+static int propager(Solveur *s) {
+    int conflit = REF_AUCUNE;
+    while (s->propagees < s->trace.nb && conflit == REF_AUCUNE) {
+        int faux = s->trace.elements[s->propagees++] ^ 1;
+        VecteurEntiers *w = &s->surveillances[faux];
+        int *e = w->elements;
+        int i = 0, j = 0;
+        s->propagations++;
+        while (i < w->nb) {
+            int ref = e[i], bloqueur = e[i + 1];
+            i += 2;
+            if (s->valeurs[bloqueur] == 1) {
+                e[j++] = ref;
+                e[j++] = bloqueur;
+                continue;
+            }
+            int *lits = &s->memoire.elements[ref + ENTETE_CLAUSE];
+            if (lits[0] == faux) {
+                lits[0] = lits[1];
+                lits[1] = faux;
+            }
+            int premier = lits[0];
+            if (premier != bloqueur && s->valeurs[premier] == 1) {
+                e[j++] = ref;
+                e[j++] = premier;
+                continue;
+            }
+            //Recherche d'un autre littéral à surveiller
+            int taille = s->memoire.elements[ref];
+            int k = 2;
+            while (k < taille && s->valeurs[lits[k]] == -1) k++;
+            if (k < taille) {
+                VecteurEntiers *autre = &s->surveillances[lits[k]];
+                if (vecteur_reserver(autre, autre->nb + 2) < 0) {
+                    e[j++] = ref;
+                    e[j++] = bloqueur;
+                    while (i < w->nb) e[j++] = e[i++];
+                    s->propagees--;
+                    conflit = REF_MEMOIRE;
+                    continue;
+                }
+                lits[1] = lits[k];
+                lits[k] = faux;
+                vecteur_ajouter(&s->surveillances[lits[1]], ref);
+                vecteur_ajouter(&s->surveillances[lits[1]], premier);
+                continue;
+            }
+            //Clause unitaire ou en conflit
+            e[j++] = ref;
+            e[j++] = premier;
+            if (s->valeurs[premier] == -1) {
+                conflit = ref;
+                while (i < w->nb) e[j++] = e[i++];
+            } else {
+                affecter(s, premier, ref);
+            }
+        }
+        w->nb = j;
+    }
+    if (conflit >= 0) s->propagees = s->trace.nb;
+    return conflit;
+}
+
+
+// ----------------------
+/*
+Analyse des conflits
+   La clause apprise est coupée au premier point d'implication unique du niveau courant, puis
+   réduite : un littéral dont la raison ne contient que des littéraux de la clause est retiré.
+   Son premier littéral devient vrai après le retour au niveau du second (le plus haut des autres).
+*/
+// ----------------------
+
+//Fonction d'apprentissage d'une clause (rangée dans s->tampon)
+//Parametre conflit : référence de la clause en conflit
+//Parametre niveau_retour : niveau auquel revenir (sortie)
+//Retourne le lbd de la clause (nombre de niveaux distincts)
+static int analyser(Solveur *s, int conflit, int *niveau_retour) {
+    VecteurEntiers *appris = &s->tampon;
+    appris->nb = 0;
+    vecteur_ajouter(appris, 0);
+    int restants = 0, p = -1, index = s->trace.nb - 1, ref = conflit;
+    do {
+        const int *lits = &s->memoire.elements[ref + ENTETE_CLAUSE];
+        int taille = s->memoire.elements[ref];
+        for (int k = p < 0 ? 0 : 1; k < taille; k++) {
+            int v = lits[k] >> 1;
+            if (s->vu[v] || s->niveau[v] == 0) continue;
+            s->vu[v] = 1;
+            augmenter_activite(s, v);
+            if (s->niveau[v] >= niveau_courant(s)) restants++;
+            else vecteur_ajouter(appris, lits[k]);
+        }
+        while (!s->vu[s->trace.elements[index] >> 1]) index--;
+        p = s->trace.elements[index--];
+        ref = s->raison[p >> 1];
+        s->vu[p >> 1] = 0;
+        restants--;
+    } while (restants > 0);
+    appris->elements[0] = p ^ 1;
+
+    //Réduction, puis effacement des marques
+    s->effaces.nb = 0;
+    for (int i = 1; i < appris->nb; i++) vecteur_ajouter(&s->effaces, appris->elements[i] >> 1);
+    int j = 1;
+    for (int i = 1; i < appris->nb; i++) {
+        int r = s->raison[appris->elements[i] >> 1];
+        int redondant = r != REF_AUCUNE;
+        for (int k = 1; redondant && k < s->memoire.elements[r]; k++) {
+            int v = s->memoire.elements[r + ENTETE_CLAUSE + k] >> 1;
+            redondant = s->vu[v] || s->niveau[v] == 0;
+        }
+        if (!redondant) appris->elements[j++] = appris->elements[i];
+    }
+    appris->nb = j;
+    for (int i = 0; i < s->effaces.nb; i++) s->vu[s->effaces.elements[i]] = 0;
+
+    //Le littéral du niveau le plus haut (après le premier) est placé en second pour être surveillé
+    *niveau_retour = 0;
+    for (int i = 1; i < appris->nb; i++) {
+        if (s->niveau[appris->elements[i] >> 1] > *niveau_retour) {
+            *niveau_retour = s->niveau[appris->elements[i] >> 1];
+            int x = appris->elements[1];
+            appris->elements[1] = appris->elements[i];
+            appris->elements[i] = x;
+        }
+    }
+
+    s->estampille++;
+    int lbd = 0;
+    for (int i = 0; i < appris->nb; i++) {
+        int niveau = s->niveau[appris->elements[i] >> 1];
+        if (s->marque_niveau[niveau] != s->estampille) {
+            s->marque_niveau[niveau] = s->estampille;
+            lbd++;
+        }
+    }
+    return lbd;
+}
+
+//Fonction calculant le noyau quand l'hypothèse codée code est fausse : les hypothèses (décisions
+//des premiers niveaux) dont dépend sa négation
+static void analyser_final(Solveur *s, int code) {
+    s->noyau.nb = 0;
+    vecteur_ajouter(&s->noyau, litteral_code(code));
+    if (niveau_courant(s) == 0) return;
+    s->vu[code >> 1] = 1;
+    for (int i = s->trace.nb - 1; i >= s->debut_niveaux.elements[0]; i--) {
+        int q = s->trace.elements[i];
+        int v = q >> 1;
+        if (!s->vu[v]) continue;
+        int r = s->raison[v];
+        if (r == REF_AUCUNE) {
+            vecteur_ajouter(&s->noyau, litteral_code(q));
+        } else {
+            for (int k = 1; k < s->memoire.elements[r]; k++) {
+                int x = s->memoire.elements[r + ENTETE_CLAUSE + k] >> 1;
+                if (s->niveau[x] > 0) s->vu[x] = 1;
+            }
+        }
+        s->vu[v] = 0;
+    }
+    s->vu[code >> 1] = 0;
+}
+
+
+// ----------------------
+/*
+Réduction de la base de clauses (au niveau 0, entre deux redémarrages)
+   Les clauses satisfaites au niveau 0 sont retirées, les littéraux faux au niveau 0 aussi, et la
+   moitié des clauses apprises de lbd > 2 (les lbd les plus grands) est oubliée. La mémoire est
+   compactée et les surveillances reconstruites.
+*/
+// ----------------------
+
+typedef struct {
+    long cle;
+    int ref;
+} CleClause;
+
+static int comparer_cles(const void *a, const void *b) {
+    long x = ((const CleClause *)a)->cle, y = ((const CleClause *)b)->cle;
+    return (x > y) - (x < y);
+}
+
+//Fonction recopiant les clauses gardées de refs dans la nouvelle mémoire
+static void recopier_clauses(Solveur *s, VecteurEntiers *refs, VecteurEntiers *memoire) {
+    int gardees = 0;
+    for (int i = 0; i < refs->nb; i++) {
+        int ref = refs->elements[i];
+        const int *clause = &s->memoire.elements[ref];
+        if (clause[1] < 0) continue;
+        int satisfaite = 0;
+        s->tampon.nb = 0;
+        for (int k = 0; k < clause[0] && !satisfaite; k++) {
+            int code = clause[ENTETE_CLAUSE + k];
+            if (s->valeurs[code] == 1) satisfaite = 1;
+            else if (s->valeurs[code] == 0) vecteur_ajouter(&s->tampon, code);
+        }
+        if (satisfaite) continue;
+        int nouvelle = memoire->nb;
+        vecteur_ajouter(memoire, s->tampon.nb);
+        vecteur_ajouter(memoire, clause[1]);
+        vecteur_ajouter(memoire, clause[2]);
+        for (int k = 0; k < s->tampon.nb; k++) vecteur_ajouter(memoire, s->tampon.elements[k]);
+        refs->elements[gardees++] = nouvelle;
+    }
+    refs->nb = gardees;
+}
+
+//Fonction de réduction, appelée au niveau 0 après une propagation complète
+//Les clauses ne font que raccourcir : la nouvelle mémoire est réservée à la taille de l'ancienne, avant
+//tout changement. Les surveillances d'une clause gardée portent sur les mêmes littéraux qu'avant (ses
+//deux premiers, non affectés au niveau 0) : leurs listes ont déjà la place nécessaire
+//Retourne 0, ou -1 si la mémoire manque (les clauses sont alors inchangées)
+static int reduire_clauses(Solveur *s) {
+    CleClause *cles = mem_allouer((s->apprises.nb > 0 ? s->apprises.nb : 1) * sizeof(CleClause));
+    VecteurEntiers memoire = {NULL, 0, 0};
+    if (!cles || vecteur_reserver(&memoire, s->memoire.nb) < 0) {
+        mem_liberer(cles);
+        return -1;
+    }
+
+    //Oubli des clauses apprises : marquées par apprise = -1
+    int nb = 0;
+    for (int i = 0; i < s->apprises.nb; i++) {
+        int ref = s->apprises.elements[i];
+        if (s->memoire.elements[ref + 2] > 2) {
+            cles[nb].cle = (long)s->memoire.elements[ref + 2] * (1L << 32) + s->memoire.elements[ref];
+            cles[nb].ref = ref;
+            nb++;
+        }
+    }
+    qsort(cles, nb, sizeof(CleClause), comparer_cles);
+    for (int i = nb / 2; i < nb; i++) s->memoire.elements[cles[i].ref + 1] = -1;
+    mem_liberer(cles);
+
+    //Compactage : les affectations du niveau 0 n'ont plus besoin de raison
+    recopier_clauses(s, &s->originales, &memoire);
+    recopier_clauses(s, &s->apprises, &memoire);
+    mem_liberer(s->memoire.elements);
+    s->memoire = memoire;
+    for (int i = 0; i < s->trace.nb; i++) s->raison[s->trace.elements[i] >> 1] = REF_AUCUNE;
+    for (int c = 2; c <= 2 * s->nb_variables + 1; c++) s->surveillances[c].nb = 0;
+    for (int i = 0; i < s->originales.nb; i++) surveiller_clause(s, s->originales.elements[i]);
+    for (int i = 0; i < s->apprises.nb; i++) surveiller_clause(s, s->apprises.elements[i]);
+    return 0;
+}
+
+
+// ----------------------
+/*
+Interface
+*/
+// ----------------------
+
+//Clauses émises par l'encodeur : ajoutées au solveur
+static void recevoir_clause(const int *litteraux, int n, void *donnees) {
+    Solveur *s = donnees;
+    if (solveur_ajouter_clause(s, litteraux, n, NULL) < 0) s->clause_refusee = 1;
+}
+
+//Fonction d'initialisation d'un solveur
+void solveur_initialiser(Solveur *s) {
+    memset(s, 0, sizeof(*s));
+    encodeur_initialiser(&s->enc, recevoir_clause, s);
+    s->enc.selon_polarite = 0;
+    s->increment = 1.0;
+    s->max_apprises = MAX_APPRISES_INITIAL;
+}
+
+//Fonction de libération d'un solveur
+void solveur_liberer(Solveur *s) {
+    encodeur_liberer(&s->enc);
+    for (int c = 0; c < 2 * s->capacite_variables; c++) mem_liberer(s->surveillances[c].elements);
+    mem_liberer(s->surveillances);
+    mem_liberer(s->valeurs);
+    mem_liberer(s->niveau);
+    mem_liberer(s->raison);
+    mem_liberer(s->phase);
+    mem_liberer(s->vu);
+    mem_liberer(s->marque_niveau);
+    mem_liberer(s->activite);
+    mem_liberer(s->tas);
+    mem_liberer(s->position_tas);
+    mem_liberer(s->modele);
+    mem_liberer(s->memoire.elements);
+    mem_liberer(s->originales.elements);
+    mem_liberer(s->apprises.elements);
+    mem_liberer(s->trace.elements);
+    mem_liberer(s->debut_niveaux.elements);
+    mem_liberer(s->tampon.elements);
+    mem_liberer(s->effaces.elements);
+    mem_liberer(s->noyau.elements);
+    memset(s, 0, sizeof(*s));
+}
+
+//Fonction donnant la variable d'une proposition
+//Retourne la variable, ou 0 si la mémoire manque
+int solveur_variable_prop(Solveur *s, const char *nom) {
+    int v = encodeur_variable_prop(&s->enc, nom);
+    return v == 0 || reserver_variables(s, v) < 0 ? 0 : v;
+}
+
+//Fonction créant une variable (partagée avec l'encodeur, qui ne la réutilise pas)
+//Retourne la variable, ou 0 si la mémoire manque
+int solveur_nouvelle_variable(Solveur *s) {
+    int v = s->enc.nb_variables + 1;
+    if (reserver_variables(s, v) < 0) return 0;
+    s->enc.nb_variables = v;
+    return v;
+}
+
+//Fonction ajoutant une clause (toujours au niveau 0, entre deux appels de resoudre)
+//Parametre litteraux : littéraux DIMACS
+//Parametre n : nombre de littéraux
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0 si les clauses sont devenues insatisfiables, 1 sinon, -1 si la mémoire manque
+int solveur_ajouter_clause(Solveur *s, const int *litteraux, int n, Statut *statut) {
+    statut_ok(statut);
+    if (s->incoherent) return 0;
+    int max = 0;
+    for (int i = 0; i < n; i++) {
+        if (abs(litteraux[i]) > max) max = abs(litteraux[i]);
+    }
+    if (reserver_variables(s, max) < 0) return memoire_manquante_solveur(statut);
+
+    //Littéraux en double, clause tautologique, littéraux déjà affectés au niveau 0
+    s->tampon.nb = 0;
+    for (int i = 0; i < n; i++) {
+        int code = code_litteral(litteraux[i]);
+        if (s->valeurs[code] == 1) return 1;
+        if (s->valeurs[code] == -1) continue;
+        int k = 0;
+        while (k < s->tampon.nb && (s->tampon.elements[k] >> 1) != (code >> 1)) k++;
+        if (k == s->tampon.nb) vecteur_ajouter(&s->tampon, code);
+        else if (s->tampon.elements[k] != code) return 1;
+    }
+
+    if (s->tampon.nb == 0) {
+        s->incoherent = 1;
+    } else if (s->tampon.nb == 1) {
+        //Si la propagation s'interrompt, le littéral reste affecté et sera propagé par l'appel suivant
+        affecter(s, s->tampon.elements[0], REF_AUCUNE);
+        int conflit = propager(s);
+        if (conflit == REF_MEMOIRE) return memoire_manquante_solveur(statut);
+        if (conflit != REF_AUCUNE) s->incoherent = 1;
+    } else if (stocker_clause(s, s->tampon.elements, s->tampon.nb, 0, 0) == REF_AUCUNE) {
+        return memoire_manquante_solveur(statut);
+    }
+    return !s->incoherent;
+}
+
+//Fonction ajoutant une formule
+//Parametre ast : ASTNode (les propositions sont désignées par leur nom)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le littéral représentant la formule, 0 si l'arbre est invalide ou si la mémoire manque
+//(les clauses de définition déjà ajoutées ne contraignent que des variables nouvelles)
+int solveur_ajouter_formule(Solveur *s, ASTNode *ast, Statut *statut) {
+    statut_ok(statut);
+    s->clause_refusee = 0;
+    int litteral = encoder_formule(&s->enc, ast);
+    if (s->clause_refusee || s->enc.memoire_manquante || reserver_variables(s, s->enc.nb_variables) < 0) {
+        memoire_manquante_solveur(statut);
+        return 0;
+    }
+    if (litteral == 0) statut_definir(statut, ERR_ARITE, -1, "Arbre invalide");
+    return litteral;
+}
+
+//Fonction ajoutant une formule toujours vraie
+//Retourne 0 si les clauses sont devenues insatisfiables (ou si l'arbre est invalide), 1 sinon,
+//-1 si la mémoire manque
+int solveur_affirmer_formule(Solveur *s, ASTNode *ast, Statut *statut) {
+    Statut local;
+    int litteral = solveur_ajouter_formule(s, ast, &local);
+    if (statut) *statut = local;
+    if (litteral == 0) return local.code == ERR_MEMOIRE ? -1 : 0;
+    return solveur_ajouter_clause(s, &litteral, 1, statut);
+}
+
+//Nombre de conflits avant le i-ème redémarrage (suite de Luby : 1 1 2 1 1 2 4 1 1 2 ...)
+static long luby(int i) {
+    int taille = 1, puissance = 0;
+    while (taille < i + 1) {
+        puissance++;
+        taille = 2 * taille + 1;
+    }
+    while (taille - 1 != i) {
+        taille = (taille - 1) >> 1;
+        puissance--;
+        i = i % taille;
+    }
+    return (long)LUBY_UNITE << puissance;
+}
+
+//Fonction abandonnant une résolution faute de mémoire (retour au niveau 0)
+//Retourne -1
+static int abandonner_resolution(Solveur *s, Statut *statut) {
+    annuler(s, 0);
+    return memoire_manquante_solveur(statut);
+}
+
+//Fonction de résolution sous hypothèses
+//Parametre hypotheses : littéraux DIMACS supposés vrais pendant cet appel
+//Parametre nb_hypotheses : entier
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 1 si les clauses et les hypothèses sont satisfiables (modèle dans s->modele), 0 sinon
+//(noyau dans s->noyau), -1 si la mémoire manque. Le solveur revient au niveau 0 : des clauses
+//peuvent être ajoutées ensuite, et la question reposée
+int resoudre(Solveur *s, const int *hypotheses, int nb_hypotheses, Statut *statut) {
+    statut_ok(statut);
+    s->noyau.nb = 0;
+    if (s->incoherent) return 0;
+    int max = s->enc.nb_variables;
+    for (int i = 0; i < nb_hypotheses; i++) {
+        if (abs(hypotheses[i]) > max) max = abs(hypotheses[i]);
+    }
+    if (reserver_variables(s, max) < 0) return memoire_manquante_solveur(statut);
+    //Un niveau par hypothèse (même déjà vraie), puis au plus un par variable ; le noyau ne contient
+    //que des hypothèses
+    int nb_niveaux = s->nb_variables + nb_hypotheses + 1;
+    if (nb_niveaux > s->capacite_niveaux) {
+        int *marques = agrandir_tableau(s->marque_niveau, s->capacite_niveaux, nb_niveaux, sizeof(int));
+        if (!marques) return memoire_manquante_solveur(statut);
+        s->marque_niveau = marques;
+        s->capacite_niveaux = nb_niveaux;
+    }
+    if (vecteur_reserver(&s->debut_niveaux, nb_niveaux) < 0 || vecteur_reserver(&s->noyau, nb_hypotheses + 1) < 0) {
+        return memoire_manquante_solveur(statut);
+    }
+
+    //Les clauses apprises par les appels précédents sont aussi réduites (au niveau 0 ici)
+    if (s->apprises.nb >= s->max_apprises) {
+        int conflit = propager(s);
+        if (conflit == REF_MEMOIRE) return memoire_manquante_solveur(statut);
+        if (conflit != REF_AUCUNE) {
+            s->incoherent = 1;
+            return 0;
+        }
+        if (reduire_clauses(s) < 0) return memoire_manquante_solveur(statut);
+        s->max_apprises += MAX_APPRISES_PAS;
+    }
+
+    int redemarrages = 0;
+    long conflits = 0, limite = luby(0);
+    for (;;) {
+        int conflit = propager(s);
+        if (conflit == REF_MEMOIRE) return abandonner_resolution(s, statut);
+        if (conflit != REF_AUCUNE) {
+            s->conflits++;
+            conflits++;
+            if (niveau_courant(s) == 0) {
+                s->incoherent = 1;
+                return 0;
+            }
+            int niveau_retour;
+            int lbd = analyser(s, conflit, &niveau_retour);
+            annuler(s, niveau_retour);
+            if (s->tampon.nb == 1) {
+                affecter(s, s->tampon.elements[0], REF_AUCUNE);
+            } else {
+                int ref = stocker_clause(s, s->tampon.elements, s->tampon.nb, 1, lbd);
+                if (ref == REF_AUCUNE) return abandonner_resolution(s, statut);
+                affecter(s, s->tampon.elements[0], ref);
+            }
+            s->increment /= DECROISSANCE_ACTIVITE;
+            continue;
+        }
+
+        if (conflits >= limite) {
+            annuler(s, 0);
+            conflits = 0;
+            limite = luby(++redemarrages);
+            if (s->apprises.nb >= s->max_apprises) {
+                if (reduire_clauses(s) < 0) return abandonner_resolution(s, statut);
+                s->max_apprises += MAX_APPRISES_PAS;
+            }
+            continue;
+        }
+
+        //Les hypothèses sont les décisions des premiers niveaux (un niveau vide si déjà vraie)
+        int suivant = -1;
+        while (niveau_courant(s) < nb_hypotheses) {
+            int code = code_litteral(hypotheses[niveau_courant(s)]);
+            if (s->valeurs[code] == 1) {
+                vecteur_ajouter(&s->debut_niveaux, s->trace.nb);
+            } else if (s->valeurs[code] == -1) {
+                analyser_final(s, code);
+                annuler(s, 0);
+                return 0;
+            } else {
+                suivant = code;
+                break;
+            }
+        }
+        while (suivant < 0 && s->taille_tas > 0) {
+            int v = tas_extraire(s);
+            if (s->valeurs[2 * v] == 0) suivant = 2 * v + s->phase[v];
+        }
+        if (suivant < 0) {
+            for (int v = 1; v <= s->nb_variables; v++) s->modele[v] = s->valeurs[2 * v] == 1;
+            annuler(s, 0);
+            return 1;
+        }
+        s->decisions++;
+        vecteur_ajouter(&s->debut_niveaux, s->trace.nb);
+        affecter(s, suivant, REF_AUCUNE);
+    }
+}
+
+//Fonction donnant la valeur d'un littéral dans le dernier modèle
+int solveur_valeur(const Solveur *s, int litteral) {
+    int v = abs(litteral);
+    if (v == 0 || v > s->nb_variables) return 0;
+    return litteral > 0 ? s->modele[v] : !s->modele[v];
+}
+
+//Fonction donnant le noyau de la dernière réponse non
+int solveur_noyau(const Solveur *s, const int **noyau) {
+    *noyau = s->noyau.elements;
+    return s->noyau.nb;
+}
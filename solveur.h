@@ -0,0 +1,102 @@
+#ifndef SOLVEUR_H
+#define SOLVEUR_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "cnf.h"     //pour l'encodeur de Tseitin
+#include "anasynt.h" //pour les arbres syntaxiques
+
+//Solveur SAT incrémental (CDCL : propagation par deux littéraux surveillés, apprentissage de
+//clauses au premier point d'implication unique, heuristique VSIDS, redémarrages de Luby).
+//Les formules et les clauses sont ajoutées une fois, puis resoudre répond à des questions sous
+//hypothèses (littéraux supposés vrais le temps d'un appel) : les clauses apprises ne dépendent
+//pas des hypothèses et servent aux questions suivantes. Quand la réponse est non, le noyau est
+//un sous-ensemble des hypothèses qui suffit à la rendre non.
+//Les littéraux sont au format DIMACS (v ou -v), avec les variables de l'encodeur.
+//Si la mémoire manque, l'appel retourne -1 (ERR_MEMOIRE) et le solveur reste utilisable : la clause
+//n'est pas rangée, la question peut être reposée.
+
+//Tableau d'entiers extensible
+typedef struct {
+    int* elements;
+    int nb;
+    int capacite;
+} VecteurEntiers;
+
+typedef struct {
+    EncodeurCNF enc;                //Encodage complet : une formule peut être supposée vraie ou fausse
+    int nb_variables;
+    int capacite_variables;
+    int incoherent;                 //1 si les clauses sont insatisfiables sans aucune hypothèse
+
+    //Clauses : [taille, apprise, lbd, littéraux...] à partir de leur référence dans memoire.
+    //Les littéraux internes sont codés 2 * v (v) et 2 * v + 1 (¬v)
+    VecteurEntiers memoire;
+    VecteurEntiers originales;      //Références des clauses ajoutées
+    VecteurEntiers apprises;        //Références des clauses apprises
+    VecteurEntiers* surveillances;  //Par littéral codé : paires (clause, bloqueur) des clauses où il est surveillé
+
+    int8_t* valeurs;                //Par littéral codé : 1 vrai, -1 faux, 0 inconnu
+    int* niveau;                    //Par variable : niveau de décision de l'affectation
+    int* raison;                    //Par variable : clause qui l'a propagée, -1 pour une décision
+    int8_t* phase;                  //Par variable : dernier signe affecté (1 : négatif)
+    uint8_t* vu;                    //Marques de l'analyse des conflits
+    int* marque_niveau;             //Marques des niveaux (calcul du lbd)
+    int capacite_niveaux;
+    int estampille;
+    double* activite;               //VSIDS
+    double increment;
+    int* tas;                       //Tas des variables par activité décroissante
+    int* position_tas;              //-1 si la variable n'est pas dans le tas
+    int taille_tas;
+
+    VecteurEntiers trace;           //Littéraux affectés, dans l'ordre
+    VecteurEntiers debut_niveaux;   //Début de chaque niveau de décision dans trace
+    int propagees;                  //Littéraux de trace déjà propagés
+
+    VecteurEntiers tampon;          //Clause en cours (ajout ou apprentissage)
+    VecteurEntiers effaces;         //Variables marquées pendant l'apprentissage
+    VecteurEntiers noyau;           //Hypothèses responsables de la dernière réponse non
+    int8_t* modele;                 //Valeur de chaque variable après la dernière réponse oui
+    int max_apprises;               //Nombre de clauses apprises avant une réduction
+    int clause_refusee;             //1 si une clause émise par l'encodeur n'a pas pu être rangée
+
+    long conflits;                  //Statistiques cumulées sur tous les appels
+    long decisions;
+    long propagations;
+} Solveur;
+
+//Initialisation et libération
+void solveur_initialiser(Solveur* s);
+void solveur_liberer(Solveur* s);
+
+//Variable d'une proposition (créée à la première rencontre), 0 si la mémoire manque
+int solveur_variable_prop(Solveur* s, const char* nom);
+
+//Nouvelle variable sans nom (pour les encodages faits hors de l'encodeur), 0 si la mémoire manque
+int solveur_nouvelle_variable(Solveur* s);
+
+//Ajoute une clause. Retourne 0 si les clauses sont devenues insatisfiables, 1 sinon, -1 si la
+//mémoire manque
+int solveur_ajouter_clause(Solveur* s, const int* litteraux, int n, Statut* statut);
+
+//Encode une formule (ses clauses de définition sont ajoutées) et retourne le littéral qui la
+//représente, à utiliser comme hypothèse ; 0 si l'arbre est invalide ou si la mémoire manque (statut)
+int solveur_ajouter_formule(Solveur* s, ASTNode* ast, Statut* statut);
+
+//Ajoute une formule affirmée (toujours vraie). Retourne 0 si les clauses sont devenues insatisfiables,
+//1 sinon, -1 si la mémoire manque
+int solveur_affirmer_formule(Solveur* s, ASTNode* ast, Statut* statut);
+
+//Résout sous hypothèses. Retourne 1 (satisfiable, modèle disponible), 0 (noyau disponible) ou -1 si
+//la mémoire manque
+int resoudre(Solveur* s, const int* hypotheses, int nb_hypotheses, Statut* statut);
+
+//Valeur d'un littéral dans le modèle de la dernière réponse oui (1 ou 0)
+int solveur_valeur(const Solveur* s, int litteral);
+
+//Noyau de la dernière réponse non : nombre d'hypothèses, rangées dans *noyau (vide si les clauses
+//sont insatisfiables sans hypothèse)
+int solveur_noyau(const Solveur* s, const int** noyau);
+
+#endif
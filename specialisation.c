@@ -0,0 +1,351 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "specialisation.h"
+#include "anasem.h"     //Pour indice_prop
+#include "operateurs.h" //Pour les tables de vérité des opérateurs
+#include "allocateur.h"
+
+
+//Valeur d'une sous-formule pendant la spécialisation : constante, ou code residuel[debut .. taille - 1]
+typedef struct {
+    int debut;
+    int constante;              //0 ou 1, -1 si la valeur dépend des propositions inconnues
+} ValeurPartielle;
+
+//Etat d'une spécialisation
+typedef struct {
+    const AffectationPartielle *affectation;
+    VMInstruction *residuel;
+    int taille;
+    int capacite;
+    Statut *statut;
+} Specialiseur;
+
+
+// ----------------------
+/*
+Affectations partielles
+*/
+// ----------------------
+
+//Fonction vidant une affectation (aucune proposition connue)
+void affectation_vider(AffectationPartielle *a) {
+    memset(a, 0, sizeof(*a));
+}
+
+//Fonction fixant la valeur d'une proposition
+//Parametre a : AffectationPartielle
+//Parametre prop : indice de la proposition (opérande de VM_LOAD)
+//Parametre valeur : 0 pour faux, vrai sinon
+//Retourne 0, ou -1 si l'indice n'est pas dans [0, MAX_PROPS_AFFECTATION)
+int affectation_fixer(AffectationPartielle *a, int prop, int valeur) {
+    if (prop < 0 || prop >= MAX_PROPS_AFFECTATION) return -1;
+    uint64_t bit = 1ULL << (prop % 64);
+    a->connues[prop / 64] |= bit;
+    if (valeur) a->valeurs[prop / 64] |= bit;
+    else a->valeurs[prop / 64] &= ~bit;
+    return 0;
+}
+
+
+// ----------------------
+/*
+Propagation des constantes
+   Les constantes ne produisent pas de code : seules les sous-formules qui dépendent d'une
+   proposition inconnue ont leur code dans le résidu, à la suite, dans l'ordre postfixe. Le code
+   du dernier opérande se termine donc toujours à la fin du résidu, et supprimer un opérande (ou
+   les deux) revient à raccourcir le résidu.
+*/
+// ----------------------
+
+static const ValeurPartielle valeur_erreur = {-1, -2};
+
+//Fonction ajoutant une instruction au résidu
+//Retourne 0, ou -1 si le résidu est plein
+static int emettre_residuel(Specialiseur *s, VMOpcode opcode, int operande) {
+    if (s->taille >= s->capacite) {
+        statut_definir(s->statut, ERR_PROGRAMME_PLEIN, s->taille, "Programme trop long");
+        return -1;
+    }
+    s->residuel[s->taille++] = (VMInstruction){opcode, operande};
+    return 0;
+}
+
+static ValeurPartielle constante_partielle(int valeur) {
+    return (ValeurPartielle){-1, valeur != 0};
+}
+
+//Proposition : constante si elle est connue, VM_LOAD sinon
+static ValeurPartielle specialiser_proposition(Specialiseur *s, int prop) {
+    const AffectationPartielle *a = s->affectation;
+    if (prop >= 0 && prop < MAX_PROPS_AFFECTATION && (a->connues[prop / 64] >> (prop % 64) & 1)) {
+        return constante_partielle(a->valeurs[prop / 64] >> (prop % 64) & 1);
+    }
+    int debut = s->taille;
+    if (emettre_residuel(s, VM_LOAD, prop) < 0) return valeur_erreur;
+    return (ValeurPartielle){debut, -1};
+}
+
+//Négation : une négation qui suit une négation les annule toutes les deux
+static ValeurPartielle specialiser_negation(Specialiseur *s, ValeurPartielle x) {
+    if (x.constante >= 0) return constante_partielle(!x.constante);
+    if (s->taille - x.debut >= 2 && s->residuel[s->taille - 1].opcode == VM_NOT) {
+        s->taille--;
+        return x;
+    }
+    if (emettre_residuel(s, VM_NOT, 0) < 0) return valeur_erreur;
+    return x;
+}
+
+//Opérateur binaire de table t : une constante réduit l'opérateur à vrai, faux, l'autre opérande ou sa négation
+static ValeurPartielle specialiser_binaire(Specialiseur *s, VMOpcode opcode, uint8_t t, ValeurPartielle a,
+                                           ValeurPartielle b) {
+    if (a.constante >= 0 && b.constante >= 0) {
+        return constante_partielle(valeur_table(t, a.constante, b.constante));
+    }
+    if (a.constante >= 0 || b.constante >= 0) {
+        //Valeurs du résultat selon l'opérande inconnu x
+        ValeurPartielle x = a.constante >= 0 ? b : a;
+        int si_faux = a.constante >= 0 ? valeur_table(t, a.constante, 0) : valeur_table(t, 0, b.constante);
+        int si_vrai = a.constante >= 0 ? valeur_table(t, a.constante, 1) : valeur_table(t, 1, b.constante);
+        if (si_faux == si_vrai) {
+            s->taille = x.debut;        //Opérande mort
+            return constante_partielle(si_faux);
+        }
+        return si_vrai ? x : specialiser_negation(s, x);
+    }
+    if (emettre_residuel(s, opcode, 0) < 0) return valeur_erreur;
+    return (ValeurPartielle){a.debut, -1};
+}
+
+//Fonction terminant le résidu : une constante devient VM_PUSH, le code du résultat est placé au début
+//Retourne la taille du résidu, ou -1 en cas d'erreur
+static int terminer_residuel(Specialiseur *s, ValeurPartielle resultat) {
+    if (resultat.constante == valeur_erreur.constante) return -1;
+    if (resultat.constante >= 0) {
+        s->taille = 0;
+        return emettre_residuel(s, VM_PUSH, resultat.constante ? -1 : 0) < 0 ? -1 : 1;
+    }
+    //Valeurs restées sous le résultat dans la pile : elles ne servent pas
+    int n = s->taille - resultat.debut;
+    memmove(s->residuel, s->residuel + resultat.debut, n * sizeof(VMInstruction));
+    s->taille = n;
+    return n;
+}
+
+
+// ----------------------
+/*
+Programmes et arbres syntaxiques
+*/
+// ----------------------
+
+//Fonction de spécialisation d'un programme de la machine virtuelle
+//Parametre prog : tableau d'instructions, taille : entier
+//Parametre a : AffectationPartielle des propositions connues
+//Parametre residuel : tableau d'au moins taille instructions (le résidu n'est jamais plus long)
+//Parametre statut : Statut (peut être NULL)
+//Retourne la taille du résidu, ou -1 si le programme est refusé par verifier_programme
+int specialiser_programme(const VMInstruction *prog, int taille, const AffectationPartielle *a,
+                          VMInstruction *residuel, Statut *statut) {
+    statut_ok(statut);
+    if (verifier_programme(prog, taille, statut) < 0) return -1;
+    ValeurPartielle *pile = mem_allouer(taille * sizeof(ValeurPartielle));
+    if (!pile) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    Specialiseur s = {a, residuel, 0, taille, statut};
+    int sommet = -1;
+    for (int pc = 0; pc < taille; pc++) {
+        VMInstruction instr = prog[pc];
+        switch (instr.opcode) {
+            case VM_NOP:
+                break;
+            case VM_PUSH:
+                pile[++sommet] = constante_partielle(instr.operand);
+                break;
+            case VM_LOAD:
+                pile[++sommet] = specialiser_proposition(&s, instr.operand);
+                break;
+            case VM_POP:
+            case VM_PRINT:  //Comme pour executer_programme_64, la valeur est seulement dépilée
+                if (pile[sommet].constante < 0) s.taille = pile[sommet].debut;
+                sommet--;
+                break;
+            case VM_NOT:
+                pile[sommet] = specialiser_negation(&s, pile[sommet]);
+                break;
+            default: {
+                ValeurPartielle b = pile[sommet--];
+                pile[sommet] = specialiser_binaire(&s, instr.opcode, operateur_opcode(instr.opcode)->table,
+                                                   pile[sommet], b);
+                break;
+            }
+        }
+        //Le résidu n'est jamais plus long que le programme : seule la mémoire peut manquer ici
+        if (sommet >= 0 && pile[sommet].constante == valeur_erreur.constante) break;
+    }
+    int n = terminer_residuel(&s, pile[sommet]);
+    mem_liberer(pile);
+    return n;
+}
+
+//Spécialisation d'un sous-arbre (opérandes avant l'opérateur, comme compiler_programme)
+static ValeurPartielle specialiser_noeud(Specialiseur *s, ASTNode *node) {
+    const Operateur *op = node ? operateur_noeud(node->type) : NULL;
+    if (!op) {
+        statut_definir(s->statut, ERR_NOEUD_INCONNU, s->taille, "Type de noeud inconnu");
+        return valeur_erreur;
+    }
+    if (op->arite == 0) {
+        int indice = indice_prop(node->value);
+        if (indice < 0) {
+            statut_definir(s->statut, ERR_PROP_INVALIDE, s->taille, "Proposition invalide");
+            return valeur_erreur;
+        }
+        return specialiser_proposition(s, indice);
+    }
+    if (op->arite == 1) {
+        ValeurPartielle x = specialiser_noeud(s, node->left ? node->left : node->right);
+        return x.constante == valeur_erreur.constante ? x : specialiser_negation(s, x);
+    }
+    ValeurPartielle a = specialiser_noeud(s, node->left);
+    if (a.constante == valeur_erreur.constante) return a;
+    ValeurPartielle b = specialiser_noeud(s, node->right);
+    if (b.constante == valeur_erreur.constante) return b;
+    return specialiser_binaire(s, op->opcode, op->table, a, b);
+}
+
+//Fonction de spécialisation d'un arbre syntaxique (sans passer par le programme complet)
+//Parametre ast : ASTNode
+//Parametre a : AffectationPartielle des propositions connues
+//Parametre residuel : tableau d'instructions, capacite : entier
+//Parametre statut : Statut (peut être NULL)
+//Retourne la taille du résidu, ou -1 en cas d'erreur
+int specialiser_ast(ASTNode *ast, const AffectationPartielle *a, VMInstruction *residuel, int capacite,
+                    Statut *statut) {
+    statut_ok(statut);
+    Specialiseur s = {a, residuel, 0, capacite, statut};
+    return terminer_residuel(&s, specialiser_noeud(&s, ast));
+}
+
+
+// ----------------------
+/*
+Cache des résidus d'un client
+*/
+// ----------------------
+
+#define CAPACITE_CACHE_SPECIALISATIONS 64
+
+static uint64_t hacher_specialisation(uint64_t id, const AffectationPartielle *a) {
+    uint64_t h = id * 0x9E3779B97F4A7C15ULL;
+    for (int k = 0; k < MAX_PROPS_AFFECTATION / 64; k++) {
+        h = (h ^ a->connues[k]) * 0xFF51AFD7ED558CCDULL;
+        h = (h ^ (a->valeurs[k] & a->connues[k])) * 0xC4CEB9FE1A85EC53ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+static int meme_affectation(const AffectationPartielle *a, const AffectationPartielle *b) {
+    for (int k = 0; k < MAX_PROPS_AFFECTATION / 64; k++) {
+        if (a->connues[k] != b->connues[k] || ((a->valeurs[k] ^ b->valeurs[k]) & a->connues[k])) return 0;
+    }
+    return 1;
+}
+
+//Recherche d'un résidu : indice de l'entrée trouvée, ou de la case libre où l'insérer
+static int chercher_specialisation(const CacheSpecialisations *c, uint64_t id, const AffectationPartielle *a) {
+    int i = (int)(hacher_specialisation(id, a) & (uint64_t)(c->capacite - 1));
+    while (c->entrees[i].residuel) {
+        if (c->entrees[i].id == id && meme_affectation(&c->entrees[i].affectation, a)) return i;
+        i = (i + 1) & (c->capacite - 1);
+    }
+    return i;
+}
+
+//Fonction d'initialisation d'un cache vide
+//Retourne 0, ou -1 si la mémoire manque
+int cache_specialisations_initialiser(CacheSpecialisations *c) {
+    memset(c, 0, sizeof(*c));
+    c->entrees = mem_callouer(CAPACITE_CACHE_SPECIALISATIONS, sizeof(EntreeSpecialisation));
+    if (!c->entrees) return -1;
+    c->capacite = CAPACITE_CACHE_SPECIALISATIONS;
+    return 0;
+}
+
+//Fonction libérant tous les résidus d'un cache (le cache reste utilisable)
+void vider_cache_specialisations(CacheSpecialisations *c) {
+    for (int i = 0; i < c->capacite; i++) {
+        mem_liberer(c->entrees[i].residuel);
+        c->entrees[i].residuel = NULL;
+    }
+    c->nb = 0;
+}
+
+//Fonction de libération d'un cache
+void liberer_cache_specialisations(CacheSpecialisations *c) {
+    if (c->entrees) vider_cache_specialisations(c);
+    mem_liberer(c->entrees);
+    memset(c, 0, sizeof(*c));
+}
+
+//Agrandissement du cache quand il est à moitié plein
+//Retourne 0, ou -1 si la mémoire manque (le cache est alors inchangé)
+static int agrandir_cache_specialisations(CacheSpecialisations *c) {
+    CacheSpecialisations nouveau = *c;
+    nouveau.capacite = 2 * c->capacite;
+    nouveau.entrees = mem_callouer(nouveau.capacite, sizeof(EntreeSpecialisation));
+    if (!nouveau.entrees) return -1;
+    for (int i = 0; i < c->capacite; i++) {
+        if (c->entrees[i].residuel) {
+            nouveau.entrees[chercher_specialisation(&nouveau, c->entrees[i].id, &c->entrees[i].affectation)] =
+                c->entrees[i];
+        }
+    }
+    mem_liberer(c->entrees);
+    *c = nouveau;
+    return 0;
+}
+
+//Fonction donnant le résidu d'un programme pour une affectation, calculé une seule fois
+//Parametre c : CacheSpecialisations
+//Parametre id : identifiant du programme d'origine choisi par l'appelant
+//Parametre prog, taille : programme d'origine (lu seulement si le résidu n'est pas dans le cache)
+//Parametre a : AffectationPartielle
+//Parametre taille_residuelle : pointeur vers un entier, rempli avec la taille du résidu
+//Parametre statut : Statut (peut être NULL)
+//Retourne le résidu (gardé par le cache), ou NULL en cas d'erreur
+const VMInstruction *specialisation_en_cache(CacheSpecialisations *c, uint64_t id, const VMInstruction *prog,
+                                             int taille, const AffectationPartielle *a, int *taille_residuelle,
+                                             Statut *statut) {
+    statut_ok(statut);
+    int i = chercher_specialisation(c, id, a);
+    if (c->entrees[i].residuel) {
+        c->succes++;
+        *taille_residuelle = c->entrees[i].taille;
+        return c->entrees[i].residuel;
+    }
+
+    PhaseMemoire phase = definir_phase_memoire(PHASE_COMPILATION);
+    VMInstruction *residuel = mem_allouer((taille > 0 ? taille : 1) * sizeof(VMInstruction));
+    int n = residuel ? specialiser_programme(prog, taille, a, residuel, statut) : -1;
+    VMInstruction *ajuste = n > 0 ? mem_reallouer(residuel, n * sizeof(VMInstruction)) : NULL;
+    definir_phase_memoire(phase);
+    if (!ajuste) {
+        if (!residuel || n > 0) statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        mem_liberer(residuel);
+        return NULL;
+    }
+    c->echecs++;
+    if (2 * (c->nb + 1) > c->capacite && agrandir_cache_specialisations(c) == 0) {
+        i = chercher_specialisation(c, id, a);
+    }
+    c->entrees[i] = (EntreeSpecialisation){id, *a, ajuste, n};
+    c->nb++;
+    *taille_residuelle = n;
+    return ajuste;
+}
@@ -0,0 +1,78 @@
+#ifndef SPECIALISATION_H
+#define SPECIALISATION_H
+
+#include <stdint.h>
+#include "erreurs.h"
+#include "anasynt.h" //pour les arbres syntaxiques
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Evaluation partielle : quand une partie des propositions est connue d'avance (fixée pour un client
+//ou une partition des données), un programme est spécialisé une fois pour ces valeurs :
+//  - les valeurs connues sont propagées à travers tous les opérateurs (table de vérité de
+//    operateurs.h) : p ∧ faux donne faux, vrai ⇒ p donne p, p ⇔ faux donne ¬p... ;
+//  - le code d'un opérande qui ne change plus le résultat est supprimé ;
+//  - les doubles négations produites ainsi sont retirées.
+//Le programme résiduel ne lit que les propositions inconnues ; il donne le même résultat que le
+//programme d'origine pour toute valuation qui respecte l'affectation, et n'est jamais plus long.
+//Un résultat constant donne un programme d'une instruction (VM_PUSH).
+
+//Propositions d'indice 0 .. MAX_PROPS_AFFECTATION - 1 (les autres sont toujours inconnues).
+//La limite couvre toutes les propositions valides (au plus MAX_PROPS = 100, anasem.c), donc tous les
+//programmes compilés. L'affectation est un bitmap de taille fixe (32 octets) : elle est recopiée
+//telle quelle dans chaque entrée du cache, hachée et comparée en 4 mots, sans allocation.
+//Dans un programme écrit à la main, une proposition d'indice plus grand ne peut pas être fixée
+//(affectation_fixer retourne -1) : elle reste lue par le programme résiduel, qui est toujours
+//correct mais moins spécialisé.
+#define MAX_PROPS_AFFECTATION 128
+
+typedef struct {
+    uint64_t connues[MAX_PROPS_AFFECTATION / 64];   //Bit i : proposition i connue
+    uint64_t valeurs[MAX_PROPS_AFFECTATION / 64];   //Bit i : valeur de la proposition i (si connue)
+} AffectationPartielle;
+
+//Affectation vide, puis valeur d'une proposition (0, ou -1 si l'indice n'est pas dans
+//0 .. MAX_PROPS_AFFECTATION - 1 : l'affectation est alors inchangée)
+void affectation_vider(AffectationPartielle* a);
+int affectation_fixer(AffectationPartielle* a, int prop, int valeur);
+
+//Spécialisation d'un programme (vérifié ici) : residuel doit avoir au moins taille cases.
+//Retourne la taille du programme résiduel, ou -1 en cas d'erreur
+int specialiser_programme(const VMInstruction* prog, int taille, const AffectationPartielle* a,
+                          VMInstruction* residuel, Statut* statut);
+
+//Spécialisation d'un arbre syntaxique (propositions valides, comme compiler_programme).
+//Retourne la taille du programme résiduel, ou -1 (proposition invalide, plus de capacite instructions)
+int specialiser_ast(ASTNode* ast, const AffectationPartielle* a, VMInstruction* residuel, int capacite,
+                    Statut* statut);
+
+//Cache des programmes résiduels d'un client : chaque programme d'origine est identifié par l'appelant
+//(id, qui doit changer si le programme change), chaque résiduel est gardé pour son affectation.
+//Un cache ne doit servir qu'à un thread à la fois (un cache par client ou par thread).
+typedef struct {
+    uint64_t id;
+    AffectationPartielle affectation;
+    VMInstruction* residuel;    //NULL si la case est libre
+    int taille;
+} EntreeSpecialisation;
+
+typedef struct {
+    EntreeSpecialisation* entrees;
+    int capacite;               //Puissance de 2, agrandie quand le cache est à moitié plein
+    int nb;
+    long succes;                //Résiduels trouvés dans le cache
+    long echecs;                //Résiduels calculés
+} CacheSpecialisations;
+
+//Initialisation (0, ou -1 si la mémoire manque), vidage et libération
+int cache_specialisations_initialiser(CacheSpecialisations* c);
+void vider_cache_specialisations(CacheSpecialisations* c);
+void liberer_cache_specialisations(CacheSpecialisations* c);
+
+//Programme résiduel de (id, prog) pour l'affectation a, calculé au premier appel puis gardé.
+//Retourne le programme (gardé par le cache jusqu'à son vidage) et sa taille dans *taille_residuelle,
+//ou NULL en cas d'erreur
+const VMInstruction* specialisation_en_cache(CacheSpecialisations* c, uint64_t id, const VMInstruction* prog,
+                                             int taille, const AffectationPartielle* a, int* taille_residuelle,
+                                             Statut* statut);
+
+#endif
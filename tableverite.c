@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//Pour projeter les tables enregistrées en mémoire (mmap)
+
+#include "tableverite.h"
+#include "allocateur.h"
+
+
+
+//Fonction calculant l'empreinte d'un programme
+//Parametre prog : tableau d'instructions
+//Parametre taille : entier
+//Retourne l'empreinte FNV-1a des opcodes et des opérandes
+uint64_t empreinte_programme(const VMInstruction *prog, int taille) {
+    uint64_t h = 14695981039346656037ULL;
+    for (int i = 0; i < taille; i++) {
+        uint32_t mots[2] = {(uint32_t)prog[i].opcode, (uint32_t)prog[i].operand};
+        const unsigned char *octets = (const unsigned char *)mots;
+        for (size_t k = 0; k < sizeof(mots); k++) {
+            h = (h ^ octets[k]) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+//Fonction recensant les propositions d'un programme dans l'ordre de leur première apparition
+//Parametre props : tableau d'au moins MAX_PROPS_TABLE cases
+//Retourne le nombre de propositions, ou MAX_PROPS_TABLE + 1 s'il y en a plus
+static int recenser_props(const VMInstruction *prog, int taille, int *props) {
+    int n = 0;
+    for (int i = 0; i < taille; i++) {
+        if (prog[i].opcode != VM_LOAD) continue;
+        int k = 0;
+        while (k < n && props[k] != prog[i].operand) k++;
+        if (k < n) continue;
+        if (n == MAX_PROPS_TABLE) return MAX_PROPS_TABLE + 1;
+        props[n++] = prog[i].operand;
+    }
+    return n;
+}
+
+//Fonction comptant les propositions distinctes d'un programme
+int compter_props_programme(const VMInstruction *prog, int taille) {
+    int props[MAX_PROPS_TABLE];
+    return recenser_props(prog, taille, props);
+}
+
+//Fonction donnant la valuation d'une table
+//Parametre t : TableVerite
+//Parametre valeurs : valeurs des propositions, indicées comme les propositions valides (0 : faux)
+//Retourne la valuation (bit k : valeur de la proposition t->props[k])
+uint32_t valuation_table_verite(const TableVerite *t, const int *valeurs) {
+    uint32_t v = 0;
+    for (int k = 0; k < t->nb_props; k++) {
+        v |= (uint32_t)(valeurs[t->props[k]] != 0) << k;
+    }
+    return v;
+}
+
+
+// ----------------------
+/*
+Construction
+   Les propositions sont renumérotées de 0 à nb_props - 1, puis les mots sont ceux de
+   enumerer_valuations (runtime.h) : chaque mot de la table est le résultat d'une seule exécution
+   de executer_programme_64.
+*/
+// ----------------------
+
+//Programme renuméroté et mots de la table en construction
+typedef struct {
+    const VMInstruction *prog;
+    int taille;
+    uint64_t *mots;
+} ConstructionTable;
+
+static int remplir_mot_table(uint64_t mot, const uint64_t *colonnes, void *donnees) {
+    ConstructionTable *c = donnees;
+    c->mots[mot] = executer_programme_64(c->prog, c->taille, colonnes);
+    return 0;
+}
+
+//Fonction de construction d'une table de vérité
+//Parametre prog : tableau d'instructions (résultat au sommet de la pile)
+//Parametre taille : entier
+//Parametre t : TableVerite, à libérer avec liberer_table_verite
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 si le programme est refusé ou a trop de propositions
+int construire_table_verite(const VMInstruction *prog, int taille, TableVerite *t, Statut *statut) {
+    memset(t, 0, sizeof(*t));
+    statut_ok(statut);
+    if (verifier_programme(prog, taille, statut) < 0) return -1;
+    int nb_props = recenser_props(prog, taille, t->props);
+    if (nb_props > MAX_PROPS_TABLE) {
+        statut_definir(statut, ERR_TABLE_PLEINE, -1, "Trop de propositions pour une table de vérité");
+        return -1;
+    }
+
+    VMInstruction *copie = mem_allouer((taille > 0 ? taille : 1) * sizeof(VMInstruction));
+    uint64_t nb_mots = mots_table_verite(nb_props);
+    uint64_t *mots = mem_allouer(nb_mots * sizeof(uint64_t));
+    if (!copie || !mots) {
+        mem_liberer(copie);
+        mem_liberer(mots);
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    for (int i = 0; i < taille; i++) {
+        copie[i] = prog[i];
+        if (prog[i].opcode != VM_LOAD) continue;
+        int k = 0;
+        while (t->props[k] != prog[i].operand) k++;
+        copie[i].operand = k;
+    }
+
+    uint64_t colonnes[MAX_PROPS_TABLE];
+    ConstructionTable construction = {copie, taille, mots};
+    enumerer_valuations(nb_props, NULL, colonnes, 0, nb_mots, remplir_mot_table, &construction);
+    //Moins de 6 propositions : les bits au-delà de 2^nb_props ne correspondent à aucune valuation
+    mots[0] &= masque_valuations(nb_props);
+    mem_liberer(copie);
+
+    t->nb_props = nb_props;
+    t->empreinte = empreinte_programme(prog, taille);
+    t->mots = mots;
+    t->nb_mots = nb_mots;
+    t->alloue = mots;
+    return 0;
+}
+
+
+// ----------------------
+/*
+Partage entre processus : enregistrement puis projection en mémoire
+*/
+// ----------------------
+
+//Fonction d'enregistrement d'une table de vérité
+//Parametre t : TableVerite
+//Parametre chemin : fichier de la table (remplacé)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int enregistrer_table_verite(const TableVerite *t, const char *chemin, Statut *statut) {
+    statut_ok(statut);
+    EnteteTableVerite entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, MAGIE_TABLE_VERITE, 8);
+    entete.nb_props = (uint32_t)t->nb_props;
+    entete.empreinte = t->empreinte;
+    for (int k = 0; k < t->nb_props; k++) entete.props[k] = t->props[k];
+    entete.nb_mots = t->nb_mots;
+    entete.taille_totale = sizeof(entete) + t->nb_mots * sizeof(uint64_t);
+
+    //Le fichier est écrit sous un nom temporaire puis renommé (rename est atomique)
+    size_t longueur = strlen(chemin);
+    char *temporaire = mem_allouer(longueur + 5);
+    if (!temporaire) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    memcpy(temporaire, chemin, longueur);
+    memcpy(temporaire + longueur, ".tmp", 5);
+
+    FILE *sortie = fopen(temporaire, "wb");
+    if (!sortie) {
+        mem_liberer(temporaire);
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de la table impossible à créer");
+        return -1;
+    }
+    int ok = fwrite(&entete, sizeof(entete), 1, sortie) == 1 &&
+             fwrite(t->mots, sizeof(uint64_t), t->nb_mots, sortie) == t->nb_mots;
+    ok = fclose(sortie) == 0 && ok && rename(temporaire, chemin) == 0;
+    if (!ok) {
+        remove(temporaire);
+        mem_liberer(temporaire);
+        statut_definir(statut, ERR_FICHIER, -1, "Erreur d'écriture de la table");
+        return -1;
+    }
+    mem_liberer(temporaire);
+    return 0;
+}
+
+//Fonction de chargement d'une table de vérité enregistrée
+//Parametre chemin : fichier de la table
+//Parametre prog, taille : programme dont la table est attendue (prog peut être NULL)
+//Parametre t : TableVerite, à libérer avec liberer_table_verite
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne 0, ou -1 en cas d'erreur
+int charger_table_verite(const char *chemin, const VMInstruction *prog, int taille, TableVerite *t, Statut *statut) {
+    memset(t, 0, sizeof(*t));
+    statut_ok(statut);
+    int fd = open(chemin, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) close(fd);
+        statut_definir(statut, ERR_FICHIER, -1, "Table de vérité illisible");
+        return -1;
+    }
+    size_t taille_image = (size_t)st.st_size;
+    if (taille_image < sizeof(EnteteTableVerite)) {
+        close(fd);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Table de vérité tronquée");
+        return -1;
+    }
+    const void *image = mmap(NULL, taille_image, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Projection de la table de vérité impossible");
+        return -1;
+    }
+
+    //Vérification de l'entête : les consultations ne vérifient plus rien ensuite
+    const EnteteTableVerite *entete = image;
+    int valide = memcmp(entete->magie, MAGIE_TABLE_VERITE, 8) == 0 &&
+                 entete->nb_props <= MAX_PROPS_TABLE &&
+                 entete->nb_mots == mots_table_verite((int)entete->nb_props) &&
+                 entete->taille_totale == taille_image &&
+                 sizeof(EnteteTableVerite) + entete->nb_mots * sizeof(uint64_t) == taille_image;
+    for (uint32_t k = 0; valide && k < entete->nb_props; k++) {
+        valide = entete->props[k] >= 0;
+    }
+    if (!valide) {
+        munmap((void *)image, taille_image);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Table de vérité invalide");
+        return -1;
+    }
+    if (prog && entete->empreinte != empreinte_programme(prog, taille)) {
+        munmap((void *)image, taille_image);
+        statut_definir(statut, ERR_IMAGE_INVALIDE, -1, "Table de vérité d'un autre programme");
+        return -1;
+    }
+
+    t->nb_props = (int)entete->nb_props;
+    for (int k = 0; k < t->nb_props; k++) t->props[k] = entete->props[k];
+    t->empreinte = entete->empreinte;
+    t->mots = (const uint64_t *)(entete + 1);
+    t->nb_mots = entete->nb_mots;
+    t->image = image;
+    t->taille_image = taille_image;
+    return 0;
+}
+
+//Fonction de libération d'une table de vérité
+void liberer_table_verite(TableVerite *t) {
+    mem_liberer(t->alloue);
+    if (t->image) {
+        munmap((void *)t->image, t->taille_image);
+    }
+    memset(t, 0, sizeof(*t));
+}
+
+
+// ----------------------
+/*
+Budget mémoire
+   Une table évite d'exécuter taille instructions à chaque évaluation : le gain d'une formule est
+   frequence * taille, et son coût la taille de sa table. Les formules sont retenues par gain par
+   octet décroissant, en sautant celles qui ne tiennent plus dans le budget restant.
+*/
+// ----------------------
+
+typedef struct {
+    int indice;
+    double rapport;
+} OrdreCandidat;
+
+static int comparer_candidats(const void *a, const void *b) {
+    double ra = ((const OrdreCandidat *)a)->rapport;
+    double rb = ((const OrdreCandidat *)b)->rapport;
+    return (ra < rb) - (ra > rb);
+}
+
+//Fonction choisissant les formules qui reçoivent une table de vérité
+//Parametre candidats : tableau de CandidatTable (nb_props, octets et retenu sont remplis)
+//Parametre n : nombre de candidats
+//Parametre budget : nombre d'octets disponibles pour les tables
+//Parametre utilises : rempli avec le nombre d'octets utilisés par les tables retenues
+//Parametre statut : Statut (peut être NULL)
+//Retourne 0, ou -1 si la mémoire manque
+int choisir_tables_verite(CandidatTable *candidats, int n, uint64_t budget, uint64_t *utilises, Statut *statut) {
+    statut_ok(statut);
+    *utilises = 0;
+    for (int i = 0; i < n; i++) {
+        candidats[i].retenu = 0;
+    }
+    OrdreCandidat *ordre = mem_allouer((n > 0 ? n : 1) * sizeof(OrdreCandidat));
+    if (!ordre) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    int nb = 0;
+    for (int i = 0; i < n; i++) {
+        CandidatTable *c = &candidats[i];
+        c->nb_props = compter_props_programme(c->prog, c->taille);
+        c->octets = c->nb_props <= MAX_PROPS_TABLE ?
+                    sizeof(EnteteTableVerite) + mots_table_verite(c->nb_props) * sizeof(uint64_t) : 0;
+        if (c->octets > 0 && c->frequence > 0) {
+            ordre[nb].indice = i;
+            ordre[nb].rapport = c->frequence * c->taille / (double)c->octets;
+            nb++;
+        }
+    }
+    qsort(ordre, nb, sizeof(OrdreCandidat), comparer_candidats);
+
+    for (int k = 0; k < nb; k++) {
+        CandidatTable *c = &candidats[ordre[k].indice];
+        if (*utilises + c->octets <= budget) {
+            c->retenu = 1;
+            *utilises += c->octets;
+        }
+    }
+    mem_liberer(ordre);
+    return 0;
+}
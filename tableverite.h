@@ -0,0 +1,91 @@
+#ifndef TABLEVERITE_H
+#define TABLEVERITE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "erreurs.h"
+#include "runtime.h" //pour les instructions de la machine virtuelle
+
+//Table de vérité complète d'un programme, rangée bit par bit : le bit v vaut le résultat du
+//programme pour la valuation v, où le bit k de v donne la valeur de la proposition props[k].
+//Une évaluation est alors la lecture d'un bit, quelle que soit la taille du programme.
+//Au plus MAX_PROPS_TABLE propositions distinctes : 2^24 bits = 2 Mio.
+//
+//Une table peut être enregistrée dans un fichier puis projetée en mémoire (mmap) par d'autres
+//processus, qui partagent alors les mêmes pages. Disposition du fichier :
+//  EnteteTableVerite
+//  uint64_t mots[nb_mots]                  le bit j du mot i est le résultat pour la valuation 64 * i + j
+
+#define MAX_PROPS_TABLE 24
+#define MAGIE_TABLE_VERITE "PROPTAB1"
+
+typedef struct {
+    char magie[8];
+    uint32_t nb_props;
+    uint32_t reserve;
+    uint64_t empreinte;                 //Empreinte du programme (empreinte_programme)
+    int32_t props[MAX_PROPS_TABLE];     //Indices des propositions, dans l'ordre des bits des valuations
+    uint64_t nb_mots;
+    uint64_t taille_totale;             //Taille du fichier, vérifiée au chargement
+} EnteteTableVerite;
+
+typedef struct {
+    int nb_props;
+    int props[MAX_PROPS_TABLE];
+    uint64_t empreinte;
+    const uint64_t* mots;
+    uint64_t nb_mots;
+
+    uint64_t* alloue;                   //Mots construits en mémoire (NULL pour une table projetée)
+    const void* image;                  //Fichier projeté (NULL pour une table construite)
+    size_t taille_image;
+} TableVerite;
+
+//Nombre de mots d'une table de nb_props propositions
+static inline uint64_t mots_table_verite(int nb_props) {
+    return mots_valuations(nb_props);
+}
+
+//Résultat du programme pour une valuation (bit k : valeur de la proposition props[k])
+static inline int consulter_table_verite(const TableVerite* t, uint32_t valuation) {
+    return (int)((t->mots[valuation >> 6] >> (valuation & 63)) & 1);
+}
+
+//Valuation correspondant aux valeurs des propositions (indicées comme pour definir_valeurs_propositions)
+uint32_t valuation_table_verite(const TableVerite* t, const int* valeurs);
+
+//Empreinte d'un programme (FNV-1a des instructions), qui identifie la table d'un programme
+uint64_t empreinte_programme(const VMInstruction* prog, int taille);
+
+//Nombre de propositions distinctes d'un programme (MAX_PROPS_TABLE + 1 s'il y en a plus)
+int compter_props_programme(const VMInstruction* prog, int taille);
+
+//Construction par évaluation bit-parallèle de toutes les valuations. Retourne 0 ou -1
+int construire_table_verite(const VMInstruction* prog, int taille, TableVerite* t, Statut* statut);
+
+//Enregistrement dans un fichier (écrit à côté puis renommé : un lecteur ne voit jamais de fichier partiel)
+int enregistrer_table_verite(const TableVerite* t, const char* chemin, Statut* statut);
+
+//Projection en mémoire d'une table enregistrée. Si prog n'est pas NULL, la table doit être celle
+//de ce programme (même empreinte). Retourne 0 ou -1
+int charger_table_verite(const char* chemin, const VMInstruction* prog, int taille, TableVerite* t, Statut* statut);
+
+//Libération d'une table construite ou projetée
+void liberer_table_verite(TableVerite* t);
+
+//Choix des formules qui reçoivent une table, dans la limite d'un budget mémoire
+typedef struct {
+    const VMInstruction* prog;
+    int taille;
+    double frequence;                   //Nombre d'évaluations attendu (ou fréquence relative)
+    int nb_props;                       //Rempli par choisir_tables_verite
+    uint64_t octets;                    //Taille de la table, 0 si trop de propositions (rempli)
+    int retenu;                         //1 si la formule reçoit une table (rempli)
+} CandidatTable;
+
+//Retient en priorité les formules qui économisent le plus d'instructions exécutées par octet de
+//table (frequence * taille / octets), tant que le budget le permet. Les octets utilisés sont écrits
+//dans *utilises. Retourne 0, ou -1 si la mémoire manque (aucune formule n'est alors retenue)
+int choisir_tables_verite(CandidatTable* candidats, int n, uint64_t budget, uint64_t* utilises, Statut* statut);
+
+#endif
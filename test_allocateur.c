@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "registres.c"
+
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+static const char *formules_test[] = {
+    "p1∧p2", "(p1⇒p2)→((¬p1)∨p2)", "p1⇔p2⊕p3↑¬p4↓p5∧p6∨p7", "¬(p1∧(p2∨¬p3))⇒(p4↓p5)", "(p1∨p2)∧(p3∨p4)∧(p5∨p6)"
+};
+#define NB_FORMULES_TEST 5
+
+//Traitement complet d'une formule : analyses, code à registres, exécution
+//Retourne 0, ou -1 en cas d'erreur (détaillée dans statut)
+int traiter_formule(const char *chaine, Statut *statut) {
+    char **lexemes = CreationListeLexeme(chaine, statut);
+    if (!lexemes) return -1;
+    ASTNode *ast = analyseur_syntaxique(lexemes, statut);
+    liberer_lexemes(lexemes);
+    if (!ast) return -1;
+    VMInstruction prog[PROGRAM_SIZE];
+    ProgrammeRegistres p;
+    int n = analyseur_semantique(ast, statut) == 0 ? compiler_programme(ast, prog, PROGRAM_SIZE, statut) : -1;
+    freeAST(ast);
+    if (n < 0 || compiler_registres(prog, n, &p, statut) < 0) return -1;
+    uint64_t colonnes[8] = {0xF0, 0xCC, 0xAA, 0x0F, 0x33, 0x55, 0xFF, 0};
+    executer_registres_64(&p, colonnes);
+    liberer_programme_registres(&p);
+    return 0;
+}
+
+//Statistiques par phase d'un lot de formules, et fuite d'une liste de lexèmes
+void test_suivi(void) {
+    printf("=== Suivi par phase ===\n");
+    AllocateurSuivi suivi;
+    suivi_initialiser(&suivi, NULL, 0);
+    Allocateur *precedent = utiliser_allocateur(&suivi.base);
+    Statut statut;
+    for (int i = 0; i < NB_FORMULES_TEST; i++) {
+        if (traiter_formule(formules_test[i], &statut) < 0) printf("%s : %s\n", formules_test[i], statut.message);
+    }
+    afficher_suivi(&suivi, stdout);
+    printf("Octets encore vivants : %zu\n", suivi.total.vivants);
+
+    //Liste de lexèmes jamais libérée : elle reste comptée dans la phase lexicale
+    char **oubliee = CreationListeLexeme("p1∧(p2∨p3)", NULL);
+    printf("\nListe de lexèmes non libérée : %zu octets vivants (phase lexicale : %zu)\n", suivi.total.vivants,
+           suivi.phases[PHASE_LEXICALE].vivants);
+
+    //Un bloc revient à son allocateur même si l'allocateur courant a changé
+    utiliser_allocateur(precedent);
+    liberer_lexemes(oubliee);
+    printf("Après libération sous l'allocateur par défaut : %zu octets vivants\n", suivi.total.vivants);
+}
+
+//Budget : les allocations refusées deviennent des erreurs ERR_MEMOIRE
+void test_budget(void) {
+    printf("\n=== Budget ===\n");
+    const char *chaine = "p1⇔p2⊕p3↑¬p4↓p5∧p6∨p7";
+    for (size_t budget = 256; budget <= 4096; budget *= 2) {
+        AllocateurSuivi suivi;
+        suivi_initialiser(&suivi, NULL, budget);
+        Allocateur *precedent = utiliser_allocateur(&suivi.base);
+        Statut statut;
+        int r = traiter_formule(chaine, &statut);
+        utiliser_allocateur(precedent);
+        printf("Budget %5zu octets : %s (pic %zu, %ld refus, %zu octets vivants après)\n", budget,
+               r == 0 ? "formule traitée" : statut.message, suivi.total.pic, suivi.total.refus, suivi.total.vivants);
+    }
+}
+
+//Arène vidée à la fin de chaque requête, comparée à malloc
+void test_arene(int nb_requetes) {
+    printf("\n=== Arène : %d requêtes ===\n", nb_requetes);
+    Statut statut;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nb_requetes; i++) traiter_formule(formules_test[i % NB_FORMULES_TEST], &statut);
+    double temps_defaut = secondes_depuis(debut);
+
+    AllocateurArene arene;
+    arene_initialiser(&arene, 16 * 1024);
+    Allocateur *precedent = utiliser_allocateur(&arene.base);
+    size_t max_reserves = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nb_requetes; i++) {
+        traiter_formule(formules_test[i % NB_FORMULES_TEST], &statut);
+        if (arene.reserves > max_reserves) max_reserves = arene.reserves;
+        arene_vider(&arene);
+    }
+    double temps_arene = secondes_depuis(debut);
+    utiliser_allocateur(precedent);
+    arene_liberer(&arene);
+    printf("  malloc et free    %6.2f µs par requête\n", temps_defaut * 1e6 / nb_requetes);
+    printf("  arène             %6.2f µs par requête (au plus %zu octets réservés)\n", temps_arene * 1e6 / nb_requetes,
+           max_reserves);
+}
+
+//Chaque thread a son allocateur courant
+static void *requetes_thread(void *arg) {
+    AllocateurSuivi *suivi = arg;
+    utiliser_allocateur(&suivi->base);
+    Statut statut;
+    for (int i = 0; i < 1000; i++) traiter_formule(formules_test[i % NB_FORMULES_TEST], &statut);
+    utiliser_allocateur(NULL);
+    return NULL;
+}
+
+void test_threads(void) {
+    printf("\n=== Threads ===\n");
+    AllocateurSuivi suivis[2];
+    pthread_t threads[2];
+    for (int t = 0; t < 2; t++) {
+        suivi_initialiser(&suivis[t], NULL, 0);
+        pthread_create(&threads[t], NULL, requetes_thread, &suivis[t]);
+    }
+    for (int t = 0; t < 2; t++) {
+        pthread_join(threads[t], NULL);
+        printf("Thread %d : %ld allocations, pic %zu octets, %zu octets vivants\n", t, suivis[t].total.allocations,
+               suivis[t].total.pic, suivis[t].total.vivants);
+    }
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= 7; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    test_suivi();
+    test_budget();
+    test_arene(200000);
+    test_threads();
+
+    free_valid_props_memory();
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <ctype.h>
 #include <locale.h>
 
+#include "allocateur.c"
 #include "analex.c"
 
 
@@ -15,28 +16,59 @@ void test(char* expression){
     setlocale(LC_ALL, "");
 
     //Generation de la liste de lexemes grâce à la fonction de analex.c
-    char** lexemes = CreationListeLexeme(expression);
+    Statut statut;
+    char** lexemes = CreationListeLexeme(expression, &statut);
 
     //Affichage de la liste des lexemes
     printf("Liste des lexèmes de l'expression ");
     printf("%s : \n\n",expression);
+    if (!lexemes) {
+        printf("Erreur lexicale à la position %d : %s\n\n", statut.position, statut.message);
+        return;
+    }
     printf("[");
     for (int i = 0; lexemes[i] != NULL; i++) {
         printf("%s,", lexemes[i]);
-        free(lexemes[i]); //On libére la mémoire utilisée par chaque lexeme
     }
     printf("]\n\n");
     
     //On libére la mémoire utilisée par la liste des lexemes
-    free(lexemes); 
+    liberer_lexemes(lexemes);
 
 
 }
 
 
+//Vérifie que le balayage vectorisé donne les mêmes positions que le balayage scalaire
+//sur des chaines aléatoires, pour toutes les positions de départ
+//Affiche le nombre de différences trouvées (0 attendu)
+void test_balayage(){
+    const char alphabet[] = "  \t\n\r\v\fabcxyz0189()\xE2\x88\xA7\xC2\xACP%";
+    char chaine[300];
+    int differences = 0;
+
+    srand(42);
+    for (int essai = 0; essai < 200; essai++) {
+        int n = rand() % (int)(sizeof(chaine) - 1);
+        for (int i = 0; i < n; i++) {
+            chaine[i] = alphabet[rand() % (sizeof(alphabet) - 1)];
+        }
+        chaine[n] = '\0';
+        for (int i = 0; i <= n; i++) {
+            if (avancer_espaces(chaine, i, n) != avancer_espaces_scalaire(chaine, i, n)) differences++;
+            if (avancer_identifiant(chaine, i, n) != avancer_identifiant_scalaire(chaine, i, n)) differences++;
+        }
+    }
+    printf("Balayage vectorisé / scalaire : %d différence(s)\n\n", differences);
+}
+
+
 //Fonction principale avec differentes règles de logique 
 int main() {
 	
+	//Comparaison du balayage vectorisé et scalaire
+	test_balayage();
+	
 	//Tests valides
 	test("(p1⇒p2)→((¬p1)∨p2)");
 	test("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))");
@@ -45,14 +77,17 @@ int main() {
 	test("(¬(p1∧p2))→((¬p1)∨(¬p2))");
 	test("(¬(p1∨p2))→((¬p1)∧(¬p2))");
 	test("(¬(¬p1))→p1");
+	test("   (p1   ∧\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t   p2)   ");//longues suites d'espaces
+	test("propositionavecunnomtreslong0123456789abcdefghij∨p2");//long identifiant
+	test("(p1⇔p2)⊕(p1↑p2)↓p3");//équivalence, ou exclusif, non et, non ou
 	
 	//Tests invalides
-	//Il est important de les réaliser un par un car les tests invalide stop l'execution du programme,
-	//Empechant d'executer les suivants
+	//Les erreurs sont retournées à l'appelant, les tests invalides peuvent donc s'enchainer
 	
 	test("(¬(P1∨p2))→((¬p1)∧(¬P2))");//majuscule
-	//test("(¬(¬p1))→p?a");//caractere innatendu
-	//test("(¬(¬p%1))→p2");//caractere innatendu
+	test("(¬(¬p1))→p?a");//caractere innatendu
+	test("(¬(¬p%1))→p2");//caractere innatendu
+	test("");//chaine vide
 	
     	return 0;
     
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <locale.h>
+#include "allocateur.c"
 #include "analex.c"
 #include "anasynt.c"
 #include "anasem.c"
@@ -15,16 +16,18 @@ void test_sem(const char *expression) {
     printf("\n=== Test de l'analyse sémantique pour l'expression : %s ===\n", expression);
 
     //Analyse léxicale
-    char** lexemes = CreationListeLexeme(expression);
+    Statut statut;
+    char** lexemes = CreationListeLexeme(expression, &statut);
     if (!lexemes) {
-        fprintf(stderr, "Erreur : Analyse lexicale échouée pour l'expression : %s\n", expression);
+        printf("Erreur : Analyse lexicale échouée (position %d : %s)\n", statut.position, statut.message);
         return;
     }
 
     //Analyse syntaxique
-    ASTNode* ast = analyseur_syntaxique(lexemes);
+    ASTNode* ast = analyseur_syntaxique(lexemes, &statut);
+    liberer_lexemes(lexemes);
     if (!ast) {
-        fprintf(stderr, "Erreur : Analyse syntaxique échouée pour l'expression : %s\n", expression);
+        printf("Erreur : Analyse syntaxique échouée (lexème %d : %s)\n", statut.position, statut.message);
         return;
     }
 
@@ -34,9 +37,11 @@ void test_sem(const char *expression) {
 
     //Analyse sémantique : vérification de la validité de l'arbre syntaxique
     printf("\nRésultat de l'analyse sémantique :\n");
-    analyseur_semantique(ast);
-
-    printf("Analyse sémantique réussie pour l'expression : %s\n", expression);
+    if (analyseur_semantique(ast, &statut) == 0) {
+        printf("Analyse sémantique réussie pour l'expression : %s\n", expression);
+    } else {
+        printf("Erreur sémantique (lexème %d) : %s\n", statut.position, statut.message);
+    }
 
     //On libère la mémoire allouée à l'arbre syntaxique
     freeAST(ast);
@@ -56,14 +61,15 @@ int main() {
     test_sem("(p1∧p2)→(p2∧p1)");
 
     //Tests avec des expressions invalides
-    //A tester une par une car l'execution s'arrete dès lors qu'il y a une erreur sémantique
-    //Empechant alors de tester toutes les expressions invalides à la suite
+    //Les erreurs sont retournées à l'appelant, les tests invalides peuvent donc s'enchainer
+    //(les opérateurs sans opérande sont déjà refusés par l'analyse syntaxique)
     
     test_sem("(p4∧p1)"); //Proposition invalide : p4
-    //test_sem("(p1∧)");   //Opérateur AND sans opérande droit
-    //test_sem("¬");       //Opérateur NOT sans opérande
-    //test_sem("(p1⇒)");   //Opérateur IMPLIQUE sans opérande droit
-    //test_sem("(∧p1)");   //Opérateur AND sans opérande gauche
+    test_sem("p1∨(p2∧¬p9)"); //Proposition invalide : p9 (lexème 6)
+    test_sem("(p1∧)");   //Opérateur AND sans opérande droit
+    test_sem("¬");       //Opérateur NOT sans opérande
+    test_sem("(p1⇒)");   //Opérateur IMPLIQUE sans opérande droit
+    test_sem("(∧p1)");   //Opérateur AND sans opérande gauche
 
     //On libère la mémoire allouée aux propositions valides
     free_valid_props_memory();
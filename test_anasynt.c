@@ -5,6 +5,7 @@
 #include <locale.h>
 
 //Lien vers les 2 analyseurs precedents
+#include "allocateur.c"
 #include "anasynt.c"
 #include "analex.c"
 
@@ -16,15 +17,25 @@ void test_synt(char* expression){
     setlocale(LC_ALL, "");
 
     //Création de la liste de lexemes
-    char** lexemes = CreationListeLexeme(expression);
+    Statut statut;
+    char** lexemes = CreationListeLexeme(expression, &statut);
+    if (!lexemes) {
+        printf("\nErreur lexicale dans %s à la position %d : %s\n", expression, statut.position, statut.message);
+        return;
+    }
     
     //Analyse syntaxique à partir de cette liste de lexmes
-    ASTNode* ast = analyseur_syntaxique(lexemes);
+    ASTNode* ast = analyseur_syntaxique(lexemes, &statut);
+    liberer_lexemes(lexemes);
 
 
     //Affichage de l'arbre syntaxique
     printf("\nArbre Syntaxique de l'expression ");
     printf("%s : \n\n",expression);
+    if (!ast) {
+        printf("Erreur de syntaxe au lexème %d : %s\n", statut.position, statut.message);
+        return;
+    }
     printAST(ast, 0);
 
     //On libère la mémoire de l'arbre syntaxique
@@ -43,15 +54,18 @@ int main() {
     test_synt("(p1∧p2)→(p2∧p1)");
     test_synt("(¬(p1∧p2))→((¬p1)∨(¬p2))");
     test_synt("(¬(p1∨p2))→((¬p1)∧(¬p2))");
+    test_synt("p1⇔p2⇒p3⊕p1↑p2");//précédences : ⇔ < ⇒ < ⊕ < ↑
+    test_synt("p1↓p2↓p3");//associativité à gauche
     
     
     //tests invalides
-    //A tester une par une car l'execution s'arrete dès lors qu'il y a une erreur sémantique
-    //Empechant alors de tester toutes les expressions invalides à la suite
+    //Les erreurs sont retournées à l'appelant, les tests invalides peuvent donc s'enchainer
     printf("\nTests invalides : \n\n");
     
     test_synt("(p1⇒p2");//Parenthese fermante manquante
-    //test_synt("p1⇒p2)");//Parenthese ouvrante manquante
+    test_synt("p1⇒p2)");//Parenthese ouvrante manquante
+    test_synt("(p1∧)");//Opérande droit manquant
+    test_synt("p1∧p2∧(p3∨¬)");//Erreur après plusieurs noeuds déjà construits
   
 
     return 0;
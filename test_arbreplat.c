@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "arbreplat.c"
+
+
+//Noms des types de noeuds, dans l'ordre de NodeType
+static const char *noms_types[] = {"PROP", "AND", "OR", "NOT", "IMP", "PROD"};
+
+//Fonction analysant une expression (analyses lexicale et syntaxique)
+//Retourne l'arbre syntaxique, NULL en cas d'erreur
+ASTNode *analyser(const char *expression) {
+    char **lexemes = CreationListeLexeme(expression, NULL);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, NULL) : NULL;
+    liberer_lexemes(lexemes);
+    return ast;
+}
+
+//Comparaison de deux arbres syntaxiques
+//Retourne 1 s'ils sont identiques, 0 sinon
+int arbres_identiques(ASTNode *a, ASTNode *b) {
+    if (!a || !b) return a == b;
+    if (a->type != b->type) return 0;
+    if (a->type == NODE_PROP) return strcmp(a->value, b->value) == 0;
+    return arbres_identiques(a->left, b->left) && arbres_identiques(a->right, b->right);
+}
+
+//Test d'une expression : conversion, affichage des tableaux, aller-retour et compilation
+void test_expression(const char *expression) {
+    printf("\n=== %s ===\n", expression);
+    ASTNode *ast = analyser(expression);
+    ArbrePlat arbre;
+    Statut statut;
+    arbre_plat_initialiser(&arbre);
+    if (arbre_plat_depuis_ast(ast, &arbre, &statut) < 0) {
+        printf("Conversion refusée au noeud %d : %s\n", statut.position, statut.message);
+        freeAST(ast);
+        liberer_arbre_plat(&arbre);
+        return;
+    }
+
+    for (uint32_t i = 0; i < arbre.nb_noeuds; i++) {
+        if (arbre.types[i] == NODE_PROP) {
+            printf("%u: PROP %s\n", i, nom_prop(arbre.args[i]));
+        } else if (arbre.types[i] == NODE_NOT) {
+            printf("%u: NOT %u\n", i, i - 1);
+        } else {
+            printf("%u: %s %u %u\n", i, noms_types[arbre.types[i]], arbre.args[i], i - 1);
+        }
+    }
+
+    ASTNode *retour = arbre_plat_vers_ast(&arbre, &statut);
+    printf("Aller-retour identique : %s\n", arbres_identiques(ast, retour) ? "OUI" : "NON");
+
+    VMInstruction prog_ast[PROGRAM_SIZE], prog_plat[PROGRAM_SIZE];
+    int na = compiler_programme(ast, prog_ast, PROGRAM_SIZE, NULL);
+    int np = compiler_arbre_plat(&arbre, prog_plat, PROGRAM_SIZE, NULL);
+    printf("Même programme : %s\n", na == np && memcmp(prog_ast, prog_plat, na * sizeof(VMInstruction)) == 0 ? "OUI" : "NON");
+
+    freeAST(retour);
+    freeAST(ast);
+    liberer_arbre_plat(&arbre);
+}
+
+//Test d'un arbre plat construit à la main
+void test_invalide(const char *description, const uint8_t *types, const uint32_t *args, uint32_t n) {
+    ArbrePlat arbre = {(uint8_t *)types, (uint32_t *)args, n, n};
+    Statut statut;
+    if (analyse_semantique_plate(&arbre, &statut) < 0) {
+        printf("%s : refusé au noeud %d (%s)\n", description, statut.position, statut.message);
+    } else {
+        printf("%s : accepté\n", description);
+    }
+}
+
+//Formule aléatoire de n noeuds sur les propositions valides (tailles des sous-arbres tirées au hasard)
+ASTNode *formule_aleatoire(int n) {
+    if (n <= 1) return createPropNode(nom_prop(rand() % 20));
+    if (n == 2 || rand() % 8 == 0) return createOpNode(NODE_NOT, NULL, formule_aleatoire(n - 1));
+    int gauche = 1 + rand() % (n - 2);
+    static const NodeType types[] = {NODE_AND, NODE_OR, NODE_IMP, NODE_PROD};
+    ASTNode *g = formule_aleatoire(gauche);
+    return createOpNode(types[rand() % 4], g, formule_aleatoire(n - 1 - gauche));
+}
+
+//Evaluation bit-parallèle récursive d'un arbre syntaxique (référence)
+uint64_t evaluer_ast_64(ASTNode *n, const uint64_t *colonnes) {
+    switch (n->type) {
+        case NODE_PROP: return colonnes[indice_prop(n->value)];
+        case NODE_NOT: return ~evaluer_ast_64(n->right, colonnes);
+        case NODE_AND: return evaluer_ast_64(n->left, colonnes) & evaluer_ast_64(n->right, colonnes);
+        case NODE_OR: return evaluer_ast_64(n->left, colonnes) | evaluer_ast_64(n->right, colonnes);
+        default: return ~evaluer_ast_64(n->left, colonnes) | evaluer_ast_64(n->right, colonnes);
+    }
+}
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Comparaison sur une grande formule : mémoire, analyse sémantique et évaluation
+void test_grande_formule(int n, int repetitions) {
+    printf("\n=== Formule aléatoire de %d noeuds ===\n", n);
+    srand(11);
+    ASTNode *ast = formule_aleatoire(n);
+    ArbrePlat arbre;
+    arbre_plat_initialiser(&arbre);
+    arbre_plat_depuis_ast(ast, &arbre, NULL);
+
+    //Mémoire : noeud, entête de malloc (16 octets) et copie du nom des propositions
+    size_t nb_props = 0;
+    for (uint32_t i = 0; i < arbre.nb_noeuds; i++) nb_props += arbre.types[i] == NODE_PROP;
+    size_t memoire_ast = arbre.nb_noeuds * (sizeof(ASTNode) + 16) + nb_props * (16 + 16);
+    size_t memoire_plat = arbre.nb_noeuds * (sizeof(uint8_t) + sizeof(uint32_t));
+    printf("Mémoire : %.1f Mo (ASTNode) / %.1f Mo (arbre plat), rapport %.1f\n",
+           memoire_ast / 1e6, memoire_plat / 1e6, (double)memoire_ast / memoire_plat);
+
+    uint64_t colonnes[20];
+    for (int i = 0; i < 20; i++) colonnes[i] = ((uint64_t)rand() << 40) ^ ((uint64_t)rand() << 20) ^ rand();
+    uint64_t *valeurs = malloc(arbre.nb_noeuds * sizeof(uint64_t));
+
+    struct timespec debut;
+    uint64_t r_ast = 0, r_plat = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < repetitions; k++) {
+        analyseur_semantique(ast, NULL);
+        r_ast ^= evaluer_ast_64(ast, colonnes);
+    }
+    double duree_ast = secondes_depuis(debut);
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < repetitions; k++) {
+        analyse_semantique_plate(&arbre, NULL);
+        r_plat ^= evaluer_arbre_plat_64(&arbre, colonnes, valeurs);
+    }
+    double duree_plat = secondes_depuis(debut);
+    printf("Analyse sémantique + évaluation : %.3f s (ASTNode) / %.3f s (arbre plat), résultats %s\n",
+           duree_ast, duree_plat, r_ast == r_plat ? "identiques" : "DIFFERENTS");
+
+    free(valeurs);
+    freeAST(ast);
+    liberer_arbre_plat(&arbre);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[8];
+    for (int i = 4; i <= 20; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    test_expression("(p1⇒p2)→((¬p1)∨p2)");
+    test_expression("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))");
+    test_expression("¬¬p1");
+    test_expression("p1∧p99");
+
+    printf("\n=== Arbres plats invalides ===\n");
+    const uint8_t t1[] = {NODE_PROP, NODE_PROP, NODE_AND, NODE_PROP};
+    const uint32_t a1[] = {0, 1, 0, 2};
+    test_invalide("Deux racines", t1, a1, 4);
+    const uint8_t t2[] = {NODE_PROP, NODE_PROP, NODE_PROP, NODE_AND};
+    const uint32_t a2[] = {0, 1, 2, 0};
+    test_invalide("Opérande gauche mal placé", t2, a2, 4);
+    const uint8_t t3[] = {NODE_PROP, NODE_OR};
+    const uint32_t a3[] = {0, 0};
+    test_invalide("Opérande manquant", t3, a3, 2);
+    const uint8_t t4[] = {NODE_PROP, 42};
+    const uint32_t a4[] = {0, 0};
+    test_invalide("Type inconnu", t4, a4, 2);
+    const uint8_t t5[] = {NODE_PROP, NODE_NOT, NODE_PROP, NODE_IMP};
+    const uint32_t a5[] = {1, 0, 2, 1};
+    test_invalide("Arbre correct", t5, a5, 4);
+
+    test_grande_formule(2000000, 10);
+
+    free_valid_props_memory();
+    return 0;
+}
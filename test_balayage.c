@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "balayage.c"
+
+
+//Fonction compilant une expression (analyses lexicale, syntaxique, sémantique puis compilation)
+//Parametre expression : chaine de caracteres
+//Parametre prog : tableau d'instructions de taille PROGRAM_SIZE
+//Retourne le nombre d'instructions, -1 en cas d'erreur
+int compiler_expression(const char *expression, VMInstruction *prog) {
+    Statut statut;
+    int n = -1;
+    char **lexemes = CreationListeLexeme(expression, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    if (ast && analyseur_semantique(ast, &statut) == 0) {
+        n = compiler_programme(ast, prog, PROGRAM_SIZE, &statut);
+    }
+    if (n < 0) {
+        fprintf(stderr, "%s : %s\n", expression, statut.message);
+    }
+    freeAST(ast);
+    return n;
+}
+
+//Affichage de la progression du balayage
+void afficher_progression(uint64_t faites, uint64_t total, void *donnees) {
+    fprintf(stderr, "\r%s : %llu / %llu valuations", (const char *)donnees,
+            (unsigned long long)faites, (unsigned long long)total);
+    if (faites == total) fprintf(stderr, "\n");
+}
+
+//Affichage du résultat d'un balayage et du témoin éventuel
+void afficher_resultat(int r, const ResultatBalayage *res, const Statut *statut) {
+    if (r == 1) {
+        printf("OUI (%llu valuations)\n", (unsigned long long)res->valuations_testees);
+    } else if (r == 0) {
+        printf("NON, contre-exemple après %llu valuations :", (unsigned long long)res->valuations_testees);
+        for (int k = 0; k < res->nb_props; k++) {
+            printf(" %s=%d", valid_props[res->props[k]], (int)((res->temoin >> k) & 1));
+        }
+        printf("\n");
+    } else {
+        printf("ERREUR (%s)\n", statut->message);
+    }
+}
+
+//Test de tautologie sur une expression
+void test_tautologie(const char *expression, int nb_threads) {
+    VMInstruction prog[PROGRAM_SIZE];
+    ResultatBalayage res;
+    Statut statut;
+    int n = compiler_expression(expression, prog);
+    printf("Tautologie %s ? ", expression);
+    fflush(stdout);
+    int r = balayer_tautologie(prog, n, nb_threads, afficher_progression, "balayage", &res, &statut);
+    afficher_resultat(r, &res, &statut);
+}
+
+//Test d'équivalence entre deux expressions
+void test_equivalence(const char *a, const char *b, int nb_threads) {
+    VMInstruction prog_a[PROGRAM_SIZE], prog_b[PROGRAM_SIZE];
+    ResultatBalayage res;
+    Statut statut;
+    int na = compiler_expression(a, prog_a);
+    int nb = compiler_expression(b, prog_b);
+    printf("%s équivalent à %s ? ", a, b);
+    fflush(stdout);
+    afficher_resultat(balayer_equivalence(prog_a, na, prog_b, nb, nb_threads, NULL, NULL, &res, &statut), &res,
+                      &statut);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+
+    //On ajoute p4 à p28 aux propositions valides pour les tests à grand nombre de propositions
+    initialize_valid_props();
+    char nom[8];
+    for (int i = 4; i <= 28; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    printf("\n=== Tests de tautologie ===\n");
+    test_tautologie("(p1⇒p2)→((¬p1)∨p2)", 4);
+    test_tautologie("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))", 4);
+    test_tautologie("(¬(p1∧p2))→((¬p1)∨(¬p2))", 4);
+    test_tautologie("p1∧p2", 4);
+    test_tautologie("p1⇒p2", 1);
+    test_tautologie("(p1∧p2∧p3∧p4∧p5∧p6∧p7∧p8∧p9∧p10∧p11∧p12∧p13∧p14∧p15∧p16∧p17∧p18∧p19∧p20∧p21∧p22∧p23∧p24)⇒p17", 4);
+    test_tautologie("(p1∧p2∧p3∧p4∧p5∧p6∧p7∧p8∧p9∧p10∧p11∧p12∧p13∧p14∧p15∧p16∧p17∧p18∧p19∧p20∧p21∧p22∧p23∧p24∧p25∧p26∧p27)⇒p28", 4);
+    test_tautologie("(p1∨p2∨p3∨p4∨p5∨p6∨p7∨p8∨p9∨p10∨p11∨p12∨p13∨p14∨p15∨p16∨p17∨p18∨p19∨p20∨p21∨p22∨p23∨p24∨p25∨p26∨p27∨p28)", 4);
+
+    printf("\n=== Tests d'équivalence ===\n");
+    test_equivalence("p1⇒p2", "(¬p1)∨p2", 4);
+    test_equivalence("¬(p1∧p2)", "(¬p1)∨(¬p2)", 4);
+    test_equivalence("p1⇒p2", "p2⇒p1", 4);
+    test_equivalence("(p1∧p2)∨(p3∧p4)", "(p1∨p3)∧(p1∨p4)∧(p2∨p3)∧(p2∨p4)", 4);
+
+    printf("\n=== Tests invalides ===\n");
+    test_tautologie("p1∧p99", 4);
+    test_equivalence("p1", "p1∨", 4);
+
+    //Disjonction de 63 propositions (programme écrit directement : trop de lexèmes pour l'analyseur),
+    //au-delà de MAX_PROPS_BALAYAGE
+    VMInstruction grand[2 * 63];
+    int n = 0;
+    for (int k = 0; k < 63; k++) {
+        grand[n++] = (VMInstruction){VM_LOAD, k};
+        if (k > 0) grand[n++] = (VMInstruction){VM_OR, 0};
+    }
+    ResultatBalayage res;
+    Statut statut;
+    printf("Tautologie de la disjonction de 63 propositions ? ");
+    afficher_resultat(balayer_tautologie(grand, n, 4, NULL, NULL, &res, &statut), &res, &statut);
+
+    free_valid_props_memory();
+    return 0;
+}
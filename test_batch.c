@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "batch.c"
+
+
+//Formules utilisées pour générer le fichier de test
+static const char *formules[] = {
+    "(p1⇒p2)→((¬p1)∨p2)",
+    "(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))",
+    "(p1∨p2)→(p2∨p1)",
+    "",
+    "(p1∧p2)→(p2∧p1)",
+    "  (¬(p1∧p2))→((¬p1)∨(¬p2))\r",
+    "(¬(p1∨p2))→((¬p1)∧(¬p2))",
+    "(¬(¬p1))→p1",
+    "(p1∧p4)",          //Proposition invalide : une ligne d'erreur, le lot continue
+    "(p1⇒p2",           //Parenthèse fermante manquante
+    "p1?p2",            //Caractère inattendu
+};
+#define NB_FORMULES (int)(sizeof(formules) / sizeof(formules[0]))
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Fonction de test : traite le fichier avec nb_threads threads et écrit le résultat dans chemin_sortie
+//Affiche le nombre de formules et le temps de traitement
+void test_lot(const char *chemin_entree, const char *chemin_sortie, int nb_threads) {
+    FILE *sortie = fopen(chemin_sortie, "w");
+    if (!sortie) {
+        perror("Erreur d'ouverture du fichier de sortie");
+        exit(EXIT_FAILURE);
+    }
+    struct timespec debut;
+    Statut statut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    long n = traiter_lot(chemin_entree, sortie, nb_threads, &statut);
+    double duree = secondes_depuis(debut);
+    fclose(sortie);
+    if (n < 0) {
+        printf("%d thread(s) : %s\n", nb_threads, statut.message);
+        return;
+    }
+    printf("%d thread(s) : %ld formules en %.3f s (%.0f formules/s)\n", nb_threads, n, duree, n / duree);
+}
+
+//Fonction comparant deux fichiers
+//Retourne 1 s'ils sont identiques, 0 sinon
+int fichiers_identiques(const char *a, const char *b) {
+    FILE *fa = fopen(a, "r");
+    FILE *fb = fopen(b, "r");
+    int identiques = fa && fb;
+    while (identiques) {
+        int ca = fgetc(fa), cb = fgetc(fb);
+        if (ca != cb) identiques = 0;
+        if (ca == EOF) break;
+    }
+    if (fa) fclose(fa);
+    if (fb) fclose(fb);
+    return identiques;
+}
+
+//Fonction principale
+//Sans argument : génère un fichier de formules et vérifie que le résultat ne dépend pas du nombre de threads
+//Avec arguments : test_batch fichier [threads] traite le fichier et écrit les programmes sur la sortie standard
+int main(int argc, char **argv) {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+
+    if (argc > 1) {
+        Statut statut;
+        long n = traiter_lot(argv[1], stdout, argc > 2 ? atoi(argv[2]) : 0, &statut);
+        if (n < 0) fprintf(stderr, "Erreur : %s\n", statut.message);
+        free_valid_props_memory();
+        return n < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    const char *entree = "/tmp/test_batch_entree.txt";
+    FILE *f = fopen(entree, "w");
+    if (!f) {
+        perror("Erreur d'ouverture du fichier d'entrée");
+        return EXIT_FAILURE;
+    }
+    for (int i = 0; i < 200000; i++) {
+        fprintf(f, "%s\n", formules[i % NB_FORMULES]);
+    }
+    fprintf(f, "p1∧p2"); //Dernière ligne sans fin de ligne
+    fclose(f);
+
+    printf("\n=== Traitement par lot ===\n");
+    test_lot(entree, "/tmp/test_batch_1.txt", 1);
+    test_lot(entree, "/tmp/test_batch_4.txt", 4);
+    printf("Résultats identiques avec 1 et 4 threads : %s\n",
+           fichiers_identiques("/tmp/test_batch_1.txt", "/tmp/test_batch_4.txt") ? "OUI" : "NON");
+
+    //Affichage des premières lignes du résultat
+    printf("\nPremières lignes :\n");
+    FILE *res = fopen("/tmp/test_batch_4.txt", "r");
+    char ligne[512];
+    for (int i = 0; res && i < NB_FORMULES && fgets(ligne, sizeof(ligne), res); i++) {
+        printf("%d: %s", i + 1, ligne);
+    }
+    if (res) fclose(res);
+
+    printf("\nFichier absent :\n");
+    test_lot("/tmp/test_batch_absent.txt", "/tmp/test_batch_absent_sortie.txt", 4);
+
+    free_valid_props_memory();
+    return 0;
+}
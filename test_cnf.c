@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "cnf.c"
+
+
+//Fonction de test : écrit la FNC DIMACS et la FND d'une expression
+//Parametre expression : chaine de caracteres
+void test_expression(const char *expression) {
+    char **lexemes = CreationListeLexeme(expression, NULL);
+    ASTNode *ast = analyseur_syntaxique(lexemes, NULL);
+    liberer_lexemes(lexemes);
+
+    printf("\n=== %s ===\n", expression);
+    printf("FNC selon la polarité :\n");
+    exporter_dimacs(ast, stdout, 1, NULL);
+    fflush(stdout);
+
+    EncodeurCNF enc;
+    FormeDisjonctive fnd;
+    encodeur_initialiser(&enc, NULL, NULL);
+    printf("FND : ");
+    if (expansion_fnd(&enc, ast, 64, &fnd, NULL) >= 0) {
+        ecrire_fnd(&enc, &fnd, stdout);
+    } else {
+        printf("plus de 64 termes\n");
+    }
+    liberer_fnd(&fnd);
+    encodeur_liberer(&enc);
+
+    freeAST(ast);
+}
+
+//Evaluation directe d'un arbre dont les propositions sont nommées r0, r1, ...
+int evaluer_arbre(ASTNode *n, unsigned valuation) {
+    switch (n->type) {
+        case NODE_PROP: return (valuation >> atoi(n->value + 1)) & 1;
+        case NODE_NOT: return !evaluer_arbre(n->right, valuation);
+        case NODE_AND: return evaluer_arbre(n->left, valuation) && evaluer_arbre(n->right, valuation);
+        case NODE_OR: return evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+        case NODE_EQUIV: return evaluer_arbre(n->left, valuation) == evaluer_arbre(n->right, valuation);
+        case NODE_XOR: return evaluer_arbre(n->left, valuation) != evaluer_arbre(n->right, valuation);
+        case NODE_NAND: return !(evaluer_arbre(n->left, valuation) && evaluer_arbre(n->right, valuation));
+        case NODE_NOR: return !(evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation));
+        default: return !evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+    }
+}
+
+//Formule aléatoire sur les propositions r0 .. r(nb_props - 1)
+ASTNode *formule_aleatoire(int profondeur, int nb_props) {
+    char nom[16];
+    if (profondeur == 0 || rand() % 4 == 0) {
+        snprintf(nom, sizeof(nom), "r%d", rand() % nb_props);
+        return createPropNode(nom);
+    }
+    int choix = rand() % 8;
+    if (choix == 0) return createOpNode(NODE_NOT, NULL, formule_aleatoire(profondeur - 1, nb_props));
+    NodeType types[] = {NODE_AND, NODE_OR, NODE_PROD, NODE_EQUIV, NODE_XOR, NODE_NAND, NODE_NOR};
+    return createOpNode(types[choix - 1], formule_aleatoire(profondeur - 1, nb_props), formule_aleatoire(profondeur - 1, nb_props));
+}
+
+//Clauses collectées pour la vérification
+typedef struct {
+    int litteraux[4096];
+    int debut[1025];
+    int nb;
+} Clauses;
+
+static void collecter(const int *litteraux, int n, void *donnees) {
+    Clauses *c = donnees;
+    memcpy(&c->litteraux[c->debut[c->nb]], litteraux, n * sizeof(int));
+    c->nb++;
+    c->debut[c->nb] = c->debut[c->nb - 1] + n;
+}
+
+//Retourne 1 si une affectation des variables 1..nb_variables satisfait les clauses
+int clauses_satisfiables(const Clauses *c, int nb_variables) {
+    for (unsigned long v = 0; v < (1ul << nb_variables); v++) {
+        int ok = 1;
+        for (int i = 0; i < c->nb && ok; i++) {
+            int sat = 0;
+            for (int x = c->debut[i]; x < c->debut[i + 1]; x++) {
+                int l = c->litteraux[x];
+                int val = (v >> (abs(l) - 1)) & 1;
+                if ((l > 0) == val) sat = 1;
+            }
+            ok = sat;
+        }
+        if (ok) return 1;
+    }
+    return 0;
+}
+
+//Vérifie sur des formules aléatoires que la FNC selon la polarité est satisfiable exactement
+//quand la formule l'est, et que la FND a la même table de vérité que la formule
+void test_aleatoire(int nb_formules) {
+    int erreurs_fnc = 0, erreurs_fnd = 0;
+    srand(3);
+    for (int f = 0; f < nb_formules; f++) {
+        ASTNode *ast = formule_aleatoire(3, 4);
+
+        int satisfiable = 0;
+        for (unsigned v = 0; v < 16; v++) satisfiable |= evaluer_arbre(ast, v);
+
+        Clauses *c = calloc(1, sizeof(Clauses));
+        EncodeurCNF enc;
+        encodeur_initialiser(&enc, collecter, c);
+        enc.selon_polarite = 1;
+        int racine = encoder_formule(&enc, ast);
+        encodeur_clause(&enc, &racine, 1);
+        if (enc.nb_variables <= 20 && clauses_satisfiables(c, enc.nb_variables) != satisfiable) erreurs_fnc++;
+        encodeur_liberer(&enc);
+        free(c);
+
+        //Pour la FND, les propositions r0..r3 reçoivent les variables 1..4
+        FormeDisjonctive fnd;
+        encodeur_initialiser(&enc, NULL, NULL);
+        for (int i = 0; i < 4; i++) {
+            char nom[8];
+            snprintf(nom, sizeof(nom), "r%d", i);
+            encodeur_variable_prop(&enc, nom);
+        }
+        if (expansion_fnd(&enc, ast, 1000, &fnd, NULL) >= 0) {
+            for (unsigned v = 0; v < 16; v++) {
+                int val = 0;
+                for (int t = 0; t < fnd.nb_termes && !val; t++) {
+                    int terme = 1;
+                    for (int x = fnd.debut[t]; x < fnd.debut[t + 1]; x++) {
+                        int l = fnd.litteraux[x];
+                        if ((l > 0) != (int)((v >> (abs(l) - 1)) & 1)) terme = 0;
+                    }
+                    val = terme;
+                }
+                if (val != evaluer_arbre(ast, v)) {
+                    erreurs_fnd++;
+                    break;
+                }
+            }
+        }
+        liberer_fnd(&fnd);
+        encodeur_liberer(&enc);
+        freeAST(ast);
+    }
+    printf("\n%d formules aléatoires : %d erreur(s) FNC, %d erreur(s) FND\n", nb_formules, erreurs_fnc, erreurs_fnd);
+}
+
+//Export d'une formule de plusieurs millions de noeuds : chaine d'implications (profondeur maximale)
+//Parametre nb_props : nombre de propositions
+void test_grande_formule(int nb_props) {
+    char nom[16];
+    snprintf(nom, sizeof(nom), "x%d", nb_props);
+    ASTNode *ast = createPropNode(nom);
+    for (int i = nb_props - 1; i >= 1; i--) {
+        snprintf(nom, sizeof(nom), "x%d", i);
+        ASTNode *gauche = createOpNode(NODE_AND, createPropNode(nom), createOpNode(NODE_NOT, NULL, createPropNode("y")));
+        ast = createOpNode(NODE_IMP, gauche, ast);
+    }
+
+    FILE *sortie = fopen("/tmp/test_cnf.dimacs", "w");
+    if (!sortie) {
+        perror("Erreur d'ouverture du fichier");
+        return;
+    }
+    clock_t debut = clock();
+    long n = exporter_dimacs(ast, sortie, 1, NULL);
+    fclose(sortie);
+    printf("Formule de %d noeuds : %ld clauses écrites en %.3f s\n", 5 * nb_props - 4, n,
+           (double)(clock() - debut) / CLOCKS_PER_SEC);
+
+    //Libération itérative (freeAST est récursif et la chaine est très profonde)
+    while (ast->type == NODE_IMP) {
+        ASTNode *suivant = ast->right;
+        ast->right = NULL;
+        freeAST(ast);
+        ast = suivant;
+    }
+    freeAST(ast);
+}
+
+//Export et développement sous des budgets mémoire croissants : chaque appel réussit avec le même
+//résultat que sans budget, ou échoue avec ERR_MEMOIRE sans laisser de mémoire allouée
+void test_budget(int nb_formules) {
+    ASTNode **formules = malloc(nb_formules * sizeof(ASTNode *));
+    long *clauses = malloc(nb_formules * sizeof(long));
+    int *termes = malloc(nb_formules * sizeof(int));
+    FILE *sortie = fopen("/dev/null", "w");
+    if (!sortie) {
+        perror("Erreur d'ouverture du fichier");
+        return;
+    }
+    srand(5);
+    for (int f = 0; f < nb_formules; f++) {
+        formules[f] = formule_aleatoire(6, 40);
+        clauses[f] = exporter_dimacs(formules[f], sortie, 1, NULL);
+        EncodeurCNF enc;
+        FormeDisjonctive fnd;
+        encodeur_initialiser(&enc, NULL, NULL);
+        termes[f] = expansion_fnd(&enc, formules[f], 200, &fnd, NULL);
+        liberer_fnd(&fnd);
+        encodeur_liberer(&enc);
+    }
+
+    printf("\n=== Budget mémoire : %d formules ===\n", nb_formules);
+    for (size_t budget = 1024; budget <= 512 * 1024; budget *= 8) {
+        AllocateurSuivi suivi;
+        suivi_initialiser(&suivi, NULL, budget);
+        Allocateur *precedent = utiliser_allocateur(&suivi.base);
+        int refus = 0, mauvais_statuts = 0, differences = 0;
+        for (int f = 0; f < nb_formules; f++) {
+            Statut statut;
+            long n = exporter_dimacs(formules[f], sortie, 1, &statut);
+            if (n < 0) {
+                refus++;
+                if (statut.code != ERR_MEMOIRE) mauvais_statuts++;
+            } else if (n != clauses[f]) {
+                differences++;
+            }
+
+            EncodeurCNF enc;
+            FormeDisjonctive fnd;
+            encodeur_initialiser(&enc, NULL, NULL);
+            int t = expansion_fnd(&enc, formules[f], 200, &fnd, &statut);
+            if (statut.code != ERR_AUCUNE) {
+                refus++;
+                if (statut.code != ERR_MEMOIRE || t >= 0) mauvais_statuts++;
+            } else if (t != termes[f]) {
+                differences++;
+            }
+            liberer_fnd(&fnd);
+            encodeur_liberer(&enc);
+        }
+        utiliser_allocateur(precedent);
+        printf("Budget %6zu octets : %3d appel(s) refusé(s), %d mauvais statut(s), %d résultat(s) différent(s), "
+               "%zu octets vivants après\n",
+               budget, refus, mauvais_statuts, differences, suivi.total.vivants);
+    }
+    fclose(sortie);
+    for (int f = 0; f < nb_formules; f++) freeAST(formules[f]);
+    free(formules);
+    free(clauses);
+    free(termes);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+
+    test_expression("(p1⇒p2)→((¬p1)∨p2)");
+    test_expression("(p1∨p2)∧(¬p3)");
+    test_expression("¬((p1∧p2)⇒p3)");
+    test_expression("(p1⇔p2)⊕¬p3");
+    test_expression("p1↑(p2↓p3)");
+
+    test_aleatoire(500);
+    test_budget(200);
+    test_grande_formule(1000000);
+    return 0;
+}
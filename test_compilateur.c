@@ -3,10 +3,13 @@
 #include <string.h>
 #include <locale.h>
 
+#include "allocateur.c" //Pour mem_allouer et mem_liberer
 #include "analex.c"     //Pour CreationListeLexeme
 #include "anasynt.c"    //Pour ASTNode, analyseur_syntaxique, printAST, freeAST
 #include "anasem.c"     //Pour analyseur_semantique (ou semantic_analysis),
                         //initialize_valid_props, free_valid_props_memory
+#include "compilateur.c"//Pour compiler_proposition
+#include "runtime.c"    //Pour execute_program
 
 int main() {
 
@@ -23,30 +26,48 @@ int main() {
     input[strcspn(input, "\n")] = '\0';
 
     //Analyse lexicale
-    char** lexemes = CreationListeLexeme(input);
+    Statut statut;
+    char** lexemes = CreationListeLexeme(input, &statut);
     if (!lexemes) {
-        fprintf(stderr, "Erreur : L'analyse lexicale a échoué.\n");
+        fprintf(stderr, "Erreur : L'analyse lexicale a échoué (position %d : %s).\n", statut.position, statut.message);
+        free_valid_props_memory();
         return EXIT_FAILURE;
     }
 
-    //Comptage des lexemes
-    int lexeme_count = 0;
-    while (lexemes[lexeme_count]) {
-        lexeme_count++;
-    }
-
     //Analyse syntaxique
-    ASTNode* ast = analyseur_syntaxique(lexemes);
+    ASTNode* ast = analyseur_syntaxique(lexemes, &statut);
+    liberer_lexemes(lexemes);
     if (!ast) {
-        fprintf(stderr, "Erreur : L'analyse syntaxique a échoué.\n");
+        fprintf(stderr, "Erreur : L'analyse syntaxique a échoué (lexème %d : %s).\n", statut.position, statut.message);
+        free_valid_props_memory();
         return EXIT_FAILURE;
     }
 
     //On affiche l'AST si l'analyse a réussie
     printAST(ast, 0);
 
-    //Analyse sémantique
-    analyseur_semantique(ast);
-    
+    //Analyse sémantique puis compilation
+    if (analyseur_semantique(ast, &statut) < 0 || compiler_proposition(ast, &statut) < 0) {
+        fprintf(stderr, "Erreur : %s.\n", statut.message);
+        freeAST(ast);
+        free_valid_props_memory();
+        return EXIT_FAILURE;
+    }
+
+    //Exécution pour chaque valuation de p1, p2, p3
+    add_instruction(VM_PRINT, 0);
+    for (int v = 0; v < 8; v++) {
+        int valeurs[3] = {v & 1, (v >> 1) & 1, (v >> 2) & 1};
+        printf("p1=%d p2=%d p3=%d -> ", valeurs[0], valeurs[1], valeurs[2]);
+        definir_valeurs_propositions(valeurs);
+        if (execute_program(&statut) < 0) {
+            printf("Erreur à l'instruction %d : %s\n", statut.position, statut.message);
+        }
+    }
+
+    //On libère la mémoire
+    freeAST(ast);
+    free_valid_props_memory();
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "arbreplat.c"
+#include "frontal.c"
+#include "decoupage.c"
+
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Comparaison de deux arbres plats
+int arbres_plats_identiques(const ArbrePlat *a, const ArbrePlat *b) {
+    return a->nb_noeuds == b->nb_noeuds &&
+           memcmp(a->types, b->types, a->nb_noeuds) == 0 &&
+           memcmp(a->args, b->args, a->nb_noeuds * sizeof(uint32_t)) == 0;
+}
+
+//Texte de taille variable
+typedef struct {
+    char *texte;
+    size_t n;
+    size_t capacite;
+} Texte;
+
+void ajouter_texte(Texte *t, const char *s) {
+    size_t l = strlen(s);
+    if (t->n + l + 1 > t->capacite) {
+        t->capacite = 2 * (t->n + l + 1);
+        t->texte = realloc(t->texte, t->capacite);
+    }
+    memcpy(t->texte + t->n, s, l + 1);
+    t->n += l;
+}
+
+//Fonction écrivant une formule aléatoire d'environ taille octets : opérandes reliés par des
+//opérateurs au hasard, entre parenthèses et précédés de négations au hasard
+void ecrire_formule_aleatoire(Texte *t, size_t taille) {
+    static const char *props[] = {"p1", "p2", "p3", "p4", "p5"};
+    static const char *binaires[] = {"∧", "∨", "⇒", "→", "⇔", "⊕", "↑", "↓"};
+    static const char *espaces[] = {"", "", "", " ", "\t"};
+    if (taille < 4) {
+        ajouter_texte(t, props[rand() % 5]);
+        ajouter_texte(t, espaces[rand() % 5]);
+        return;
+    }
+    int nb_operandes = 2 + rand() % 6;
+    for (int k = 0; k < nb_operandes; k++) {
+        if (k > 0) {
+            ajouter_texte(t, binaires[rand() % 8]);
+            ajouter_texte(t, espaces[rand() % 5]);
+        }
+        int negations = rand() % 8 == 0 ? 1 + rand() % 2 : 0;
+        int parentheses = negations > 0 || rand() % 2;
+        for (int i = 0; i < negations; i++) ajouter_texte(t, "¬");
+        if (parentheses) ajouter_texte(t, "(");
+        ecrire_formule_aleatoire(t, taille / nb_operandes);
+        if (parentheses) ajouter_texte(t, ")");
+    }
+}
+
+//Comparaison avec analyser_formule sur des formules aléatoires, découpées en opérandes de quelques
+//octets, puis sur des formules abimées (un octet supprimé ou remplacé) pour comparer aussi les refus
+void test_aleatoire(int nb_formules) {
+    Texte t = {NULL, 0, 0};
+    int differences = 0, refus = 0, decoupees = 0;
+    ArbrePlat a, b;
+    arbre_plat_initialiser(&a);
+    arbre_plat_initialiser(&b);
+    srand(5);
+    for (int f = 0; f < nb_formules; f++) {
+        t.n = 0;
+        ajouter_texte(&t, "");
+        ecrire_formule_aleatoire(&t, 20 + rand() % 400);
+        if (f % 2 == 1 && t.n > 1) {
+            size_t k = rand() % t.n;
+            if (rand() % 2) {
+                memmove(t.texte + k, t.texte + k + 1, t.n - k);
+                t.n--;
+            } else {
+                t.texte[k] = "()p4 ?"[rand() % 6];
+            }
+        }
+        Statut sa, sb;
+        RapportDecoupage rapport;
+        int ra = analyser_formule_parallele(t.texte, &a, 2 + f % 3, 1 + rand() % 64, &rapport, &sa);
+        int rb = analyser_formule(t.texte, &b, &sb);
+        refus += rb < 0;
+        decoupees += rapport.niveaux > 0 && !rapport.repli;
+        if (ra != rb || (ra == 0 && !arbres_plats_identiques(&a, &b)) ||
+            (ra < 0 && (sa.code != sb.code || sa.position != sb.position))) {
+            if (differences++ < 5) printf("Différence : %s\n", t.texte);
+        }
+    }
+    printf("%d formules aléatoires (%d refusées, %d découpées) : %d différence(s)\n", nb_formules, refus, decoupees,
+           differences);
+    liberer_arbre_plat(&a);
+    liberer_arbre_plat(&b);
+    free(t.texte);
+}
+
+//Imbrication : la limite de profondeur est atteinte au même endroit qu'en analyse séquentielle
+void test_imbrication(void) {
+    Texte t = {NULL, 0, 0};
+    ArbrePlat a, b;
+    arbre_plat_initialiser(&a);
+    arbre_plat_initialiser(&b);
+    int tailles[3] = {1000, 9990, 20000};
+    for (int k = 0; k < 3; k++) {
+        for (int forme = 0; forme < 2; forme++) {
+            t.n = 0;
+            ajouter_texte(&t, "");
+            for (int i = 0; i < tailles[k]; i++) ajouter_texte(&t, forme == 0 ? "p1⇒" : "¬(p2∧");
+            ajouter_texte(&t, "p3");
+            for (int i = 0; forme == 1 && i < tailles[k]; i++) ajouter_texte(&t, ")");
+            Statut sa, sb;
+            RapportDecoupage rapport;
+            int ra = analyser_formule_parallele(t.texte, &a, 4, 64, &rapport, &sa);
+            int rb = analyser_formule(t.texte, &b, &sb);
+            int identiques = ra == rb && (ra < 0 ? sa.code == sb.code && sa.position == sb.position
+                                                 : arbres_plats_identiques(&a, &b));
+            printf("%5d %s : %s, %d niveau(x), %ld segment(s)%s [%s]\n", tailles[k],
+                   forme == 0 ? "implications" : "¬( ∧ imbriqués", ra == 0 ? "acceptée" : sa.message,
+                   rapport.niveaux, rapport.segments, rapport.repli ? ", analyse séquentielle refaite" : "",
+                   identiques ? "identique" : "DIFFERENT");
+        }
+    }
+    liberer_arbre_plat(&a);
+    liberer_arbre_plat(&b);
+    free(t.texte);
+}
+
+//Grande formule : temps de l'analyse séquentielle et de l'analyse parallèle
+void test_grande_formule(size_t taille) {
+    Texte t = {NULL, 0, 0};
+    srand(11);
+    ajouter_texte(&t, "");
+    ecrire_formule_aleatoire(&t, taille);
+    printf("\n=== Formule de %.1f Mo ===\n", t.n / 1e6);
+
+    ArbrePlat a, b;
+    arbre_plat_initialiser(&a);
+    arbre_plat_initialiser(&b);
+    Statut statut;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int r = analyser_formule(t.texte, &b, &statut);
+    double temps_sequentiel = secondes_depuis(debut);
+    printf("analyser_formule          : %.3f s, %u noeuds%s\n", temps_sequentiel, b.nb_noeuds,
+           r == 0 ? "" : statut.message);
+    int threads[3] = {1, 2, 4};
+    for (int k = 0; k < 3; k++) {
+        RapportDecoupage rapport;
+        clock_gettime(CLOCK_MONOTONIC, &debut);
+        r = analyser_formule_parallele(t.texte, &a, threads[k], 0, &rapport, &statut);
+        double temps = secondes_depuis(debut);
+        printf("parallèle, %d thread(s)    : %.3f s, %ld segments, %d niveau(x)%s [%s]\n", threads[k], temps,
+               rapport.segments, rapport.niveaux, rapport.repli ? ", analyse séquentielle refaite" : "",
+               r == 0 && arbres_plats_identiques(&a, &b) ? "arbre identique" : "ARBRE DIFFERENT");
+    }
+    liberer_arbre_plat(&a);
+    liberer_arbre_plat(&b);
+    free(t.texte);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    add_valid_prop("p4");
+    add_valid_prop("p5");
+
+    test_aleatoire(20000);
+    test_imbrication();
+    test_grande_formule(16 * 1000 * 1000);
+
+    free_valid_props_memory();
+    return 0;
+}
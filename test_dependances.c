@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "dependances.c"
+
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+uint64_t mot_aleatoire(void) {
+    return ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+}
+
+//Fonction écrivant en postfixe une formule aléatoire de la profondeur donnée, dont les propositions
+//sont prises parmi les nb_props propositions de props
+//Retourne la nouvelle taille du programme
+int programme_aleatoire(VMInstruction *prog, int taille, int profondeur, const int *props, int nb_props) {
+    static const VMOpcode binaires[] = {VM_AND, VM_OR, VM_IMP, VM_EQV, VM_XOR, VM_NAND, VM_NOR};
+    if (profondeur == 0) {
+        prog[taille++] = (VMInstruction){VM_LOAD, props[rand() % nb_props]};
+        return taille;
+    }
+    if (rand() % 6 == 0) {
+        taille = programme_aleatoire(prog, taille, profondeur - 1, props, nb_props);
+        prog[taille++] = (VMInstruction){VM_NOT, 0};
+        return taille;
+    }
+    taille = programme_aleatoire(prog, taille, profondeur - 1, props, nb_props);
+    taille = programme_aleatoire(prog, taille, profondeur - 1, props, nb_props);
+    prog[taille++] = (VMInstruction){binaires[rand() % 7], 0};
+    return taille;
+}
+
+//Exemple : support d'une formule analysée
+void test_support(const char *expression) {
+    VMInstruction prog[PROGRAM_SIZE];
+    Statut statut;
+    char **lexemes = CreationListeLexeme(expression, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int taille = ast ? compiler_programme(ast, prog, PROGRAM_SIZE, &statut) : -1;
+    freeAST(ast);
+    SupportRegle support;
+    if (taille < 0 || calculer_support(prog, taille, &support, &statut) < 0) {
+        printf("%s : erreur %s\n", expression, statut.message);
+        return;
+    }
+    printf("%-20s : %d proposition(s), %d mot(s) :", expression, taille_support(&support), support.nb_mots);
+    for (int p = 0; p < 8; p++) {
+        if (support_contient(&support, p)) printf(" p%d", p + 1);
+    }
+    printf("\n");
+    liberer_support(&support);
+}
+
+//Cas particuliers : support creux, programme refusé, règle ajoutée après la construction de l'index
+void test_limites(void) {
+    printf("\n=== Limites ===\n");
+    SupportRegle support;
+    Statut statut;
+    VMInstruction creux[] = {{VM_LOAD, 3}, {VM_LOAD, 100000}, {VM_AND, 0}, {VM_LOAD, 3}, {VM_OR, 0}};
+    calculer_support(creux, 5, &support, &statut);
+    printf("p4 ∧ p100001 ∨ p4 : %d proposition(s) en %d mot(s), contient p100001 : %d, p100002 : %d\n",
+           taille_support(&support), support.nb_mots, support_contient(&support, 100000),
+           support_contient(&support, 100001));
+    liberer_support(&support);
+    VMInstruction constante[] = {{VM_PUSH, 1}};
+    calculer_support(constante, 1, &support, &statut);
+    printf("Constante : %d mot(s)\n", support.nb_mots);
+    VMInstruction mauvais[] = {{VM_LOAD, 0}, {VM_AND, 0}};
+    int r = calculer_support(mauvais, 2, &support, &statut);
+    printf("Programme refusé : %d (%s)\n", r, statut.message);
+
+    EnsembleRegles e;
+    ensemble_regles_initialiser(&e);
+    VMInstruction ou[] = {{VM_LOAD, 0}, {VM_LOAD, 1}, {VM_OR, 0}};
+    VMInstruction non[] = {{VM_LOAD, 2}, {VM_NOT, 0}};
+    ajouter_regle(&e, ou, 3, &statut);
+    int basculees[4];
+    int props[2] = {0, 7};
+    uint64_t valeurs[2] = {~0ULL, ~0ULL};
+    int n = reevaluer_changements(&e, props, valeurs, 2, basculees, &statut);
+    printf("p1 := vrai (p8 lue par aucune règle) : %d règle(s) basculée(s)\n", n);
+    ajouter_regle(&e, non, 2, &statut);
+    printf("Règle ¬p3 ajoutée après l'index : %s\n", valeur_regle(&e, 1) == ~0ULL ? "vraie" : "fausse");
+    props[0] = 2;
+    n = reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    printf("p3 := vrai : %d règle(s) basculée(s) (règle %d), %ld réévaluation(s)\n", n, n > 0 ? basculees[0] : -1,
+           e.reevaluations);
+    n = reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    printf("p3 := vrai à nouveau : %d règle(s) basculée(s), %ld réévaluation(s)\n", n, e.reevaluations);
+    //p8 a été fixée à vrai avant qu'une règle ne la lise : la nouvelle règle voit cette valeur
+    VMInstruction lit_p8[] = {{VM_LOAD, 7}, {VM_LOAD, 1}, {VM_AND, 0}};
+    VMInstruction lit_p10[] = {{VM_LOAD, 9}};
+    props[0] = 9;
+    reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    ajouter_regle(&e, lit_p8, 3, &statut);
+    ajouter_regle(&e, lit_p10, 1, &statut);
+    printf("Règles p8 ∧ p2 et p10 ajoutées après p8 := vrai et p10 := vrai : %s, %s\n",
+           valeur_regle(&e, 2) == 0 ? "fausse" : "ERREUR", valeur_regle(&e, 3) == ~0ULL ? "vraie" : "ERREUR");
+    props[0] = 1;
+    n = reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    printf("p2 := vrai : %d règle(s) basculée(s) (règle %d)\n", n, n > 0 ? basculees[0] : -1);
+    props[0] = -1;
+    n = reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    printf("Proposition -1 : %d (%s)\n", n, statut.message);
+    props[0] = INT_MAX;
+    n = reevaluer_changements(&e, props, valeurs, 1, basculees, &statut);
+    printf("Proposition INT_MAX : %d (%s)\n", n, statut.message);
+    VMInstruction lit_max[] = {{VM_LOAD, INT_MAX}};
+    n = ajouter_regle(&e, lit_max, 1, &statut);
+    printf("Règle lisant la proposition INT_MAX : %d (%s)\n", n, statut.message);
+    liberer_ensemble_regles(&e);
+}
+
+//Règles lisant chacune quelques propositions parmi nb_props, événements modifiant quelques propositions :
+//réévaluation de toutes les règles, puis réévaluation dirigée par l'index
+void test_evenements(int nb_regles, int nb_props, int nb_evenements) {
+    EnsembleRegles e;
+    ensemble_regles_initialiser(&e);
+    VMInstruction prog[PROGRAM_SIZE];
+    long instructions = 0, supports = 0;
+    srand(7);
+    for (int r = 0; r < nb_regles; r++) {
+        int props[8];
+        int nb = 2 + rand() % 7;
+        for (int k = 0; k < nb; k++) props[k] = rand() % nb_props;
+        int taille = programme_aleatoire(prog, 0, 2 + rand() % 4, props, nb);
+        if (ajouter_regle(&e, prog, taille, NULL) < 0) {
+            printf("Règle %d refusée\n", r);
+            exit(EXIT_FAILURE);
+        }
+        instructions += taille;
+        supports += taille_support(&e.supports[r]);
+    }
+    construire_index(&e, NULL);
+
+    //Evénements tirés d'avance : 1 à 4 propositions modifiées
+    int *props = malloc(4 * nb_evenements * sizeof(int));
+    uint64_t *valeurs = malloc(4 * nb_evenements * sizeof(uint64_t));
+    int *nb_changees = malloc(nb_evenements * sizeof(int));
+    for (int v = 0; v < nb_evenements; v++) {
+        nb_changees[v] = 1 + rand() % 4;
+        for (int k = 0; k < nb_changees[v]; k++) {
+            props[4 * v + k] = rand() % nb_props;
+            valeurs[4 * v + k] = mot_aleatoire();
+        }
+    }
+
+    //Référence : toutes les règles réévaluées à chaque événement
+    uint64_t *colonnes = calloc(e.nb_props, sizeof(uint64_t));
+    uint64_t *resultats = malloc(nb_regles * sizeof(uint64_t));
+    for (int r = 0; r < nb_regles; r++) resultats[r] = valeur_regle(&e, r);
+    long basculees_reference = 0;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int v = 0; v < nb_evenements; v++) {
+        for (int k = 0; k < nb_changees[v]; k++) colonnes[props[4 * v + k]] = valeurs[4 * v + k];
+        for (int r = 0; r < nb_regles; r++) {
+            uint64_t resultat = executer_programme_64(e.progs[r], e.tailles[r], colonnes);
+            basculees_reference += resultat != resultats[r];
+            resultats[r] = resultat;
+        }
+    }
+    double temps_complet = secondes_depuis(debut);
+
+    //Réévaluation dirigée ; les règles basculées sont comptées, les résultats finals comparés
+    int *basculees = malloc(nb_regles * sizeof(int));
+    long nb_basculees = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int v = 0; v < nb_evenements; v++) {
+        nb_basculees += reevaluer_changements(&e, props + 4 * v, valeurs + 4 * v, nb_changees[v], basculees, NULL);
+    }
+    double temps_dirige = secondes_depuis(debut);
+    int differences = 0;
+    for (int r = 0; r < nb_regles; r++) differences += valeur_regle(&e, r) != resultats[r];
+
+    printf("\n=== %d règles sur %d propositions, %d événements (1 à 4 propositions) ===\n", nb_regles, nb_props,
+           nb_evenements);
+    printf("%.1f instructions et %.1f propositions par règle, %.1f règles réévaluées par événement\n",
+           (double)instructions / nb_regles, (double)supports / nb_regles, (double)e.reevaluations / nb_evenements);
+    printf("  toutes les règles     %9.2f us par événement\n", temps_complet * 1e6 / nb_evenements);
+    printf("  index inversé         %9.2f us par événement (x%.0f)\n", temps_dirige * 1e6 / nb_evenements,
+           temps_complet / temps_dirige);
+    printf("  %ld basculement(s), %ld attendu(s), %d résultat(s) différent(s) [%s]\n", nb_basculees,
+           basculees_reference, differences,
+           nb_basculees == basculees_reference && differences == 0 ? "mêmes résultats" : "ERREUR");
+
+    liberer_ensemble_regles(&e);
+    free(props);
+    free(valeurs);
+    free(nb_changees);
+    free(colonnes);
+    free(resultats);
+    free(basculees);
+}
+
+//Vérification événement par événement : les règles basculées sont exactement celles dont le résultat
+//change, chacune une seule fois
+void test_basculements(int nb_regles, int nb_props, int nb_evenements) {
+    EnsembleRegles e;
+    ensemble_regles_initialiser(&e);
+    VMInstruction prog[PROGRAM_SIZE];
+    srand(9);
+    for (int r = 0; r < nb_regles; r++) {
+        int props[4];
+        for (int k = 0; k < 4; k++) props[k] = rand() % nb_props;
+        ajouter_regle(&e, prog, programme_aleatoire(prog, 0, 3, props, 4), NULL);
+    }
+    uint64_t *colonnes = calloc(nb_props + 5, sizeof(uint64_t));
+    uint64_t *resultats = malloc(nb_regles * sizeof(uint64_t));
+    int *basculees = malloc(nb_regles * sizeof(int));
+    char *vue = malloc(nb_regles);
+    for (int r = 0; r < nb_regles; r++) resultats[r] = valeur_regle(&e, r);
+    int erreurs = 0;
+    for (int v = 0; v < nb_evenements; v++) {
+        int props[6];
+        uint64_t valeurs[6];
+        int nb = 1 + rand() % 6;
+        for (int k = 0; k < nb; k++) {
+            props[k] = rand() % (nb_props + 5);  //Quelques propositions lues par aucune règle
+            valeurs[k] = rand() % 3 == 0 ? mot_aleatoire() : (rand() % 2 ? ~0ULL : 0);
+            colonnes[props[k]] = valeurs[k];
+        }
+        int n = reevaluer_changements(&e, props, valeurs, nb, basculees, NULL);
+        memset(vue, 0, nb_regles);
+        for (int i = 0; i < n; i++) erreurs += vue[basculees[i]]++ != 0;
+        for (int r = 0; r < nb_regles; r++) {
+            uint64_t resultat = executer_programme_64(e.progs[r], e.tailles[r], colonnes);
+            erreurs += (resultat != resultats[r]) != vue[r];
+            resultats[r] = resultat;
+        }
+    }
+    printf("%d événements vérifiés un par un sur %d règles : %d erreur(s)\n", nb_evenements, nb_regles, erreurs);
+    liberer_ensemble_regles(&e);
+    free(colonnes);
+    free(resultats);
+    free(basculees);
+    free(vue);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    add_valid_prop("p4");
+    add_valid_prop("p5");
+
+    printf("=== Supports ===\n");
+    test_support("p1∧p2");
+    test_support("p3⇒(p1∨p3)");
+    test_support("¬p5⊕(p2↑p2)");
+    test_limites();
+
+    printf("\n=== Basculements ===\n");
+    test_basculements(500, 60, 5000);
+    test_evenements(5000, 4096, 2000);
+    test_evenements(50000, 65536, 200);
+
+    free_valid_props_memory();
+    return 0;
+}
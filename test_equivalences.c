@@ -0,0 +1,396 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "cnf.c"
+#include "solveur.c"
+#include "equivalences.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p24)
+#define NB_PROPS_TEST 24
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Fonction compilant une formule en programme de la machine virtuelle
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_chaine(const char *chaine, VMInstruction *prog, int capacite) {
+    Statut statut;
+    char **lexemes = CreationListeLexeme(chaine, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int n = -1;
+    if (ast && analyseur_semantique(ast, &statut) == 0) {
+        n = compiler_programme(ast, prog, capacite, &statut);
+    }
+    freeAST(ast);
+    return n;
+}
+
+//Formules compilées d'un test
+typedef struct {
+    VMInstruction **progs;
+    int *tailles;
+    int *base;          //Formule de départ dont chaque formule est une réécriture
+    int nb;
+} Formules;
+
+void ajouter_formule(Formules *f, const char *texte, int base) {
+    VMInstruction prog[PROGRAM_SIZE];
+    int taille = compiler_chaine(texte, prog, PROGRAM_SIZE);
+    if (taille < 0) {
+        printf("%s : formule refusée\n", texte);
+        return;
+    }
+    f->progs = realloc(f->progs, (f->nb + 1) * sizeof(VMInstruction *));
+    f->tailles = realloc(f->tailles, (f->nb + 1) * sizeof(int));
+    f->base = realloc(f->base, (f->nb + 1) * sizeof(int));
+    f->progs[f->nb] = malloc(taille * sizeof(VMInstruction));
+    memcpy(f->progs[f->nb], prog, taille * sizeof(VMInstruction));
+    f->tailles[f->nb] = taille;
+    f->base[f->nb] = base;
+    f->nb++;
+}
+
+void liberer_formules(Formules *f) {
+    for (int i = 0; i < f->nb; i++) free(f->progs[i]);
+    free(f->progs);
+    free(f->tailles);
+    free(f->base);
+    memset(f, 0, sizeof(*f));
+}
+
+//Classement de formules dont on connait les classes attendues
+void test_classement(const char *titre, Formules *f, const int *attendu) {
+    ClassesEquivalence res;
+    Statut statut;
+    int n = classer_equivalences((const VMInstruction *const *)f->progs, f->tailles, f->nb, NB_PROPS_TEST, 0, 1,
+                                 &res, &statut);
+    if (n < 0) {
+        printf("%s : erreur %s\n", titre, statut.message);
+        return;
+    }
+    int erreurs = 0;
+    for (int i = 0; i < f->nb; i++) erreurs += res.classe[i] != attendu[i];
+    printf("%-40s %d formule(s), %d classe(s), %d seau(x), %ld vérification(s) dont %ld SAT, %ld faux candidat(s) : %s\n",
+           titre, f->nb, n, res.nb_seaux, res.verifications, res.verifications_sat, res.faux_candidats,
+           erreurs ? "ERREUR" : "ok");
+    liberer_classes_equivalence(&res);
+}
+
+//Paires de formules vérifiées exactement
+void test_paire(const char *a, const char *b) {
+    VMInstruction prog_a[PROGRAM_SIZE], prog_b[PROGRAM_SIZE];
+    int taille_a = compiler_chaine(a, prog_a, PROGRAM_SIZE);
+    int taille_b = compiler_chaine(b, prog_b, PROGRAM_SIZE);
+    if (taille_a < 0 || taille_b < 0) return;
+    printf("%-30s %-30s %s\n", a, b,
+           programmes_equivalents(prog_a, taille_a, prog_b, taille_b, NB_PROPS_TEST, NULL) ? "équivalentes" : "différentes");
+}
+
+
+// ----------------------
+/*
+Formules aléatoires et réécritures qui préservent l'équivalence
+*/
+// ----------------------
+
+enum { FEUILLE, NON, ET, OU, IMPLIQUE, EQUIVALENT, OU_EXCLUSIF, NON_ET, NON_OU };
+
+static const char *symboles_test[] = {"", "¬", "∧", "∨", "⇒", "⇔", "⊕", "↑", "↓"};
+
+typedef struct Arbre {
+    int op;
+    int prop;
+    struct Arbre *gauche, *droite;
+} Arbre;
+
+Arbre *arbre_aleatoire(int profondeur) {
+    Arbre *a = calloc(1, sizeof(Arbre));
+    int tirage = rand() % 8;
+    if (profondeur == 0 || tirage == 0) {
+        a->op = FEUILLE;
+        a->prop = 1 + rand() % NB_PROPS_TEST;
+    } else if (tirage == 1) {
+        a->op = NON;
+        a->gauche = arbre_aleatoire(profondeur - 1);
+    } else {
+        a->op = ET + rand() % 7;
+        a->gauche = arbre_aleatoire(profondeur - 1);
+        a->droite = arbre_aleatoire(profondeur - 1);
+    }
+    return a;
+}
+
+void liberer_arbre(Arbre *a) {
+    if (!a) return;
+    liberer_arbre(a->gauche);
+    liberer_arbre(a->droite);
+    free(a);
+}
+
+//Fonction écrivant un arbre, réécrit au hasard si reecrire (commutations, De Morgan, définitions
+//des opérateurs par les autres, contraposée, doubles négations)
+//Retourne le nombre d'octets écrits
+int ecrire_arbre(const Arbre *a, char *texte, int reecrire);
+
+//Écrit ¬a
+static int ecrire_negation(const Arbre *a, char *texte, int reecrire) {
+    int n = sprintf(texte, "¬");
+    return n + ecrire_arbre(a, texte + n, reecrire);
+}
+
+//Écrit (x op y), avec x et y éventuellement niés
+static int ecrire_binaire(const Arbre *x, int non_x, const char *op, const Arbre *y, int non_y, char *texte,
+                          int reecrire) {
+    int n = sprintf(texte, "(");
+    n += non_x ? ecrire_negation(x, texte + n, reecrire) : ecrire_arbre(x, texte + n, reecrire);
+    n += sprintf(texte + n, "%s", op);
+    n += non_y ? ecrire_negation(y, texte + n, reecrire) : ecrire_arbre(y, texte + n, reecrire);
+    return n + sprintf(texte + n, ")");
+}
+
+int ecrire_arbre(const Arbre *a, char *texte, int reecrire) {
+    int n = 0;
+    if (reecrire && rand() % 10 == 0) n += sprintf(texte, "¬¬");
+    texte += n;
+    const Arbre *g = a->gauche, *d = a->droite;
+    int choix = reecrire ? rand() % 3 : 0;
+    switch (a->op) {
+        case FEUILLE:
+            return n + sprintf(texte, "p%d", a->prop);
+        case NON:
+            return n + ecrire_negation(g, texte, reecrire);
+        case ET:
+            if (choix == 1) return n + ecrire_binaire(d, 0, "∧", g, 0, texte, reecrire);
+            if (choix == 2) {
+                int m = sprintf(texte, "¬");
+                return n + m + ecrire_binaire(g, 1, "∨", d, 1, texte + m, reecrire);
+            }
+            break;
+        case OU:
+            if (choix == 1) return n + ecrire_binaire(d, 0, "∨", g, 0, texte, reecrire);
+            if (choix == 2) return n + ecrire_binaire(g, 1, "⇒", d, 0, texte, reecrire);
+            break;
+        case IMPLIQUE:
+            if (choix == 1) return n + ecrire_binaire(g, 1, "∨", d, 0, texte, reecrire);
+            if (choix == 2) return n + ecrire_binaire(d, 1, "→", g, 1, texte, reecrire);
+            break;
+        case EQUIVALENT:
+        case OU_EXCLUSIF: {
+            const char *autre = a->op == EQUIVALENT ? "⊕" : "⇔";
+            if (choix == 1) return n + ecrire_binaire(d, 0, symboles_test[a->op], g, 0, texte, reecrire);
+            if (choix == 2) {
+                int m = sprintf(texte, "¬");
+                return n + m + ecrire_binaire(g, 0, autre, d, 0, texte + m, reecrire);
+            }
+            break;
+        }
+        case NON_ET:
+        case NON_OU: {
+            const char *positif = a->op == NON_ET ? "∧" : "∨";
+            const char *dual = a->op == NON_ET ? "∨" : "∧";
+            if (choix == 1) {
+                int m = sprintf(texte, "¬");
+                return n + m + ecrire_binaire(g, 0, positif, d, 0, texte + m, reecrire);
+            }
+            if (choix == 2) return n + ecrire_binaire(g, 1, dual, d, 1, texte, reecrire);
+            break;
+        }
+    }
+    return n + ecrire_binaire(g, 0, symboles_test[a->op], d, 0, texte, reecrire);
+}
+
+
+// ----------------------
+/*
+Tests
+*/
+// ----------------------
+
+//Formules de peu de propositions : vérification exacte par balayage
+void test_petites(void) {
+    printf("=== Paires ===\n");
+    test_paire("p1⇒p2", "¬p2⇒¬p1");
+    test_paire("p1⇒p2", "p2⇒p1");
+    test_paire("p1↑p2", "¬p1∨¬p2");
+    test_paire("p1⊕p2", "¬(p1⇔p2)");
+    test_paire("p1∧(p2∨p3)", "(p1∧p2)∨(p1∧p3)");
+    test_paire("p1∧(p2∨p3)", "(p1∧p2)∨p3");
+
+    printf("\n=== Classements ===\n");
+    Formules f = {0};
+    const char *textes[] = {"p1⇒p2", "p1∧p2", "¬p2⇒¬p1", "p2∧p1", "¬p1∨p2", "p1↓p2", "¬(p1∨p2)", "¬p1∧¬p2"};
+    int attendu[] = {0, 1, 0, 1, 0, 2, 2, 2};
+    for (int i = 0; i < 8; i++) ajouter_formule(&f, textes[i], 0);
+    test_classement("Quelques propositions", &f, attendu);
+    liberer_formules(&f);
+}
+
+//Budget mémoire : un classement refusé retourne -1 (ERR_MEMOIRE) sans fuite, et donne les classes
+//attendues dès que le budget suffit
+void test_budget(Formules *f, const int *attendu) {
+    printf("\n=== Budget mémoire ===\n");
+    for (size_t budget = 2048; budget <= 128 * 1024; budget *= 2) {
+        AllocateurSuivi suivi;
+        suivi_initialiser(&suivi, NULL, budget);
+        Allocateur *precedent = utiliser_allocateur(&suivi.base);
+        ClassesEquivalence res;
+        Statut statut;
+        int n = classer_equivalences((const VMInstruction *const *)f->progs, f->tailles, f->nb, NB_PROPS_TEST, 0, 1,
+                                     &res, &statut);
+        int erreurs = 0;
+        if (n >= 0) {
+            for (int i = 0; i < f->nb; i++) erreurs += res.classe[i] != attendu[i];
+            liberer_classes_equivalence(&res);
+        }
+        utiliser_allocateur(precedent);
+        printf("Budget %6zu octets : %s (code %d), %zu octets vivants après\n", budget,
+               n < 0 ? statut.message : erreurs ? "ERREUR" : "classes attendues", n < 0 ? (int)statut.code : 0,
+               suivi.total.vivants);
+    }
+}
+
+//Formules de plus de MAX_PROPS_BALAYAGE_EXACT propositions : vérification exacte par le solveur,
+//et formules qui ne diffèrent que sur une valuation (même signature, pas équivalentes)
+void test_grandes(void) {
+    Formules f = {0};
+    char texte[1024];
+    int attendu[8], nb = 0;
+    //Conjonction de p1 .. p20 dans trois ordres : même classe
+    for (int variante = 0; variante < 3; variante++) {
+        int n = 0;
+        for (int i = 0; i < 20; i++) {
+            int p = variante == 0 ? i + 1 : variante == 1 ? 20 - i : 1 + (i * 7) % 20;
+            n += sprintf(texte + n, "%s%sp%d", i ? "∧" : "", variante == 2 && i % 2 ? "¬¬" : "", p);
+        }
+        ajouter_formule(&f, texte, 0);
+        attendu[nb++] = 0;
+    }
+    //Contradiction : ne diffère de la conjonction que si les 20 propositions sont vraies
+    ajouter_formule(&f, "p1∧¬p1", 1);
+    attendu[nb++] = 1;
+    ajouter_formule(&f, "¬(p2∨¬p2)", 1);
+    attendu[nb++] = 1;
+    //Forme normale conjonctive sur 20 propositions, clauses et littéraux permutés
+    ajouter_formule(&f, "(p1∨¬p2)∧(p3∨p4)∧(¬p5∨p6)∧(p7∨p8)∧(p9∨¬p10)∧(p11∨p12)∧(p13∨p14)∧(¬p15∨p16)∧(p17∨p18)∧(p19∨p20)", 2);
+    attendu[nb++] = 2;
+    ajouter_formule(&f, "(p20∨p19)∧(p18∨p17)∧(p16∨¬p15)∧(p14∨p13)∧(p12∨p11)∧(¬p10∨p9)∧(p8∨p7)∧(p6∨¬p5)∧(p4∨p3)∧(¬p2∨p1)", 2);
+    attendu[nb++] = 2;
+    test_classement("Plus de 16 propositions", &f, attendu);
+    test_budget(&f, attendu);
+    liberer_formules(&f);
+}
+
+//Dizaines de milliers de formules : nb_bases formules aléatoires réécrites nb_variantes fois
+void test_performances(int nb_bases, int nb_variantes, int nb_naif) {
+    Formules f = {0};
+    char texte[4096];
+    srand(5);
+    for (int b = 0; b < nb_bases; b++) {
+        Arbre *a = arbre_aleatoire(4);
+        for (int v = 0; v < nb_variantes; v++) {
+            ecrire_arbre(a, texte, v > 0);
+            ajouter_formule(&f, texte, b);
+        }
+        liberer_arbre(a);
+    }
+    printf("\n=== Performances : %d formules (%d formules de départ, %d propositions) ===\n", f.nb, nb_bases,
+           NB_PROPS_TEST);
+
+    ClassesEquivalence res;
+    Statut statut;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int n = classer_equivalences((const VMInstruction *const *)f.progs, f.tailles, f.nb, NB_PROPS_TEST, 0, 1, &res,
+                                 &statut);
+    double total = secondes_depuis(debut);
+    if (n < 0) {
+        printf("Erreur : %s\n", statut.message);
+        liberer_formules(&f);
+        return;
+    }
+    printf("%d classe(s), %d seau(x), %ld vérification(s) exacte(s) dont %ld SAT, %ld faux candidat(s)\n", n,
+           res.nb_seaux, res.verifications, res.verifications_sat, res.faux_candidats);
+    printf("Signatures (%d valuations) : %7.1f ms\n", MOTS_SIGNATURE * 64, res.temps_signatures * 1e3);
+    printf("Seaux                      : %7.1f ms\n", res.temps_seaux * 1e3);
+    printf("Vérifications exactes      : %7.1f ms\n", res.temps_verifications * 1e3);
+    printf("Total                      : %7.1f ms\n", total * 1e3);
+
+    //Les réécritures d'une même formule sont dans la même classe
+    int separees = 0;
+    for (int i = 0; i < f.nb; i++) separees += res.classe[i] != res.classe[f.base[i] * nb_variantes];
+    printf("Réécritures séparées de leur formule : %d\n", separees);
+    //Chaque membre est équivalent à son représentant (sur d'autres valuations aléatoires)
+    uint64_t colonnes[NB_PROPS_TEST];
+    int differences = 0;
+    for (int essai = 0; essai < 64; essai++) {
+        for (int p = 0; p < NB_PROPS_TEST; p++) colonnes[p] = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ rand();
+        for (int i = 0; i < f.nb; i++) {
+            int r = res.representant[res.classe[i]];
+            differences += executer_programme_64(f.progs[i], f.tailles[i], colonnes) !=
+                           executer_programme_64(f.progs[r], f.tailles[r], colonnes);
+        }
+    }
+    printf("Membres différents de leur représentant : %d\n", differences);
+
+    //Comparaison : chaque formule vérifiée exactement contre le représentant de chaque classe déjà trouvée
+    if (nb_naif > f.nb) nb_naif = f.nb;
+    int *representants = malloc(nb_naif * sizeof(int));
+    int nb_classes_naif = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < nb_naif; i++) {
+        int c = 0;
+        while (c < nb_classes_naif && !programmes_equivalents(f.progs[representants[c]], f.tailles[representants[c]],
+                                                              f.progs[i], f.tailles[i], NB_PROPS_TEST, NULL)) {
+            c++;
+        }
+        if (c == nb_classes_naif) representants[nb_classes_naif++] = i;
+    }
+    double naif = secondes_depuis(debut);
+    ClassesEquivalence sous_ensemble;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int n_sous_ensemble = classer_equivalences((const VMInstruction *const *)f.progs, f.tailles, nb_naif, NB_PROPS_TEST,
+                                               0, 1, &sous_ensemble, &statut);
+    double signatures = secondes_depuis(debut);
+    printf("\n%d formules, vérification exacte contre chaque classe : %d classe(s) en %8.1f ms\n", nb_naif,
+           nb_classes_naif, naif * 1e3);
+    printf("%d formules, signatures puis seaux                   : %d classe(s) en %8.1f ms\n", nb_naif,
+           n_sous_ensemble, signatures * 1e3);
+    liberer_classes_equivalence(&sous_ensemble);
+    free(representants);
+
+    liberer_classes_equivalence(&res);
+    liberer_formules(&f);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    test_petites();
+    test_grandes();
+    test_performances(2000, 10, 2000);
+
+    free_valid_props_memory();
+    return 0;
+}
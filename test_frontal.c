@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "arbreplat.c"
+#include "frontal.c"
+
+
+//Analyse en trois passages (liste de lexèmes, arbre syntaxique, analyse sémantique) vers un arbre plat
+//Retourne 0, ou -1 en cas d'erreur
+int analyser_trois_passages(const char *expression, ArbrePlat *arbre, Statut *statut) {
+    int r = -1;
+    char **lexemes = CreationListeLexeme(expression, statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, statut) : NULL;
+    liberer_lexemes(lexemes);
+    if (ast && analyseur_semantique(ast, statut) == 0) {
+        r = arbre_plat_depuis_ast(ast, arbre, statut);
+    }
+    freeAST(ast);
+    return r;
+}
+
+//Comparaison de deux arbres plats
+int arbres_plats_identiques(const ArbrePlat *a, const ArbrePlat *b) {
+    return a->nb_noeuds == b->nb_noeuds &&
+           memcmp(a->types, b->types, a->nb_noeuds) == 0 &&
+           memcmp(a->args, b->args, a->nb_noeuds * sizeof(uint32_t)) == 0;
+}
+
+//Test d'une expression : résultat de l'analyse en un passage, comparé à l'analyse en trois passages
+void test(const char *expression) {
+    ArbrePlat a, b;
+    Statut sa, sb;
+    arbre_plat_initialiser(&a);
+    arbre_plat_initialiser(&b);
+    int ra = analyser_formule(expression, &a, &sa);
+    int rb = analyser_trois_passages(expression, &b, &sb);
+    printf("%-40s ", expression);
+    if (ra == 0) {
+        printf("%u noeud(s)", a.nb_noeuds);
+    } else {
+        printf("erreur %d à l'octet %d : %s", sa.code, sa.position, sa.message);
+    }
+    printf(" [%s]\n", (ra == rb && (ra < 0 || arbres_plats_identiques(&a, &b))) ? "identique" : "DIFFERENT");
+    liberer_arbre_plat(&a);
+    liberer_arbre_plat(&b);
+}
+
+//Fonction écrivant une formule aléatoire dans texte (au plus nb_operateurs opérateurs),
+//avec des parenthèses et des espaces au hasard
+void ecrire_formule_aleatoire(char *texte, size_t *n, int nb_operateurs) {
+    static const char *props[] = {"p1", "p2", "p3"};
+    static const char *binaires[] = {"∧", "∨", "⇒", "→", "⇔", "⊕", "↑", "↓"};
+    static const char *espaces[] = {"", "", "", " ", "\t"};
+    if (nb_operateurs == 0) {
+        *n += sprintf(texte + *n, "%s%s", props[rand() % 3], espaces[rand() % 5]);
+        return;
+    }
+    int parentheses = rand() % 2;
+    if (parentheses) *n += sprintf(texte + *n, "(");
+    if (rand() % 4 == 0) {
+        *n += sprintf(texte + *n, "¬");
+        ecrire_formule_aleatoire(texte, n, nb_operateurs - 1);
+    } else {
+        int gauche = rand() % nb_operateurs;
+        ecrire_formule_aleatoire(texte, n, gauche);
+        *n += sprintf(texte + *n, "%s%s", binaires[rand() % 8], espaces[rand() % 5]);
+        ecrire_formule_aleatoire(texte, n, nb_operateurs - 1 - gauche);
+    }
+    if (parentheses) *n += sprintf(texte + *n, ")");
+}
+
+//Comparaison avec l'analyse en trois passages sur des formules aléatoires, puis sur des formules
+//abimées (un octet supprimé ou remplacé) pour comparer aussi les refus
+void test_aleatoire(int nb_formules) {
+    char texte[1024];
+    int differences = 0, refus = 0;
+    ArbrePlat a, b;
+    arbre_plat_initialiser(&a);
+    arbre_plat_initialiser(&b);
+    srand(3);
+    for (int f = 0; f < nb_formules; f++) {
+        size_t n = 0;
+        ecrire_formule_aleatoire(texte, &n, rand() % 20);
+        if (f % 2 == 1 && n > 1) {
+            size_t k = rand() % n;
+            if (rand() % 2) {
+                memmove(texte + k, texte + k + 1, n - k);
+                n--;
+            } else {
+                texte[k] = "()p4 ?"[rand() % 6];
+            }
+        }
+        Statut sa, sb;
+        int ra = analyser_formule(texte, &a, &sa);
+        int rb = analyser_trois_passages(texte, &b, &sb);
+        refus += ra < 0;
+        if (ra != rb || (ra == 0 && !arbres_plats_identiques(&a, &b))) {
+            if (differences++ < 5) printf("Différence : %s\n", texte);
+        }
+    }
+    printf("%d formules aléatoires (%d refusées) : %d différence(s)\n", nb_formules, refus, differences);
+    liberer_arbre_plat(&a);
+    liberer_arbre_plat(&b);
+}
+
+//Chaque opérateur natif coûte une seule instruction et donne le même résultat que sa forme développée
+void test_operateurs(void) {
+    static const char *formules[][2] = {
+        {"p1⇔p2", "(p1⇒p2)∧(p2⇒p1)"},
+        {"p1⊕p2", "(p1∧¬p2)∨(¬p1∧p2)"},
+        {"p1↑p2", "¬(p1∧p2)"},
+        {"p1↓p2", "¬(p1∨p2)"},
+        {"p1⇔p2⊕p3↑p1", "p1⇔(p2⊕(p3↑p1))"},
+        {"p1⇒p2⇔p2⇒p1", "(p1⇒p2)⇔(p2⇒p1)"},
+    };
+    //Les 8 valuations de p1, p2, p3
+    const uint64_t colonnes[] = {0xAA, 0xCC, 0xF0};
+    VMInstruction a[PROGRAM_SIZE], b[PROGRAM_SIZE];
+    printf("\n");
+    for (size_t k = 0; k < sizeof(formules) / sizeof(formules[0]); k++) {
+        int na = compiler_formule(formules[k][0], a, PROGRAM_SIZE, NULL);
+        int nb = compiler_formule(formules[k][1], b, PROGRAM_SIZE, NULL);
+        int identiques = na > 0 && nb > 0 &&
+                         (executer_programme_64(a, na, colonnes) & 0xFF) == (executer_programme_64(b, nb, colonnes) & 0xFF);
+        printf("%-16s %2d instruction(s), %-24s %2d instruction(s) [%s]\n",
+               formules[k][0], na, formules[k][1], nb, identiques ? "équivalentes" : "DIFFERENTES");
+    }
+}
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Comparaison des temps : une même formule analysée et compilée de nombreuses fois
+void test_performances(const char *expression, int repetitions) {
+    VMInstruction prog[PROGRAM_SIZE];
+    ArbrePlat arbre;
+    arbre_plat_initialiser(&arbre);
+    struct timespec debut;
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < repetitions; k++) {
+        char **lexemes = CreationListeLexeme(expression, NULL);
+        ASTNode *ast = analyseur_syntaxique(lexemes, NULL);
+        liberer_lexemes(lexemes);
+        analyseur_semantique(ast, NULL);
+        compiler_programme(ast, prog, PROGRAM_SIZE, NULL);
+        freeAST(ast);
+    }
+    double trois = secondes_depuis(debut);
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < repetitions; k++) {
+        analyser_formule(expression, &arbre, NULL);
+    }
+    double plat = secondes_depuis(debut);
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < repetitions; k++) {
+        compiler_formule(expression, prog, PROGRAM_SIZE, NULL);
+    }
+    double direct = secondes_depuis(debut);
+
+    printf("\n%d compilations de %s :\n", repetitions, expression);
+    printf("  trois passages : %.0f ns, un passage vers l'arbre plat : %.0f ns, un passage vers le programme : %.0f ns\n",
+           trois * 1e9 / repetitions, plat * 1e9 / repetitions, direct * 1e9 / repetitions);
+    liberer_arbre_plat(&arbre);
+}
+
+//Formule trop longue pour la liste de lexèmes : 300000 propositions reliées par ∧
+void test_longue_formule(void) {
+    int n = 300000;
+    char *texte = malloc(n * 6 + 1);
+    size_t taille = 0;
+    for (int i = 0; i < n; i++) {
+        taille += sprintf(texte + taille, i ? "∧p%d" : "p%d", 1 + i % 3);
+    }
+    ArbrePlat arbre;
+    Statut statut;
+    arbre_plat_initialiser(&arbre);
+    int r = analyser_formule(texte, &arbre, &statut);
+    printf("\nFormule de %d propositions : %s, %u noeuds\n", n, r == 0 ? "acceptée" : statut.message, arbre.nb_noeuds);
+
+    //Imbrication trop profonde : refusée sans débordement de la pile d'appels
+    taille = 0;
+    for (int i = 0; i < 50000; i++) taille += sprintf(texte + taille, "(");
+    sprintf(texte + taille, "p1");
+    r = analyser_formule(texte, &arbre, &statut);
+    printf("50000 parenthèses ouvrantes : %s\n", r == 0 ? "acceptée" : statut.message);
+    liberer_arbre_plat(&arbre);
+    free(texte);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+
+    printf("=== Analyse en un passage ===\n");
+    test("(p1⇒p2)→((¬p1)∨p2)");
+    test("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))");
+    test("p1⇒p2⇒p3");
+    test("¬¬(p1∧p2∨p3)");
+    test("   p1   ");
+    test("");
+    test("(p1⇒p2");
+    test("p1⇒p2)");
+    test("p1∧p4");
+    test("p1?p2");
+    test("(p1∧)");
+    test("p1⇔p2⊕p3↑¬p1↓p2");
+
+    printf("\n");
+    test_operateurs();
+    test_aleatoire(20000);
+    test_performances("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))", 200000);
+    test_longue_formule();
+
+    free_valid_props_memory();
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "cnf.c"
+#include "modeles.c"
+
+
+//Fonction de test : compte les modèles d'une expression et compare au nombre attendu
+//Parametre expression : chaine de caracteres
+//Parametre attendu : chaine de caracteres (nombre décimal)
+void test_expression(const char *expression, const char *attendu) {
+    char **lexemes = CreationListeLexeme(expression, NULL);
+    ASTNode *ast = analyseur_syntaxique(lexemes, NULL);
+    liberer_lexemes(lexemes);
+    GrandEntier n = count_models(ast, NULL);
+    char *texte = grand_entier_texte(&n);
+    printf("%s : %s modèle(s) %s\n", expression, texte, strcmp(texte, attendu) == 0 ? "OK" : "ERREUR");
+
+    mem_liberer(texte);
+    liberer_grand_entier(&n);
+    freeAST(ast);
+}
+
+//Fonction de test sur un arbre construit directement (formules à centaines de propositions)
+//L'arbre est libéré par la fonction
+void test_arbre(const char *description, ASTNode *ast, const char *attendu) {
+    clock_t debut = clock();
+    GrandEntier n = count_models(ast, NULL);
+    double duree = (double)(clock() - debut) / CLOCKS_PER_SEC;
+    char *texte = grand_entier_texte(&n);
+    printf("%s : %s modèle(s) en %.3f s %s\n", description, texte, duree, strcmp(texte, attendu) == 0 ? "OK" : "ERREUR");
+
+    mem_liberer(texte);
+    liberer_grand_entier(&n);
+    freeAST(ast);
+}
+
+//Proposition x<i>
+ASTNode *prop_numero(const char *prefixe, int i) {
+    char nom[32];
+    snprintf(nom, sizeof(nom), "%s%d", prefixe, i);
+    return createPropNode(nom);
+}
+
+//Evaluation directe d'un arbre dont les propositions sont nommées r0, r1, ...
+//Parametre valuation : bit i = valeur de ri
+int evaluer_arbre(ASTNode *n, unsigned valuation) {
+    switch (n->type) {
+        case NODE_PROP: return (valuation >> atoi(n->value + 1)) & 1;
+        case NODE_NOT: return !evaluer_arbre(n->right, valuation);
+        case NODE_AND: return evaluer_arbre(n->left, valuation) && evaluer_arbre(n->right, valuation);
+        case NODE_OR: return evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+        default: return !evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+    }
+}
+
+//Formule aléatoire de profondeur donnée sur les propositions r0 .. r(nb_props - 1)
+ASTNode *formule_aleatoire(int profondeur, int nb_props) {
+    if (profondeur == 0 || rand() % 5 == 0) return prop_numero("r", rand() % nb_props);
+    int choix = rand() % 4;
+    if (choix == 0) return createOpNode(NODE_NOT, NULL, formule_aleatoire(profondeur - 1, nb_props));
+    NodeType types[] = {NODE_AND, NODE_OR, NODE_IMP};
+    return createOpNode(types[choix - 1], formule_aleatoire(profondeur - 1, nb_props), formule_aleatoire(profondeur - 1, nb_props));
+}
+
+//Comparaison avec une énumération de toutes les valuations sur des formules aléatoires
+//Les propositions absentes de la formule ne sont pas comptées : on divise par 2 pour chacune
+void test_aleatoire(int nb_formules, int nb_props) {
+    int erreurs = 0;
+    srand(7);
+    for (int f = 0; f < nb_formules; f++) {
+        ASTNode *ast = formule_aleatoire(8, nb_props);
+        unsigned long long attendu = 0;
+        for (unsigned v = 0; v < (1u << nb_props); v++) {
+            attendu += evaluer_arbre(ast, v);
+        }
+        //Propositions présentes dans l'arbre
+        unsigned presentes = 0;
+        ASTNode *pile[4096];
+        int sommet = 0;
+        pile[sommet++] = ast;
+        while (sommet > 0) {
+            ASTNode *n = pile[--sommet];
+            if (n->type == NODE_PROP) presentes |= 1u << atoi(n->value + 1);
+            if (n->left) pile[sommet++] = n->left;
+            if (n->right) pile[sommet++] = n->right;
+        }
+        attendu >>= nb_props - __builtin_popcount(presentes);
+
+        GrandEntier n = count_models(ast, NULL);
+        char *texte = grand_entier_texte(&n);
+        if (strtoull(texte, NULL, 10) != attendu) erreurs++;
+        mem_liberer(texte);
+        liberer_grand_entier(&n);
+        freeAST(ast);
+    }
+    printf("%d formules aléatoires sur %d propositions : %d erreur(s)\n", nb_formules, nb_props, erreurs);
+}
+
+//Comptage sous des budgets mémoire croissants : chaque comptage donne le même nombre que sans budget,
+//ou échoue avec ERR_MEMOIRE sans laisser de mémoire allouée
+void test_budget(int nb_formules, int nb_props) {
+    ASTNode **formules = malloc(nb_formules * sizeof(ASTNode *));
+    char **attendus = malloc(nb_formules * sizeof(char *));
+    srand(11);
+    for (int f = 0; f < nb_formules; f++) {
+        formules[f] = formule_aleatoire(8, nb_props);
+        GrandEntier n = count_models(formules[f], NULL);
+        attendus[f] = grand_entier_texte(&n);
+        liberer_grand_entier(&n);
+    }
+
+    printf("\n=== Budget mémoire : %d formules sur %d propositions ===\n", nb_formules, nb_props);
+    for (size_t budget = 1024; budget <= 4 * 1024 * 1024; budget *= 8) {
+        AllocateurSuivi suivi;
+        suivi_initialiser(&suivi, NULL, budget);
+        Allocateur *precedent = utiliser_allocateur(&suivi.base);
+        int refus = 0, mauvais_statuts = 0, differences = 0;
+        for (int f = 0; f < nb_formules; f++) {
+            Statut statut;
+            GrandEntier n = count_models(formules[f], &statut);
+            char *texte = statut.code == ERR_AUCUNE ? grand_entier_texte(&n) : NULL;
+            if (statut.code != ERR_AUCUNE || !texte) {
+                refus++;
+                if ((statut.code != ERR_AUCUNE && statut.code != ERR_MEMOIRE) || n.taille != 0) mauvais_statuts++;
+            } else if (strcmp(texte, attendus[f]) != 0) {
+                differences++;
+            }
+            mem_liberer(texte);
+            liberer_grand_entier(&n);
+        }
+        utiliser_allocateur(precedent);
+        printf("Budget %7zu octets : %3d comptage(s) refusé(s), %d mauvais statut(s), %d résultat(s) différent(s), "
+               "%zu octets vivants après\n",
+               budget, refus, mauvais_statuts, differences, suivi.total.vivants);
+    }
+    for (int f = 0; f < nb_formules; f++) {
+        mem_liberer(attendus[f]);
+        freeAST(formules[f]);
+    }
+    free(formules);
+    free(attendus);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+
+    printf("\n=== Comptage de modèles ===\n");
+    test_expression("p1∧p2", "1");
+    test_expression("p1∨p2", "3");
+    test_expression("p1⇒p2", "3");
+    test_expression("¬p1", "1");
+    test_expression("p1∧(¬p1)", "0");
+    test_expression("(p1⇒p2)→((¬p1)∨p2)", "4");
+    test_expression("(p1∨(p2∧p3))→((p1∨p2)∧(p1∨p3))", "8");
+    test_expression("(p1∨p2)∧(p2∨p3)∧(p3∨p4)", "8");
+    test_expression("(p1∧p2)∨(p3∧p4)∨(p5∧p6)", "37");
+
+    test_aleatoire(300, 12);
+    test_budget(100, 20);
+
+    printf("\n=== Formules à centaines de propositions ===\n");
+
+    //Chaine (x1 ∨ x2) ∧ (x2 ∨ x3) ∧ ... ∧ (x299 ∨ x300) : Fibonacci(302) modèles
+    ASTNode *chaine = createOpNode(NODE_OR, prop_numero("x", 1), prop_numero("x", 2));
+    for (int i = 2; i < 300; i++) {
+        chaine = createOpNode(NODE_AND, chaine, createOpNode(NODE_OR, prop_numero("x", i), prop_numero("x", i + 1)));
+    }
+    test_arbre("Chaine de 300 propositions", chaine,
+               "581811569836004006491505558634099066259034153405766997246569401");
+
+    //100 composantes indépendantes (a_i ∨ b_i) : 3^100 modèles
+    ASTNode *independantes = createOpNode(NODE_OR, prop_numero("a", 1), prop_numero("b", 1));
+    for (int i = 2; i <= 100; i++) {
+        independantes = createOpNode(NODE_AND, independantes, createOpNode(NODE_OR, prop_numero("a", i), prop_numero("b", i)));
+    }
+    test_arbre("100 composantes indépendantes", independantes, "515377520732011331036461129765621272702107522001");
+
+    //Implications en chaine x1 ⇒ x2 ⇒ ... (associativité à droite) sur 200 propositions, niée
+    ASTNode *implications = prop_numero("y", 200);
+    for (int i = 199; i >= 1; i--) {
+        implications = createOpNode(NODE_IMP, prop_numero("y", i), implications);
+    }
+    test_arbre("Négation de y1 ⇒ (y2 ⇒ ... y200)", createOpNode(NODE_NOT, NULL, implications), "1");
+
+    return 0;
+}
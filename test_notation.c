@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "registres.c"
+#include "notation.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p24)
+#define NB_PROPS_TEST 24
+
+#define CHEMIN_ENTREE "/tmp/test_notation_entree.col"
+#define CHEMIN_SORTIE "/tmp/test_notation_sortie.col"
+#define CHEMIN_SORTIE_1 "/tmp/test_notation_sortie1.col"
+
+static const char *formules_test[] = {
+    "p1∧p2",
+    "(p1⇒p2)→((¬p1)∨p2)",
+    "p3⇔p4⊕p5↑¬p6↓p7∧p8∨p9",
+    "¬(p10∧(p11∨¬p12))⇒(p13↓p14)",
+    "(p15∨p16)∧(p17∨p18)∧(p19∨p20)∧(p21∨p22)",
+    "(p23⊕p24)∨(p1∧p24)∨¬(p12⇔p13)",
+    "p5∧¬p5"
+};
+#define NB_FORMULES_TEST 7
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Fonction compilant une formule en programme de la machine virtuelle
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_chaine(const char *chaine, VMInstruction *prog, int capacite) {
+    Statut statut;
+    char **lexemes = CreationListeLexeme(chaine, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int n = -1;
+    if (ast && analyseur_semantique(ast, &statut) == 0) {
+        n = compiler_programme(ast, prog, capacite, &statut);
+    }
+    if (n < 0) printf("%s : erreur %s\n", chaine, statut.message);
+    freeAST(ast);
+    return n;
+}
+
+//Fonction écrivant un fichier d'entrée de valeurs aléatoires
+//Retourne 0, ou -1 en cas d'erreur
+int ecrire_entree_aleatoire(const char *chemin, uint32_t nb_colonnes, uint64_t nb_enregistrements) {
+    FichierColonnes f;
+    Statut statut;
+    if (creer_colonnes(chemin, nb_colonnes, nb_enregistrements, &f, &statut) < 0) {
+        printf("%s\n", statut.message);
+        return -1;
+    }
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (uint32_t c = 0; c < nb_colonnes; c++) {
+        uint64_t *colonne = colonne_fichier(&f, c);
+        for (uint64_t w = 0; w < f.mots_par_colonne; w++) {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            colonne[w] = x;
+        }
+        if (nb_enregistrements % 64) colonne[f.mots_par_colonne - 1] &= (1ULL << (nb_enregistrements % 64)) - 1;
+    }
+    fermer_colonnes(&f);
+    return 0;
+}
+
+//Vérification de chaque mot de résultat avec la machine à pile
+//Retourne le nombre de mots différents
+uint64_t verifier_resultats(const FichierColonnes *entree, const FichierColonnes *sortie, VMInstruction **progs,
+                            const int *tailles, int nb_formules) {
+    uint64_t differences = 0;
+    uint64_t colonnes[NB_PROPS_TEST];
+    uint64_t masque = entree->nb_enregistrements % 64 ? (1ULL << (entree->nb_enregistrements % 64)) - 1 : ~0ULL;
+    for (uint64_t w = 0; w < entree->mots_par_colonne; w++) {
+        for (uint32_t c = 0; c < entree->nb_colonnes && c < NB_PROPS_TEST; c++) {
+            colonnes[c] = colonne_fichier(entree, c)[w];
+        }
+        for (int f = 0; f < nb_formules; f++) {
+            uint64_t attendu = executer_programme_64(progs[f], tailles[f], colonnes);
+            if (w == entree->mots_par_colonne - 1) attendu &= masque;
+            differences += colonne_fichier(sortie, (uint32_t)f)[w] != attendu;
+        }
+    }
+    return differences;
+}
+
+//Fichiers invalides et propositions sans colonne
+void test_fichiers(VMInstruction **progs, const int *tailles) {
+    printf("=== Fichiers ===\n");
+    Statut statut;
+    FichierColonnes f;
+    int r = ouvrir_colonnes("/tmp/test_notation_absent.col", &f, &statut);
+    printf("Fichier absent : %d (%s, code %d)\n", r, r < 0 ? statut.message : "ouvert", statut.code);
+
+    FILE *fichier = fopen("/tmp/test_notation_invalide.col", "wb");
+    if (fichier) {
+        EnteteColonnes entete = {MAGIE_COLONNES, 2, 0, 1000, 16};
+        fwrite(&entete, sizeof(entete), 1, fichier);
+        fclose(fichier);
+    }
+    r = ouvrir_colonnes("/tmp/test_notation_invalide.col", &f, &statut);
+    printf("Colonnes absentes du fichier : %d (%s, code %d)\n", r, r < 0 ? statut.message : "ouvert", statut.code);
+    remove("/tmp/test_notation_invalide.col");
+
+    //Entrée de 4 colonnes : p5 (colonne 4) n'a pas de valeurs
+    ecrire_entree_aleatoire("/tmp/test_notation_petit.col", 4, 1000);
+    RapportNotation rapport;
+    const VMInstruction *deux[2] = {progs[0], progs[2]};
+    int tailles_deux[2] = {tailles[0], tailles[2]};
+    r = noter_fichier("/tmp/test_notation_petit.col", CHEMIN_SORTIE, deux, tailles_deux, 2, 1, &rapport, &statut);
+    printf("Formule sur p5 avec 4 colonnes : %d (%s), fichier de résultats %s\n", r,
+           r < 0 ? statut.message : "notée", access(CHEMIN_SORTIE, F_OK) == 0 ? "présent" : "supprimé");
+    r = noter_fichier("/tmp/test_notation_petit.col", CHEMIN_SORTIE, deux, tailles_deux, 1, 1, &rapport, &statut);
+    printf("Formule sur p1, p2 avec 4 colonnes : %d (%s)\n", r, r < 0 ? statut.message : "notée");
+
+    //Fichier de résultats d'un autre nombre d'enregistrements
+    FichierColonnes entree, sortie;
+    if (ouvrir_colonnes("/tmp/test_notation_petit.col", &entree, &statut) == 0 &&
+        creer_colonnes(CHEMIN_SORTIE, 1, 999, &sortie, &statut) == 0) {
+        r = noter_colonnes(&entree, &sortie, deux, tailles_deux, 1, 1, &rapport, &statut);
+        printf("Résultats de 999 enregistrements pour 1000 : %d (%s, code %d)\n", r,
+               r < 0 ? statut.message : "notée", statut.code);
+        fermer_colonnes(&sortie);
+    }
+    fermer_colonnes(&entree);
+    remove("/tmp/test_notation_petit.col");
+    remove(CHEMIN_SORTIE);
+}
+
+//Notation d'un grand fichier avec 1 et 4 threads, vérification complète
+void test_notation(VMInstruction **progs, const int *tailles, uint64_t nb_enregistrements) {
+    printf("\n=== Notation de %lu enregistrements, %d formules ===\n", (unsigned long)nb_enregistrements,
+           NB_FORMULES_TEST);
+    if (ecrire_entree_aleatoire(CHEMIN_ENTREE, NB_PROPS_TEST, nb_enregistrements) < 0) return;
+    Statut statut;
+    RapportNotation rapport;
+    const VMInstruction *const *ps = (const VMInstruction *const *)progs;
+    const char *chemins[2] = {CHEMIN_SORTIE_1, CHEMIN_SORTIE};
+    int threads[2] = {1, 4};
+    for (int essai = 0; essai < 2; essai++) {
+        if (noter_fichier(CHEMIN_ENTREE, chemins[essai], ps, tailles, NB_FORMULES_TEST, threads[essai], &rapport,
+                          &statut) < 0) {
+            printf("erreur : %s\n", statut.message);
+            return;
+        }
+        printf("%d thread(s), %lu mots par bloc, %d colonnes lues : %.3f s, %.1f millions d'enregistrements/s\n",
+               rapport.nb_threads, (unsigned long)rapport.mots_par_bloc, rapport.nb_props_utilisees, rapport.secondes,
+               rapport.enregistrements_par_seconde / 1e6);
+    }
+
+    FichierColonnes entree, sortie, sortie_1;
+    if (ouvrir_colonnes(CHEMIN_ENTREE, &entree, &statut) < 0 || ouvrir_colonnes(CHEMIN_SORTIE, &sortie, &statut) < 0 ||
+        ouvrir_colonnes(CHEMIN_SORTIE_1, &sortie_1, &statut) < 0) {
+        printf("erreur : %s\n", statut.message);
+        return;
+    }
+    printf("Mots différents de la machine à pile : %lu\n",
+           (unsigned long)verifier_resultats(&entree, &sortie, progs, tailles, NB_FORMULES_TEST));
+    printf("Résultats identiques avec 1 thread : %s\n",
+           sortie.taille_image == sortie_1.taille_image &&
+                   memcmp(sortie.image, sortie_1.image, sortie.taille_image) == 0 ? "oui" : "NON");
+    for (int f = 0; f < NB_FORMULES_TEST; f++) {
+        uint64_t vrais = 0;
+        for (uint64_t w = 0; w < sortie.mots_par_colonne; w++) {
+            vrais += __builtin_popcountll(colonne_fichier(&sortie, (uint32_t)f)[w]);
+        }
+        printf("  %8lu vrais  %s\n", (unsigned long)vrais, formules_test[f]);
+    }
+
+    //Comparaison : un enregistrement à la fois, valeurs décodées puis execute_program pour chaque formule
+    uint64_t nb_base = nb_enregistrements < 200000 ? nb_enregistrements : 200000;
+    int valeurs[NB_PROPS_TEST];
+    uint64_t differences = 0;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int f = 0; f < NB_FORMULES_TEST; f++) {
+        reinitialiser_machine();
+        for (int i = 0; i < tailles[f]; i++) add_instruction(progs[f][i].opcode, progs[f][i].operand);
+        for (uint64_t e = 0; e < nb_base; e++) {
+            for (int k = 0; k < NB_PROPS_TEST; k++) {
+                valeurs[k] = (colonne_fichier(&entree, (uint32_t)k)[e / 64] >> (e % 64) & 1) ? -1 : 0;
+            }
+            int r = 0;
+            definir_valeurs_propositions(valeurs);
+            execute_program(NULL);
+            vm_pop(&r);
+            differences += (r != 0) != (int)(colonne_fichier(&sortie, (uint32_t)f)[e / 64] >> (e % 64) & 1);
+        }
+    }
+    double temps_base = secondes_depuis(debut);
+    reinitialiser_machine();
+    printf("Un enregistrement à la fois (%lu enregistrements) : %.2f millions d'enregistrements/s, %lu différence(s)\n",
+           (unsigned long)nb_base, nb_base / temps_base / 1e6, (unsigned long)differences);
+
+    fermer_colonnes(&entree);
+    fermer_colonnes(&sortie);
+    fermer_colonnes(&sortie_1);
+    remove(CHEMIN_ENTREE);
+    remove(CHEMIN_SORTIE);
+    remove(CHEMIN_SORTIE_1);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    VMInstruction *progs[NB_FORMULES_TEST];
+    int tailles[NB_FORMULES_TEST];
+    for (int f = 0; f < NB_FORMULES_TEST; f++) {
+        progs[f] = malloc(PROGRAM_SIZE * sizeof(VMInstruction));
+        tailles[f] = compiler_chaine(formules_test[f], progs[f], PROGRAM_SIZE);
+        if (tailles[f] < 0) return 1;
+    }
+
+    test_fichiers(progs, tailles);
+    test_notation(progs, tailles, 1000003);
+    test_notation(progs, tailles, 16000037);
+
+    for (int f = 0; f < NB_FORMULES_TEST; f++) free(progs[f]);
+    free_valid_props_memory();
+    return 0;
+}
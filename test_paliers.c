@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "paliers.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p12)
+#define NB_PROPS_TEST 12
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Valeurs aléatoires des colonnes
+void colonnes_aleatoires(uint64_t *colonnes) {
+    for (int i = 0; i < NB_PROPS_TEST; i++) {
+        colonnes[i] = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+    }
+}
+
+//Fonction écrivant une formule aléatoire d'au plus nb_operateurs opérateurs (tous les opérateurs)
+void ecrire_formule_aleatoire(char *texte, size_t *n, int nb_operateurs) {
+    static const char *binaires[] = {"∧", "∨", "⇒", "→", "⇔", "⊕", "↑", "↓"};
+    if (nb_operateurs == 0) {
+        *n += sprintf(texte + *n, "p%d", 1 + rand() % NB_PROPS_TEST);
+        return;
+    }
+    *n += sprintf(texte + *n, "(");
+    if (rand() % 3 == 0) {
+        *n += sprintf(texte + *n, "¬");
+        ecrire_formule_aleatoire(texte, n, nb_operateurs - 1);
+    } else {
+        int gauche = rand() % nb_operateurs;
+        ecrire_formule_aleatoire(texte, n, gauche);
+        *n += sprintf(texte + *n, "%s", binaires[rand() % 8]);
+        ecrire_formule_aleatoire(texte, n, nb_operateurs - 1 - gauche);
+    }
+    *n += sprintf(texte + *n, ")");
+}
+
+//Test d'une expression : taille du code de chaque palier et résultats identiques
+void test_expression(const char *expression) {
+    FormulePaliers f;
+    Statut statut;
+    if (formule_paliers_depuis_chaine(&f, expression, &statut) < 0) {
+        printf("%-30s erreur : %s\n", expression, statut.message);
+        return;
+    }
+    uint64_t colonnes[NB_PROPS_TEST];
+    colonnes_aleatoires(colonnes);
+    uint64_t r0 = evaluer_ast_64(f.ast, colonnes);
+    promouvoir_bytecode(&f, NULL);
+    int taille_prog = f.taille_prog;
+    uint64_t r1 = executer_programme_64(f.prog, f.taille_prog, colonnes);
+    promouvoir_superinstructions(&f, NULL);
+    uint64_t r2 = executer_superinstructions_64(f.sup, f.taille_sup, colonnes);
+    printf("%-30s %2d instruction(s), %2d superinstruction(s) [%s]\n", expression, taille_prog, f.taille_sup,
+           (r0 == r1 && r1 == r2) ? "identiques" : "DIFFERENTS");
+    liberer_formule_paliers(&f);
+}
+
+//Comparaison des trois paliers sur des formules aléatoires, et promotions au fil des évaluations
+void test_aleatoire(int nb_formules) {
+    char texte[4096];
+    uint64_t colonnes[NB_PROPS_TEST];
+    int differences = 0, promotions = 0;
+    srand(5);
+    for (int k = 0; k < nb_formules; k++) {
+        size_t n = 0;
+        ecrire_formule_aleatoire(texte, &n, 1 + rand() % 20);
+        FormulePaliers f;
+        if (formule_paliers_depuis_chaine(&f, texte, NULL) < 0) {
+            differences++;
+            continue;
+        }
+        f.seuil_bytecode = 2;
+        f.seuil_superinstructions = 5;
+        for (int e = 0; e < 8; e++) {
+            colonnes_aleatoires(colonnes);
+            uint64_t attendu = evaluer_ast_64(f.ast, colonnes);
+            if (evaluer_paliers_64(&f, colonnes) != attendu) differences++;
+        }
+        promotions += f.palier == PALIER_SUPERINSTRUCTIONS;
+        liberer_formule_paliers(&f);
+    }
+    printf("\n%d formules aléatoires : %d différence(s), %d promue(s) jusqu'aux superinstructions\n",
+           nb_formules, differences, promotions);
+}
+
+//Charge mixte : beaucoup de formules évaluées quelques fois, quelques formules évaluées très souvent.
+//Le temps compte les évaluations et les compilations, pas l'analyse des chaines (commune à tous).
+//Parametre seuil_bytecode, seuil_superinstructions : seuils imposés à toutes les formules
+double charge_mixte(FormulePaliers *formules, const int *nb_evaluations, int nb_formules,
+                    unsigned long seuil_bytecode, unsigned long seuil_superinstructions, uint64_t *total) {
+    uint64_t colonnes[NB_PROPS_TEST];
+    srand(17);
+    colonnes_aleatoires(colonnes);
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int k = 0; k < nb_formules; k++) {
+        FormulePaliers *f = &formules[k];
+        f->seuil_bytecode = seuil_bytecode;
+        f->seuil_superinstructions = seuil_superinstructions;
+        for (int e = 0; e < nb_evaluations[k]; e++) {
+            colonnes[e % NB_PROPS_TEST] += 0x9E3779B97F4A7C15ULL;
+            *total += evaluer_paliers_64(f, colonnes);
+        }
+    }
+    return secondes_depuis(debut);
+}
+
+//Comparaison des stratégies sur la même charge mixte
+void test_performances(int nb_formules) {
+    char texte[4096];
+    char **chaines = malloc(nb_formules * sizeof(char *));
+    int *nb_evaluations = malloc(nb_formules * sizeof(int));
+    FormulePaliers *formules = malloc(nb_formules * sizeof(FormulePaliers));
+    long total_evaluations = 0;
+    srand(11);
+    for (int k = 0; k < nb_formules; k++) {
+        size_t n = 0;
+        ecrire_formule_aleatoire(texte, &n, 5 + rand() % 15);
+        chaines[k] = strdup(texte);
+        //90 % de formules froides (1 à 3 évaluations), 10 % de formules chaudes (2000 évaluations)
+        nb_evaluations[k] = (rand() % 10 == 0) ? 2000 : 1 + rand() % 3;
+        total_evaluations += nb_evaluations[k];
+    }
+
+    static const struct {
+        const char *nom;
+        unsigned long seuil_bytecode, seuil_superinstructions;
+    } strategies[] = {
+        {"arbre seulement", (unsigned long)-1, (unsigned long)-1},
+        {"bytecode dès la création", 0, (unsigned long)-1},
+        {"superinstructions dès la création", (unsigned long)-1, 0},
+        {"paliers (seuils par défaut)", SEUIL_BYTECODE, SEUIL_SUPERINSTRUCTIONS},
+    };
+    printf("\nCharge mixte : %d formules, %ld évaluations de 64 valuations\n", nb_formules, total_evaluations);
+    uint64_t reference = 0;
+    for (size_t s = 0; s < sizeof(strategies) / sizeof(strategies[0]); s++) {
+        for (int k = 0; k < nb_formules; k++) formule_paliers_depuis_chaine(&formules[k], chaines[k], NULL);
+        uint64_t total = 0;
+        double t = charge_mixte(formules, nb_evaluations, nb_formules,
+                                strategies[s].seuil_bytecode, strategies[s].seuil_superinstructions, &total);
+        if (s == 0) reference = total;
+        printf("  %-36s %.3f s, %.0f ns par évaluation%s\n", strategies[s].nom, t,
+               t * 1e9 / total_evaluations, total == reference ? "" : " (RESULTATS DIFFERENTS)");
+        for (int k = 0; k < nb_formules; k++) liberer_formule_paliers(&formules[k]);
+    }
+
+    for (int k = 0; k < nb_formules; k++) free(chaines[k]);
+    free(chaines);
+    free(nb_evaluations);
+    free(formules);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    printf("=== Paliers d'exécution ===\n");
+    test_expression("(p1∧¬p2)∨¬p3");
+    test_expression("(p1⇒p2)→((¬p1)∨p2)");
+    test_expression("¬¬(p1∧p2∨p3)");
+    test_expression("p1⇔p2⊕p3↑¬p1↓p2");
+    test_expression("((p1∨p2)∧(p3∨p4))⇒¬((p5∧p6)∨(p7∧p8))");
+    test_expression("p1");
+
+    test_aleatoire(5000);
+    test_performances(20000);
+
+    free_valid_props_memory();
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "registres.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p24)
+#define NB_PROPS_TEST 24
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Valeurs aléatoires des colonnes
+void colonnes_aleatoires(uint64_t *colonnes) {
+    for (int i = 0; i < NB_PROPS_TEST; i++) {
+        colonnes[i] = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+    }
+}
+
+//Fonction compilant une formule en programme de la machine virtuelle
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_chaine(const char *chaine, VMInstruction *prog, int capacite) {
+    Statut statut;
+    char **lexemes = CreationListeLexeme(chaine, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int n = -1;
+    if (ast && analyseur_semantique(ast, &statut) == 0) {
+        n = compiler_programme(ast, prog, capacite, &statut);
+    }
+    if (n < 0) printf("%s : erreur %s\n", chaine, statut.message);
+    freeAST(ast);
+    return n;
+}
+
+//Comparaison des deux machines sur 64 * 64 valuations aléatoires
+//Retourne le nombre de mots différents
+int comparer_machines(const VMInstruction *prog, int taille, const ProgrammeRegistres *p) {
+    uint64_t colonnes[NB_PROPS_TEST];
+    int differences = 0;
+    for (int essai = 0; essai < 64; essai++) {
+        colonnes_aleatoires(colonnes);
+        differences += executer_programme_64(prog, taille, colonnes) != executer_registres_64(p, colonnes);
+    }
+    return differences;
+}
+
+//Test d'une expression : taille des deux codes et résultats identiques
+void test_expression(const char *expression) {
+    VMInstruction prog[PROGRAM_SIZE];
+    int taille = compiler_chaine(expression, prog, PROGRAM_SIZE);
+    ProgrammeRegistres p;
+    Statut statut;
+    if (taille < 0) return;
+    if (compiler_registres(prog, taille, &p, &statut) < 0) {
+        printf("erreur : %s  %s\n", statut.message, expression);
+        return;
+    }
+    printf("pile %3d, registres %3d instruction(s), %2d registre(s), %d partage(s) : %s  %s\n", taille, p.taille,
+           p.nb_registres, p.partages, comparer_machines(prog, taille, &p) ? "ERREUR" : "ok", expression);
+    liberer_programme_registres(&p);
+}
+
+
+// ----------------------
+/*
+Règles longues construites directement en arbres syntaxiques (sans la limite de lexèmes de
+l'analyse lexicale). Les règles partagées réutilisent des sous-formules d'une réserve commune.
+*/
+// ----------------------
+
+static const NodeType binaires_test[] = {NODE_AND, NODE_OR, NODE_IMP, NODE_PROD, NODE_EQUIV, NODE_XOR, NODE_NAND,
+                                         NODE_NOR};
+
+ASTNode *copier_arbre(const ASTNode *n) {
+    if (!n) return NULL;
+    if (n->type == NODE_PROP) return createPropNode(n->value);
+    return createOpNode(n->type, copier_arbre(n->left), copier_arbre(n->right));
+}
+
+//Arbre aléatoire de la profondeur donnée ; les feuilles sont des propositions, ou des copies de
+//sous-formules de la réserve si nb_reserve > 0
+ASTNode *arbre_aleatoire(int profondeur, ASTNode **reserve, int nb_reserve) {
+    if (profondeur == 0) {
+        if (nb_reserve > 0) return copier_arbre(reserve[rand() % nb_reserve]);
+        char nom[16];
+        snprintf(nom, sizeof(nom), "p%d", 1 + rand() % NB_PROPS_TEST);
+        return createPropNode(nom);
+    }
+    if (rand() % 6 == 0) return createOpNode(NODE_NOT, NULL, arbre_aleatoire(profondeur - 1, reserve, nb_reserve));
+    return createOpNode(binaires_test[rand() % 8], arbre_aleatoire(profondeur - 1, reserve, nb_reserve),
+                        arbre_aleatoire(profondeur - 1, reserve, nb_reserve));
+}
+
+//Mesure des deux machines sur nb_regles règles
+void test_performances(const char *titre, int nb_regles, int partagees, int nb_evaluations) {
+    VMInstruction **progs = malloc(nb_regles * sizeof(VMInstruction *));
+    int *tailles = malloc(nb_regles * sizeof(int));
+    ProgrammeRegistres *regs = malloc(nb_regles * sizeof(ProgrammeRegistres));
+    ASTNode *reserve[12];
+    long instructions_pile = 0, instructions_registres = 0, partages = 0;
+    int differences = 0, max_registres = 0;
+    for (int i = 0; i < 12; i++) reserve[i] = arbre_aleatoire(3, NULL, 0);
+    for (int r = 0; r < nb_regles; r++) {
+        ASTNode *ast = partagees ? arbre_aleatoire(4, reserve, 12) : arbre_aleatoire(7, NULL, 0);
+        progs[r] = malloc(PROGRAM_SIZE * sizeof(VMInstruction));
+        tailles[r] = compiler_programme(ast, progs[r], PROGRAM_SIZE, NULL);
+        freeAST(ast);
+        if (tailles[r] < 0 || compiler_registres(progs[r], tailles[r], &regs[r], NULL) < 0) {
+            printf("Règle %d refusée\n", r);
+            exit(EXIT_FAILURE);
+        }
+        instructions_pile += tailles[r];
+        instructions_registres += regs[r].taille;
+        partages += regs[r].partages;
+        if (regs[r].nb_registres > max_registres) max_registres = regs[r].nb_registres;
+        differences += comparer_machines(progs[r], tailles[r], &regs[r]);
+    }
+    for (int i = 0; i < 12; i++) freeAST(reserve[i]);
+
+    uint64_t colonnes[16][NB_PROPS_TEST];
+    for (int c = 0; c < 16; c++) colonnes_aleatoires(colonnes[c]);
+    struct timespec debut;
+    uint64_t somme_pile = 0, somme_registres = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        for (int r = 0; r < nb_regles; r++) somme_pile += executer_programme_64(progs[r], tailles[r], colonnes[e & 15]);
+    }
+    double temps_pile = secondes_depuis(debut);
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        for (int r = 0; r < nb_regles; r++) somme_registres += executer_registres_64(&regs[r], colonnes[e & 15]);
+    }
+    double temps_registres = secondes_depuis(debut);
+
+    long nb = (long)nb_regles * nb_evaluations;
+    printf("\n=== %s : %d règles, %d évaluations de 64 valuations ===\n", titre, nb_regles, nb_evaluations);
+    printf("Instructions par règle : pile %.1f, registres %.1f (%.1f sous-formules partagées, au plus %d registres)\n",
+           (double)instructions_pile / nb_regles, (double)instructions_registres / nb_regles,
+           (double)partages / nb_regles, max_registres);
+    printf("  machine à pile        %7.1f ns par règle\n", temps_pile * 1e9 / nb);
+    printf("  machine à registres   %7.1f ns par règle (x%.2f) [%s]\n", temps_registres * 1e9 / nb,
+           temps_pile / temps_registres, somme_pile == somme_registres && !differences ? "mêmes résultats" : "ERREUR");
+
+    for (int r = 0; r < nb_regles; r++) {
+        free(progs[r]);
+        liberer_programme_registres(&regs[r]);
+    }
+    free(progs);
+    free(tailles);
+    free(regs);
+}
+
+//Cas particuliers du code généré
+void test_limites(void) {
+    printf("\n=== Limites ===\n");
+    //Constantes et programme avec POP (seul le sommet final compte)
+    VMInstruction constantes[] = {{VM_PUSH, 1}, {VM_LOAD, 0}, {VM_AND, 0}, {VM_PUSH, 0}, {VM_OR, 0},
+                                  {VM_LOAD, 1}, {VM_POP, 0}, {VM_NOT, 0}};
+    ProgrammeRegistres p;
+    Statut statut;
+    if (compiler_registres(constantes, 8, &p, &statut) == 0) {
+        printf("¬((1∧p1)∨0) : %d instruction(s), %s\n", p.taille, comparer_machines(constantes, 8, &p) ? "ERREUR" : "ok");
+        liberer_programme_registres(&p);
+    }
+    //Programme refusé
+    VMInstruction mauvais[] = {{VM_AND, 0}};
+    int r = compiler_registres(mauvais, 1, &p, &statut);
+    printf("Programme refusé : %d (%s)\n", r, r < 0 ? statut.message : "accepté");
+    //Plus de MAX_REGISTRES valeurs vivantes : 276 sous-formules pi∧pj combinées une première fois,
+    //puis une seconde fois, elles restent toutes en registre entre les deux (la pile ne dépasse pas 3)
+    int taille = 0;
+    VMInstruction *long_prog = malloc(4 * 2 * 276 * sizeof(VMInstruction));
+    for (int passe = 0; passe < 2; passe++) {
+        int termes = 0;
+        for (int i = 0; i < NB_PROPS_TEST; i++) {
+            for (int j = i + 1; j < NB_PROPS_TEST; j++) {
+                long_prog[taille++] = (VMInstruction){VM_LOAD, i};
+                long_prog[taille++] = (VMInstruction){VM_LOAD, j};
+                long_prog[taille++] = (VMInstruction){VM_AND, 0};
+                if (termes++ > 0) long_prog[taille++] = (VMInstruction){passe ? VM_OR : VM_XOR, 0};
+            }
+        }
+    }
+    long_prog[taille++] = (VMInstruction){VM_AND, 0};
+    r = compiler_registres(long_prog, taille, &p, &statut);
+    printf("276 sous-formules vivantes : %d (%s)\n", r, r < 0 ? statut.message : "accepté");
+    if (r == 0) liberer_programme_registres(&p);
+    free(long_prog);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    printf("=== Code à trois adresses ===\n");
+    test_expression("p1");
+    test_expression("¬¬p1");
+    test_expression("p1∧¬p1");
+    test_expression("(p1∧¬p2)∨¬p3");
+    test_expression("p1↑p2");
+    test_expression("p1⇔p2⊕p3↑¬p4↓p5∧p6∨p7");
+    test_expression("(p1∧p2⇒p3)∧(p4∨(p1∧p2⇒p3))∧¬(p1∧p2⇒p3)");
+    test_expression("(p1∧p2)∨(p2∧p1)∨¬(¬p1∨¬p2)");
+    test_expression("(p1⊕p2)∧(p1⇔p2)");
+
+    srand(11);
+    test_limites();
+    test_performances("Règles sans sous-formules communes", 200, 0, 20000);
+    test_performances("Règles avec sous-formules communes", 200, 1, 20000);
+
+    free_valid_props_memory();
+    return 0;
+}
@@ -19,11 +19,13 @@ void test_runtime(const char *test_name, VMInstruction program[], int program_si
     }
 
     //On exécute le programme
-    execute_program();
+    Statut statut;
+    if (execute_program(&statut) < 0) {
+        printf("Erreur à l'instruction %d : %s\n", statut.position, statut.message);
+    }
 
     //Réinitialisation de la machine virtuelle (vide le programme et la pile)
-    program_counter = 0;
-    stack_top = -1;
+    reinitialiser_machine();
 }
 
 //Fonction principale pour exécuter les tests
@@ -79,6 +81,46 @@ int main() {
     };
     test_runtime("Test 4 : (1 AND (NOT 0)) OR (NOT 1)", test4, sizeof(test4) / sizeof(test4[0]));
 
+    //Tests invalides : l'erreur est retournée et la machine reste utilisable
+    VMInstruction test5[] = {
+        {VM_PUSH, 1},   //Empiler 1 (vrai)
+        {VM_AND, 0},    //AND logique avec un seul opérande
+        {VM_PRINT, 0}   //Afficher le résultat
+    };
+    test_runtime("Test 5 : pile vide", test5, sizeof(test5) / sizeof(test5[0]));
+
+    VMInstruction test6[] = {
+        {VM_LOAD, 0},   //Valeurs des propositions non définies
+        {VM_PRINT, 0}   //Afficher le résultat
+    };
+    test_runtime("Test 6 : valeurs absentes", test6, sizeof(test6) / sizeof(test6[0]));
+
+    VMInstruction test8[] = {
+        {VM_PUSH, 1},   //Empiler 1 (vrai)
+        {VM_PUSH, 0},   //Empiler 0 (faux)
+        {VM_XOR, 0},    //OU exclusif : vrai
+        {VM_PUSH, 1},   //Empiler 1 (vrai)
+        {VM_NAND, 0},   //NON ET : faux
+        {VM_PUSH, 0},   //Empiler 0 (faux)
+        {VM_NOR, 0},    //NON OU : vrai
+        {VM_PUSH, 1},   //Empiler 1 (vrai)
+        {VM_EQV, 0},    //EQUIVALENT : vrai
+        {VM_PRINT, 0}   //Afficher le résultat
+    };
+    test_runtime("Test 8 : opérateurs ⊕ ↑ ↓ ⇔", test8, sizeof(test8) / sizeof(test8[0]));
+
+    //Vérification des programmes avant une exécution bit-parallèle
+    Statut statut;
+    printf("\n=== Vérification des programmes ===\n");
+    printf("Test 2 : %d\n", verifier_programme(test2, 4, &statut));
+    printf("Test 5 : %d", verifier_programme(test5, 3, &statut));
+    printf(" (instruction %d : %s)\n", statut.position, statut.message);
+    printf("Test 8 : %d, bit-parallèle : %s\n", verifier_programme(test8, 9, &statut),
+           executer_programme_64(test8, 9, NULL) == ~(uint64_t)0 ? "VRAI" : "FAUX");
+    VMInstruction test7[] = {{VM_PUSH, 1}, {(VMOpcode)42, 0}};
+    printf("Test 7 : %d", verifier_programme(test7, 2, &statut));
+    printf(" (instruction %d : %s)\n", statut.position, statut.message);
+
     return 0;
 }
 
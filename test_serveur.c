@@ -0,0 +1,365 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "serveur.c"
+
+
+//Paramètres du thread serveur
+typedef struct {
+    Serveur *serveur;
+    int fd;                 //Flux servi, ou -1 pour le mode socket
+    const char *chemin;
+} ParametresServeur;
+
+//Fonction exécutée par le thread serveur
+void *thread_serveur(void *arg) {
+    ParametresServeur *p = arg;
+    if (p->fd >= 0) {
+        servir_flux(p->serveur, p->fd, p->fd);
+    } else {
+        servir_socket(p->serveur, p->chemin);
+    }
+    return NULL;
+}
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Fonction envoyant une requête d'évaluation
+void envoyer_evaluation(int fd, uint32_t id, uint32_t handle, uint64_t valuation) {
+    char donnees[12];
+    memcpy(donnees, &handle, 4);
+    memcpy(donnees + 4, &valuation, 8);
+    envoyer_trame(fd, REQ_EVALUER, id, donnees, sizeof(donnees));
+}
+
+//Fonction lisant une réponse et vérifiant son identifiant
+//Retourne le code d'erreur de la réponse, les données sont copiées dans resultat (au plus taille octets)
+uint32_t lire_reponse(int fd, uint32_t id, void *resultat, size_t taille) {
+    EnteteTrame entete;
+    void *donnees;
+    if (lire_trame(fd, &entete, &donnees) < 0) {
+        fprintf(stderr, "Erreur : Connexion fermée.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (entete.id != id) {
+        printf("ERREUR : réponse %u reçue à la place de %u\n", entete.id, id);
+    }
+    if (entete.type != ERR_AUCUNE && entete.taille >= 4) {
+        printf("  requête %u : erreur %u à la position %d : %.*s\n", id, entete.type, *(int *)donnees,
+               (int)entete.taille - 4, (char *)donnees + 4);
+    } else if (resultat) {
+        memcpy(resultat, donnees, entete.taille < taille ? entete.taille : taille);
+    }
+    free(donnees);
+    return entete.type;
+}
+
+//Fonction compilant une formule (requête et réponse)
+//Retourne le handle, ou 0xFFFFFFFF en cas d'erreur
+uint32_t compiler_distant(int fd, const char *formule) {
+    uint32_t handle = 0xFFFFFFFF;
+    envoyer_trame(fd, REQ_COMPILER, 0, formule, strlen(formule));
+    lire_reponse(fd, 0, &handle, sizeof(handle));
+    return handle;
+}
+
+//Test des requêtes sur un flux : plusieurs requêtes sont envoyées avant de lire les réponses
+void test_requetes(int fd) {
+    printf("\n=== Requêtes enchainées sur un flux ===\n");
+    const char *formules[] = {"p1⇒p2", "(p1∧p2)∨¬p3", "p1∧p4", "(p1∨"};
+    for (uint32_t i = 0; i < 4; i++) {
+        envoyer_trame(fd, REQ_COMPILER, i, formules[i], strlen(formules[i]));
+    }
+    uint32_t handles[4] = {0};
+    for (uint32_t i = 0; i < 4; i++) {
+        uint32_t code = lire_reponse(fd, i, &handles[i], sizeof(handles[i]));
+        printf("Compilation de %s : %s\n", formules[i], code == ERR_AUCUNE ? "OK" : "refusée");
+    }
+
+    //Evaluations : les 8 valuations de p1, p2, p3 pour les deux formules valides
+    int erreurs = 0;
+    for (uint32_t v = 0; v < 8; v++) {
+        envoyer_evaluation(fd, 100 + v, handles[0], v);
+        envoyer_evaluation(fd, 200 + v, handles[1], v);
+    }
+    for (uint32_t v = 0; v < 8; v++) {
+        int p1 = v & 1, p2 = (v >> 1) & 1, p3 = (v >> 2) & 1;
+        uint32_t r0 = 2, r1 = 2;
+        lire_reponse(fd, 100 + v, &r0, sizeof(r0));
+        lire_reponse(fd, 200 + v, &r1, sizeof(r1));
+        if (r0 != (uint32_t)(!p1 || p2)) erreurs++;
+        if (r1 != (uint32_t)((p1 && p2) || !p3)) erreurs++;
+    }
+    printf("Evaluations unitaires : %d erreur(s)\n", erreurs);
+
+    //Evaluation par lot de 1000 valuations aléatoires
+    uint32_t n = 1000;
+    char *requete = malloc(8 + 8 * n);
+    uint64_t *valuations = malloc(8 * n);
+    memcpy(requete, &handles[1], 4);
+    memcpy(requete + 4, &n, 4);
+    for (uint32_t k = 0; k < n; k++) {
+        valuations[k] = ((uint64_t)rand() << 32) ^ rand();
+    }
+    memcpy(requete + 8, valuations, 8 * n);
+    envoyer_trame(fd, REQ_EVALUER_LOT, 300, requete, 8 + 8 * n);
+    uint64_t resultats[(1000 + 63) / 64];
+    lire_reponse(fd, 300, resultats, sizeof(resultats));
+    erreurs = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        int p1 = valuations[k] & 1, p2 = (valuations[k] >> 1) & 1, p3 = (valuations[k] >> 2) & 1;
+        if ((int)((resultats[k / 64] >> (k % 64)) & 1) != ((p1 && p2) || !p3)) erreurs++;
+    }
+    printf("Evaluation par lot de %u valuations : %d erreur(s)\n", n, erreurs);
+    free(requete);
+    free(valuations);
+
+    //Libération puis utilisation d'un handle périmé, requête inconnue
+    envoyer_trame(fd, REQ_LIBERER, 400, &handles[0], 4);
+    envoyer_evaluation(fd, 401, handles[0], 0);
+    envoyer_trame(fd, 99, 402, NULL, 0);
+    printf("Libération : %s\n", lire_reponse(fd, 400, NULL, 0) == ERR_AUCUNE ? "OK" : "ERREUR");
+    printf("Handle libéré refusé : %s\n", lire_reponse(fd, 401, NULL, 0) == ERR_HANDLE_INVALIDE ? "OUI" : "NON");
+    printf("Requête inconnue refusée : %s\n", lire_reponse(fd, 402, NULL, 0) == ERR_REQUETE_INVALIDE ? "OUI" : "NON");
+}
+
+//Mesure de la latence : requêtes une par une (aller-retour), puis enchainées
+void test_latence(int fd) {
+    printf("\n=== Latence ===\n");
+    uint32_t handle = compiler_distant(fd, "(p1⇒p2)→((¬p1)∨p2)");
+    int n = 100000;
+    uint32_t r;
+
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < n; i++) {
+        envoyer_evaluation(fd, i, handle, i);
+        lire_reponse(fd, i, &r, sizeof(r));
+    }
+    double duree = secondes_depuis(debut);
+    printf("Aller-retour : %.2f µs par requête\n", duree * 1e6 / n);
+
+    //Les requêtes enchainées sont écrites par paquets de 256 avant de lire les réponses
+    char paquet[256][sizeof(EnteteTrame) + 12];
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int i = 0; i < n; i += 256) {
+        for (int k = 0; k < 256; k++) {
+            EnteteTrame entete = {12, REQ_EVALUER, (uint32_t)(i + k)};
+            uint64_t valuation = i + k;
+            memcpy(paquet[k], &entete, sizeof(entete));
+            memcpy(paquet[k] + sizeof(entete), &handle, 4);
+            memcpy(paquet[k] + sizeof(entete) + 4, &valuation, 8);
+        }
+        ecrire_tout(fd, paquet, sizeof(paquet));
+        for (int k = 0; k < 256; k++) {
+            lire_reponse(fd, i + k, &r, sizeof(r));
+        }
+    }
+    duree = secondes_depuis(debut);
+    printf("Enchainées : %.2f µs par requête\n", duree * 1e6 / ((n + 255) / 256 * 256));
+}
+
+//Lecture des réponses de test_saturation : une réponse d'erreur par requête, dans l'ordre
+typedef struct {
+    int fd;
+    int nb;
+    int erreurs;
+} LectureReponses;
+
+void *thread_lecture(void *arg) {
+    LectureReponses *l = arg;
+    for (int i = 0; i < l->nb; i++) {
+        EnteteTrame entete;
+        void *donnees;
+        if (lire_trame(l->fd, &entete, &donnees) < 0) {
+            l->erreurs++;
+            break;
+        }
+        l->erreurs += entete.id != (uint32_t)i || entete.type != ERR_REQUETE_INVALIDE;
+        free(donnees);
+    }
+    return NULL;
+}
+
+//Requêtes enchainées sans lire les réponses (type inconnu : chaque réponse d'erreur est plus grande que
+//la requête). Le serveur cesse de lire la connexion quand ses réponses en attente atteignent
+//MAX_SORTIE_EN_ATTENTE : l'envoi est bloqué avant la fin, puis toutes les réponses arrivent dans l'ordre
+void test_saturation(int fd) {
+    int nb_requetes = 1 << 20;
+    size_t total = (size_t)nb_requetes * sizeof(EnteteTrame);
+    EnteteTrame *requetes = malloc(total);
+    for (int i = 0; i < nb_requetes; i++) requetes[i] = (EnteteTrame){0, 99, (uint32_t)i};
+    int drapeaux = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, drapeaux | O_NONBLOCK);
+    size_t envoyes = 0;
+    for (int attentes = 0; envoyes < total && attentes < 100;) {
+        ssize_t ecrit = write(fd, (char *)requetes + envoyes, total - envoyes);
+        if (ecrit > 0) {
+            envoyes += ecrit;
+            attentes = 0;
+        } else {
+            usleep(10000);
+            attentes++;
+        }
+    }
+    fcntl(fd, F_SETFL, drapeaux);
+    printf("Requêtes sans lecture des réponses : %s\n",
+           envoyes < total ? "envoi bloqué avant la fin" : "ERREUR : tout est envoyé");
+
+    //Lecture des réponses, pendant que la fin de la requête entamée est envoyée (le serveur ne la lit
+    //qu'une fois ses réponses lues)
+    LectureReponses lecture = {fd, (int)((envoyes + sizeof(EnteteTrame) - 1) / sizeof(EnteteTrame)), 0};
+    pthread_t thread;
+    pthread_create(&thread, NULL, thread_lecture, &lecture);
+    ecrire_tout(fd, (char *)requetes + envoyes, (size_t)lecture.nb * sizeof(EnteteTrame) - envoyes);
+    pthread_join(thread, NULL);
+    printf("Réponses des requêtes envoyées : %s\n", lecture.erreurs ? "ERREUR" : "toutes reçues dans l'ordre");
+    free(requetes);
+}
+
+//Fonction ouvrant une connexion sur la socket Unix chemin (en attendant que le serveur écoute)
+int connecter_socket(const char *chemin) {
+    struct sockaddr_un adresse;
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    strcpy(adresse.sun_path, chemin);
+    int fd = -1;
+    for (int essai = 0; essai < 1000 && fd < 0; essai++) {
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, (struct sockaddr *)&adresse, sizeof(adresse)) < 0) {
+            close(fd);
+            fd = -1;
+            usleep(1000);
+        }
+    }
+    if (fd < 0) {
+        fprintf(stderr, "Erreur : Connexion impossible.\n");
+        exit(EXIT_FAILURE);
+    }
+    return fd;
+}
+
+//Fonction envoyant des requêtes de type inconnu sur fd sans lire les réponses, jusqu'à ce que le
+//serveur cesse de lire la connexion
+void envoyer_sans_lire(int fd) {
+    int nb_requetes = 1 << 20;
+    EnteteTrame *requetes = malloc((size_t)nb_requetes * sizeof(EnteteTrame));
+    for (int i = 0; i < nb_requetes; i++) requetes[i] = (EnteteTrame){0, 99, (uint32_t)i};
+    int drapeaux = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, drapeaux | O_NONBLOCK);
+    size_t envoyes = 0, total = (size_t)nb_requetes * sizeof(EnteteTrame);
+    for (int attentes = 0; envoyes < total && attentes < 20;) {
+        ssize_t ecrit = write(fd, (char *)requetes + envoyes, total - envoyes);
+        if (ecrit > 0) {
+            envoyes += ecrit;
+            attentes = 0;
+        } else {
+            usleep(10000);
+            attentes++;
+        }
+    }
+    fcntl(fd, F_SETFL, drapeaux);
+    free(requetes);
+}
+
+//Un client qui ferme sa connexion avec des réponses en attente ne fait que fermer cette connexion
+//(sans SIGPIPE, qui arrêterait tout le processus) : le serveur répond toujours sur fd
+void test_client_ferme(const char *chemin, int fd) {
+    int autre = connecter_socket(chemin);
+    envoyer_sans_lire(autre);
+    close(autre);
+    usleep(100000);
+    uint32_t handle = compiler_distant(fd, "p1∨p2"), r = 2;
+    envoyer_evaluation(fd, 3, handle, 0);
+    lire_reponse(fd, 3, &r, sizeof(r));
+    printf("Client fermé sans lire ses réponses : serveur %s\n", r == 0 ? "toujours actif" : "ERREUR");
+}
+
+//Test du mode socket : connexion, compilation, évaluation puis arrêt du serveur
+void test_socket(void) {
+    printf("\n=== Socket Unix ===\n");
+    const char *chemin = "/tmp/test_serveur.sock";
+    Serveur serveur;
+    serveur_initialiser(&serveur);
+    ParametresServeur p = {&serveur, -1, chemin};
+    pthread_t thread;
+    unlink(chemin);
+    pthread_create(&thread, NULL, thread_serveur, &p);
+    int fd = connecter_socket(chemin);
+
+    uint32_t handle = compiler_distant(fd, "p1∧¬p2"), r = 2;
+    envoyer_evaluation(fd, 1, handle, 1);
+    lire_reponse(fd, 1, &r, sizeof(r));
+    printf("p1∧¬p2 avec p1=1 p2=0 : %u\n", r);
+    test_saturation(fd);
+    test_client_ferme(chemin, fd);
+
+    //Arrêt alors qu'un client ne lit plus ses réponses : l'envoi de ses réponses est abandonné après
+    //DELAI_ARRET_MS au lieu de bloquer l'arrêt
+    int muet = connecter_socket(chemin);
+    envoyer_sans_lire(muet);
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    envoyer_trame(fd, REQ_ARRETER, 2, NULL, 0);
+    printf("Arrêt : %s\n", lire_reponse(fd, 2, NULL, 0) == ERR_AUCUNE ? "OK" : "ERREUR");
+    close(fd);
+    pthread_join(thread, NULL);
+    printf("Arrêt avec un client qui ne lit plus : %s\n",
+           secondes_depuis(debut) < 5 ? "terminé" : "ERREUR : trop long");
+    close(muet);
+    serveur_liberer(&serveur);
+}
+
+//Fonction principale
+//Sans argument : tests sur un flux (socketpair) puis sur une socket Unix
+//Avec argument : test_serveur chemin sert la socket chemin, test_serveur - sert l'entrée et la sortie standard
+int main(int argc, char **argv) {
+    setlocale(LC_ALL, "");
+
+    if (argc > 1) {
+        Serveur serveur;
+        serveur_initialiser(&serveur);
+        int r = strcmp(argv[1], "-") == 0 ? servir_flux(&serveur, 0, 1) : servir_socket(&serveur, argv[1]);
+        serveur_liberer(&serveur);
+        return r < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        perror("Erreur de socketpair");
+        return EXIT_FAILURE;
+    }
+    Serveur serveur;
+    serveur_initialiser(&serveur);
+    ParametresServeur p = {&serveur, fds[1], NULL};
+    pthread_t thread;
+    pthread_create(&thread, NULL, thread_serveur, &p);
+
+    srand(7);
+    test_requetes(fds[0]);
+    test_latence(fds[0]);
+
+    //La fermeture du flux termine servir_flux
+    close(fds[0]);
+    pthread_join(thread, NULL);
+    close(fds[1]);
+    serveur_liberer(&serveur);
+
+    test_socket();
+    return 0;
+}
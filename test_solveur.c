@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "cnf.c"
+#include "solveur.c"
+
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Arbre syntaxique d'une chaine (sans analyse sémantique : les propositions sont libres)
+ASTNode *arbre_chaine(const char *chaine) {
+    char **lexemes = CreationListeLexeme(chaine, NULL);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, NULL) : NULL;
+    liberer_lexemes(lexemes);
+    return ast;
+}
+
+//Affiche une réponse de resoudre et le noyau éventuel
+void afficher_reponse(Solveur *s, const char *question, int reponse) {
+    printf("%-34s %s", question, reponse ? "satisfiable" : "insatisfiable");
+    if (!reponse) {
+        const int *noyau;
+        int n = solveur_noyau(s, &noyau);
+        printf(", noyau {");
+        for (int i = 0; i < n; i++) printf("%s%d", i ? ", " : "", noyau[i]);
+        printf("}");
+    }
+    printf("\n");
+}
+
+//Exemple : une base de règles et des questions sous hypothèses
+void test_regles(void) {
+    const char *regles[] = {"p1⇒p2", "p2⇒p3", "p3⇒¬p4", "p5⇔p1∨p6", "p7⊕p5"};
+    int nb_regles = sizeof(regles) / sizeof(regles[0]);
+    Solveur s;
+    solveur_initialiser(&s);
+    printf("=== Base de règles ===\n");
+    for (int i = 0; i < nb_regles; i++) {
+        ASTNode *ast = arbre_chaine(regles[i]);
+        solveur_affirmer_formule(&s, ast, NULL);
+        freeAST(ast);
+        printf("%s ", regles[i]);
+    }
+    int p[8];
+    char nom[8];
+    for (int i = 1; i <= 7; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        p[i] = solveur_variable_prop(&s, nom);
+    }
+    printf("\n(variables : p1 = %d, p3 = %d, p4 = %d, p7 = %d)\n", p[1], p[3], p[4], p[7]);
+
+    int h1[] = {p[1], p[4]};
+    afficher_reponse(&s, "p1 et p4 ?", resoudre(&s, h1, 2, NULL));
+    int h2[] = {p[3], -p[7]};
+    afficher_reponse(&s, "p3 et ¬p7 ?", resoudre(&s, h2, 2, NULL));
+    printf("  modèle : p1 = %d, p5 = %d, p6 = %d\n", solveur_valeur(&s, p[1]), solveur_valeur(&s, p[5]),
+           solveur_valeur(&s, p[6]));
+    int h3[] = {p[3], p[7], -p[6], p[1]};
+    afficher_reponse(&s, "p3, p7, ¬p6 et p1 ?", resoudre(&s, h3, 4, NULL));
+
+    //Une formule ajoutée sans être affirmée peut servir d'hypothèse
+    ASTNode *ast = arbre_chaine("p2∧p4");
+    int f = solveur_ajouter_formule(&s, ast, NULL);
+    freeAST(ast);
+    int h4[] = {p[6], f};
+    afficher_reponse(&s, "p6 et (p2∧p4) ?", resoudre(&s, h4, 2, NULL));
+    int h5[] = {-f, p[2], p[4]};
+    afficher_reponse(&s, "¬(p2∧p4), p2 et p4 ?", resoudre(&s, h5, 3, NULL));
+
+    //Clause ajoutée entre deux questions
+    int clause[] = {-p[6]};
+    solveur_ajouter_clause(&s, clause, 1, NULL);
+    int h6[] = {p[5], -p[1]};
+    afficher_reponse(&s, "après ¬p6 : p5 et ¬p1 ?", resoudre(&s, h6, 2, NULL));
+    solveur_liberer(&s);
+}
+
+//Evaluation directe d'un arbre dont les propositions sont nommées r0, r1, ...
+int evaluer_arbre(ASTNode *n, unsigned valuation) {
+    switch (n->type) {
+        case NODE_PROP: return (valuation >> atoi(n->value + 1)) & 1;
+        case NODE_NOT: return !evaluer_arbre(n->right, valuation);
+        case NODE_AND: return evaluer_arbre(n->left, valuation) && evaluer_arbre(n->right, valuation);
+        case NODE_OR: return evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+        case NODE_EQUIV: return evaluer_arbre(n->left, valuation) == evaluer_arbre(n->right, valuation);
+        case NODE_XOR: return evaluer_arbre(n->left, valuation) != evaluer_arbre(n->right, valuation);
+        case NODE_NAND: return !(evaluer_arbre(n->left, valuation) && evaluer_arbre(n->right, valuation));
+        case NODE_NOR: return !(evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation));
+        default: return !evaluer_arbre(n->left, valuation) || evaluer_arbre(n->right, valuation);
+    }
+}
+
+//Formule aléatoire sur les propositions r0 .. r(nb_props - 1)
+ASTNode *formule_aleatoire(int profondeur, int nb_props) {
+    char nom[16];
+    if (profondeur == 0 || rand() % 4 == 0) {
+        snprintf(nom, sizeof(nom), "r%d", rand() % nb_props);
+        return createPropNode(nom);
+    }
+    int choix = rand() % 8;
+    if (choix == 0) return createOpNode(NODE_NOT, NULL, formule_aleatoire(profondeur - 1, nb_props));
+    NodeType types[] = {NODE_AND, NODE_OR, NODE_PROD, NODE_EQUIV, NODE_XOR, NODE_NAND, NODE_NOR};
+    return createOpNode(types[choix - 1], formule_aleatoire(profondeur - 1, nb_props), formule_aleatoire(profondeur - 1, nb_props));
+}
+
+//Base de règles aléatoire et questions sous hypothèses (propositions r0 .. r9 et formules non affirmées)
+#define NB_PROPS_ALEA 10
+#define NB_REGLES_ALEA 6
+#define NB_FORMULES_ALEA 4
+
+typedef struct {
+    ASTNode *regles[NB_REGLES_ALEA];
+    ASTNode *formules[NB_FORMULES_ALEA];
+    int codes[8];           //Hypothèses : 2 * i + signe, i < NB_PROPS_ALEA pour une proposition
+    int nb;
+} QuestionAleatoire;
+
+//Retourne 1 si la valuation v satisfait les règles et les hypothèses du masque
+int satisfait(const QuestionAleatoire *q, unsigned v, unsigned masque) {
+    for (int r = 0; r < NB_REGLES_ALEA; r++) {
+        if (!evaluer_arbre(q->regles[r], v)) return 0;
+    }
+    for (int h = 0; h < q->nb; h++) {
+        if (!((masque >> h) & 1)) continue;
+        int i = q->codes[h] >> 1;
+        int valeur = i < NB_PROPS_ALEA ? (int)((v >> i) & 1) : evaluer_arbre(q->formules[i - NB_PROPS_ALEA], v);
+        if (valeur == (q->codes[h] & 1)) return 0;
+    }
+    return 1;
+}
+
+//Retourne 1 si une valuation satisfait les règles et les hypothèses du masque
+int satisfiable(const QuestionAleatoire *q, unsigned masque) {
+    for (unsigned v = 0; v < (1u << NB_PROPS_ALEA); v++) {
+        if (satisfait(q, v, masque)) return 1;
+    }
+    return 0;
+}
+
+//Questions aléatoires sur une base de règles aléatoires, comparées à l'énumération des valuations :
+//réponse, modèle (règles et hypothèses vraies) et noyau (sous-ensemble des hypothèses, lui-même insatisfiable)
+void test_aleatoire(int nb_bases, int nb_questions) {
+    int erreurs_reponse = 0, erreurs_modele = 0, erreurs_noyau = 0, nb_non = 0;
+    srand(5);
+    for (int b = 0; b < nb_bases; b++) {
+        Solveur s;
+        solveur_initialiser(&s);
+        QuestionAleatoire q;
+        int litteraux_formules[NB_FORMULES_ALEA], variables[NB_PROPS_ALEA];
+        char nom[16];
+        for (int i = 0; i < NB_PROPS_ALEA; i++) {
+            snprintf(nom, sizeof(nom), "r%d", i);
+            variables[i] = solveur_variable_prop(&s, nom);
+        }
+        for (int i = 0; i < NB_REGLES_ALEA; i++) {
+            q.regles[i] = formule_aleatoire(3, NB_PROPS_ALEA);
+            solveur_affirmer_formule(&s, q.regles[i], NULL);
+        }
+        for (int i = 0; i < NB_FORMULES_ALEA; i++) {
+            q.formules[i] = formule_aleatoire(3, NB_PROPS_ALEA);
+            litteraux_formules[i] = solveur_ajouter_formule(&s, q.formules[i], NULL);
+        }
+
+        for (int k = 0; k < nb_questions; k++) {
+            int hypotheses[8];
+            q.nb = 1 + rand() % 6;
+            for (int h = 0; h < q.nb; h++) {
+                int i = rand() % (NB_PROPS_ALEA + NB_FORMULES_ALEA);
+                int signe = rand() % 2;
+                q.codes[h] = 2 * i + signe;
+                int l = i < NB_PROPS_ALEA ? variables[i] : litteraux_formules[i - NB_PROPS_ALEA];
+                hypotheses[h] = signe ? -l : l;
+            }
+
+            int reponse = resoudre(&s, hypotheses, q.nb, NULL);
+            if (reponse != satisfiable(&q, 0xFF)) erreurs_reponse++;
+            if (reponse) {
+                unsigned v = 0;
+                for (int i = 0; i < NB_PROPS_ALEA; i++) v |= (unsigned)solveur_valeur(&s, variables[i]) << i;
+                if (!satisfait(&q, v, 0xFF)) erreurs_modele++;
+            } else {
+                nb_non++;
+                //Le noyau ne contient que des hypothèses, et reste insatisfiable seul
+                const int *noyau;
+                int n = solveur_noyau(&s, &noyau);
+                unsigned masque = 0;
+                for (int c = 0; c < n; c++) {
+                    int h = 0;
+                    while (h < q.nb && hypotheses[h] != noyau[c]) h++;
+                    if (h == q.nb) erreurs_noyau++;
+                    else masque |= 1u << h;
+                }
+                if (satisfiable(&q, masque)) erreurs_noyau++;
+            }
+        }
+        for (int i = 0; i < NB_REGLES_ALEA; i++) freeAST(q.regles[i]);
+        for (int i = 0; i < NB_FORMULES_ALEA; i++) freeAST(q.formules[i]);
+        solveur_liberer(&s);
+    }
+    printf("\n%d bases, %d questions chacune : %d réponse(s) non, %d erreur(s) de réponse, %d de modèle, %d de noyau\n",
+           nb_bases, nb_questions, nb_non, erreurs_reponse, erreurs_modele, erreurs_noyau);
+}
+
+//Littéral aléatoire (proposition éventuellement niée) parmi r0 .. r(nb_props - 1)
+ASTNode *litteral_aleatoire(int nb_props) {
+    char nom[16];
+    snprintf(nom, sizeof(nom), "r%d", rand() % nb_props);
+    ASTNode *p = createPropNode(nom);
+    return rand() % 2 ? createOpNode(NODE_NOT, NULL, p) : p;
+}
+
+//Règle aléatoire de la forme (a∧b)⇒c : une clause de 3 littéraux (3-SAT aléatoire)
+ASTNode *regle_aleatoire(int nb_props) {
+    ASTNode *a = litteral_aleatoire(nb_props);
+    ASTNode *b = litteral_aleatoire(nb_props);
+    return createOpNode(NODE_IMP, createOpNode(NODE_AND, a, b), litteral_aleatoire(nb_props));
+}
+
+//Fonction ajoutant une base de règles aléatoires (propositions r0 .. r(nb_props - 1)) à un solveur
+void affirmer_regles(Solveur *s, ASTNode **regles, int nb_regles, int nb_props) {
+    char nom[16];
+    for (int i = 0; i < nb_props; i++) {
+        snprintf(nom, sizeof(nom), "r%d", i);
+        solveur_variable_prop(s, nom);
+    }
+    for (int i = 0; i < nb_regles; i++) solveur_affirmer_formule(s, regles[i], NULL);
+}
+
+//Questions répétées sur une même base de règles : un solveur incrémental, ou un solveur reconstruit
+//(encodage des règles compris) à chaque question. Temps processeur
+void test_performances(int nb_props, int nb_regles, int nb_questions) {
+    ASTNode **regles = malloc(nb_regles * sizeof(ASTNode *));
+    int *hypotheses = malloc(5 * nb_questions * sizeof(int));
+    srand(13);
+    for (int i = 0; i < nb_regles; i++) regles[i] = regle_aleatoire(nb_props);
+    //Les propositions r0 .. r(nb_props - 1) reçoivent les variables 1 .. nb_props
+    for (int i = 0; i < 5 * nb_questions; i++) {
+        int v = 1 + rand() % nb_props;
+        hypotheses[i] = rand() % 2 ? v : -v;
+    }
+
+    clock_t debut = clock();
+    Solveur s;
+    solveur_initialiser(&s);
+    affirmer_regles(&s, regles, nb_regles, nb_props);
+    int oui_incremental = 0;
+    for (int q = 0; q < nb_questions; q++) oui_incremental += resoudre(&s, &hypotheses[5 * q], 5, NULL);
+    double temps_incremental = (double)(clock() - debut) / CLOCKS_PER_SEC;
+    long conflits_incremental = s.conflits;
+    int variables = s.nb_variables, clauses = s.originales.nb, apprises = s.apprises.nb;
+    solveur_liberer(&s);
+
+    debut = clock();
+    int oui_reconstruit = 0;
+    long conflits_reconstruit = 0;
+    for (int q = 0; q < nb_questions; q++) {
+        solveur_initialiser(&s);
+        affirmer_regles(&s, regles, nb_regles, nb_props);
+        oui_reconstruit += resoudre(&s, &hypotheses[5 * q], 5, NULL);
+        conflits_reconstruit += s.conflits;
+        solveur_liberer(&s);
+    }
+    double temps_reconstruit = (double)(clock() - debut) / CLOCKS_PER_SEC;
+
+    printf("\n=== %d règles sur %d propositions (%d variables, %d clauses), %d questions de 5 hypothèses ===\n",
+           nb_regles, nb_props, variables, clauses, nb_questions);
+    printf("  incrémental           %.3f s, %ld conflits, %d clauses apprises gardées, %d oui\n",
+           temps_incremental, conflits_incremental, apprises, oui_incremental);
+    printf("  reconstruit à chaque  %.3f s, %ld conflits, %d oui%s\n", temps_reconstruit, conflits_reconstruit,
+           oui_reconstruit, oui_reconstruit == oui_incremental ? "" : " (REPONSES DIFFERENTES)");
+    for (int i = 0; i < nb_regles; i++) freeAST(regles[i]);
+    free(regles);
+    free(hypotheses);
+}
+
+//Budget mémoire : les règles et les questions refusées (-1, ERR_MEMOIRE) sont reprises une fois le
+//budget levé, et les réponses doivent être celles d'un solveur sans budget
+void test_budget(int nb_props, int nb_regles, int nb_questions) {
+    ASTNode **regles = malloc(nb_regles * sizeof(ASTNode *));
+    int *hypotheses = malloc(5 * nb_questions * sizeof(int));
+    int *reponses = malloc(nb_questions * sizeof(int));
+    srand(17);
+    for (int i = 0; i < nb_regles; i++) regles[i] = regle_aleatoire(nb_props);
+    for (int i = 0; i < 5 * nb_questions; i++) {
+        int v = 1 + rand() % nb_props;
+        hypotheses[i] = rand() % 2 ? v : -v;
+    }
+    Solveur s;
+    solveur_initialiser(&s);
+    affirmer_regles(&s, regles, nb_regles, nb_props);
+    for (int q = 0; q < nb_questions; q++) reponses[q] = resoudre(&s, &hypotheses[5 * q], 5, NULL);
+    solveur_liberer(&s);
+
+    printf("\n=== Budget mémoire : %d règles, %d questions ===\n", nb_regles, nb_questions);
+    for (size_t budget = 16 * 1024; budget <= 1024 * 1024; budget *= 4) {
+        AllocateurSuivi suivi;
+        suivi_initialiser(&suivi, NULL, budget);
+        Allocateur *precedent = utiliser_allocateur(&suivi.base);
+        solveur_initialiser(&s);
+        char nom[16];
+        //Les hypothèses désignent ri par la variable i + 1 : une proposition refusée est reprise sans budget
+        for (int i = 0; i < nb_props; i++) {
+            snprintf(nom, sizeof(nom), "r%d", i);
+            if (solveur_variable_prop(&s, nom) == 0) {
+                suivi.budget = 0;
+                solveur_variable_prop(&s, nom);
+                suivi.budget = budget;
+            }
+        }
+        Statut statut;
+        int refus_regles = 0, refus_questions = 0, mauvais_statuts = 0, differences = 0;
+        char *refusee = calloc(nb_regles > nb_questions ? nb_regles : nb_questions, 1);
+        for (int i = 0; i < nb_regles; i++) {
+            if (solveur_affirmer_formule(&s, regles[i], &statut) < 0) {
+                refusee[i] = 1;
+                refus_regles++;
+                if (statut.code != ERR_MEMOIRE) mauvais_statuts++;
+            }
+        }
+        suivi.budget = 0;
+        for (int i = 0; i < nb_regles; i++) {
+            if (refusee[i]) solveur_affirmer_formule(&s, regles[i], NULL);
+        }
+
+        //Questions sous le même budget, reprises sans budget en cas de refus
+        suivi.budget = budget;
+        for (int q = 0; q < nb_questions; q++) {
+            int r = resoudre(&s, &hypotheses[5 * q], 5, &statut);
+            if (r < 0) {
+                refus_questions++;
+                if (statut.code != ERR_MEMOIRE) mauvais_statuts++;
+                suivi.budget = 0;
+                r = resoudre(&s, &hypotheses[5 * q], 5, NULL);
+                suivi.budget = budget;
+            }
+            if (r != reponses[q]) differences++;
+        }
+        solveur_liberer(&s);
+        utiliser_allocateur(precedent);
+        free(refusee);
+        printf("Budget %7zu octets : %3d règle(s) et %3d question(s) refusée(s), %d mauvais statut(s), "
+               "%d réponse(s) différente(s), %zu octets vivants après\n",
+               budget, refus_regles, refus_questions, mauvais_statuts, differences, suivi.total.vivants);
+    }
+    for (int i = 0; i < nb_regles; i++) freeAST(regles[i]);
+    free(regles);
+    free(hypotheses);
+    free(reponses);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    test_regles();
+    test_aleatoire(200, 50);
+    test_performances(150, 600, 1000);
+    test_budget(150, 600, 200);
+    return 0;
+}
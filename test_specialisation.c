@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "specialisation.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p24)
+#define NB_PROPS_TEST 24
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Valeurs aléatoires des colonnes, qui respectent l'affectation a
+void colonnes_affectation(uint64_t *colonnes, const AffectationPartielle *a) {
+    for (int i = 0; i < NB_PROPS_TEST; i++) {
+        if (a->connues[i / 64] >> (i % 64) & 1) {
+            colonnes[i] = (a->valeurs[i / 64] >> (i % 64) & 1) ? ~0ULL : 0;
+        } else {
+            colonnes[i] = ((uint64_t)rand() << 42) ^ ((uint64_t)rand() << 21) ^ (uint64_t)rand();
+        }
+    }
+}
+
+//Affectation aléatoire d'environ une proposition sur proportion
+void affectation_aleatoire(AffectationPartielle *a, int proportion) {
+    affectation_vider(a);
+    for (int i = 0; i < NB_PROPS_TEST; i++) {
+        if (rand() % proportion == 0) affectation_fixer(a, i, rand() % 2);
+    }
+}
+
+static const NodeType binaires_test[] = {NODE_AND, NODE_OR, NODE_IMP, NODE_PROD, NODE_EQUIV, NODE_XOR, NODE_NAND,
+                                         NODE_NOR};
+
+//Arbre aléatoire de la profondeur donnée (les négations sont parfois doublées)
+ASTNode *arbre_aleatoire(int profondeur) {
+    if (profondeur == 0) {
+        char nom[16];
+        snprintf(nom, sizeof(nom), "p%d", 1 + rand() % NB_PROPS_TEST);
+        return createPropNode(nom);
+    }
+    if (rand() % 5 == 0) return createOpNode(NODE_NOT, NULL, arbre_aleatoire(profondeur - 1));
+    return createOpNode(binaires_test[rand() % 8], arbre_aleatoire(profondeur - 1), arbre_aleatoire(profondeur - 1));
+}
+
+//Nombre de VM_LOAD d'une proposition connue
+int lectures_connues(const VMInstruction *prog, int taille, const AffectationPartielle *a) {
+    int n = 0;
+    for (int i = 0; i < taille; i++) {
+        int p = prog[i].operand;
+        n += prog[i].opcode == VM_LOAD && p < MAX_PROPS_AFFECTATION && (a->connues[p / 64] >> (p % 64) & 1);
+    }
+    return n;
+}
+
+//Comparaison sur des formules et des affectations aléatoires : même résultat pour les valuations qui
+//respectent l'affectation, aucune lecture d'une proposition connue, résidu jamais plus long, et même
+//résidu par le programme et par l'arbre
+void test_aleatoire(int nb_formules) {
+    VMInstruction prog[PROGRAM_SIZE], residuel[PROGRAM_SIZE], residuel_ast[PROGRAM_SIZE];
+    int differences = 0, lectures = 0, plus_longs = 0, ast_differents = 0, constants = 0;
+    long instructions = 0, instructions_residuelles = 0;
+    srand(3);
+    for (int f = 0; f < nb_formules; f++) {
+        ASTNode *ast = arbre_aleatoire(1 + rand() % 7);
+        int taille = compiler_programme(ast, prog, PROGRAM_SIZE, NULL);
+        AffectationPartielle a;
+        affectation_aleatoire(&a, 1 + rand() % 4);
+        Statut statut;
+        int n = specialiser_programme(prog, taille, &a, residuel, &statut);
+        int n_ast = specialiser_ast(ast, &a, residuel_ast, PROGRAM_SIZE, &statut);
+        freeAST(ast);
+        if (taille < 0 || n < 0) {
+            printf("Formule %d refusée : %s\n", f, statut.message);
+            differences++;
+            continue;
+        }
+        instructions += taille;
+        instructions_residuelles += n;
+        constants += n == 1 && residuel[0].opcode == VM_PUSH;
+        plus_longs += n > taille;
+        lectures += lectures_connues(residuel, n, &a);
+        ast_differents += n != n_ast || memcmp(residuel, residuel_ast, n * sizeof(VMInstruction)) != 0;
+        uint64_t colonnes[NB_PROPS_TEST];
+        for (int essai = 0; essai < 16; essai++) {
+            colonnes_affectation(colonnes, &a);
+            differences += executer_programme_64(prog, taille, colonnes) != executer_programme_64(residuel, n, colonnes);
+        }
+    }
+    printf("%d formules aléatoires : %.1f instructions, %.1f après spécialisation, %d constante(s)\n", nb_formules,
+           (double)instructions / nb_formules, (double)instructions_residuelles / nb_formules, constants);
+    printf("  %d différence(s), %d lecture(s) de propositions connues, %d résidu(s) plus long(s), "
+           "%d différence(s) arbre/programme\n", differences, lectures, plus_longs, ast_differents);
+}
+
+//Affichage d'un programme
+void afficher_programme(const VMInstruction *prog, int taille) {
+    for (int i = 0; i < taille; i++) {
+        switch (prog[i].opcode) {
+            case VM_LOAD: printf(" p%d", prog[i].operand + 1); break;
+            case VM_PUSH: printf(" %s", prog[i].operand ? "vrai" : "faux"); break;
+            default: printf(" %s", operateur_opcode(prog[i].opcode)->symbole); break;
+        }
+    }
+    printf("\n");
+}
+
+//Exemple : formule et affectation données (p1 à p3 : -1 inconnue, 0 ou 1)
+void test_exemple(const char *expression, int p1, int p2, int p3) {
+    VMInstruction prog[PROGRAM_SIZE], residuel[PROGRAM_SIZE];
+    Statut statut;
+    char **lexemes = CreationListeLexeme(expression, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int taille = ast ? compiler_programme(ast, prog, PROGRAM_SIZE, &statut) : -1;
+    freeAST(ast);
+    AffectationPartielle a;
+    affectation_vider(&a);
+    int valeurs[3] = {p1, p2, p3};
+    for (int i = 0; i < 3; i++) {
+        if (valeurs[i] >= 0) affectation_fixer(&a, i, valeurs[i]);
+    }
+    int n = taille < 0 ? -1 : specialiser_programme(prog, taille, &a, residuel, &statut);
+    printf("%-16s p1=%2d p2=%2d p3=%2d :", expression, p1, p2, p3);
+    if (n < 0) printf(" erreur %s\n", statut.message);
+    else afficher_programme(residuel, n);
+}
+
+//Cas particuliers : VM_POP, VM_NOP, programme refusé, résidu trop long pour specialiser_ast
+void test_limites(void) {
+    printf("\n=== Limites ===\n");
+    AffectationPartielle a;
+    affectation_vider(&a);
+    affectation_fixer(&a, 0, 1);
+    VMInstruction residuel[16];
+    Statut statut;
+    VMInstruction avec_pop[] = {{VM_LOAD, 1}, {VM_LOAD, 2}, {VM_NOP, 0}, {VM_POP, 0}, {VM_LOAD, 0}, {VM_AND, 0}};
+    int n = specialiser_programme(avec_pop, 6, &a, residuel, &statut);
+    printf("p2 p3 POP p1 ∧ (p1 vrai) :");
+    afficher_programme(residuel, n);
+    VMInstruction sous_resultat[] = {{VM_LOAD, 1}, {VM_LOAD, 2}, {VM_NOT, 0}};
+    n = specialiser_programme(sous_resultat, 3, &a, residuel, &statut);
+    printf("p2 p3 ¬ (p2 reste sous le résultat) :");
+    afficher_programme(residuel, n);
+    VMInstruction mauvais[] = {{VM_AND, 0}};
+    n = specialiser_programme(mauvais, 1, &a, residuel, &statut);
+    printf("Programme refusé : %d (%s)\n", n, n < 0 ? statut.message : "accepté");
+    affectation_vider(&a);
+    ASTNode *ast = arbre_aleatoire(5);
+    n = specialiser_ast(ast, &a, residuel, 16, &statut);
+    printf("Arbre de profondeur 5 dans 16 instructions : %d (%s)\n", n, n < 0 ? statut.message : "accepté");
+    freeAST(ast);
+    printf("Proposition %d : %d\n", MAX_PROPS_AFFECTATION, affectation_fixer(&a, MAX_PROPS_AFFECTATION, 1));
+}
+
+//Règles d'un ensemble évaluées pour plusieurs clients, chacun ayant fixé la plupart des propositions :
+//programmes d'origine, puis résidus pris dans le cache de chaque client
+void test_clients(int nb_regles, int nb_clients, int nb_evaluations) {
+    VMInstruction **progs = malloc(nb_regles * sizeof(VMInstruction *));
+    int *tailles = malloc(nb_regles * sizeof(int));
+    for (int r = 0; r < nb_regles; r++) {
+        ASTNode *ast = arbre_aleatoire(7);
+        progs[r] = malloc(PROGRAM_SIZE * sizeof(VMInstruction));
+        tailles[r] = compiler_programme(ast, progs[r], PROGRAM_SIZE, NULL);
+        freeAST(ast);
+    }
+    //Chaque client fixe 20 des 24 propositions ; les colonnes respectent l'affectation de leur client
+    AffectationPartielle *affectations = malloc(nb_clients * sizeof(AffectationPartielle));
+    CacheSpecialisations *caches = malloc(nb_clients * sizeof(CacheSpecialisations));
+    uint64_t (*colonnes)[NB_PROPS_TEST] = malloc(nb_clients * sizeof(*colonnes));
+    for (int c = 0; c < nb_clients; c++) {
+        affectation_vider(&affectations[c]);
+        for (int i = 4; i < NB_PROPS_TEST; i++) affectation_fixer(&affectations[c], i, rand() % 2);
+        colonnes_affectation(colonnes[c], &affectations[c]);
+        cache_specialisations_initialiser(&caches[c]);
+    }
+
+    struct timespec debut;
+    uint64_t somme_origine = 0, somme_residuelle = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        for (int c = 0; c < nb_clients; c++) {
+            for (int r = 0; r < nb_regles; r++) somme_origine += executer_programme_64(progs[r], tailles[r], colonnes[c]);
+        }
+    }
+    double temps_origine = secondes_depuis(debut);
+    long instructions_residuelles = 0, instructions = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        for (int c = 0; c < nb_clients; c++) {
+            for (int r = 0; r < nb_regles; r++) {
+                int n;
+                const VMInstruction *residuel =
+                    specialisation_en_cache(&caches[c], r, progs[r], tailles[r], &affectations[c], &n, NULL);
+                somme_residuelle += executer_programme_64(residuel, n, colonnes[c]);
+                if (e == 0) {
+                    instructions += tailles[r];
+                    instructions_residuelles += n;
+                }
+            }
+        }
+    }
+    double temps_residuel = secondes_depuis(debut);
+
+    long succes = 0, echecs = 0;
+    for (int c = 0; c < nb_clients; c++) {
+        succes += caches[c].succes;
+        echecs += caches[c].echecs;
+    }
+    long nb = (long)nb_regles * nb_clients * nb_evaluations;
+    printf("\n=== %d règles, %d clients (20 propositions sur 24 fixées), %d évaluations ===\n", nb_regles, nb_clients,
+           nb_evaluations);
+    printf("Instructions par règle : %.1f, %.1f après spécialisation\n", (double)instructions / (nb_regles * nb_clients),
+           (double)instructions_residuelles / (nb_regles * nb_clients));
+    printf("Cache : %ld résidu(s) calculé(s), %ld trouvé(s)\n", echecs, succes);
+    printf("  programmes d'origine  %7.1f ns par règle\n", temps_origine * 1e9 / nb);
+    printf("  résidus en cache      %7.1f ns par règle (x%.2f) [%s]\n", temps_residuel * 1e9 / nb,
+           temps_origine / temps_residuel, somme_origine == somme_residuelle ? "mêmes résultats" : "ERREUR");
+
+    //Un cache vidé recalcule ses résidus
+    vider_cache_specialisations(&caches[0]);
+    int n;
+    specialisation_en_cache(&caches[0], 0, progs[0], tailles[0], &affectations[0], &n, NULL);
+    printf("Après vidage du cache du client 0 : %d entrée(s), %ld résidu(s) calculé(s)\n", caches[0].nb,
+           caches[0].echecs);
+
+    for (int c = 0; c < nb_clients; c++) liberer_cache_specialisations(&caches[c]);
+    for (int r = 0; r < nb_regles; r++) free(progs[r]);
+    free(progs);
+    free(tailles);
+    free(affectations);
+    free(caches);
+    free(colonnes);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    printf("=== Exemples ===\n");
+    test_exemple("p1∧p2", 0, -1, -1);
+    test_exemple("p1∧p2", 1, -1, -1);
+    test_exemple("p1⇒p2", -1, 0, -1);
+    test_exemple("p1⇔p2", 0, -1, -1);
+    test_exemple("¬p1⊕p2", -1, 1, -1);
+    test_exemple("(p1∨p2)∧p3", 1, -1, -1);
+    test_exemple("(p1↑p2)↓p3", -1, -1, 1);
+    test_exemple("(p1∧p2)∨(p1∧p3)", 1, 0, -1);
+
+    printf("\n=== Spécialisations aléatoires ===\n");
+    test_aleatoire(20000);
+    test_limites();
+    test_clients(200, 16, 200);
+
+    free_valid_props_memory();
+    return 0;
+}
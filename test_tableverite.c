@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+#include <sys/wait.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "tableverite.c"
+
+
+//Nombre de propositions utilisées par les tests (p1 .. p26)
+#define NB_PROPS_TEST 26
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Fonction compilant une formule en programme de la machine virtuelle
+//Retourne le nombre d'instructions, ou -1 en cas d'erreur
+int compiler_chaine(const char *chaine, VMInstruction *prog, int capacite) {
+    Statut statut;
+    char **lexemes = CreationListeLexeme(chaine, &statut);
+    ASTNode *ast = lexemes ? analyseur_syntaxique(lexemes, &statut) : NULL;
+    liberer_lexemes(lexemes);
+    int n = -1;
+    if (ast && analyseur_semantique(ast, &statut) == 0) {
+        n = compiler_programme(ast, prog, capacite, &statut);
+    }
+    if (n < 0) printf("%s : erreur %s\n", chaine, statut.message);
+    freeAST(ast);
+    return n;
+}
+
+//Fonction écrivant une formule aléatoire sans parenthèses sur les propositions p1 .. p(nb_props)
+//(chacune une fois, dans un ordre aléatoire, les précédences donnent la structure)
+void ecrire_formule_aleatoire(char *texte, int nb_props) {
+    static const char *binaires[] = {"∧", "∨", "⇒", "→", "⇔", "⊕", "↑", "↓"};
+    int ordre[NB_PROPS_TEST];
+    for (int i = 0; i < nb_props; i++) ordre[i] = i + 1;
+    for (int i = nb_props - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int x = ordre[i];
+        ordre[i] = ordre[j];
+        ordre[j] = x;
+    }
+    size_t n = 0;
+    for (int i = 0; i < nb_props; i++) {
+        if (i > 0) n += sprintf(texte + n, "%s", binaires[rand() % 8]);
+        if (rand() % 4 == 0) n += sprintf(texte + n, "¬");
+        n += sprintf(texte + n, "p%d", ordre[i]);
+    }
+}
+
+//Résultat du programme pour une valuation de la table, calculé par la machine virtuelle
+int resultat_programme(const VMInstruction *prog, int taille, const TableVerite *t, uint32_t valuation) {
+    uint64_t colonnes[NB_PROPS_TEST] = {0};
+    for (int k = 0; k < t->nb_props; k++) {
+        colonnes[t->props[k]] = ((valuation >> k) & 1) ? ~(uint64_t)0 : 0;
+    }
+    return (int)(executer_programme_64(prog, taille, colonnes) & 1);
+}
+
+//Comparaison de la table et de la machine virtuelle (toutes les valuations jusqu'à 16 propositions)
+void test_formule(const char *chaine) {
+    VMInstruction prog[PROGRAM_SIZE];
+    int taille = compiler_chaine(chaine, prog, PROGRAM_SIZE);
+    if (taille < 0) return;
+    TableVerite t;
+    Statut statut;
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    if (construire_table_verite(prog, taille, &t, &statut) < 0) {
+        printf("%.40s : %s\n", chaine, statut.message);
+        return;
+    }
+    double construction = secondes_depuis(debut);
+
+    uint64_t nb_valuations = (uint64_t)1 << t.nb_props;
+    uint64_t testees = nb_valuations <= 65536 ? nb_valuations : 65536;
+    long differences = 0;
+    for (uint64_t i = 0; i < testees; i++) {
+        uint32_t v = nb_valuations <= 65536 ? (uint32_t)i : (uint32_t)(rand() % nb_valuations);
+        differences += consulter_table_verite(&t, v) != resultat_programme(prog, taille, &t, v);
+    }
+    printf("%2d prop(s), %8llu octets, construite en %5.1f ms, %5llu valuation(s) : %ld différence(s)  %s\n",
+           t.nb_props, (unsigned long long)(t.nb_mots * sizeof(uint64_t)), construction * 1e3,
+           (unsigned long long)testees, differences, chaine);
+    liberer_table_verite(&t);
+}
+
+//Enregistrement puis projection par un autre processus
+void test_partage(void) {
+    const char *chemin = "/tmp/test_tableverite.tab";
+    char texte[1024];
+    VMInstruction prog[PROGRAM_SIZE], autre[PROGRAM_SIZE];
+    Statut statut;
+    srand(3);
+    ecrire_formule_aleatoire(texte, MAX_PROPS_TABLE);
+    int taille = compiler_chaine(texte, prog, PROGRAM_SIZE);
+    int taille_autre = compiler_chaine("p1∧p2", autre, PROGRAM_SIZE);
+    TableVerite t, projetee;
+    if (taille < 0 || construire_table_verite(prog, taille, &t, &statut) < 0) return;
+
+    printf("\n=== Partage par projection en mémoire ===\n");
+    printf("Enregistrement : %s\n", enregistrer_table_verite(&t, chemin, &statut) == 0 ? "ok" : statut.message);
+
+    //Un autre processus projette la table et la compare à la machine virtuelle
+    pid_t fils = fork();
+    if (fils == 0) {
+        if (charger_table_verite(chemin, prog, taille, &projetee, &statut) < 0) _exit(2);
+        long differences = 0;
+        for (int i = 0; i < 100000; i++) {
+            uint32_t v = (uint32_t)rand() & ((1u << MAX_PROPS_TABLE) - 1);
+            differences += consulter_table_verite(&projetee, v) != resultat_programme(prog, taille, &projetee, v);
+        }
+        liberer_table_verite(&projetee);
+        _exit(differences == 0 ? 0 : 1);
+    }
+    int etat = 0;
+    waitpid(fils, &etat, 0);
+    printf("Autre processus : %s\n", WIFEXITED(etat) && WEXITSTATUS(etat) == 0 ? "table identique" : "ERREUR");
+
+    struct timespec debut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int r = charger_table_verite(chemin, prog, taille, &projetee, &statut);
+    double chargement = secondes_depuis(debut);
+    int identiques = r == 0 && memcmp(projetee.mots, t.mots, t.nb_mots * sizeof(uint64_t)) == 0;
+    printf("Projection : %.1f µs, %s\n", chargement * 1e6, identiques ? "table identique" : "ERREUR");
+    liberer_table_verite(&projetee);
+
+    r = charger_table_verite(chemin, autre, taille_autre, &projetee, &statut);
+    printf("Autre programme : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+
+    //Fichier tronqué
+    truncate(chemin, sizeof(EnteteTableVerite) + 8);
+    r = charger_table_verite(chemin, NULL, 0, &projetee, &statut);
+    printf("Table tronquée : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+    remove(chemin);
+    liberer_table_verite(&t);
+
+    //Trop de propositions
+    ecrire_formule_aleatoire(texte, MAX_PROPS_TABLE + 1);
+    taille = compiler_chaine(texte, prog, PROGRAM_SIZE);
+    r = construire_table_verite(prog, taille, &t, &statut);
+    printf("%d propositions : %d (%s)\n", MAX_PROPS_TABLE + 1, r, r < 0 ? statut.message : "acceptée");
+}
+
+//Comparaison du temps d'une évaluation : machine virtuelle et consultation de la table
+void test_performances(int nb_props, int nb_evaluations) {
+    char texte[1024];
+    VMInstruction prog[PROGRAM_SIZE];
+    srand(7);
+    ecrire_formule_aleatoire(texte, nb_props);
+    int taille = compiler_chaine(texte, prog, PROGRAM_SIZE);
+    TableVerite t;
+    if (taille < 0 || construire_table_verite(prog, taille, &t, NULL) < 0) return;
+
+    int (*valeurs)[NB_PROPS_TEST] = malloc(1024 * sizeof(*valeurs));
+    for (int i = 0; i < 1024; i++) {
+        for (int k = 0; k < NB_PROPS_TEST; k++) valeurs[i][k] = (rand() & 1) ? -1 : 0;
+    }
+
+    //Machine virtuelle (execute_program) : une exécution complète du programme par évaluation
+    reinitialiser_machine();
+    for (int i = 0; i < taille; i++) add_instruction(prog[i].opcode, prog[i].operand);
+    struct timespec debut;
+    long vrais_vm = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        int r = 0;
+        definir_valeurs_propositions(valeurs[e & 1023]);
+        execute_program(NULL);
+        vm_pop(&r);
+        vrais_vm += r != 0;
+    }
+    double temps_vm = secondes_depuis(debut);
+    reinitialiser_machine();
+
+    //Table : valuation construite à partir des valeurs, puis lecture d'un bit
+    long vrais_table = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        vrais_table += consulter_table_verite(&t, valuation_table_verite(&t, valeurs[e & 1023]));
+    }
+    double temps_table = secondes_depuis(debut);
+
+    //Table : valuations déjà sous forme de bits (lecture seule)
+    long vrais_bits = 0;
+    uint32_t masque = (uint32_t)(((uint64_t)1 << nb_props) - 1);
+    uint32_t v = 12345;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (int e = 0; e < nb_evaluations; e++) {
+        v = (v * 1664525u + 1013904223u);
+        vrais_bits += consulter_table_verite(&t, v & masque);
+    }
+    double temps_bits = secondes_depuis(debut);
+
+    printf("\n=== %d propositions, %d instructions, %d évaluations ===\n", nb_props, taille, nb_evaluations);
+    printf("  execute_program                 %6.1f ns par évaluation\n", temps_vm * 1e9 / nb_evaluations);
+    printf("  table (valeurs -> valuation)    %6.1f ns par évaluation [%s]\n", temps_table * 1e9 / nb_evaluations,
+           vrais_table == vrais_vm ? "mêmes résultats" : "RESULTATS DIFFERENTS");
+    printf("  table (valuation en bits)       %6.1f ns par évaluation (%ld vrais)\n", temps_bits * 1e9 / nb_evaluations,
+           vrais_bits);
+    free(valeurs);
+    liberer_table_verite(&t);
+}
+
+//Choix des tables dans un budget mémoire
+void test_budget(uint64_t budget) {
+    enum { NB_CANDIDATS = 40 };
+    static VMInstruction progs[NB_CANDIDATS][PROGRAM_SIZE];
+    CandidatTable candidats[NB_CANDIDATS];
+    char texte[1024];
+    srand(9);
+    for (int i = 0; i < NB_CANDIDATS; i++) {
+        ecrire_formule_aleatoire(texte, 4 + rand() % (NB_PROPS_TEST - 3));
+        candidats[i].prog = progs[i];
+        candidats[i].taille = compiler_chaine(texte, progs[i], PROGRAM_SIZE);
+        candidats[i].frequence = (double)(1 + rand() % 1000);
+    }
+    uint64_t utilises;
+    Statut statut;
+    if (choisir_tables_verite(candidats, NB_CANDIDATS, budget, &utilises, &statut) < 0) {
+        printf("\nBudget de %llu octets : %s\n", (unsigned long long)budget, statut.message);
+        return;
+    }
+    int retenus = 0, impossibles = 0;
+    for (int i = 0; i < NB_CANDIDATS; i++) {
+        retenus += candidats[i].retenu;
+        impossibles += candidats[i].octets == 0;
+    }
+    printf("\nBudget de %llu octets : %d formule(s) retenue(s) sur %d (%d avec trop de propositions), %llu octets utilisés\n",
+           (unsigned long long)budget, retenus, NB_CANDIDATS, impossibles, (unsigned long long)utilises);
+
+    //Mémoire insuffisante : les formules retenues par l'appel précédent ne le restent pas
+    AllocateurSuivi suivi;
+    suivi_initialiser(&suivi, NULL, 1);
+    Allocateur *precedent = utiliser_allocateur(&suivi.base);
+    int r = choisir_tables_verite(candidats, NB_CANDIDATS, budget, &utilises, &statut);
+    utiliser_allocateur(precedent);
+    retenus = 0;
+    for (int i = 0; i < NB_CANDIDATS; i++) retenus += candidats[i].retenu;
+    printf("Sans mémoire : %d (%s), %d formule(s) retenue(s)\n", r, r < 0 ? statut.message : "", retenus);
+}
+
+//Fonction principale
+int main() {
+    setlocale(LC_ALL, "");
+    initialize_valid_props();
+    char nom[16];
+    for (int i = 4; i <= NB_PROPS_TEST; i++) {
+        snprintf(nom, sizeof(nom), "p%d", i);
+        add_valid_prop(nom);
+    }
+
+    printf("=== Tables de vérité ===\n");
+    test_formule("p1");
+    test_formule("p1∧¬p2");
+    test_formule("(p1⇒p2)→((¬p1)∨p2)");
+    test_formule("p1⇔p2⊕p3↑¬p4↓p5∧p6∨p7");
+    char texte[1024];
+    srand(1);
+    for (int n = 10; n <= MAX_PROPS_TABLE; n += 7) {
+        ecrire_formule_aleatoire(texte, n);
+        test_formule(texte);
+    }
+
+    test_partage();
+    test_performances(20, 10000000);
+    test_budget(4 << 20);
+
+    free_valid_props_memory();
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+#include <time.h>
+
+#include "allocateur.c"
+#include "analex.c"
+#include "anasynt.c"
+#include "anasem.c"
+#include "compilateur.c"
+#include "runtime.c"
+#include "arbreplat.c"
+#include "frontal.c"
+#include "vocabulaire.c"
+
+
+//Temps écoulé en secondes depuis debut
+double secondes_depuis(struct timespec debut) {
+    struct timespec fin;
+    clock_gettime(CLOCK_MONOTONIC, &fin);
+    return (fin.tv_sec - debut.tv_sec) + (fin.tv_nsec - debut.tv_nsec) / 1e9;
+}
+
+//Nom de la i-ème proposition générée (distinct pour chaque i)
+void nom_genere(char *nom, long i) {
+    sprintf(nom, "v%lxq", i * 2654435761UL % 4294967291UL);
+}
+
+//Fonction écrivant un fichier de nb_noms noms (avec des doublons et des lignes vides)
+void ecrire_noms(const char *chemin, long nb_noms) {
+    FILE *f = fopen(chemin, "w");
+    char nom[32];
+    for (long i = 0; i < nb_noms; i++) {
+        nom_genere(nom, i);
+        fprintf(f, "%s\n", nom);
+        if (i % 1000 == 0) fprintf(f, "%s\r\n\n", nom);
+    }
+    fclose(f);
+}
+
+//Fonction écrivant un fichier texte
+void ecrire_fichier(const char *chemin, const char *texte) {
+    FILE *f = fopen(chemin, "w");
+    fputs(texte, f);
+    fclose(f);
+}
+
+//Construction, chargement puis vérification de toutes les recherches
+void test_grand_vocabulaire(long nb_noms) {
+    const char *noms = "/tmp/test_vocabulaire.txt";
+    const char *image = "/tmp/test_vocabulaire.voc";
+    ecrire_noms(noms, nb_noms);
+
+    struct timespec debut;
+    Statut statut;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    long n = construire_vocabulaire(noms, image, &statut);
+    double construction = secondes_depuis(debut);
+    if (n < 0) {
+        printf("Construction impossible : %s\n", statut.message);
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    int r = charger_vocabulaire(image, &statut);
+    double chargement = secondes_depuis(debut);
+    printf("%ld noms distincts : construction %.2f s, chargement %.1f µs (%s)\n",
+           n, construction, chargement * 1e6, r == 0 ? "ok" : statut.message);
+    if (r < 0) return;
+
+    //Chaque nom a un indice unique dans [0, n), et nom_prop retrouve le nom
+    char nom[32];
+    uint8_t *vu = calloc(n, 1);
+    long erreurs = 0;
+    clock_gettime(CLOCK_MONOTONIC, &debut);
+    for (long i = 0; i < nb_noms; i++) {
+        nom_genere(nom, i);
+        int indice = indice_prop(nom);
+        if (indice < 0 || indice >= n || vu[indice] || strcmp(nom_prop(indice), nom) != 0) erreurs++;
+        else vu[indice] = 1;
+    }
+    double recherche = secondes_depuis(debut);
+    printf("Recherches des noms connus : %ld erreur(s), %.0f ns par nom\n", erreurs, recherche * 1e9 / nb_noms);
+    free(vu);
+
+    //Noms inconnus : refusés
+    long acceptes = 0;
+    for (long i = 0; i < 100000; i++) {
+        sprintf(nom, "w%ld", i);
+        acceptes += is_valid_prop(nom);
+    }
+    printf("Noms inconnus acceptés : %ld\n", acceptes);
+
+    //Les propositions de la liste viennent après le vocabulaire, et l'analyse des formules utilise les deux
+    nom_genere(nom, 12345);
+    char formule[128];
+    snprintf(formule, sizeof(formule), "(%s∧p1)⇒¬p3", nom);
+    ArbrePlat arbre;
+    arbre_plat_initialiser(&arbre);
+    r = analyser_formule(formule, &arbre, &statut);
+    printf("%s : %s, p1 -> %d, %d propositions\n", formule, r == 0 ? "acceptée" : statut.message,
+           indice_prop("p1"), nombre_props());
+    liberer_arbre_plat(&arbre);
+
+    fermer_vocabulaire();
+    printf("Après fermeture : p1 -> %d, %s -> %d\n", indice_prop("p1"), nom, indice_prop(nom));
+    remove(noms);
+    remove(image);
+}
+
+//Fichiers de noms ou images invalides : refusés avec une erreur
+void test_invalides(void) {
+    const char *noms = "/tmp/test_vocabulaire_invalide.txt";
+    const char *image = "/tmp/test_vocabulaire_invalide.voc";
+    Statut statut;
+
+    printf("\n=== Images et fichiers invalides ===\n");
+    ecrire_fichier(noms, "alpha\nbeta\nGamma\n");
+    long n = construire_vocabulaire(noms, image, &statut);
+    printf("Nom en majuscules : %ld, erreur %d ligne %d : %s\n", n, statut.code, statut.position, statut.message);
+
+    ecrire_fichier(noms, "");
+    n = construire_vocabulaire(noms, image, &statut);
+    int r = charger_vocabulaire(image, &statut);
+    printf("Vocabulaire vide : %ld nom(s), chargement %d, alpha -> %d\n", n, r, indice_prop("alpha"));
+    fermer_vocabulaire();
+
+    //Image tronquée, puis entête modifié
+    ecrire_fichier(noms, "alpha\nbeta\ngamma\n");
+    construire_vocabulaire(noms, image, &statut);
+    FILE *f = fopen(image, "r+b");
+    fseek(f, 0, SEEK_END);
+    long taille = ftell(f);
+    char *contenu = malloc(taille);
+    fseek(f, 0, SEEK_SET);
+    fread(contenu, 1, taille, f);
+    fclose(f);
+
+    f = fopen(image, "wb");
+    fwrite(contenu, 1, taille - 3, f);
+    fclose(f);
+    r = charger_vocabulaire(image, &statut);
+    printf("Image tronquée : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+
+    contenu[0] = 'X';
+    f = fopen(image, "wb");
+    fwrite(contenu, 1, taille, f);
+    fclose(f);
+    r = charger_vocabulaire(image, &statut);
+    printf("Magie incorrecte : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+
+    contenu[0] = 'P';
+    ((EnteteVocabulaire *)contenu)->nb_mots = 1000;
+    f = fopen(image, "wb");
+    fwrite(contenu, 1, taille, f);
+    fclose(f);
+    r = charger_vocabulaire(image, &statut);
+    printf("Nombre de noms incorrect : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+
+    //Tailles choisies pour que leur somme reboucle sur la taille du fichier
+    EnteteVocabulaire *entete = (EnteteVocabulaire *)contenu;
+    entete->nb_mots = INT32_MAX;
+    uint64_t taille_tables = 2 * (uint64_t)entete->nb_seaux * sizeof(uint32_t) +
+                             ((uint64_t)entete->nb_mots + 1) * sizeof(uint32_t);
+    entete->taille_noms = (uint64_t)taille - sizeof(EnteteVocabulaire) - taille_tables;
+    f = fopen(image, "wb");
+    fwrite(contenu, 1, taille, f);
+    fclose(f);
+    r = charger_vocabulaire(image, &statut);
+    printf("Tailles qui rebouclent : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+
+    r = charger_vocabulaire("/tmp/inexistant.voc", &statut);
+    printf("Image absente : %d (%s, code %d)\n", r, r < 0 ? statut.message : "acceptée", statut.code);
+    free(contenu);
+    remove(noms);
+    remove(image);
+}
+
+//Fonction principale
+//Sans argument : tests ; avec deux arguments : construction de l'image d'un fichier de noms
+int main(int argc, char **argv) {
+    setlocale(LC_ALL, "");
+    if (argc == 3) {
+        Statut statut;
+        long n = construire_vocabulaire(argv[1], argv[2], &statut);
+        if (n < 0) {
+            fprintf(stderr, "ERREUR %d %d %s\n", statut.code, statut.position, statut.message);
+            return 1;
+        }
+        printf("%ld noms\n", n);
+        return 0;
+    }
+
+    initialize_valid_props();
+    printf("=== Vocabulaire projeté en mémoire ===\n");
+    test_grand_vocabulaire(1000000);
+    test_invalides();
+    free_valid_props_memory();
+    return 0;
+}
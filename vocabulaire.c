@@ -0,0 +1,303 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+//Pour projeter le fichier des noms en mémoire (mmap)
+
+#include "vocabulaire.h"
+#include "allocateur.h"
+
+
+//Nombre moyen de noms par seau
+#define NOMS_PAR_SEAU 4
+
+//Nombre de valeurs de d0 essayées pour un seau avant de changer de graine
+#define ESSAIS_D0 64
+
+//Nombre maximal de graines essayées
+#define MAX_GRAINES 32
+
+//Nom lu dans le fichier (pointe dans la projection du fichier)
+typedef struct {
+    const char *texte;
+    uint32_t longueur;
+    uint64_t h;
+} NomVocabulaire;
+
+//Comparaison de deux noms pour qsort (ordre des octets puis longueur)
+static int comparer_noms(const void *a, const void *b) {
+    const NomVocabulaire *x = a, *y = b;
+    uint32_t n = x->longueur < y->longueur ? x->longueur : y->longueur;
+    int c = memcmp(x->texte, y->texte, n);
+    if (c) return c;
+    return (x->longueur > y->longueur) - (x->longueur < y->longueur);
+}
+
+//Fonction lisant les noms d'un fichier projeté en mémoire (un par ligne)
+//Parametre donnees, taille : contenu du fichier
+//Parametre noms : tableau alloué par la fonction
+//Parametre statut : Statut, la position est le numéro de ligne d'un nom invalide
+//Retourne le nombre de noms distincts, ou -1 en cas d'erreur
+static long lire_noms(const char *donnees, size_t taille, NomVocabulaire **noms, Statut *statut) {
+    size_t capacite = 1024, n = 0;
+    NomVocabulaire *t = mem_allouer(capacite * sizeof(NomVocabulaire));
+    if (!t) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        return -1;
+    }
+    size_t pos = 0;
+    int ligne = 1;
+    while (pos < taille) {
+        const char *debut = donnees + pos;
+        const char *fin = memchr(debut, '\n', taille - pos);
+        size_t len = fin ? (size_t)(fin - debut) : taille - pos;
+        pos += len + 1;
+        if (len > 0 && debut[len - 1] == '\r') len--;
+        if (len > 0) {
+            //Seuls les noms que l'analyse lexicale reconnaît comme une proposition sont acceptés
+            int valide = debut[0] >= 'a' && debut[0] <= 'z' && len < UINT32_MAX;
+            for (size_t i = 1; i < len && valide; i++) {
+                valide = (debut[i] >= 'a' && debut[i] <= 'z') || (debut[i] >= '0' && debut[i] <= '9');
+            }
+            if (!valide) {
+                statut_definir(statut, ERR_LEXEME_INVALIDE, ligne, "Nom de proposition invalide");
+                mem_liberer(t);
+                return -1;
+            }
+            if (n == capacite) {
+                capacite *= 2;
+                NomVocabulaire *nouveau = mem_reallouer(t, capacite * sizeof(NomVocabulaire));
+                if (!nouveau) {
+                    statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+                    mem_liberer(t);
+                    return -1;
+                }
+                t = nouveau;
+            }
+            t[n].texte = debut;
+            t[n].longueur = (uint32_t)len;
+            n++;
+        }
+        ligne++;
+    }
+
+    //Suppression des doublons (deux noms identiques ne peuvent pas avoir deux emplacements différents)
+    qsort(t, n, sizeof(NomVocabulaire), comparer_noms);
+    size_t distincts = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (distincts == 0 || comparer_noms(&t[distincts - 1], &t[i]) != 0) {
+            t[distincts++] = t[i];
+        }
+    }
+    if (distincts > UINT32_MAX / 2) {
+        statut_definir(statut, ERR_TABLE_PLEINE, -1, "Trop de noms");
+        mem_liberer(t);
+        return -1;
+    }
+    *noms = t;
+    return (long)distincts;
+}
+
+//Fonction cherchant le déplacement d'un seau : toutes ses clés doivent tomber sur des emplacements
+//libres et distincts
+//Parametre cles : indices des noms du seau
+//Parametre taille : nombre de noms du seau (au moins 2, au plus 64)
+//Parametre occupe, emplacements : emplacements déjà pris, mis à jour si le seau est placé
+//Retourne 0 si un déplacement est trouvé (écrit dans d), -1 sinon
+static int placer_seau(const NomVocabulaire *noms, const uint32_t *cles, int taille, uint32_t m,
+                       uint8_t *occupe, uint32_t *emplacements, uint32_t *d) {
+    uint32_t positions[64];
+    for (uint32_t d0 = 0; d0 < ESSAIS_D0; d0++) {
+        for (uint32_t d1 = 0; d1 < m; d1++) {
+            int ok = 1;
+            for (int k = 0; k < taille && ok; k++) {
+                positions[k] = emplacement_vocabulaire(noms[cles[k]].h, d0, d1, m);
+                if (occupe[positions[k]]) ok = 0;
+                for (int j = 0; j < k && ok; j++) {
+                    if (positions[j] == positions[k]) ok = 0;
+                }
+            }
+            if (ok) {
+                for (int k = 0; k < taille; k++) {
+                    occupe[positions[k]] = 1;
+                    emplacements[positions[k]] = cles[k];
+                }
+                d[0] = d0;
+                d[1] = d1;
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+//Fonction calculant les déplacements de tous les seaux pour une graine
+//Parametre emplacements : nom placé à chaque emplacement (sortie)
+//Parametre deplacements : (d0, d1) de chaque seau (sortie)
+//Retourne 0, ou -1 si la graine ne convient pas
+static int construire_deplacements(NomVocabulaire *noms, uint32_t n, uint32_t nb_seaux, uint32_t graine,
+                                   uint32_t *emplacements, uint32_t *deplacements) {
+    int resultat = -1;
+    uint32_t *taille_seau = mem_callouer(nb_seaux + 1, sizeof(uint32_t));
+    uint32_t *debut_seau = mem_allouer((nb_seaux + 1) * sizeof(uint32_t));
+    uint32_t *cles = mem_allouer((n ? n : 1) * sizeof(uint32_t));
+    uint32_t *ordre = mem_allouer(nb_seaux * sizeof(uint32_t));
+    uint8_t *occupe = mem_callouer(n ? n : 1, 1);
+    if (!taille_seau || !debut_seau || !cles || !ordre || !occupe) goto fin;
+
+    //Répartition des noms dans les seaux (tri par seau)
+    for (uint32_t i = 0; i < n; i++) {
+        noms[i].h = hacher_vocabulaire(noms[i].texte, noms[i].longueur, graine);
+        taille_seau[seau_vocabulaire(noms[i].h, nb_seaux)]++;
+    }
+    uint32_t max_taille = 0;
+    debut_seau[0] = 0;
+    for (uint32_t s = 0; s < nb_seaux; s++) {
+        debut_seau[s + 1] = debut_seau[s] + taille_seau[s];
+        if (taille_seau[s] > max_taille) max_taille = taille_seau[s];
+        taille_seau[s] = 0;
+    }
+    if (max_taille > 64) goto fin;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t s = seau_vocabulaire(noms[i].h, nb_seaux);
+        cles[debut_seau[s] + taille_seau[s]++] = i;
+    }
+
+    //Les seaux sont placés du plus grand au plus petit (tri par comptage sur la taille)
+    uint32_t compte[66] = {0};
+    for (uint32_t s = 0; s < nb_seaux; s++) compte[max_taille - taille_seau[s] + 1]++;
+    for (uint32_t t = 1; t <= max_taille + 1; t++) compte[t] += compte[t - 1];
+    for (uint32_t s = 0; s < nb_seaux; s++) ordre[compte[max_taille - taille_seau[s]]++] = s;
+
+    uint32_t prochain_libre = 0;
+    for (uint32_t k = 0; k < nb_seaux; k++) {
+        uint32_t s = ordre[k];
+        uint32_t taille = taille_seau[s];
+        uint32_t *d = &deplacements[2 * s];
+        if (taille == 0) {
+            d[0] = d[1] = 0;
+        } else if (taille == 1) {
+            //d1 désigne directement le prochain emplacement libre
+            while (occupe[prochain_libre]) prochain_libre++;
+            uint32_t i = cles[debut_seau[s]];
+            uint32_t f1 = emplacement_vocabulaire(noms[i].h, 0, 0, n);
+            d[0] = 0;
+            d[1] = (prochain_libre + n - f1) % n;
+            occupe[prochain_libre] = 1;
+            emplacements[prochain_libre] = i;
+        } else if (placer_seau(noms, &cles[debut_seau[s]], taille, n, occupe, emplacements, d) < 0) {
+            goto fin;
+        }
+    }
+    resultat = 0;
+
+fin:
+    mem_liberer(taille_seau);
+    mem_liberer(debut_seau);
+    mem_liberer(cles);
+    mem_liberer(ordre);
+    mem_liberer(occupe);
+    return resultat;
+}
+
+//Fonction construisant l'image d'un vocabulaire
+//Parametre chemin_noms : fichier des noms, un par ligne
+//Parametre chemin_image : fichier de l'image (remplacé)
+//Parametre statut : Statut, rempli en cas d'erreur (peut être NULL)
+//Retourne le nombre de noms distincts, ou -1 en cas d'erreur
+long construire_vocabulaire(const char *chemin_noms, const char *chemin_image, Statut *statut) {
+    statut_ok(statut);
+    int fd = open(chemin_noms, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        if (fd >= 0) close(fd);
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier des noms illisible");
+        return -1;
+    }
+    const char *donnees = NULL;
+    if (st.st_size > 0) {
+        donnees = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (donnees == MAP_FAILED) {
+            close(fd);
+            statut_definir(statut, ERR_MEMOIRE, -1, "Projection du fichier des noms impossible");
+            return -1;
+        }
+    }
+    close(fd);
+
+    NomVocabulaire *noms = NULL;
+    long n = lire_noms(donnees, st.st_size, &noms, statut);
+    uint32_t nb_seaux = n > 0 ? (uint32_t)((n + NOMS_PAR_SEAU - 1) / NOMS_PAR_SEAU) : 1;
+    uint32_t *deplacements = n >= 0 ? mem_allouer(2 * (size_t)nb_seaux * sizeof(uint32_t)) : NULL;
+    uint32_t *emplacements = n >= 0 ? mem_allouer((n ? n : 1) * sizeof(uint32_t)) : NULL;
+    long resultat = -1;
+    if (n < 0) goto fin;
+    if (!deplacements || !emplacements) {
+        statut_definir(statut, ERR_MEMOIRE, -1, "Erreur d'allocation mémoire");
+        goto fin;
+    }
+
+    //On change de graine tant que les déplacements ne peuvent pas être trouvés
+    uint32_t graine = 0;
+    if (n > 0) {
+        while (graine < MAX_GRAINES &&
+               construire_deplacements(noms, (uint32_t)n, nb_seaux, graine, emplacements, deplacements) < 0) {
+            graine++;
+        }
+        if (graine == MAX_GRAINES) {
+            statut_definir(statut, ERR_TABLE_PLEINE, -1, "Aucune graine ne convient");
+            goto fin;
+        }
+    } else {
+        deplacements[0] = deplacements[1] = 0;
+    }
+
+    //Ecriture de l'image
+    EnteteVocabulaire entete;
+    memset(&entete, 0, sizeof(entete));
+    memcpy(entete.magie, MAGIE_VOCABULAIRE, 8);
+    entete.nb_mots = (uint32_t)n;
+    entete.nb_seaux = nb_seaux;
+    entete.graine = graine;
+    for (long i = 0; i < n; i++) entete.taille_noms += noms[i].longueur + 1;
+    if (entete.taille_noms > UINT32_MAX) {
+        statut_definir(statut, ERR_TABLE_PLEINE, -1, "Noms trop longs pour l'image");
+        goto fin;
+    }
+    entete.taille_totale = sizeof(entete) + 2 * (uint64_t)nb_seaux * sizeof(uint32_t) +
+                           ((uint64_t)n + 1) * sizeof(uint32_t) + entete.taille_noms;
+
+    FILE *sortie = fopen(chemin_image, "wb");
+    if (!sortie) {
+        statut_definir(statut, ERR_FICHIER, -1, "Fichier de l'image impossible à créer");
+        goto fin;
+    }
+    int ok = fwrite(&entete, sizeof(entete), 1, sortie) == 1 &&
+             fwrite(deplacements, sizeof(uint32_t), 2 * (size_t)nb_seaux, sortie) == 2 * (size_t)nb_seaux;
+    uint32_t debut = 0;
+    for (long e = 0; e < n && ok; e++) {
+        ok = fwrite(&debut, sizeof(debut), 1, sortie) == 1;
+        debut += noms[emplacements[e]].longueur + 1;
+    }
+    ok = ok && fwrite(&debut, sizeof(debut), 1, sortie) == 1;
+    for (long e = 0; e < n && ok; e++) {
+        const NomVocabulaire *nom = &noms[emplacements[e]];
+        ok = fwrite(nom->texte, 1, nom->longueur, sortie) == nom->longueur && fputc('\0', sortie) != EOF;
+    }
+    if (fclose(sortie) != 0 || !ok) {
+        statut_definir(statut, ERR_FICHIER, -1, "Erreur d'écriture de l'image");
+        goto fin;
+    }
+    resultat = n;
+
+fin:
+    mem_liberer(noms);
+    mem_liberer(deplacements);
+    mem_liberer(emplacements);
+    if (donnees) munmap((void *)donnees, st.st_size);
+    return resultat;
+}
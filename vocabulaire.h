@@ -0,0 +1,63 @@
+#ifndef VOCABULAIRE_H
+#define VOCABULAIRE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "erreurs.h"
+
+//Image d'un vocabulaire de propositions, projetée en mémoire (mmap) telle quelle.
+//Le hachage parfait minimal (CHD : hachage puis déplacement) associe à chaque nom un emplacement
+//unique dans [0, nb_mots) : cet emplacement est l'indice de la proposition.
+//
+//Disposition du fichier (entiers dans l'ordre des octets de la machine) :
+//  EnteteVocabulaire
+//  uint32_t deplacements[2 * nb_seaux]     (d0, d1) de chaque seau
+//  uint32_t debut_noms[nb_mots + 1]        début du nom de chaque emplacement dans noms
+//  char noms[taille_noms]                  noms terminés par '\0', dans l'ordre des emplacements
+//
+//Recherche d'un nom : seau = f0(h), emplacement = (f1(h) + d0 * f2(h) + d1) mod nb_mots,
+//puis comparaison avec le nom rangé à cet emplacement.
+
+#define MAGIE_VOCABULAIRE "PROPVOC1"
+
+typedef struct {
+    char magie[8];
+    uint32_t nb_mots;
+    uint32_t nb_seaux;
+    uint32_t graine;            //Graine du hachage retenue à la construction
+    uint32_t reserve;
+    uint64_t taille_noms;
+    uint64_t taille_totale;     //Taille du fichier, vérifiée au chargement
+} EnteteVocabulaire;
+
+//Fonction de hachage d'un nom de n octets (FNV-1a puis mélange final, dépendant de la graine)
+static inline uint64_t hacher_vocabulaire(const char *nom, size_t n, uint32_t graine) {
+    uint64_t h = 14695981039346656037ULL ^ ((uint64_t)graine * 0x9E3779B97F4A7C15ULL);
+    for (size_t i = 0; i < n; i++) {
+        h = (h ^ (unsigned char)nom[i]) * 1099511628211ULL;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+//Seau d'un hachage
+static inline uint32_t seau_vocabulaire(uint64_t h, uint32_t nb_seaux) {
+    return (uint32_t)(((h >> 32) * 0x9E3779B97F4A7C15ULL) >> 32) % nb_seaux;
+}
+
+//Emplacement d'un hachage pour le déplacement (d0, d1)
+static inline uint32_t emplacement_vocabulaire(uint64_t h, uint32_t d0, uint32_t d1, uint32_t nb_mots) {
+    uint64_t f1 = (uint32_t)h % nb_mots;
+    uint64_t f2 = (uint32_t)(h >> 32) % nb_mots;
+    return (uint32_t)((f1 + d0 * f2 + d1) % nb_mots);
+}
+
+//Construction de l'image à partir d'un fichier de noms (un par ligne, [a-z][a-z0-9]*, les doublons
+//et les lignes vides sont ignorés). Retourne le nombre de noms, ou -1 en cas d'erreur
+long construire_vocabulaire(const char *chemin_noms, const char *chemin_image, Statut *statut);
+
+#endif